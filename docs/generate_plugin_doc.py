@@ -22,7 +22,8 @@ SHAPE_ORDERING = [
     'cube',
     'sdfgrid',
     'shapegroup',
-    'instance'
+    'instance',
+    'deferred'
 ]
 
 BSDF_ORDERING = [
@@ -68,6 +69,7 @@ TEXTURE_ORDERING = [
     'bitmap',
     'checkerboard',
     'mesh_attribute',
+    'tiled',
     'volume'
 ]
 
@@ -128,7 +130,8 @@ PHASE_ORDERING = [
 
 VOLUME_ORDERING = [
     'constvolume',
-    'gridvolume'
+    'gridvolume',
+    'sparsegridvolume'
 ]
 
 
@@ -4,6 +4,7 @@
 #include <mitsuba/core/vector.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/rfilter.h>
+#include <map>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -89,7 +90,7 @@ public:
          *
          * The following is <em>not</em> supported:
          * <ul>
-         *   <li>Saving of tiled images, tile-based read access</li>
+         *   <li>Tile-based read access</li>
          *   <li>Display windows that are different than the data window</li>
          *   <li>Loading of spectrum-valued bitmaps</li>
          * </ul>
@@ -165,7 +166,62 @@ public:
         Auto
     };
 
+    /// Compression methods supported when writing OpenEXR files
+    enum class ExrCompression : uint32_t {
+        /// Lossless PIZ compression, or DWAB if a \c quality level is given (default)
+        Auto,
 
+        /// No compression
+        Uncompressed,
+
+        /// Lossless run-length encoding
+        RLE,
+
+        /// Lossless zlib compression of individual scanlines
+        ZIPS,
+
+        /// Lossless zlib compression of blocks of 16 scanlines
+        ZIP,
+
+        /// Lossless wavelet compression
+        PIZ,
+
+        /// Lossy DCT-based compression of blocks of 32 scanlines
+        DWAA,
+
+        /// Lossy DCT-based compression of blocks of 256 scanlines
+        DWAB
+    };
+
+    /// Options for writing OpenEXR files (see \ref write_exr())
+    struct ExrWriteOptions {
+        /// Compression method
+        ExrCompression compression = ExrCompression::Auto;
+
+        /**
+         * \brief Compression level
+         *
+         * Denotes the zlib level (1-9) of the ZIP compressors, and the
+         * quantization level of the DWA compressors (higher values correspond
+         * to a lower quality). Negative values select the library default.
+         */
+        float compression_level = -1.f;
+
+        /// Write a tiled file instead of a scanline-based file
+        bool tiled = false;
+
+        /// Width and height of the tiles of tiled files
+        uint32_t tile_size = 64;
+
+        /**
+         * \brief Storage format of individual channels in the file
+         *
+         * Maps channel names to \ref Struct::Type::Float16 or \ref
+         * Struct::Type::Float32. Other channels are stored using the component
+         * format of the bitmap. OpenEXR converts the values while writing.
+         */
+        std::map<std::string, Struct::Type> channel_formats;
+    };
 
     /// Type of alpha transformation
     enum class AlphaTransform : uint32_t {
@@ -388,6 +444,21 @@ public:
     void write_async(const fs::path &path, FileFormat format = FileFormat::Auto,
                      int quality = -1) const;
 
+    /**
+     * \brief Write the bitmap to an OpenEXR file using the specified options
+     *
+     * Compression of the chunks of the file is distributed over the thread pool.
+     */
+    void write_exr(const fs::path &path, const ExrWriteOptions &options) const;
+
+    /**
+     * \brief Equivalent to \ref write_exr(), but executes asynchronously on a
+     * different thread
+     *
+     * Use \ref Thread::wait_for_tasks() to wait for pending writes.
+     */
+    void write_exr_async(const fs::path &path, const ExrWriteOptions &options) const;
+
     /**
      * \brief Up- or down-sample this image to a different resolution
      *
@@ -584,6 +655,29 @@ public:
     /// Return a human-readable summary of this bitmap
     virtual std::string to_string() const override;
 
+    /**
+     * \brief Start loading the given image file in the background
+     *
+     * The file is decoded by the thread pool. A subsequent call to \ref
+     * load_prefetched() with the same filename returns the image, which lets
+     * the scene loader overlap the decoding of texture files with parsing and
+     * the instantiation of other objects. Files that are already being
+     * prefetched are ignored.
+     */
+    static void prefetch(const fs::path &path);
+
+    /**
+     * \brief Return an image that was requested using \ref prefetch()
+     *
+     * Waits for the image if it is still being decoded. Each prefetched image
+     * is returned only once; further calls (and calls for files that weren't
+     * prefetched) load the file immediately.
+     */
+    static ref<Bitmap> load_prefetched(const fs::path &path);
+
+    /// Discard prefetched images that weren't requested
+    static void clear_prefetched();
+
     /// Static initialization of bitmap-related data structures (thread pools, etc.)
     static void static_initialization();
 
@@ -605,7 +699,7 @@ public:
      void read_exr(Stream *stream);
 
      /// Write a file using the OpenEXR file format
-     void write_exr(Stream *stream, int compression = -1) const;
+     void write_exr(Stream *stream, const ExrWriteOptions &options) const;
 
      /// Read a file encoded using the JPEG file format
      void read_jpeg(Stream *stream);
@@ -726,6 +820,7 @@ void accumulate_2d(ConstT source,
 
 extern MI_EXPORT_LIB std::ostream &operator<<(std::ostream &os, Bitmap::PixelFormat value);
 extern MI_EXPORT_LIB std::ostream &operator<<(std::ostream &os, Bitmap::FileFormat value);
+extern MI_EXPORT_LIB std::ostream &operator<<(std::ostream &os, Bitmap::ExrCompression value);
 extern MI_EXPORT_LIB std::ostream &operator<<(std::ostream &os, Bitmap::AlphaTransform value);
 
 NAMESPACE_END(mitsuba)
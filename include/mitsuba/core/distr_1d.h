@@ -288,6 +288,7 @@ template <typename Value> struct ContinuousDistribution {
                                      dr::value_t<Value>, Value>;
     using FloatStorage = DynamicBuffer<Float>;
     using UInt32 = dr::uint32_array_t<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
     using Index = dr::uint32_array_t<Value>;
     using Mask = dr::mask_t<Value>;
     using Vector2u = dr::Array<UInt32, 2>;
@@ -328,6 +329,9 @@ public:
             compute_cdf();
         else
             compute_cdf_scalar(m_pdf.data(), m_pdf.size());
+
+        if (has_alias_table())
+            build_alias_table();
     }
 
     /// Return the range of the distribution
@@ -498,6 +502,120 @@ public:
                  dr::fmadd(t, y1 - y0, y0) * m_normalization };
     }
 
+    /**
+     * \brief Precompute an alias table over the intervals of the distribution
+     *
+     * The table enables \ref sample_alias() and \ref sample_pdf_alias(),
+     * which select an interval in constant time instead of performing a
+     * binary search over the CDF. Once built, the table is kept up to date by
+     * subsequent calls to \ref update().
+     */
+    void build_alias_table() {
+        auto &&pdf_host = dr::migrate(m_pdf, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        const ScalarFloat *pdf = pdf_host.data();
+
+        uint32_t size = (uint32_t) m_pdf.size() - 1;
+        std::vector<double> mass(size);
+        double sum = 0.;
+        for (uint32_t i = 0; i < size; ++i) {
+            mass[i] = (double) pdf[i] + (double) pdf[i + 1];
+            sum += mass[i];
+        }
+
+        // Vose's method: pair underfull buckets with overfull intervals
+        std::vector<ScalarFloat> prob(size, 1.f);
+        std::vector<uint32_t> alias(size), small, large;
+        for (uint32_t i = 0; i < size; ++i) {
+            mass[i] *= size / sum;
+            alias[i] = i;
+            (mass[i] < 1. ? small : large).push_back(i);
+        }
+
+        while (!small.empty() && !large.empty()) {
+            uint32_t s = small.back(), l = large.back();
+            small.pop_back();
+            prob[s] = (ScalarFloat) mass[s];
+            alias[s] = l;
+            mass[l] -= 1. - mass[s];
+            if (mass[l] < 1.) {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+
+        m_alias_prob = dr::load<FloatStorage>(prob.data(), size);
+        m_alias_index = dr::load<UInt32Storage>(alias.data(), size);
+    }
+
+    /// Was an alias table built using \ref build_alias_table()?
+    bool has_alias_table() const { return !m_alias_index.empty(); }
+
+    /**
+     * \brief %Transform a uniformly distributed sample to the stored
+     * distribution using the alias table
+     *
+     * This function produces the same distribution as \ref sample() in
+     * constant time, but the mapping from samples to positions is not
+     * monotonic. It requires a prior call to \ref build_alias_table().
+     *
+     * \param sample
+     *     A uniformly distributed sample on the interval [0, 1].
+     *
+     * \return
+     *     The sampled position.
+     */
+    Value sample_alias(Value sample, Mask active = true) const {
+        return sample_pdf_alias(sample, active).first;
+    }
+
+    /**
+     * \brief %Transform a uniformly distributed sample to the stored
+     * distribution using the alias table
+     *
+     * See \ref sample_alias() for details.
+     *
+     * \param sample
+     *     A uniformly distributed sample on the interval [0, 1].
+     *
+     * \return
+     *     A tuple consisting of
+     *
+     *     1. the sampled position.
+     *     2. the normalized probability density of the sample.
+     */
+    std::pair<Value, Value> sample_pdf_alias(Value sample, Mask active = true) const {
+        MI_MASK_ARGUMENT(active);
+
+        uint32_t size = (uint32_t) m_alias_index.size();
+        sample *= (ScalarFloat) size;
+
+        Index index = dr::minimum(Index(sample), size - 1u);
+        sample = dr::minimum(sample - Value(index), dr::OneMinusEpsilon<Value>);
+
+        Value prob  = dr::gather<Value>(m_alias_prob, index, active);
+        Index alias = dr::gather<Index>(m_alias_index, index, active);
+
+        // Reuse the remainder of the sample within the chosen interval
+        Mask keep = sample < prob;
+        sample = dr::select(keep, sample * dr::rcp(prob),
+                            (sample - prob) * dr::rcp(1.f - prob));
+        dr::masked(index, !keep) = alias;
+
+        Value y0 = dr::gather<Value>(m_pdf, index,      active),
+              y1 = dr::gather<Value>(m_pdf, index + 1u, active);
+
+        sample *= .5f * (y0 + y1);
+
+        Value t_linear = (y0 - dr::safe_sqrt(dr::fmadd(y0, y0, 2.f * sample * (y1 - y0)))) * dr::rcp(y0 - y1),
+              t_const  = sample * dr::rcp(y0),
+              t        = dr::select(dr::eq(y0, y1), t_const, t_linear);
+
+        return { dr::fmadd(Value(index) + t, m_interval_size, m_range.x()),
+                 dr::fmadd(t, y1 - y0, y0) * m_normalization };
+    }
+
     /// Return the minimum resolution of the discretization
     ScalarFloat interval_resolution() const {
         return m_interval_size_scalar;
@@ -601,6 +719,8 @@ private:
     ScalarVector2f m_range { 0.f, 0.f };
     Vector2u m_valid;
     ScalarFloat m_max = 0.f;
+    FloatStorage m_alias_prob;
+    UInt32Storage m_alias_index;
 };
 
 /**
@@ -83,9 +83,19 @@ public:
     /// Copy constructor
     Properties(const Properties &props);
 
+    /**
+     * \brief Move constructor
+     *
+     * The moved-from instance may only be destroyed or assigned to afterwards.
+     */
+    Properties(Properties &&props) noexcept;
+
     /// Assignment operator
     void operator=(const Properties &props);
 
+    /// Move assignment operator
+    void operator=(Properties &&props) noexcept;
+
     /// Release all memory
     ~Properties();
 
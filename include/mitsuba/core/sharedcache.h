@@ -0,0 +1,70 @@
+#pragma once
+
+#include <mitsuba/core/platform.h>
+#include <mitsuba/core/fwd.h>
+#include <functional>
+#include <memory>
+#include <string>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Process-wide cache of immutable data shared by several objects
+ *
+ * Plugins use this cache to avoid loading and storing the same data
+ * multiple times, e.g. when many \c bitmap textures reference the same image
+ * file. Entries are identified by a string key that must encode everything
+ * affecting the cached data (e.g. the resolved filename and conversion
+ * parameters). The cache only holds weak references, hence an entry is
+ * released once the last object using it is destroyed.
+ *
+ * Concurrent requests for the same key are serialized, so that the data is
+ * created only once even when a scene is loaded in parallel.
+ */
+class MI_EXPORT_LIB SharedCache {
+public:
+    /// Statistics of the shared cache
+    struct Stats {
+        /// Number of requests
+        size_t requests = 0;
+        /// Number of requests that were served by an existing entry
+        size_t hits = 0;
+        /// Number of bytes that didn't need to be created due to hits
+        size_t bytes_saved = 0;
+    };
+
+    /**
+     * \brief Look up the entry associated with \c key, calling \c create
+     * to initialize it if necessary
+     *
+     * The type \c T must provide a <tt>size_t bytes() const</tt> method
+     * returning its memory usage, which is used for the statistics.
+     * Exceptions raised by \c create are propagated to the caller, and the
+     * entry remains uninitialized.
+     */
+    template <typename T, typename Func>
+    static std::shared_ptr<T> get(const std::string &key, const Func &create) {
+        return std::static_pointer_cast<T>(get_impl(
+            key, [&create](size_t &bytes) -> std::shared_ptr<void> {
+                std::shared_ptr<T> value = create();
+                bytes = value->bytes();
+                return value;
+            }));
+    }
+
+    /// Return statistics of the shared cache
+    static Stats stats();
+
+    /// Reset the statistics of the shared cache
+    static void reset_stats();
+
+    /// Return the number of entries that are currently alive
+    static size_t entry_count();
+
+protected:
+    static std::shared_ptr<void>
+    get_impl(const std::string &key,
+             const std::function<std::shared_ptr<void>(size_t &)> &create);
+};
+
+NAMESPACE_END(mitsuba)
@@ -362,6 +362,11 @@ MI_DECLARE_ENUM_OPERATORS(Struct::Flags)
  * function is cached and reused in case the same conversion is needed later
  * on. Note that JIT compilation only works on x86_64 processors; other
  * platforms use a slow generic fallback implementation.
+ *
+ * When Mitsuba is compiled for processors supporting AVX2 (or AVX-512), the
+ * generated code converts packets of 8 (or 16) records at once if all fields
+ * of the source and target share a common type (e.g. RGBA8 and RGBA32F
+ * pixels), and only falls back to scalar code for the end of each row.
  */
 class MI_EXPORT_LIB StructConverter : public Object {
     using FuncType = bool (*) (size_t, size_t, const void *, void *);
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/vector.h>
+#include <memory>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Read-only MIP-mapped image that is stored on disk as a set of
+ * square tiles and paged into memory on demand
+ *
+ * This class enables rendering with textures that are much larger than the
+ * available memory. Tiles are loaded when they are first accessed and held
+ * in a cache that is shared by all tiled images of the process. The cache is
+ * bounded by a global byte budget (see \ref set_cache_budget()); when it is
+ * exceeded, the least recently used tiles are evicted. Each thread
+ * additionally remembers the tiles it accessed most recently, which serves
+ * the common case of consecutive lookups into the same tile without
+ * acquiring a lock.
+ *
+ * Images use a Mitsuba-specific file format, which is generated from any
+ * image supported by the \ref Bitmap class (including OpenEXR files) using
+ * \ref convert(). The file stores a header followed by the tiles of all
+ * levels of the MIP pyramid in 32-bit floating point format.
+ */
+class MI_EXPORT_LIB TiledImage : public Object {
+public:
+    using ScalarVector2u = Vector<uint32_t, 2>;
+
+    /// Statistics of the shared tile cache
+    struct CacheStats {
+        /// Lookups served by the per-thread hint table
+        size_t hint_hits = 0;
+        /// Lookups served by the shared cache
+        size_t hits = 0;
+        /// Lookups that required loading the tile from disk
+        size_t misses = 0;
+        /// Number of tiles evicted to stay within the budget
+        size_t evictions = 0;
+        /// Number of bytes read from disk
+        size_t bytes_read = 0;
+        /// Total time spent reading tiles (in seconds, summed over threads)
+        double read_time = 0.0;
+        /// Number of bytes currently held by the cache
+        size_t resident_bytes = 0;
+        /// Peak number of bytes held by the cache
+        size_t peak_bytes = 0;
+
+        /// Fraction of lookups that did not require disk I/O
+        double hit_rate() const {
+            size_t total = hint_hits + hits + misses;
+            return total == 0 ? 1.0 : double(hint_hits + hits) / double(total);
+        }
+    };
+
+    /// Open the tiled image stored in the given file
+    TiledImage(const fs::path &filename);
+
+    /// Return the number of levels of the MIP pyramid (level 0 is the full resolution image)
+    uint32_t level_count() const { return (uint32_t) m_levels.size(); }
+
+    /// Return the resolution of the given level
+    ScalarVector2u size(uint32_t level = 0) const { return m_levels[level].size; }
+
+    /// Return the number of channels (1 or 3)
+    uint32_t channel_count() const { return m_channel_count; }
+
+    /// Return the side length of the tiles in pixels
+    uint32_t tile_size() const { return m_tile_size; }
+
+    /// Was the image stored without color transformations (see \ref convert())?
+    bool raw() const { return m_raw; }
+
+    /// Return the associated filename
+    const fs::path &filename() const { return m_filename; }
+
+    /**
+     * \brief Copy the channels of a pixel to \c out
+     *
+     * The pixel coordinates must lie within the resolution of the level.
+     * This function is thread-safe.
+     */
+    void read(uint32_t level, const ScalarVector2u &pos, float *out) const;
+
+    /// Return a human-readable summary
+    std::string to_string() const override;
+
+    /**
+     * \brief Convert an image into the tiled format
+     *
+     * \param input
+     *     Any image file supported by the \ref Bitmap class
+     *
+     * \param output
+     *     Filename of the tiled image
+     *
+     * \param tile_size
+     *     Side length of the tiles in pixels
+     *
+     * \param raw
+     *     When set to \c false, the image is converted into linear RGB (or
+     *     luminance) values, undoing the sRGB gamma curve of the input.
+     */
+    static void convert(const fs::path &input, const fs::path &output,
+                        uint32_t tile_size = 64, bool raw = false);
+
+    /// Set the byte budget of the shared tile cache (0: unlimited)
+    static void set_cache_budget(size_t bytes);
+
+    /// Return the byte budget of the shared tile cache
+    static size_t cache_budget();
+
+    /// Return statistics of the shared tile cache
+    static CacheStats cache_stats();
+
+    /// Reset the statistics of the shared tile cache
+    static void reset_cache_stats();
+
+    /// Evict all tiles from the shared cache
+    static void clear_cache();
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~TiledImage();
+
+    struct Level {
+        ScalarVector2u size;
+        ScalarVector2u tile_count;
+        /// Index of the first tile of this level in the offset table
+        size_t tile_offset;
+    };
+
+    struct TiledImagePrivate;
+    /// Load a tile from disk (called by the cache on misses)
+    void load_tile(uint32_t level, uint32_t tx, uint32_t ty, float *out) const;
+
+protected:
+    fs::path m_filename;
+    uint32_t m_id;
+    uint32_t m_channel_count;
+    uint32_t m_tile_size;
+    bool m_raw;
+    std::vector<Level> m_levels;
+    std::vector<uint64_t> m_tile_offsets;
+    std::unique_ptr<TiledImagePrivate> d;
+};
+
+NAMESPACE_END(mitsuba)
@@ -41,6 +41,9 @@ extern MI_EXPORT_LIB fs::path library_path();
 /// Determine the width of the terminal window that is used to run Mitsuba
 extern MI_EXPORT_LIB int terminal_width();
 
+/// Return the resident memory usage of the current process in bytes (0 if unknown)
+extern MI_EXPORT_LIB size_t resident_memory();
+
 /// Return human-readable information about the Mitsuba build
 extern MI_EXPORT_LIB std::string info_build(int thread_count);
 
@@ -33,6 +33,49 @@ struct ScopedSetJITScope {
 /// Used to pass key=value pairs to the parser
 using ParameterList = std::vector<std::tuple<std::string, std::string, bool>>;
 
+/**
+ * \brief Resolved object graph of a scene that was loaded from XML
+ *
+ * The XML loader attaches this record to the scene it instantiates, which
+ * makes it possible to write the scene to a binary snapshot without going
+ * through the XML parser again (see <tt>Scene::save_snapshot()</tt>).
+ *
+ * Nodes are stored in dependency order, i.e. every node only references
+ * nodes that precede it. The last node is the scene itself. References
+ * between nodes are expressed using named references to the node IDs.
+ */
+class MI_EXPORT_LIB ObjectGraph : public Object {
+public:
+    struct Node {
+        /// Unique identifier of the node
+        std::string id;
+        /// Name of the class of the instantiated object (e.g. "Shape")
+        std::string class_name;
+        /// Fully resolved properties used to instantiate the object
+        Properties props;
+        /// The instantiated object (not set for the last node)
+        ref<Object> object;
+    };
+
+    ObjectGraph(const std::string &variant) : m_variant(variant) { }
+
+    /// Return the variant that was used to instantiate the graph
+    const std::string &variant() const { return m_variant; }
+
+    /// Return the nodes of the graph (in dependency order)
+    std::vector<Node> &nodes() { return m_nodes; }
+    /// Return the nodes of the graph (in dependency order)
+    const std::vector<Node> &nodes() const { return m_nodes; }
+
+    MI_DECLARE_CLASS()
+protected:
+    virtual ~ObjectGraph() = default;
+
+protected:
+    std::string m_variant;
+    std::vector<Node> m_nodes;
+};
+
 /**
  * Load a Mitsuba scene from an XML file
  *
@@ -67,6 +110,38 @@ extern MI_EXPORT_LIB std::vector<ref<Object>> load_string(
                                         ParameterList parameters = ParameterList(),
                                         bool parallel = true);
 
+/**
+ * \brief Record a timeline of the object instantiations performed by
+ * subsequent calls to \ref load_file() and \ref load_string()
+ *
+ * For every object, the start and end time, thread, plugin type, source file,
+ * and change in resident memory during its construction are recorded. When
+ * loading finishes, the timeline is written to \c filename in the Chrome trace
+ * event format (viewable in <tt>chrome://tracing</tt> or Perfetto), and a
+ * summary of the most expensive plugin types and objects is logged along with
+ * the critical path through the dependency graph of the scene.
+ *
+ * Memory is measured for the whole process, hence the per-object values are
+ * only exact when loading with <tt>parallel=false</tt>.
+ *
+ * \param filename
+ *     Output filename of the trace. An empty string disables profiling.
+ */
+extern MI_EXPORT_LIB void set_load_profile(const std::string &filename);
+
+/**
+ * \brief Retain the object graph of scenes loaded by subsequent calls to
+ * \ref load_file(), \ref load_string() and <tt>Scene::load_snapshot()</tt>
+ *
+ * The graph holds the resolved properties of every object. It is required to
+ * write a scene to a binary snapshot (see <tt>Scene::save_snapshot()</tt>),
+ * but otherwise only occupies memory, hence it is disabled by default.
+ */
+extern MI_EXPORT_LIB void set_keep_object_graph(bool value);
+
+/// Are object graphs retained by the loader? (see \ref set_keep_object_graph())
+extern MI_EXPORT_LIB bool keep_object_graph();
+
 
 
 NAMESPACE_BEGIN(detail)
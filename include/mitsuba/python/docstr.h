@@ -928,7 +928,12 @@ Parameter ``sample2``:
     A uniformly distributed sample on :math:`[0,1]^2`. It is used to
     generate the sampled direction.)doc";
 
-static const char *__doc_mitsuba_BSDF_flags = R"doc(Flags for all components combined.)doc";
+static const char *__doc_mitsuba_BSDF_flags =
+R"doc(Flags for all components combined.
+
+Includes BSDFFlags::NeedsDifferentials when one of the textures or
+nested BSDFs passed to the BSDF filters its lookups using texture-space
+differentials.)doc";
 
 static const char *__doc_mitsuba_BSDF_flags_2 = R"doc(Flags for a specific component of this BSDF.)doc";
 
@@ -946,6 +951,9 @@ static const char *__doc_mitsuba_BSDF_m_flags = R"doc(Combined flags for all com
 
 static const char *__doc_mitsuba_BSDF_m_id = R"doc(Identifier (if available))doc";
 
+static const char *__doc_mitsuba_BSDF_m_texture_differentials = R"doc(Does one of the textures or nested BSDFs of this BSDF need texture-
+space differentials?)doc";
+
 static const char *__doc_mitsuba_BSDF_needs_differentials = R"doc(Does the implementation require access to texture-space differentials?)doc";
 
 static const char *__doc_mitsuba_BSDF_operator_delete = R"doc()doc";
@@ -1100,6 +1108,46 @@ static const char *__doc_mitsuba_Bitmap_Bitmap_4 = R"doc(Copy constructor (copie
 
 static const char *__doc_mitsuba_Bitmap_Bitmap_5 = R"doc(Move constructor)doc";
 
+static const char *__doc_mitsuba_Bitmap_ExrCompression = R"doc(Compression methods supported when writing OpenEXR files)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrCompression_Auto = R"doc(Lossless PIZ compression, or DWAB if a ``quality`` level is given (default))doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrCompression_DWAA = R"doc(Lossy DCT-based compression of blocks of 32 scanlines)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrCompression_DWAB = R"doc(Lossy DCT-based compression of blocks of 256 scanlines)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrCompression_PIZ = R"doc(Lossless wavelet compression)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrCompression_RLE = R"doc(Lossless run-length encoding)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrCompression_Uncompressed = R"doc(No compression)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrCompression_ZIP = R"doc(Lossless zlib compression of blocks of 16 scanlines)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrCompression_ZIPS = R"doc(Lossless zlib compression of individual scanlines)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrWriteOptions = R"doc(Options for writing OpenEXR files (see write_exr()))doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrWriteOptions_channel_formats =
+R"doc(Storage format of individual channels in the file
+
+Maps channel names to Struct::Type::Float16 or Struct::Type::Float32.
+Other channels are stored using the component format of the bitmap.
+OpenEXR converts the values while writing.)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrWriteOptions_compression = R"doc(Compression method)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrWriteOptions_compression_level =
+R"doc(Compression level
+
+Denotes the zlib level (1-9) of the ZIP compressors, and the
+quantization level of the DWA compressors (higher values correspond to
+a lower quality). Negative values select the library default.)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrWriteOptions_tile_size = R"doc(Width and height of the tiles of tiled files)doc";
+
+static const char *__doc_mitsuba_Bitmap_ExrWriteOptions_tiled = R"doc(Write a tiled file instead of a scanline-based file)doc";
+
 static const char *__doc_mitsuba_Bitmap_FileFormat = R"doc(Supported image file formats)doc";
 
 static const char *__doc_mitsuba_Bitmap_FileFormat_Auto =
@@ -1255,6 +1303,8 @@ static const char *__doc_mitsuba_Bitmap_channel_count = R"doc(Return the number
 
 static const char *__doc_mitsuba_Bitmap_class = R"doc()doc";
 
+static const char *__doc_mitsuba_Bitmap_clear_prefetched = R"doc(Discard prefetched images that weren't requested)doc";
+
 static const char *__doc_mitsuba_Bitmap_clear = R"doc(Clear the bitmap to zero)doc";
 
 static const char *__doc_mitsuba_Bitmap_component_format = R"doc(Return the component format of this bitmap)doc";
@@ -1314,6 +1364,13 @@ static const char *__doc_mitsuba_Bitmap_has_alpha = R"doc(Return whether this im
 
 static const char *__doc_mitsuba_Bitmap_height = R"doc(Return the bitmap's height in pixels)doc";
 
+static const char *__doc_mitsuba_Bitmap_load_prefetched =
+R"doc(Return an image that was requested using prefetch()
+
+Waits for the image if it is still being decoded. Each prefetched image
+is returned only once; further calls (and calls for files that weren't
+prefetched) load the file immediately.)doc";
+
 static const char *__doc_mitsuba_Bitmap_m_component_format = R"doc()doc";
 
 static const char *__doc_mitsuba_Bitmap_m_data = R"doc()doc";
@@ -1346,6 +1403,15 @@ static const char *__doc_mitsuba_Bitmap_pixel_count = R"doc(Return the total num
 
 static const char *__doc_mitsuba_Bitmap_pixel_format = R"doc(Return the pixel format of this bitmap)doc";
 
+static const char *__doc_mitsuba_Bitmap_prefetch =
+R"doc(Start decoding the image file at ``path`` in the background
+
+The file is decoded asynchronously by the thread pool. A subsequent call
+to load_prefetched() with the same filename returns the image, which lets
+the scene loader overlap the decoding of texture files with parsing and
+the instantiation of other objects. Files that are already being
+prefetched are ignored.)doc";
+
 static const char *__doc_mitsuba_Bitmap_premultiplied_alpha = R"doc(Return whether the bitmap uses premultiplied alpha)doc";
 
 static const char *__doc_mitsuba_Bitmap_read = R"doc(Read a file from a stream)doc";
@@ -1525,7 +1591,19 @@ static const char *__doc_mitsuba_Bitmap_write_async =
 R"doc(Equivalent to write(), but executes asynchronously on a different
 thread)doc";
 
-static const char *__doc_mitsuba_Bitmap_write_exr = R"doc(Write a file using the OpenEXR file format)doc";
+static const char *__doc_mitsuba_Bitmap_write_exr =
+R"doc(Write the bitmap to an OpenEXR file using the specified options
+
+Compression of the chunks of the file is distributed over the thread
+pool.)doc";
+
+static const char *__doc_mitsuba_Bitmap_write_exr_2 = R"doc(Write a file using the OpenEXR file format)doc";
+
+static const char *__doc_mitsuba_Bitmap_write_exr_async =
+R"doc(Equivalent to write_exr(), but executes asynchronously on a different
+thread
+
+Use Thread::wait_for_tasks() to wait for pending writes.)doc";
 
 static const char *__doc_mitsuba_Bitmap_write_jpeg = R"doc(Save a file using the JPEG file format)doc";
 
@@ -1875,6 +1953,14 @@ static const char *__doc_mitsuba_ContinuousDistribution_ContinuousDistribution_3
 
 static const char *__doc_mitsuba_ContinuousDistribution_ContinuousDistribution_4 = R"doc(Initialize from a given floating point array)doc";
 
+static const char *__doc_mitsuba_ContinuousDistribution_build_alias_table =
+R"doc(Precompute an alias table over the intervals of the distribution
+
+The table enables sample_alias() and sample_pdf_alias(), which select
+an interval in constant time instead of performing a binary search over
+the CDF. Once built, the table is kept up to date by subsequent calls
+to update().)doc";
+
 static const char *__doc_mitsuba_ContinuousDistribution_cdf =
 R"doc(Return the unnormalized discrete cumulative distribution function over
 intervals)doc";
@@ -1905,10 +1991,16 @@ static const char *__doc_mitsuba_ContinuousDistribution_eval_pdf_normalized =
 R"doc(Evaluate the normalized probability mass function (PDF) at position
 ``x``)doc";
 
+static const char *__doc_mitsuba_ContinuousDistribution_has_alias_table = R"doc(Was an alias table built using build_alias_table()?)doc";
+
 static const char *__doc_mitsuba_ContinuousDistribution_integral = R"doc(Return the original integral of PDF entries before normalization)doc";
 
 static const char *__doc_mitsuba_ContinuousDistribution_interval_resolution = R"doc(Return the minimum resolution of the discretization)doc";
 
+static const char *__doc_mitsuba_ContinuousDistribution_m_alias_index = R"doc()doc";
+
+static const char *__doc_mitsuba_ContinuousDistribution_m_alias_prob = R"doc()doc";
+
 static const char *__doc_mitsuba_ContinuousDistribution_m_cdf = R"doc()doc";
 
 static const char *__doc_mitsuba_ContinuousDistribution_m_integral = R"doc()doc";
@@ -1946,6 +2038,20 @@ static const char *__doc_mitsuba_ContinuousDistribution_range_2 = R"doc(Return t
 static const char *__doc_mitsuba_ContinuousDistribution_sample =
 R"doc(%Transform a uniformly distributed sample to the stored distribution
 
+Parameter ``sample``:
+    A uniformly distributed sample on the interval [0, 1].
+
+Returns:
+    The sampled position.)doc";
+
+static const char *__doc_mitsuba_ContinuousDistribution_sample_alias =
+R"doc(%Transform a uniformly distributed sample to the stored distribution
+using the alias table
+
+This function produces the same distribution as sample() in constant
+time, but the mapping from samples to positions is not monotonic. It
+requires a prior call to build_alias_table().
+
 Parameter ``sample``:
     A uniformly distributed sample on the interval [0, 1].
 
@@ -1964,6 +2070,21 @@ Returns:
 1. the sampled position. 2. the normalized probability density of the
 sample.)doc";
 
+static const char *__doc_mitsuba_ContinuousDistribution_sample_pdf_alias =
+R"doc(%Transform a uniformly distributed sample to the stored distribution
+using the alias table
+
+See sample_alias() for details.
+
+Parameter ``sample``:
+    A uniformly distributed sample on the interval [0, 1].
+
+Returns:
+    A tuple consisting of
+
+1. the sampled position. 2. the normalized probability density of the
+sample.)doc";
+
 static const char *__doc_mitsuba_ContinuousDistribution_size = R"doc(Return the number of discretizations)doc";
 
 static const char *__doc_mitsuba_ContinuousDistribution_update = R"doc(Update the internal state. Must be invoked when changing the pdf.)doc";
@@ -3069,6 +3190,15 @@ static const char *__doc_mitsuba_Film_traverse = R"doc()doc";
 
 static const char *__doc_mitsuba_Film_write = R"doc(Write the developed contents of the film to a file on disk)doc";
 
+static const char *__doc_mitsuba_Film_write_async =
+R"doc(Equivalent to write(), but may execute asynchronously on a different
+thread
+
+The film contents are developed before the function returns, hence it
+is safe to modify the film afterwards. Use Thread::wait_for_tasks() to
+wait for pending writes. The default implementation simply calls
+write().)doc";
+
 static const char *__doc_mitsuba_FilterBoundaryCondition =
 R"doc(When resampling data to a different resolution using
 Resampler::resample(), this enumeration specifies how lookups
@@ -4278,6 +4408,10 @@ static const char *__doc_mitsuba_MediumInteraction_apply_label = R"doc()doc";
 
 static const char *__doc_mitsuba_MediumInteraction_combined_extinction = R"doc()doc";
 
+static const char *__doc_mitsuba_MediumInteraction_footprint =
+R"doc(World-space radius of the ray footprint, selects the level of detail
+of volume lookups)doc";
+
 static const char *__doc_mitsuba_MediumInteraction_medium = R"doc(Pointer to the associated medium)doc";
 
 static const char *__doc_mitsuba_MediumInteraction_mint = R"doc(mint used when sampling the given distance ``t``)doc";
@@ -4316,26 +4450,88 @@ static const char *__doc_mitsuba_Medium_Medium_2 = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_class = R"doc()doc";
 
+static const char *__doc_mitsuba_Medium_emitter = R"doc(Return the emitter sampling the emission of this medium (if any))doc";
+
+static const char *__doc_mitsuba_Medium_emitter_2 = R"doc(Return the emitter sampling the emission of this medium (if any))doc";
+
+static const char *__doc_mitsuba_Medium_get_albedo =
+R"doc(Returns the single scattering albedo evaluated at a given
+MediumInteraction mi
+
+The default implementation divides the coefficients returned by
+get_scattering_coefficients(). Media should override it when the
+albedo can be evaluated without looking up the extinction.)doc";
+
+static const char *__doc_mitsuba_Medium_get_emission =
+R"doc(Returns the emitted radiance per unit length, i.e. the product of the
+absorption coefficient and the emitted radiance, evaluated at a given
+MediumInteraction mi
+
+The default implementation returns zero. Media that emit light should
+override it and provide an emitter (see emitter()) that samples
+positions proportionally to this quantity.)doc";
+
 static const char *__doc_mitsuba_Medium_get_majorant = R"doc(Returns the medium's majorant used for delta tracking)doc";
 
 static const char *__doc_mitsuba_Medium_get_scattering_coefficients =
 R"doc(Returns the medium coefficients Sigma_s, Sigma_n and Sigma_t evaluated
 at a given MediumInteraction mi)doc";
 
+static const char *__doc_mitsuba_Medium_eval_majorant_grid = R"doc(Look up the local majorant at the given world space position)doc";
+
+static const char *__doc_mitsuba_Medium_eval_transmittance =
+R"doc(Estimate the transmittance along a ray segment
+
+This function computes an unbiased estimate of the transmittance
+between the start of the ray (or the entry point into the medium) and
+``ray.maxt`` using residual ratio tracking: the extinction is split
+into a control extinction, whose transmittance is evaluated
+analytically, and a residual that is estimated by ratio tracking.
+
+The control extinction of each cell of the majorant grid is the
+midpoint between its local minorant and majorant. Without a majorant
+grid, it is half of the majorant of the medium. Homogeneous media
+return the exact transmittance.
+
+Parameter ``ray``:
+    Ray segment, along which the transmittance is estimated
+
+Parameter ``sample``:
+    A uniformly distributed random sample, which seeds the tentative
+    collisions along the segment)doc";
+
 static const char *__doc_mitsuba_Medium_has_spectral_extinction = R"doc(Returns whether this medium has a spectrally varying extinction)doc";
 
+static const char *__doc_mitsuba_Medium_has_majorant_grid = R"doc(Returns whether this medium samples distances using local majorants)doc";
+
 static const char *__doc_mitsuba_Medium_id = R"doc(Return a string identifier)doc";
 
 static const char *__doc_mitsuba_Medium_intersect_aabb = R"doc(Intersects a ray with the medium's bounding box)doc";
 
+static const char *__doc_mitsuba_Medium_is_emitter = R"doc(Is this medium also an emitter?)doc";
+
 static const char *__doc_mitsuba_Medium_is_homogeneous = R"doc(Returns whether this medium is homogeneous)doc";
 
+static const char *__doc_mitsuba_Medium_m_control_extinction = R"doc(Control extinction of decomposition tracking without local minorants)doc";
+
+static const char *__doc_mitsuba_Medium_m_decomposition = R"doc(Is decomposition tracking enabled?)doc";
+
+static const char *__doc_mitsuba_Medium_m_emitter = R"doc(Emitter sampling the emission of the medium (if any))doc";
+
 static const char *__doc_mitsuba_Medium_m_has_spectral_extinction = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_m_id = R"doc(Identifier (if available))doc";
 
 static const char *__doc_mitsuba_Medium_m_is_homogeneous = R"doc()doc";
 
+static const char *__doc_mitsuba_Medium_m_majorant_grid = R"doc(Local majorants (empty when a single majorant is used))doc";
+
+static const char *__doc_mitsuba_Medium_m_majorant_resolution = R"doc(Resolution of the majorant grid)doc";
+
+static const char *__doc_mitsuba_Medium_m_majorant_to_grid = R"doc(Transforms world space positions to majorant grid cell coordinates)doc";
+
+static const char *__doc_mitsuba_Medium_m_minorant_grid = R"doc(Local minorants (empty when they are all zero))doc";
+
 static const char *__doc_mitsuba_Medium_m_phase_function = R"doc()doc";
 
 static const char *__doc_mitsuba_Medium_m_sample_emitters = R"doc()doc";
@@ -4368,11 +4564,72 @@ Parameter ``channel``:
     The channel according to which we will sample the free-flight
     distance. This argument is only used when rendering in RGB modes.
 
+Parameter ``footprint``:
+    World-space radius of the ray footprint, which lets media evaluate
+    their volumes at a coarser level of detail (see
+    Volume::eval_lod()). Zero requests the finest level.
+
+When the medium provides a grid of local majorants (see
+set_majorant_grid()), the distance is sampled by stepping through its
+cells with a 3D DDA, and the ``combined_extinction`` field of the
+returned interaction holds the majorant of the cell containing the
+sampled position.
+
+With decomposition tracking (see set_control_extinction()), a
+tentative collision is attributed to the control extinction with
+probability ``control / majorant``. Such collisions only evaluate the
+albedo and are reported as real collisions. The coefficients of the
+remaining collisions describe the residual extinction, rescaled so that
+the integrator's usual null-collision test accepts them with
+probability ``(sigma_t - control) / (majorant - control)``.
+
 Returns:
     This method returns a MediumInteraction. The MediumInteraction
     will always be valid, except if the ray missed the Medium's
     bounding box.)doc";
 
+static const char *__doc_mitsuba_Medium_sample_interaction_2 = R"doc(Sample a free-flight distance at the finest level of detail)doc";
+
+static const char *__doc_mitsuba_Medium_sample_majorant_grid =
+R"doc(Sample a free-flight distance by stepping through the cells of the
+majorant grid between ``mint`` and ``maxt``
+
+Returns the sampled distance (infinite if the optical depth ``tau``
+isn't reached before ``maxt``) and the majorant at that position.
+
+When ``residual`` is set, distances are sampled according to the
+residual majorant ``(majorant - minorant) / 2`` of each cell. The
+minorant at the sampled position and the optical depth of the control
+extinction ``(majorant + minorant) / 2`` up to that position (or
+``maxt``) are returned as well. Both are zero otherwise, except for the
+minorant when decomposition tracking is enabled.)doc";
+
+static const char *__doc_mitsuba_Medium_set_control_extinction =
+R"doc(Enable decomposition tracking in sample_interaction()
+
+Parameter ``control``:
+    A lower bound of the extinction coefficient over the medium, which
+    must not depend on the wavelength. When the medium provides local
+    minorants (see set_majorant_grid()), these are used instead. Pass a
+    negative value to disable decomposition tracking.)doc";
+
+static const char *__doc_mitsuba_Medium_set_majorant_grid =
+R"doc(Use a grid of local majorants for free-flight sampling
+
+Parameter ``majorants``:
+    Tensor of shape ``(z, y, x, 1)`` holding an upper bound of the
+    extinction coefficient inside each cell, e.g. computed using
+    Volume::local_majorants(). An empty tensor disables the grid.
+
+Parameter ``to_world``:
+    Transformation from the unit cube covered by the grid to world
+    space
+
+Parameter ``minorants``:
+    Optional tensor of the same shape holding a lower bound of the
+    extinction coefficient inside each cell, which is used by
+    eval_transmittance(). Zero is assumed when it is empty.)doc";
+
 static const char *__doc_mitsuba_Medium_set_id = R"doc(Set a string identifier)doc";
 
 static const char *__doc_mitsuba_Medium_to_string = R"doc(Return a human-readable representation of the Medium)doc";
@@ -4571,6 +4828,8 @@ static const char *__doc_mitsuba_Mesh_add_attribute = R"doc(Add an attribute buf
 
 static const char *__doc_mitsuba_Mesh_attribute_buffer = R"doc(Return the mesh attribute associated with ``name``)doc";
 
+static const char *__doc_mitsuba_Mesh_attribute_names = R"doc(Return the names of all additional mesh attributes)doc";
+
 static const char *__doc_mitsuba_Mesh_barycentric_coordinates = R"doc()doc";
 
 static const char *__doc_mitsuba_Mesh_bbox = R"doc(//! @{ \name Shape interface implementation)doc";
@@ -5918,6 +6177,12 @@ static const char *__doc_mitsuba_Properties_Properties_2 = R"doc(Construct an em
 
 static const char *__doc_mitsuba_Properties_Properties_3 = R"doc(Copy constructor)doc";
 
+static const char *__doc_mitsuba_Properties_Properties_4 =
+R"doc(Move constructor
+
+The moved-from instance may only be destroyed or assigned to
+afterwards.)doc";
+
 static const char *__doc_mitsuba_Properties_PropertiesPrivate = R"doc()doc";
 
 static const char *__doc_mitsuba_Properties_Type = R"doc(Supported types of properties)doc";
@@ -6010,6 +6275,8 @@ Parameter ``mark_queried``:
 
 static const char *__doc_mitsuba_Properties_operator_assign = R"doc(Assignment operator)doc";
 
+static const char *__doc_mitsuba_Properties_operator_assign_2 = R"doc(Move assignment operator)doc";
+
 static const char *__doc_mitsuba_Properties_operator_eq = R"doc(Equality comparison operator)doc";
 
 static const char *__doc_mitsuba_Properties_operator_ne = R"doc(Inequality comparison operator)doc";
@@ -6794,6 +7061,12 @@ Parameter ``ss``:
 Returns:
     The corresponding boundary sample space point)doc";
 
+static const char *__doc_mitsuba_Scene_load_snapshot =
+R"doc(Load a scene from a binary snapshot created by save_snapshot()
+
+Mesh buffers are stored out-of-line at the end of the snapshot file,
+from where they are copied using a memory mapping.)doc";
+
 static const char *__doc_mitsuba_Scene_m_accel = R"doc(Acceleration data structure (IAS) (type depends on implementation))doc";
 
 static const char *__doc_mitsuba_Scene_m_accel_handle = R"doc(Handle to the IAS used to ensure its lifetime in jit variants)doc";
@@ -6814,6 +7087,8 @@ static const char *__doc_mitsuba_Scene_m_environment = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_integrator = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_m_object_graph = R"doc(Object graph provided by the XML loader (see save_snapshot()))doc";
+
 static const char *__doc_mitsuba_Scene_m_sensors = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_sensors_dr = R"doc()doc";
@@ -6832,6 +7107,15 @@ static const char *__doc_mitsuba_Scene_m_silhouette_shapes = R"doc()doc";
 
 static const char *__doc_mitsuba_Scene_m_silhouette_shapes_dr = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_pack_texture_atlases =
+R"doc(Pack small textures referenced by the scene into shared atlases
+
+This pass is enabled by setting the boolean ``texture_atlas`` property
+of the scene, and only has an effect in JIT variants. Textures whose
+width and height don't exceed ``max_size`` (given by the
+``texture_atlas_max_size`` property, 256 by default) are candidates.
+See Texture::pack_atlas() for details.)doc";
+
 static const char *__doc_mitsuba_Scene_parameters_changed = R"doc(Update internal state following a parameter update)doc";
 
 static const char *__doc_mitsuba_Scene_pdf_emitter =
@@ -7076,6 +7360,18 @@ static const char *__doc_mitsuba_Scene_ray_test_cpu = R"doc(Trace a shadow ray)d
 
 static const char *__doc_mitsuba_Scene_ray_test_gpu = R"doc()doc";
 
+static const char *__doc_mitsuba_Scene_save_snapshot =
+R"doc(Write a binary snapshot of the scene to the given file
+
+The snapshot stores the object graph of the scene (plugin names and
+fully resolved properties) along with the geometry of all triangle
+meshes. This allows load_snapshot() to reconstruct the scene without
+parsing XML or re-reading the original mesh files.
+
+Only scenes that were loaded from an XML file, string or snapshot while
+the object graph was retained (see ``xml::set_keep_object_graph()``)
+can be written to a snapshot.)doc";
+
 static const char *__doc_mitsuba_Scene_sample_emitter =
 R"doc(Sample one emitter in the scene and rescale the input sample for
 reuse.
@@ -8139,6 +8435,44 @@ The default implementation throws an exception.)doc";
 
 static const char *__doc_mitsuba_Shape_traverse = R"doc()doc";
 
+static const char *__doc_mitsuba_SharedCache =
+R"doc(Process-wide cache of immutable data shared by several objects
+
+Plugins use this cache to avoid loading and storing the same data
+multiple times, e.g. when many ``bitmap`` textures reference the same
+image file. Entries are identified by a string key that must encode
+everything affecting the cached data (e.g. the resolved filename and
+conversion parameters). The cache only holds weak references, hence an
+entry is released once the last object using it is destroyed.
+
+Concurrent requests for the same key are serialized, so that the data
+is created only once even when a scene is loaded in parallel.)doc";
+
+static const char *__doc_mitsuba_SharedCache_Stats = R"doc(Statistics of the shared cache)doc";
+
+static const char *__doc_mitsuba_SharedCache_Stats_bytes_saved = R"doc(Number of bytes that didn't need to be created due to hits)doc";
+
+static const char *__doc_mitsuba_SharedCache_Stats_hits = R"doc(Number of requests that were served by an existing entry)doc";
+
+static const char *__doc_mitsuba_SharedCache_Stats_requests = R"doc(Number of requests)doc";
+
+static const char *__doc_mitsuba_SharedCache_entry_count = R"doc(Return the number of entries that are currently alive)doc";
+
+static const char *__doc_mitsuba_SharedCache_get =
+R"doc(Look up the entry associated with ``key``, calling ``create`` to
+initialize it if necessary
+
+The type ``T`` must provide a <tt>size_t bytes() const</tt> method
+returning its memory usage, which is used for the statistics.
+Exceptions raised by ``create`` are propagated to the caller, and the
+entry remains uninitialized.)doc";
+
+static const char *__doc_mitsuba_SharedCache_get_impl = R"doc()doc";
+
+static const char *__doc_mitsuba_SharedCache_reset_stats = R"doc(Reset the statistics of the shared cache)doc";
+
+static const char *__doc_mitsuba_SharedCache_stats = R"doc(Return statistics of the shared cache)doc";
+
 static const char *__doc_mitsuba_SilhouetteSample =
 R"doc(Data structure holding the result of visibility silhouette sampling
 operations on geometry.)doc";
@@ -8222,6 +8556,126 @@ offsetting, during a ray intersection, the ray could potentially find
 an intersection point at its origin due to numerical instabilities in
 the intersection routines.)doc";
 
+static const char *__doc_mitsuba_SparseVolumeGrid =
+R"doc(Sparse 3D volume grid made of bricks of 8x8x8 voxels
+
+The grid is subdivided into tiles of 8x8x8 voxels. A top-level index
+grid stores the brick holding the voxels of each tile, and all tiles
+with the same constant value (e.g. empty space) reference a single
+shared brick. This drastically reduces the memory footprint of mostly
+empty volumes such as clouds or explosions.
+
+Sparse grids can be created from dense grids, either in memory or by
+streaming a ".vol" file one slab of tiles at a time, so that the dense
+grid never needs to fit into memory. Please see the documentation of
+the ``sparsegridvolume`` plugin for the file format specification.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_SparseVolumeGrid =
+R"doc(Load a sparse grid from a given filename
+
+Both sparse grid files and dense volume files in the Mitsuba ".vol"
+format are supported. The latter are converted while they are read.
+
+Parameter ``path``:
+    Name of the file to be loaded
+
+Parameter ``tolerance``:
+    Tiles of dense volumes whose values vary by at most this amount
+    (per channel) are stored as constant tiles)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_SparseVolumeGrid_2 =
+R"doc(Load a sparse grid from an arbitrary stream data source
+
+See the other constructor for details.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_SparseVolumeGrid_3 =
+R"doc(Convert a dense volume grid that resides in memory
+
+See the other constructors for details.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_add_slab =
+R"doc(Convert a slab of tiles of a dense grid
+
+``slab`` holds ``min(8, size.z - 8 * tile_z)`` consecutive slices of
+the dense grid starting at ``z = 8 * tile_z``.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_bbox = R"doc(Return the bounding box specified in the source file)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_bbox_transform =
+R"doc(Estimates the transformation from a unit axis-aligned bounding box to
+the given one.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_brick_count = R"doc(Return the number of distinct bricks)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_brick_max = R"doc(Return the maximum of a brick over all channels)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_buffer_size = R"doc(Return the size of the index and brick data in bytes)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_channel_count = R"doc(Return the number of channels)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_class = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_data =
+R"doc(Return the voxel data of all bricks
+
+Voxel ``(x, y, z)`` of brick ``b`` is stored at offset ``((b * 8 + z)
+* 8 + y) * 8 + x``, in units of channel_count() values.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_index = R"doc(Return the brick referenced by each tile (row-major, x varies fastest))doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_init = R"doc(Prepare the index and the brick storage for a grid of the given size)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_bbox = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_brick_max = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_channel_count = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_constant_bricks = R"doc(Bricks shared by constant tiles, indexed by their value (conversion only))doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_data = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_index = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_max = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_max_per_channel = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_size = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_m_tile_count = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_max = R"doc(Return the precomputed maximum over the volume grid)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_max_per_channel =
+R"doc(Return the precomputed maximum over the volume grid per channel
+
+Pointer allocation/deallocation must be performed by the caller.)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_read = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_read_sparse = R"doc()doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_size = R"doc(Return the resolution of the voxel grid)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_tile_count = R"doc(Return the resolution of the top-level index grid)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_to_string = R"doc(Return a human-readable summary of this sparse grid)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_update_max = R"doc(Compute the per-brick and global maxima)doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_write =
+R"doc(Write the sparse grid to a binary file
+
+Parameter ``path``:
+    Target file name (expected to end in ".svol"))doc";
+
+static const char *__doc_mitsuba_SparseVolumeGrid_write_2 =
+R"doc(Write the sparse grid to a stream
+
+Parameter ``stream``:
+    Target stream that will receive the encoded output)doc";
+
 static const char *__doc_mitsuba_Spectrum =
 R"doc(//! @{ \name Data types for spectral quantities with sampled
 wavelengths)doc";
@@ -9450,6 +9904,39 @@ Parameter ``si``:
 Returns:
     An scalar intensity or reflectance value)doc";
 
+static const char *__doc_mitsuba_Texture_eval_1_batch =
+R"doc(Monochromatic evaluation of several textures at the same surface
+interaction
+
+This function is equivalent to setting ``out[i] =
+textures[i]->eval_1(si, active)`` for each of the ``count`` textures,
+but it enables implementations to share work between textures that are
+evaluated together. For instance, bitmap textures with the same
+resolution and sampling parameters compute the wrapped texel positions
+and the filter weights only once and fuse their texel fetches. This is
+useful in BSDFs that query many parameter textures per shading point.
+
+Parameter ``textures``:
+    Textures to be evaluated (at most 64). Entries may be ``nullptr``,
+    in which case the corresponding element of ``out`` is left
+    unchanged.
+
+Parameter ``si``:
+    An interaction record describing the associated surface position
+
+Parameter ``out``:
+    Array of ``count`` elements receiving the texture values)doc";
+
+static const char *__doc_mitsuba_Texture_eval_1_batch_impl =
+R"doc(Evaluate the texture as part of eval_1_batch()
+
+The texture is stored at position ``index`` of ``textures``. The bits
+of ``pending`` identify textures of the batch that remain to be
+evaluated. Implementations may evaluate further pending textures along
+with this one, and must clear the bits of all textures they evaluated
+(including their own). The default implementation only evaluates this
+texture using eval_1().)doc";
+
 static const char *__doc_mitsuba_Texture_eval_1_grad =
 R"doc(Monochromatic evaluation of the texture gradient at the given surface
 interaction
@@ -9501,6 +9988,40 @@ default implementation throws an exception.
 Even if the operation is provided, it may only return an
 approximation.)doc";
 
+static const char *__doc_mitsuba_Texture_needs_differentials =
+R"doc(Does this texture filter its lookups using the UV partials
+(<tt>SurfaceInteraction3f::duv_dx</tt> and <tt>duv_dy</tt>)?
+
+BSDFs that reference such a texture request the computation of texture
+space differentials (see BSDFFlags::NeedsDifferentials). The default
+implementation reports whether one of the textures passed to this
+texture (e.g. the inputs of a blend) needs them.)doc";
+
+static const char *__doc_mitsuba_Texture_m_nested_differentials = R"doc(Does one of the nested textures need texture-space differentials?)doc";
+
+static const char *__doc_mitsuba_Texture_pack_atlas =
+R"doc(Pack the data of this texture and of compatible textures into a shared
+texture atlas
+
+This function is invoked by Scene when its ``texture_atlas`` property
+is set. Textures that perform their lookups in the same atlas generate
+identical code, which enables the JIT compiler to merge the virtual
+function calls of the objects referencing them.
+
+Parameter ``textures``:
+    Textures of the scene, where this texture is stored at position
+    ``index``. Implementations may pack any of the following textures
+    along with this one. Entries set to ``nullptr`` were already
+    processed and must be skipped.
+
+Parameter ``max_size``:
+    Maximum width and height of textures that are considered small
+    enough to be packed
+
+Returns:
+    The positions of all processed textures (including this one). The
+    default implementation only returns ``index``.)doc";
+
 static const char *__doc_mitsuba_Texture_pdf_position = R"doc(Returns the probability per unit area of sample_position())doc";
 
 static const char *__doc_mitsuba_Texture_pdf_spectrum =
@@ -9724,6 +10245,94 @@ static const char *__doc_mitsuba_Thread_wait_for_tasks = R"doc(Wait for previous
 
 static const char *__doc_mitsuba_Thread_yield = R"doc(Yield to another processor)doc";
 
+static const char *__doc_mitsuba_TiledImage =
+R"doc(Read-only MIP-mapped image that is stored on disk as a set of square
+tiles and paged into memory on demand
+
+This class enables rendering with textures that are much larger than
+the available memory. Tiles are loaded when they are first accessed
+and held in a cache that is shared by all tiled images of the process.
+The cache is bounded by a global byte budget (see set_cache_budget());
+when it is exceeded, the least recently used tiles are evicted. Each
+thread additionally remembers the tiles it accessed most recently,
+which serves the common case of consecutive lookups into the same tile
+without acquiring a lock.
+
+Images use a Mitsuba-specific file format, which is generated from any
+image supported by the Bitmap class (including OpenEXR files) using
+convert(). The file stores a header followed by the tiles of all
+levels of the MIP pyramid in 32-bit floating point format.)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats = R"doc(Statistics of the shared tile cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_bytes_read = R"doc(Number of bytes read from disk)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_evictions = R"doc(Number of tiles evicted to stay within the budget)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_hint_hits = R"doc(Lookups served by the per-thread hint table)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_hit_rate = R"doc(Fraction of lookups that did not require disk I/O)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_hits = R"doc(Lookups served by the shared cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_misses = R"doc(Lookups that required loading the tile from disk)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_peak_bytes = R"doc(Peak number of bytes held by the cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_read_time = R"doc(Total time spent reading tiles (in seconds, summed over threads))doc";
+
+static const char *__doc_mitsuba_TiledImage_CacheStats_resident_bytes = R"doc(Number of bytes currently held by the cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_TiledImage = R"doc(Open the tiled image stored in the given file)doc";
+
+static const char *__doc_mitsuba_TiledImage_cache_budget = R"doc(Return the byte budget of the shared tile cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_cache_stats = R"doc(Return statistics of the shared tile cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_channel_count = R"doc(Return the number of channels (1 or 3))doc";
+
+static const char *__doc_mitsuba_TiledImage_clear_cache = R"doc(Evict all tiles from the shared cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_convert =
+R"doc(Convert an image into the tiled format
+
+Parameter ``input``:
+    Any image file supported by the Bitmap class
+
+Parameter ``output``:
+    Filename of the tiled image
+
+Parameter ``tile_size``:
+    Side length of the tiles in pixels
+
+Parameter ``raw``:
+    When set to ``False``, the image is converted into linear RGB (or
+    luminance) values, undoing the sRGB gamma curve of the input.)doc";
+
+static const char *__doc_mitsuba_TiledImage_filename = R"doc(Return the associated filename)doc";
+
+static const char *__doc_mitsuba_TiledImage_level_count =
+R"doc(Return the number of levels of the MIP pyramid (level 0 is the full
+resolution image))doc";
+
+static const char *__doc_mitsuba_TiledImage_raw = R"doc(Was the image stored without color transformations (see convert())?)doc";
+
+static const char *__doc_mitsuba_TiledImage_read =
+R"doc(Copy the channels of a pixel to ``out``
+
+The pixel coordinates must lie within the resolution of the level.
+This function is thread-safe.)doc";
+
+static const char *__doc_mitsuba_TiledImage_reset_cache_stats = R"doc(Reset the statistics of the shared tile cache)doc";
+
+static const char *__doc_mitsuba_TiledImage_set_cache_budget = R"doc(Set the byte budget of the shared tile cache (0: unlimited))doc";
+
+static const char *__doc_mitsuba_TiledImage_size = R"doc(Return the resolution of the given level)doc";
+
+static const char *__doc_mitsuba_TiledImage_tile_size = R"doc(Return the side length of the tiles in pixels)doc";
+
+static const char *__doc_mitsuba_TiledImage_to_string = R"doc(Return a human-readable summary)doc";
+
 static const char *__doc_mitsuba_Timer = R"doc()doc";
 
 static const char *__doc_mitsuba_Timer_Timer = R"doc()doc";
@@ -9943,7 +10552,18 @@ static const char *__doc_mitsuba_Volume_4 = R"doc()doc";
 
 static const char *__doc_mitsuba_Volume_5 = R"doc()doc";
 
-static const char *__doc_mitsuba_VolumeGrid = R"doc()doc";
+static const char *__doc_mitsuba_VolumeGrid =
+R"doc(Class to read and write 3D volume grids
+
+This class handles loading of volumes in the Mitsuba volume file
+format Please see the documentation of gridvolume (grid3d.cpp) for the
+file format specification.
+
+The voxels of version 4 files are stored at an aligned offset, and the
+file header holds the maximum of the grid. When such a file is loaded
+from the filesystem in single precision, it is memory-mapped rather
+than read into memory, and pages are only loaded once the voxels are
+accessed.)doc";
 
 static const char *__doc_mitsuba_VolumeGrid_2 = R"doc()doc";
 
@@ -9956,6 +10576,9 @@ static const char *__doc_mitsuba_VolumeGrid_5 = R"doc()doc";
 static const char *__doc_mitsuba_VolumeGrid_VolumeGrid =
 R"doc(Load a VolumeGrid from a given filename
 
+Version 4 files are memory-mapped when possible (see
+is_memory_mapped()).
+
 Parameter ``path``:
     Name of the file to be loaded)doc";
 
@@ -9979,20 +10602,34 @@ static const char *__doc_mitsuba_VolumeGrid_channel_count = R"doc(Return the num
 
 static const char *__doc_mitsuba_VolumeGrid_class = R"doc()doc";
 
-static const char *__doc_mitsuba_VolumeGrid_data = R"doc(Return a pointer to the underlying volume storage)doc";
+static const char *__doc_mitsuba_VolumeGrid_compute_max = R"doc(Compute the maximum over all channels and per channel (in parallel))doc";
+
+static const char *__doc_mitsuba_VolumeGrid_data =
+R"doc(Return a pointer to the underlying volume storage
+
+Memory-mapped grids are read-only: their contents are first copied
+into memory.)doc";
 
 static const char *__doc_mitsuba_VolumeGrid_data_2 = R"doc(Return a pointer to the underlying volume storage)doc";
 
+static const char *__doc_mitsuba_VolumeGrid_data_offset = R"doc(Offset of the voxels in version 4 files)doc";
+
+static const char *__doc_mitsuba_VolumeGrid_is_memory_mapped = R"doc(Is the volume storage a read-only memory-mapped file?)doc";
+
 static const char *__doc_mitsuba_VolumeGrid_m_bbox = R"doc()doc";
 
 static const char *__doc_mitsuba_VolumeGrid_m_channel_count = R"doc()doc";
 
 static const char *__doc_mitsuba_VolumeGrid_m_data = R"doc()doc";
 
+static const char *__doc_mitsuba_VolumeGrid_m_mapped_data = R"doc()doc";
+
 static const char *__doc_mitsuba_VolumeGrid_m_max = R"doc()doc";
 
 static const char *__doc_mitsuba_VolumeGrid_m_max_per_channel = R"doc()doc";
 
+static const char *__doc_mitsuba_VolumeGrid_m_mmap = R"doc(Memory-mapped volume file, and the voxels within it)doc";
+
 static const char *__doc_mitsuba_VolumeGrid_m_size = R"doc()doc";
 
 static const char *__doc_mitsuba_VolumeGrid_max = R"doc(Return the precomputed maximum over the volume grid)doc";
@@ -10002,7 +10639,9 @@ R"doc(Return the precomputed maximum over the volume grid per channel
 
 Pointer allocation/deallocation must be performed by the caller.)doc";
 
-static const char *__doc_mitsuba_VolumeGrid_read = R"doc()doc";
+static const char *__doc_mitsuba_VolumeGrid_read_data = R"doc(Read the voxels that follow the header of a volume file)doc";
+
+static const char *__doc_mitsuba_VolumeGrid_read_header = R"doc(Read the header of a volume file and return its version)doc";
 
 static const char *__doc_mitsuba_VolumeGrid_set_max = R"doc(Set the precomputed maximum over the volume grid)doc";
 
@@ -10015,17 +10654,28 @@ static const char *__doc_mitsuba_VolumeGrid_size = R"doc(Return the resolution o
 
 static const char *__doc_mitsuba_VolumeGrid_to_string = R"doc(Return a human-readable summary of this volume grid)doc";
 
+static const char *__doc_mitsuba_VolumeGrid_update_max = R"doc(Compute the maximum over the volume grid (in parallel))doc";
+
 static const char *__doc_mitsuba_VolumeGrid_write =
 R"doc(Write an encoded form of the bitmap to a binary volume file
 
 Parameter ``path``:
-    Target file name (expected to end in ".vol"))doc";
+    Target file name (expected to end in ".vol")
+
+Parameter ``version``:
+    File format version (3 or 4). Version 3 files can be read by older
+    releases, but need to be scanned to compute the maximum. Version 4
+    files store the maximum over all channels and per channel in their
+    header, which is computed from the voxels while writing.)doc";
 
 static const char *__doc_mitsuba_VolumeGrid_write_2 =
 R"doc(Write an encoded form of the volume grid to a stream
 
 Parameter ``stream``:
-    Target stream that will receive the encoded output)doc";
+    Target stream that will receive the encoded output
+
+Parameter ``version``:
+    File format version (3 or 4))doc";
 
 static const char *__doc_mitsuba_Volume_Volume = R"doc()doc";
 
@@ -10065,6 +10715,54 @@ This interface is specifically intended to encode a variable number of
 parameters. Pointer allocation/deallocation must be performed by the
 caller.)doc";
 
+static const char *__doc_mitsuba_Volume_eval_lod =
+R"doc(Evaluate the volume at a coarser level of detail
+
+Behaves like eval(), but may look up a prefiltered version of the
+volume whose voxels roughly match the given footprint, e.g. the radius
+of a ray cone in world space. Fine details are irrelevant for paths
+whose footprint covers many voxels, and coarse lookups are cheaper and
+more coherent.
+
+The default implementation ignores the footprint and calls eval().)doc";
+
+static const char *__doc_mitsuba_Volume_eval_pair =
+R"doc(Evaluate this volume and another volume at the same position
+
+Returns the results of eval_lod() for both volumes. When ``other`` is
+co-located with this volume (see is_colocated()), grid-based
+implementations share the transformation to local coordinates and the
+interpolation weights between both lookups, e.g. to fetch the
+extinction and albedo of a medium at once.
+
+The default implementation performs two independent lookups.)doc";
+
+static const char *__doc_mitsuba_Volume_is_colocated =
+R"doc(Can eval_pair() fuse the lookups into this volume and ``other``?
+
+The default implementation returns ``False``.)doc";
+
+static const char *__doc_mitsuba_Volume_local_majorants =
+R"doc(Compute local maxima of the volume on a coarse grid
+
+Subdivides the volume's local coordinate space into
+``grid_resolution`` cells and returns a tensor of shape ``(res.z,
+res.y, res.x, 1)`` whose entries bound the volume (over all channels,
+multiplied by ``value_scale``) everywhere inside the corresponding
+cell, taking interpolation into account. Heterogeneous media use these
+bounds as local majorants for free-flight sampling.
+
+The default implementation returns max() in every cell.)doc";
+
+static const char *__doc_mitsuba_Volume_local_minorants =
+R"doc(Compute local minima of the volume on a coarse grid
+
+Counterpart of local_majorants() that returns lower bounds of the
+volume (over all channels) inside each cell. Residual ratio tracking
+uses them to derive a control extinction.
+
+The default implementation returns zero in every cell.)doc";
+
 static const char *__doc_mitsuba_Volume_m_bbox = R"doc(Bounding box)doc";
 
 static const char *__doc_mitsuba_Volume_m_channel_count = R"doc(Number of channels stored in the volume)doc";
@@ -10089,6 +10787,8 @@ static const char *__doc_mitsuba_Volume_to_string = R"doc(Returns a human-reable
 
 static const char *__doc_mitsuba_Volume_update_bbox = R"doc()doc";
 
+static const char *__doc_mitsuba_Volume_world_transform = R"doc(Returns the transformation from local volume coordinates to world space)doc";
+
 static const char *__doc_mitsuba_ZStream =
 R"doc(Transparent compression/decompression stream based on ``zlib``.
 
@@ -10504,6 +11204,10 @@ static const char *__doc_mitsuba_filesystem_is_regular_file =
 R"doc(Checks if ``p`` points to a regular file, as opposed to a directory or
 symlink.)doc";
 
+static const char *__doc_mitsuba_filesystem_last_write_time =
+R"doc(Returns the time of the last modification of the file at ``p`` (in
+seconds since the epoch).)doc";
+
 static const char *__doc_mitsuba_filesystem_path =
 R"doc(Represents a path to a filesystem resource. On construction, the path
 is parsed and stored in a system-agnostic representation. The path can
@@ -12220,6 +12924,27 @@ Parameter ``c``:
 Returns:
     Coefficients for use with srgb_model_eval)doc";
 
+static const char *__doc_mitsuba_srgb_model_fetch_2 =
+R"doc(Look up the model coefficients for an array of sRGB color values
+
+The conversion is vectorized and distributed over all available cores,
+which makes it much faster than repeated calls to the scalar version
+when processing whole images.
+
+Parameter ``rgb``:
+    Interleaved sRGB color values (``3*count`` entries)
+
+Parameter ``coeff``:
+    Output array receiving the interleaved coefficients (``3*count``
+    entries). It may point to the same memory as ``rgb``.
+
+Parameter ``exceed_unit_range``:
+    When specified, this flag is set to ``True`` if any color component
+    lies outside of the [0, 1] range (such values are clamped)
+
+Returns:
+    The sum of srgb_model_mean() over all converted colors)doc";
+
 static const char *__doc_mitsuba_srgb_model_mean = R"doc()doc";
 
 static const char *__doc_mitsuba_srgb_to_xyz = R"doc(Convert ITU-R Rec. BT.709 linear RGB to XYZ tristimulus values)doc";
@@ -12567,6 +13292,8 @@ static const char *__doc_mitsuba_xml_detail_xml_to_properties =
 R"doc(Read a Mitsuba XML file and return a list of pairs containing the name
 of the plugin and the corresponding populated Properties object)doc";
 
+static const char *__doc_mitsuba_xml_keep_object_graph = R"doc(Are object graphs retained by the loader? (see set_keep_object_graph()))doc";
+
 static const char *__doc_mitsuba_xml_load_file =
 R"doc(Load a Mitsuba scene from an XML file
 
@@ -12591,6 +13318,33 @@ Parameter ``parallel``:
 
 static const char *__doc_mitsuba_xml_load_string = R"doc(Load a Mitsuba scene from an XML string)doc";
 
+static const char *__doc_mitsuba_xml_set_keep_object_graph =
+R"doc(Retain the object graph of scenes loaded by subsequent calls to
+load_file(), load_string() and ``Scene::load_snapshot()``
+
+The graph holds the resolved properties of every object. It is
+required to write a scene to a binary snapshot (see
+``Scene::save_snapshot()``), but otherwise only occupies memory, hence
+it is disabled by default.)doc";
+
+static const char *__doc_mitsuba_xml_set_load_profile =
+R"doc(Record a timeline of the object instantiations performed by subsequent
+calls to load_file() and load_string()
+
+For every object, the start and end time, thread, plugin type, source
+file, and change in resident memory during its construction are
+recorded. When loading finishes, the timeline is written to
+``filename`` in the Chrome trace event format (viewable in
+chrome://tracing or Perfetto), and a summary of the most expensive
+plugin types and objects is logged along with the critical path
+through the dependency graph of the scene.
+
+Memory is measured for the whole process, hence the per-object values
+are only exact when loading with parallel=false.
+
+Parameter ``filename``:
+    Output filename of the trace. An empty string disables profiling.)doc";
+
 static const char *__doc_mitsuba_xyz_to_srgb = R"doc(Convert XYZ tristimulus values to ITU-R Rec. BT.709 linear RGB)doc";
 
 static const char *__doc_operator_lshift = R"doc(Turns a vector of elements into a human-readable representation)doc";
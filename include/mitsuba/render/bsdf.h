@@ -544,8 +544,18 @@ public:
     //! @{ \name BSDF property accessors (components, flags, etc)
     // -----------------------------------------------------------------------
 
-    /// Flags for all components combined.
-    uint32_t flags(Mask /*active*/ = true) const { return m_flags; }
+    /**
+     * \brief Flags for all components combined.
+     *
+     * Includes \ref BSDFFlags::NeedsDifferentials when one of the textures
+     * or nested BSDFs passed to the BSDF filters its lookups using
+     * texture-space differentials.
+     */
+    uint32_t flags(Mask /*active*/ = true) const {
+        return m_texture_differentials
+                   ? (m_flags | +BSDFFlags::NeedsDifferentials)
+                   : m_flags;
+    }
 
     /// Flags for a specific component of this BSDF.
     uint32_t flags(size_t i, Mask /*active*/ = true) const {
@@ -555,7 +565,7 @@ public:
 
     /// Does the implementation require access to texture-space differentials?
     bool needs_differentials(Mask /*active*/ = true) const {
-        return has_flag(m_flags, BSDFFlags::NeedsDifferentials);
+        return has_flag(flags(), BSDFFlags::NeedsDifferentials);
     }
 
     /// Number of components this BSDF is comprised of.
@@ -606,6 +616,9 @@ protected:
     /// Flags for each component of this BSDF.
     std::vector<uint32_t> m_components;
 
+    /// Does one of the textures or nested BSDFs need texture-space differentials?
+    bool m_texture_differentials;
+
     /// Identifier (if available)
     std::string m_id;
 };
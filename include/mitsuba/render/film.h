@@ -75,6 +75,17 @@ public:
     /// Write the developed contents of the film to a file on disk
     virtual void write(const fs::path &path) const = 0;
 
+    /**
+     * \brief Equivalent to \ref write(), but may execute asynchronously on
+     * a different thread
+     *
+     * The film contents are developed before the function returns, hence it
+     * is safe to modify the film afterwards. Use \ref
+     * Thread::wait_for_tasks() to wait for pending writes. The default
+     * implementation simply calls \ref write().
+     */
+    virtual void write_async(const fs::path &path) const;
+
     /// dr::schedule() variables that represent the internal film storage
     virtual void schedule_storage() = 0;
 
@@ -530,6 +530,9 @@ struct MediumInteraction : Interaction<Float_, Spectrum_> {
     /// mint used when sampling the given distance ``t``
     Float mint;
 
+    /// World-space radius of the ray footprint, selects the level of detail of volume lookups
+    Float footprint;
+
     //! @}
     // =============================================================
 
@@ -552,7 +555,7 @@ struct MediumInteraction : Interaction<Float_, Spectrum_> {
 
     DRJIT_STRUCT(MediumInteraction, t, time, wavelengths, p, n, medium,
                  sh_frame, wi, sigma_s, sigma_n, sigma_t,
-                 combined_extinction, mint)
+                 combined_extinction, mint, footprint)
 };
 
 // -----------------------------------------------------------------------------
@@ -11,7 +11,7 @@ NAMESPACE_BEGIN(mitsuba)
 template <typename Float, typename Spectrum>
 class MI_EXPORT_LIB Medium : public Object {
 public:
-    MI_IMPORT_TYPES(PhaseFunction, Sampler, Scene, Texture);
+    MI_IMPORT_TYPES(PhaseFunction, Sampler, Scene, Texture, Emitter);
 
     /// Intersects a ray with the medium's bounding box
     virtual std::tuple<Mask, Float, Float>
@@ -29,6 +29,29 @@ public:
     get_scattering_coefficients(const MediumInteraction3f &mi,
                                 Mask active = true) const = 0;
 
+    /**
+     * \brief Returns the single scattering albedo evaluated at a given
+     * MediumInteraction mi
+     *
+     * The default implementation divides the coefficients returned by \ref
+     * get_scattering_coefficients(). Media should override it when the
+     * albedo can be evaluated without looking up the extinction.
+     */
+    virtual UnpolarizedSpectrum get_albedo(const MediumInteraction3f &mi,
+                                           Mask active = true) const;
+
+    /**
+     * \brief Returns the emitted radiance per unit length, i.e. the product
+     * of the absorption coefficient and the emitted radiance, evaluated at a
+     * given MediumInteraction mi
+     *
+     * The default implementation returns zero. Media that emit light should
+     * override it and provide an emitter (see \ref emitter()) that samples
+     * positions proportionally to this quantity.
+     */
+    virtual UnpolarizedSpectrum get_emission(const MediumInteraction3f &mi,
+                                             Mask active = true) const;
+
     /**
      * \brief Sample a free-flight distance in the medium.
      *
@@ -42,13 +65,37 @@ public:
      * \param channel  The channel according to which we will sample the
      * free-flight distance. This argument is only used when rendering in RGB
      * modes.
+     * \param footprint World-space radius of the ray footprint, which lets
+     * media evaluate their volumes at a coarser level of detail (see \ref
+     * Volume::eval_lod()). Zero requests the finest level.
+     *
+     * When the medium provides a grid of local majorants (see \ref
+     * set_majorant_grid()), the distance is sampled by stepping through its
+     * cells with a 3D DDA, and the \c combined_extinction field of the
+     * returned interaction holds the majorant of the cell containing the
+     * sampled position.
+     *
+     * With decomposition tracking (see \ref set_control_extinction()), a
+     * tentative collision is attributed to the control extinction with
+     * probability <tt>control / majorant</tt>. Such collisions only evaluate
+     * the albedo and are reported as real collisions. The coefficients of
+     * the remaining collisions describe the residual extinction, rescaled
+     * so that the integrator's usual null-collision test accepts them with
+     * probability <tt>(sigma_t - control) / (majorant - control)</tt>.
      *
      * \return         This method returns a MediumInteraction.
      *                 The MediumInteraction will always be valid,
      *                 except if the ray missed the Medium's bounding box.
      */
     MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
-                                           UInt32 channel, Mask active) const;
+                                           UInt32 channel, Float footprint,
+                                           Mask active) const;
+
+    /// Sample a free-flight distance at the finest level of detail
+    MediumInteraction3f sample_interaction(const Ray3f &ray, Float sample,
+                                           UInt32 channel, Mask active) const {
+        return sample_interaction(ray, sample, channel, 0.f, active);
+    }
 
     /**
      * \brief Compute the transmittance and PDF
@@ -70,6 +117,27 @@ public:
                            const SurfaceInteraction3f &si,
                            Mask active) const;
 
+    /**
+     * \brief Estimate the transmittance along a ray segment
+     *
+     * This function computes an unbiased estimate of the transmittance
+     * between the start of the ray (or the entry point into the medium) and
+     * <tt>ray.maxt</tt> using residual ratio tracking: the extinction is
+     * split into a control extinction, whose transmittance is evaluated
+     * analytically, and a residual that is estimated by ratio tracking.
+     *
+     * The control extinction of each cell of the majorant grid is the
+     * midpoint between its local minorant and majorant. Without a majorant
+     * grid, it is half of the majorant of the medium. Homogeneous media
+     * return the exact transmittance.
+     *
+     * \param ray     Ray segment, along which the transmittance is estimated
+     * \param sample  A uniformly distributed random sample, which seeds the
+     *                tentative collisions along the segment
+     */
+    UnpolarizedSpectrum eval_transmittance(const Ray3f &ray, Float sample,
+                                           Mask active) const;
+
     /// Return the phase function of this medium
     MI_INLINE const PhaseFunction *phase_function() const {
         return m_phase_function.get();
@@ -78,6 +146,15 @@ public:
     /// Returns whether this specific medium instance uses emitter sampling
     MI_INLINE bool use_emitter_sampling() const { return m_sample_emitters; }
 
+    /// Is this medium also an emitter?
+    bool is_emitter() const { return (bool) m_emitter; }
+
+    /// Return the emitter sampling the emission of this medium (if any)
+    const Emitter *emitter(Mask /*unused*/ = true) const { return m_emitter.get(); }
+
+    /// Return the emitter sampling the emission of this medium (if any)
+    Emitter *emitter(Mask /*unused*/ = true) { return m_emitter.get(); }
+
     /// Returns whether this medium is homogeneous
     MI_INLINE bool is_homogeneous() const { return m_is_homogeneous; }
 
@@ -86,6 +163,11 @@ public:
         return m_has_spectral_extinction;
     }
 
+    /// Returns whether this medium samples distances using local majorants
+    MI_INLINE bool has_majorant_grid() const {
+        return dr::width(m_majorant_grid) != 0;
+    }
+
     void traverse(TraversalCallback *callback) override;
 
     /// Return a string identifier
@@ -105,10 +187,77 @@ protected:
     Medium(const Properties &props);
     virtual ~Medium();
 
+    /**
+     * \brief Use a grid of local majorants for free-flight sampling
+     *
+     * \param majorants
+     *     Tensor of shape <tt>(z, y, x, 1)</tt> holding an upper bound of the
+     *     extinction coefficient inside each cell, e.g. computed using \ref
+     *     Volume::local_majorants(). An empty tensor disables the grid.
+     *
+     * \param to_world
+     *     Transformation from the unit cube covered by the grid to world space
+     *
+     * \param minorants
+     *     Optional tensor of the same shape holding a lower bound of the
+     *     extinction coefficient inside each cell, which is used by \ref
+     *     eval_transmittance(). Zero is assumed when it is empty.
+     */
+    void set_majorant_grid(const TensorXf &majorants,
+                           const ScalarTransform4f &to_world,
+                           const TensorXf &minorants = TensorXf());
+
+    /// Look up the local majorant at the given world space position
+    Float eval_majorant_grid(const Point3f &p, Mask active = true) const;
+
+    /**
+     * \brief Enable decomposition tracking in \ref sample_interaction()
+     *
+     * \param control
+     *     A lower bound of the extinction coefficient over the medium, which
+     *     must not depend on the wavelength. When the medium provides local
+     *     minorants (see \ref set_majorant_grid()), these are used instead.
+     *     Pass a negative value to disable decomposition tracking.
+     */
+    void set_control_extinction(ScalarFloat control);
+
+    /**
+     * \brief Sample a free-flight distance by stepping through the cells of
+     * the majorant grid between \c mint and \c maxt
+     *
+     * Returns the sampled distance (infinite if the optical depth \c tau
+     * isn't reached before \c maxt) and the majorant at that position.
+     *
+     * When \c residual is set, distances are sampled according to the
+     * residual majorant <tt>(majorant - minorant) / 2</tt> of each cell. The
+     * minorant at the sampled position and the optical depth of the control
+     * extinction <tt>(majorant + minorant) / 2</tt> up to that position (or
+     * \c maxt) are returned as well. Both are zero otherwise, except for the
+     * minorant when decomposition tracking is enabled.
+     */
+    std::tuple<Float, Float, Float, Float>
+    sample_majorant_grid(const Ray3f &ray, Float mint, Float maxt, Float tau,
+                         bool residual, Mask active) const;
+
 protected:
     ref<PhaseFunction> m_phase_function;
+    /// Emitter sampling the emission of the medium (if any)
+    ref<Emitter> m_emitter;
     bool m_sample_emitters, m_is_homogeneous, m_has_spectral_extinction;
 
+    /// Local majorants (empty when a single majorant is used)
+    DynamicBuffer<Float> m_majorant_grid;
+    /// Local minorants (empty when they are all zero)
+    DynamicBuffer<Float> m_minorant_grid;
+    /// Is decomposition tracking enabled?
+    bool m_decomposition = false;
+    /// Control extinction of decomposition tracking without local minorants
+    Float m_control_extinction = 0.f;
+    /// Resolution of the majorant grid
+    ScalarVector3i m_majorant_resolution;
+    /// Transforms world space positions to majorant grid cell coordinates
+    ScalarTransform4f m_majorant_to_grid;
+
     /// Identifier (if available)
     std::string m_id;
 };
@@ -125,11 +274,16 @@ DRJIT_VCALL_TEMPLATE_BEGIN(mitsuba::Medium)
     DRJIT_VCALL_GETTER(use_emitter_sampling, bool)
     DRJIT_VCALL_GETTER(is_homogeneous, bool)
     DRJIT_VCALL_GETTER(has_spectral_extinction, bool)
+    DRJIT_VCALL_GETTER(emitter, const typename Class::Emitter *)
     DRJIT_VCALL_METHOD(get_majorant)
     DRJIT_VCALL_METHOD(intersect_aabb)
     DRJIT_VCALL_METHOD(sample_interaction)
     DRJIT_VCALL_METHOD(transmittance_eval_pdf)
+    DRJIT_VCALL_METHOD(eval_transmittance)
     DRJIT_VCALL_METHOD(get_scattering_coefficients)
+    DRJIT_VCALL_METHOD(get_albedo)
+    DRJIT_VCALL_METHOD(get_emission)
+    auto is_emitter() const { return neq(emitter(), nullptr); }
 DRJIT_VCALL_TEMPLATE_END(mitsuba::Medium)
 
 //! @}
@@ -156,6 +156,14 @@ public:
     /// Does this mesh have additional mesh attributes?
     bool has_mesh_attributes() const { return m_mesh_attributes.size() > 0; }
 
+    /// Return the names of all additional mesh attributes
+    std::vector<std::string> attribute_names() const {
+        std::vector<std::string> names;
+        for (const auto &kv : m_mesh_attributes)
+            names.push_back(kv.first);
+        return names;
+    }
+
     /// Does this mesh use face normals?
     bool has_face_normals() const { return m_face_normals; }
 
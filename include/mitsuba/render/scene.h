@@ -541,6 +541,35 @@ public:
     //! @}
     // =============================================================
 
+    // =============================================================
+    //! @{ \name Snapshots
+    // =============================================================
+
+    /**
+     * \brief Write a binary snapshot of the scene to the given file
+     *
+     * The snapshot stores the object graph of the scene (plugin names and
+     * fully resolved properties) along with the geometry of all triangle
+     * meshes. This allows \ref load_snapshot() to reconstruct the scene
+     * without parsing XML or re-reading the original mesh files.
+     *
+     * Only scenes that were loaded from an XML file, string or snapshot
+     * while the object graph was retained (see
+     * <tt>xml::set_keep_object_graph()</tt>) can be written to a snapshot.
+     */
+    void save_snapshot(const std::string &filename) const;
+
+    /**
+     * \brief Load a scene from a binary snapshot created by \ref save_snapshot()
+     *
+     * Mesh buffers are stored out-of-line at the end of the snapshot file,
+     * from where they are copied using a memory mapping.
+     */
+    static ref<Scene> load_snapshot(const std::string &filename);
+
+    //! @}
+    // =============================================================
+
     /// Traverse the scene graph and invoke the given callback for each object
     void traverse(TraversalCallback *callback) override;
 
@@ -610,6 +639,17 @@ protected:
     /// Updates the discrete distribution used to select a shape's silhouette
     void update_silhouette_sampling_distribution();
 
+    /**
+     * \brief Pack small textures referenced by the scene into shared atlases
+     *
+     * This pass is enabled by setting the boolean \c texture_atlas property
+     * of the scene, and only has an effect in JIT variants. Textures whose
+     * width and height don't exceed \c max_size (given by the \c
+     * texture_atlas_max_size property, 256 by default) are candidates. See
+     * \ref Texture::pack_atlas() for details.
+     */
+    void pack_texture_atlases(uint32_t max_size);
+
 protected:
     /// Acceleration data structure (IAS) (type depends on implementation)
     void *m_accel = nullptr;
@@ -640,6 +680,9 @@ protected:
     std::unique_ptr<DiscreteDistribution<Float>> m_silhouette_distr = nullptr;
 
     bool m_shapes_grad_enabled;
+
+    /// Object graph provided by the XML loader (see \ref save_snapshot())
+    ref<Object> m_object_graph;
 };
 
 /// Dummy function which can be called to ensure that the librender shared library is loaded
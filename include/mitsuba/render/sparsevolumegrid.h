@@ -0,0 +1,177 @@
+#pragma once
+
+#include <mitsuba/core/bbox.h>
+#include <mitsuba/core/object.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/render/fwd.h>
+#include <map>
+#include <vector>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**
+ * \brief Sparse 3D volume grid made of bricks of 8x8x8 voxels
+ *
+ * The grid is subdivided into tiles of 8x8x8 voxels. A top-level index grid
+ * stores the brick holding the voxels of each tile, and all tiles with the
+ * same constant value (e.g. empty space) reference a single shared brick.
+ * This drastically reduces the memory footprint of mostly empty volumes such
+ * as clouds or explosions.
+ *
+ * Sparse grids can be created from dense grids, either in memory or by
+ * streaming a ".vol" file one slab of tiles at a time, so that the dense
+ * grid never needs to fit into memory. Please see the documentation of the
+ * \c sparsegridvolume plugin for the file format specification.
+ */
+MI_VARIANT
+class MI_EXPORT_LIB SparseVolumeGrid : public Object {
+public:
+    MI_IMPORT_CORE_TYPES()
+
+    /// Number of voxels of a brick along each axis
+    static constexpr uint32_t BrickSize = 8;
+
+    /// Number of voxels of a brick
+    static constexpr uint32_t BrickVoxels = BrickSize * BrickSize * BrickSize;
+
+    /**
+     * \brief Load a sparse grid from a given filename
+     *
+     * Both sparse grid files and dense volume files in the Mitsuba ".vol"
+     * format are supported. The latter are converted while they are read.
+     *
+     * \param path
+     *    Name of the file to be loaded
+     *
+     * \param tolerance
+     *    Tiles of dense volumes whose values vary by at most this amount
+     *    (per channel) are stored as constant tiles
+     */
+    SparseVolumeGrid(const fs::path &path, ScalarFloat tolerance = 0.f);
+
+    /**
+     * \brief Load a sparse grid from an arbitrary stream data source
+     *
+     * See the other constructor for details.
+     */
+    SparseVolumeGrid(Stream *stream, ScalarFloat tolerance = 0.f);
+
+    /**
+     * \brief Convert a dense volume grid that resides in memory
+     *
+     * See the other constructors for details.
+     */
+    SparseVolumeGrid(const VolumeGrid<Float, Spectrum> *grid,
+                     ScalarFloat tolerance = 0.f);
+
+    /// Return the resolution of the voxel grid
+    ScalarVector3u size() const { return m_size; }
+
+    /// Return the resolution of the top-level index grid
+    ScalarVector3u tile_count() const { return m_tile_count; }
+
+    /// Return the number of channels
+    size_t channel_count() const { return m_channel_count; }
+
+    /// Return the number of distinct bricks
+    size_t brick_count() const { return m_brick_max.size(); }
+
+    /// Return the brick referenced by each tile (row-major, x varies fastest)
+    const uint32_t *index() const { return m_index.data(); }
+
+    /**
+     * \brief Return the voxel data of all bricks
+     *
+     * Voxel <tt>(x, y, z)</tt> of brick \c b is stored at offset
+     * <tt>((b * 8 + z) * 8 + y) * 8 + x</tt>, in units of \ref
+     * channel_count() values.
+     */
+    const ScalarFloat *data() const { return m_data.data(); }
+
+    /// Return the maximum of a brick over all channels
+    ScalarFloat brick_max(size_t brick) const { return m_brick_max[brick]; }
+
+    /// Return the precomputed maximum over the volume grid
+    ScalarFloat max() const { return m_max; }
+
+    /**
+     * \brief Return the precomputed maximum over the volume grid per channel
+     *
+     * Pointer allocation/deallocation must be performed by the caller.
+     */
+    void max_per_channel(ScalarFloat *out) const;
+
+    /// Return the bounding box specified in the source file
+    const ScalarBoundingBox3f &bbox() const { return m_bbox; }
+
+    /// Estimates the transformation from a unit axis-aligned bounding box to the given one.
+    ScalarTransform4f bbox_transform() const {
+        auto scale_transf = ScalarTransform4f::scale(dr::rcp(m_bbox.extents()));
+        auto translation  = ScalarTransform4f::translate(-m_bbox.min);
+        return scale_transf * translation;
+    }
+
+    /// Return the size of the index and brick data in bytes
+    size_t buffer_size() const {
+        return m_index.size() * sizeof(uint32_t) +
+               m_data.size() * sizeof(ScalarFloat);
+    }
+
+    /**
+     * Write the sparse grid to a binary file
+     *
+     * \param path
+     *    Target file name (expected to end in ".svol")
+     */
+    void write(const fs::path &path) const;
+
+    /**
+     * Write the sparse grid to a stream
+     *
+     * \param stream
+     *    Target stream that will receive the encoded output
+     */
+    void write(Stream *stream) const;
+
+    /// Return a human-readable summary of this sparse grid
+    virtual std::string to_string() const override;
+
+    MI_DECLARE_CLASS()
+
+protected:
+    void read(Stream *stream, ScalarFloat tolerance);
+    void read_sparse(Stream *stream);
+
+    /// Prepare the index and the brick storage for a grid of the given size
+    void init(const ScalarVector3u &size, uint32_t channel_count);
+
+    /**
+     * \brief Convert a slab of tiles of a dense grid
+     *
+     * \c slab holds <tt>min(8, size.z - 8 * tile_z)</tt> consecutive slices
+     * of the dense grid starting at <tt>z = 8 * tile_z</tt>.
+     */
+    template <typename T>
+    void add_slab(const T *slab, uint32_t tile_z, ScalarFloat tolerance);
+
+    /// Compute the per-brick and global maxima
+    void update_max();
+
+protected:
+    std::vector<uint32_t> m_index;
+    std::vector<ScalarFloat> m_data;
+    std::vector<ScalarFloat> m_brick_max;
+
+    ScalarVector3u m_size;
+    ScalarVector3u m_tile_count;
+    ScalarUInt32 m_channel_count;
+    ScalarBoundingBox3f m_bbox;
+    ScalarFloat m_max;
+    std::vector<ScalarFloat> m_max_per_channel;
+
+    /// Bricks shared by constant tiles, indexed by their value (conversion only)
+    std::map<std::vector<ScalarFloat>, uint32_t> m_constant_bricks;
+};
+
+MI_EXTERN_CLASS(SparseVolumeGrid)
+NAMESPACE_END(mitsuba)
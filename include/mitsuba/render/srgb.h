@@ -41,6 +41,31 @@ MI_INLINE dr::value_t<Array3f> srgb_model_mean(const Array3f &coeff) {
  */
 MI_EXPORT_LIB dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &);
 
+/**
+ * \brief Look up the model coefficients for an array of sRGB color values
+ *
+ * The conversion is vectorized and distributed over all available cores,
+ * which makes it much faster than repeated calls to the scalar version when
+ * processing whole images.
+ *
+ * \param rgb
+ *     Interleaved sRGB color values (\c 3*count entries)
+ *
+ * \param coeff
+ *     Output array receiving the interleaved coefficients (\c 3*count
+ *     entries). It may point to the same memory as \c rgb.
+ *
+ * \param exceed_unit_range
+ *     When specified, this flag is set to \c true if any color component lies
+ *     outside of the [0, 1] range (such values are clamped)
+ *
+ * \return
+ *     The sum of \ref srgb_model_mean() over all converted colors
+ */
+template <typename Value>
+MI_EXPORT_LIB double srgb_model_fetch(const Value *rgb, Value *coeff, size_t count,
+                                      bool *exceed_unit_range = nullptr);
+
 /// Sanity check: convert the coefficients back to sRGB
 // MI_EXPORT_LIB Color<float, 3> srgb_model_eval_rgb(const dr::Array<float, 3> &);
 
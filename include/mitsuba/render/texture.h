@@ -163,6 +163,32 @@ public:
     virtual Color3f eval_3(const SurfaceInteraction3f &si,
                            Mask active = true) const;
 
+    /**
+     * \brief Monochromatic evaluation of several textures at the same surface
+     * interaction
+     *
+     * This function is equivalent to setting <tt>out[i] =
+     * textures[i]->eval_1(si, active)</tt> for each of the \c count textures,
+     * but it enables implementations to share work between textures that are
+     * evaluated together. For instance, bitmap textures with the same
+     * resolution and sampling parameters compute the wrapped texel positions
+     * and the filter weights only once and fuse their texel fetches. This is
+     * useful in BSDFs that query many parameter textures per shading point.
+     *
+     * \param textures
+     *     Textures to be evaluated (at most 64). Entries may be \c nullptr, in
+     *     which case the corresponding element of \c out is left unchanged.
+     *
+     * \param si
+     *     An interaction record describing the associated surface position
+     *
+     * \param out
+     *     Array of \c count elements receiving the texture values
+     */
+    static void eval_1_batch(const Texture *const *textures, size_t count,
+                             const SurfaceInteraction3f &si, Float *out,
+                             Mask active = true);
+
     /**
      * Return the mean value of the spectrum over the support
      * (MI_WAVELENGTH_MIN..MI_WAVELENGTH_MAX)
@@ -213,6 +239,43 @@ public:
     /// Does this texture evaluation depend on the UV coordinates
     virtual bool is_spatially_varying() const { return false; }
 
+    /**
+     * \brief Does this texture filter its lookups using the UV partials
+     * (<tt>SurfaceInteraction3f::duv_dx</tt> and <tt>duv_dy</tt>)?
+     *
+     * BSDFs that reference such a texture request the computation of texture
+     * space differentials (see \ref BSDFFlags::NeedsDifferentials). The
+     * default implementation reports whether one of the textures passed to
+     * this texture (e.g. the inputs of a blend) needs them.
+     */
+    virtual bool needs_differentials() const { return m_nested_differentials; }
+
+    /**
+     * \brief Pack the data of this texture and of compatible textures into a
+     * shared texture atlas
+     *
+     * This function is invoked by \ref Scene when its \c texture_atlas
+     * property is set. Textures that perform their lookups in the same atlas
+     * generate identical code, which enables the JIT compiler to merge the
+     * virtual function calls of the objects referencing them.
+     *
+     * \param textures
+     *     Textures of the scene, where this texture is stored at position \c
+     *     index. Implementations may pack any of the following textures
+     *     along with this one. Entries set to \c nullptr were already
+     *     processed and must be skipped.
+     *
+     * \param max_size
+     *     Maximum width and height of textures that are considered small
+     *     enough to be packed
+     *
+     * \return
+     *     The positions of all processed textures (including this one). The
+     *     default implementation only returns \c index.
+     */
+    virtual std::vector<size_t> pack_atlas(const std::vector<Texture *> &textures,
+                                           size_t index, uint32_t max_size);
+
     /// Convenience function returning the standard D65 illuminant
     static ref<Texture> D65(ScalarFloat scale = 1.f);
 
@@ -232,8 +295,26 @@ protected:
     Texture(const Properties &);
     virtual ~Texture();
 
+    /**
+     * \brief Evaluate the texture as part of \ref eval_1_batch()
+     *
+     * The texture is stored at position \c index of \c textures. The bits of
+     * \c pending identify textures of the batch that remain to be evaluated.
+     * Implementations may evaluate further pending textures along with this
+     * one, and must clear the bits of all textures they evaluated (including
+     * their own). The default implementation only evaluates this texture
+     * using \ref eval_1().
+     */
+    virtual void eval_1_batch_impl(const Texture *const *textures,
+                                   size_t count, size_t index,
+                                   uint64_t &pending,
+                                   const SurfaceInteraction3f &si,
+                                   Float *out, Mask active) const;
+
 protected:
     std::string m_id;
+    /// Does one of the nested textures need texture-space differentials?
+    bool m_nested_differentials;
 };
 
 MI_EXTERN_CLASS(Texture)
@@ -42,6 +42,43 @@ public:
      */
     virtual void eval_n(const Interaction3f &it, Float *out, Mask active = true) const;
 
+    /**
+     * \brief Evaluate the volume at a coarser level of detail
+     *
+     * Behaves like \ref eval(), but may look up a prefiltered version of the
+     * volume whose voxels roughly match the given footprint, e.g. the radius
+     * of a ray cone in world space. Fine details are irrelevant for paths
+     * whose footprint covers many voxels, and coarse lookups are cheaper and
+     * more coherent.
+     *
+     * The default implementation ignores the footprint and calls \ref eval().
+     */
+    virtual UnpolarizedSpectrum eval_lod(const Interaction3f &it, Float footprint,
+                                         Mask active = true) const;
+
+    /**
+     * \brief Evaluate this volume and another volume at the same position
+     *
+     * Returns the results of \ref eval_lod() for both volumes. When \c other
+     * is co-located with this volume (see \ref is_colocated()), grid-based
+     * implementations share the transformation to local coordinates and the
+     * interpolation weights between both lookups, e.g. to fetch the
+     * extinction and albedo of a medium at once.
+     *
+     * The default implementation performs two independent lookups.
+     */
+    virtual std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
+    eval_pair(const Volume *other, const Interaction3f &it, Float footprint,
+              Mask active = true) const;
+
+    /**
+     * \brief Can \ref eval_pair() fuse the lookups into this volume and \c
+     * other?
+     *
+     * The default implementation returns \c false.
+     */
+    virtual bool is_colocated(const Volume *other) const;
+
     /**
      * Evaluate the volume at the given surface interaction,
      * and compute the gradients of the linear interpolant as well.
@@ -60,9 +97,39 @@ public:
      */
     virtual void max_per_channel(ScalarFloat *out) const;
 
+    /**
+     * \brief Compute local maxima of the volume on a coarse grid
+     *
+     * Subdivides the volume's local coordinate space into \c grid_resolution
+     * cells and returns a tensor of shape <tt>(res.z, res.y, res.x, 1)</tt>
+     * whose entries bound the volume (over all channels, multiplied by \c
+     * value_scale) everywhere inside the corresponding cell, taking
+     * interpolation into account. Heterogeneous media use these bounds as
+     * local majorants for free-flight sampling.
+     *
+     * The default implementation returns \ref max() in every cell.
+     */
+    virtual TensorXf local_majorants(const ScalarVector3i &grid_resolution,
+                                     ScalarFloat value_scale = 1.f) const;
+
+    /**
+     * \brief Compute local minima of the volume on a coarse grid
+     *
+     * Counterpart of \ref local_majorants() that returns lower bounds of the
+     * volume (over all channels) inside each cell. Residual ratio tracking
+     * uses them to derive a control extinction.
+     *
+     * The default implementation returns zero in every cell.
+     */
+    virtual TensorXf local_minorants(const ScalarVector3i &grid_resolution,
+                                     ScalarFloat value_scale = 1.f) const;
+
     /// Returns the bounding box of the volume
     ScalarBoundingBox3f bbox() const { return m_bbox; }
 
+    /// Returns the transformation from local volume coordinates to world space
+    ScalarTransform4f world_transform() const { return m_to_local.inverse(); }
+
     /**
      * \brief Returns the resolution of the volume, assuming that it is based
      * on a discrete representation.
@@ -3,6 +3,7 @@
 #include <drjit/tensor.h>
 
 #include <mitsuba/core/bbox.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/transform.h>
@@ -16,6 +17,11 @@ NAMESPACE_BEGIN(mitsuba)
  * This class handles loading of volumes in the Mitsuba volume file format
  * Please see the documentation of gridvolume (grid3d.cpp) for the file format
  * specification.
+ *
+ * The voxels of version 4 files are stored at an aligned offset, and the
+ * file header holds the maximum of the grid. When such a file is loaded from
+ * the filesystem in single precision, it is memory-mapped rather than read
+ * into memory, and pages are only loaded once the voxels are accessed.
  */
 MI_VARIANT
 class MI_EXPORT_LIB VolumeGrid : public Object {
@@ -32,6 +38,9 @@ public:
     /**
      * \brief Load a VolumeGrid from a given filename
      *
+     * Version 4 files are memory-mapped when possible (see \ref
+     * is_memory_mapped()).
+     *
      * \param path
      *    Name of the file to be loaded
      */
@@ -47,11 +56,21 @@ public:
 
     VolumeGrid(ScalarVector3u size, ScalarUInt32 channel_count);
 
-    /// Return a pointer to the underlying volume storage
-    ScalarFloat *data() { return m_data.get(); }
+    /**
+     * \brief Return a pointer to the underlying volume storage
+     *
+     * Memory-mapped grids are read-only: their contents are first copied
+     * into memory.
+     */
+    ScalarFloat *data();
 
     /// Return a pointer to the underlying volume storage
-    const ScalarFloat *data() const { return m_data.get(); }
+    const ScalarFloat *data() const {
+        return m_mmap ? m_mapped_data : m_data.get();
+    }
+
+    /// Is the volume storage a read-only memory-mapped file?
+    bool is_memory_mapped() const { return m_mmap.get() != nullptr; }
 
     /// Return the resolution of the voxel grid
     ScalarVector3u size() const { return m_size; }
@@ -86,23 +105,35 @@ public:
     size_t bytes_per_voxel() const { return sizeof(ScalarFloat) * channel_count(); }
 
     /// Return the volume grid size in bytes (excluding metadata)
-    size_t buffer_size() const { return dr::prod(m_size) * bytes_per_voxel(); }
+    size_t buffer_size() const {
+        return (size_t) m_size.x() * m_size.y() * m_size.z() * bytes_per_voxel();
+    }
 
     /**
      * Write an encoded form of the bitmap to a binary volume file
      *
      * \param path
      *    Target file name (expected to end in ".vol")
+     *
+     * \param version
+     *    File format version (3 or 4). Version 3 files can be read by
+     *    older releases, but need to be scanned to compute the maximum.
+     *    Version 4 files store the maximum over all channels and per
+     *    channel in their header, which is computed from the voxels while
+     *    writing.
      */
-    void write(const fs::path &path) const;
+    void write(const fs::path &path, uint32_t version = 3) const;
 
     /**
      * Write an encoded form of the volume grid to a stream
      *
      * \param stream
      *    Target stream that will receive the encoded output
+     *
+     * \param version
+     *    File format version (3 or 4)
      */
-    void write(Stream *stream) const;
+    void write(Stream *stream, uint32_t version = 3) const;
 
     /// Return a human-readable summary of this volume grid
     virtual std::string to_string() const override;
@@ -110,11 +141,30 @@ public:
     MI_DECLARE_CLASS()
 
 protected:
-    void read(Stream *stream);
+    /// Read the header of a volume file and return its version
+    uint8_t read_header(Stream *stream);
+
+    /// Read the voxels that follow the header of a volume file
+    void read_data(Stream *stream, uint8_t version);
+
+    /// Compute the maximum over the volume grid (in parallel)
+    void update_max();
+
+    /// Compute the maximum over all channels and per channel (in parallel)
+    ScalarFloat compute_max(std::vector<ScalarFloat> &max_per_channel) const;
+
+    /// Offset of the voxels in version 4 files
+    size_t data_offset() const {
+        return (52 + 4 * (size_t) m_channel_count + 63) / 64 * 64;
+    }
 
 protected:
     std::unique_ptr<ScalarFloat[]> m_data;
 
+    /// Memory-mapped volume file, and the voxels within it
+    ref<MemoryMappedFile> m_mmap;
+    const ScalarFloat *m_mapped_data = nullptr;
+
     ScalarVector3u m_size;
     ScalarUInt32 m_channel_count;
     ScalarBoundingBox3f m_bbox;
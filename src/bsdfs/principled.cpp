@@ -344,12 +344,21 @@ public:
         if (unlikely(dr::none_or<false>(active)))
             return { bs, 0.0f };
 
-        // Store the weights.
-        Float anisotropic = m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-        roughness = m_roughness->eval_1(si, active),
-        spec_trans = m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f,
-        metallic = m_has_metallic ? m_metallic->eval_1(si, active) : 0.0f,
-        clearcoat = m_has_clearcoat ? m_clearcoat->eval_1(si, active) : 0.0f;
+        // Store the weights (evaluated as a batch to share texture lookups)
+        const Texture *weight_tex[] = {
+            m_has_anisotropic ? m_anisotropic.get() : nullptr,
+            m_roughness.get(),
+            m_has_spec_trans ? m_spec_trans.get() : nullptr,
+            m_has_metallic ? m_metallic.get() : nullptr,
+            m_has_clearcoat ? m_clearcoat.get() : nullptr
+        };
+        Float weight[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        Texture::eval_1_batch(weight_tex, 5, si, weight, active);
+        Float anisotropic = weight[0],
+              roughness = weight[1],
+              spec_trans = weight[2],
+              metallic = weight[3],
+              clearcoat = weight[4];
 
         // Weights of BSDF and BRDF major lobes
         Float brdf = (1.0f - metallic) * (1.0f - spec_trans),
@@ -502,14 +511,25 @@ public:
         if (unlikely(dr::none_or<false>(active)))
             return 0.0f;
 
-        // Store the weights.
-        Float anisotropic = m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-              roughness = m_roughness->eval_1(si, active),
-              flatness = m_has_flatness ? m_flatness->eval_1(si, active) : 0.0f,
-              spec_trans = m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f,
-              metallic = m_has_metallic ? m_metallic->eval_1(si, active) : 0.0f,
-              clearcoat = m_has_clearcoat ? m_clearcoat->eval_1(si, active) : 0.0f,
-              sheen = m_has_sheen ? m_sheen->eval_1(si, active) : 0.0f;
+        // Store the weights (evaluated as a batch to share texture lookups)
+        const Texture *weight_tex[] = {
+            m_has_anisotropic ? m_anisotropic.get() : nullptr,
+            m_roughness.get(),
+            m_has_flatness ? m_flatness.get() : nullptr,
+            m_has_spec_trans ? m_spec_trans.get() : nullptr,
+            m_has_metallic ? m_metallic.get() : nullptr,
+            m_has_clearcoat ? m_clearcoat.get() : nullptr,
+            m_has_sheen ? m_sheen.get() : nullptr
+        };
+        Float weight[7] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        Texture::eval_1_batch(weight_tex, 7, si, weight, active);
+        Float anisotropic = weight[0],
+              roughness = weight[1],
+              flatness = weight[2],
+              spec_trans = weight[3],
+              metallic = weight[4],
+              clearcoat = weight[5],
+              sheen = weight[6];
         UnpolarizedSpectrum base_color = m_base_color->eval(si, active);
 
         // Weights for BRDF and BSDF major lobes.
@@ -720,15 +740,21 @@ public:
         if (unlikely(dr::none_or<false>(active)))
             return 0.0f;
 
-        // Store the weights.
-        Float anisotropic =
-                m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-                roughness = m_roughness->eval_1(si, active),
-                spec_trans =
-                        m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f;
-        Float metallic = m_has_metallic ? m_metallic->eval_1(si, active) : 0.0f,
-        clearcoat =
-                m_has_clearcoat ? m_clearcoat->eval_1(si, active) : 0.0f;
+        // Store the weights (evaluated as a batch to share texture lookups)
+        const Texture *weight_tex[] = {
+            m_has_anisotropic ? m_anisotropic.get() : nullptr,
+            m_roughness.get(),
+            m_has_spec_trans ? m_spec_trans.get() : nullptr,
+            m_has_metallic ? m_metallic.get() : nullptr,
+            m_has_clearcoat ? m_clearcoat.get() : nullptr
+        };
+        Float weight[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        Texture::eval_1_batch(weight_tex, 5, si, weight, active);
+        Float anisotropic = weight[0],
+              roughness = weight[1],
+              spec_trans = weight[2],
+              metallic = weight[3],
+              clearcoat = weight[4];
 
         // BRDF and BSDF major lobe weights
         Float brdf = (1.0f - metallic) * (1.0f - spec_trans),
@@ -272,16 +272,21 @@ public:
         if (unlikely(dr::none_or<false>(active)))
             return { bs, 0.0f };
 
-        // Store the weights.
-        Float anisotropic =
-                m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-                roughness = m_roughness->eval_1(si, active),
-                spec_trans =
-                        m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f;
+        // Store the weights (evaluated as a batch to share texture lookups)
+        const Texture *weight_tex[] = {
+            m_has_anisotropic ? m_anisotropic.get() : nullptr,
+            m_roughness.get(),
+            m_has_spec_trans ? m_spec_trans.get() : nullptr,
+            m_has_diff_trans ? m_diff_trans.get() : nullptr
+        };
+        Float weight[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        Texture::eval_1_batch(weight_tex, 4, si, weight, active);
+        Float anisotropic = weight[0],
+              roughness = weight[1],
+              spec_trans = weight[2];
         /* Diffuse transmission weight. Normally, its range is 0-2, we
                make it 0-1 here. */
-        Float diff_trans =
-                m_has_diff_trans ? m_diff_trans->eval_1(si, active) / 2.0f : 0.0f;
+        Float diff_trans = weight[3] / 2.0f;
 
         // There is no negative incoming angle for a thin surface, so we
         // change the direction for back_side case. The direction change is
@@ -426,17 +431,24 @@ public:
         if (unlikely(dr::none_or<false>(active)))
             return 0.0f;
 
-        // Store the weights.
-        Float anisotropic =
-                m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-                roughness = m_roughness->eval_1(si, active),
-                flatness = m_has_flatness ? m_flatness->eval_1(si, active) : 0.0f,
-                spec_trans =
-                        m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f,
-                        eta_t = m_eta_thin->eval_1(si, active),
-                        // The range of diff_trans parameter is 0 to 2. It is made 0 to 1 here.
-                        diff_trans =
-                                m_has_diff_trans ? m_diff_trans->eval_1(si, active) / 2.0f : 0.0f;
+        // Store the weights (evaluated as a batch to share texture lookups)
+        const Texture *weight_tex[] = {
+            m_has_anisotropic ? m_anisotropic.get() : nullptr,
+            m_roughness.get(),
+            m_has_flatness ? m_flatness.get() : nullptr,
+            m_has_spec_trans ? m_spec_trans.get() : nullptr,
+            m_eta_thin.get(),
+            m_has_diff_trans ? m_diff_trans.get() : nullptr
+        };
+        Float weight[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        Texture::eval_1_batch(weight_tex, 6, si, weight, active);
+        Float anisotropic = weight[0],
+              roughness = weight[1],
+              flatness = weight[2],
+              spec_trans = weight[3],
+              eta_t = weight[4],
+              // The range of diff_trans parameter is 0 to 2. It is made 0 to 1 here.
+              diff_trans = weight[5] / 2.0f;
         UnpolarizedSpectrum base_color = m_base_color->eval(si, active);
 
         // Changing the signs in a way that we are always at the front side.
@@ -609,16 +621,22 @@ public:
         if (unlikely(dr::none_or<false>(active)))
             return 0.0f;
 
-        // Store the weights.
-        Float anisotropic =
-                m_has_anisotropic ? m_anisotropic->eval_1(si, active) : 0.0f,
-                roughness = m_roughness->eval_1(si, active),
-                spec_trans =
-                        m_has_spec_trans ? m_spec_trans->eval_1(si, active) : 0.0f,
-                        eta_t = m_eta_thin->eval_1(si, active),
-                        // The range of diff_trans parameter is 0 to 2. It is made 0 to 1 here
-                        diff_trans =
-                                m_has_diff_trans ? m_diff_trans->eval_1(si, active) / 2.0f : 0.0f;
+        // Store the weights (evaluated as a batch to share texture lookups)
+        const Texture *weight_tex[] = {
+            m_has_anisotropic ? m_anisotropic.get() : nullptr,
+            m_roughness.get(),
+            m_has_spec_trans ? m_spec_trans.get() : nullptr,
+            m_eta_thin.get(),
+            m_has_diff_trans ? m_diff_trans.get() : nullptr
+        };
+        Float weight[5] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        Texture::eval_1_batch(weight_tex, 5, si, weight, active);
+        Float anisotropic = weight[0],
+              roughness = weight[1],
+              spec_trans = weight[2],
+              eta_t = weight[3],
+              // The range of diff_trans parameter is 0 to 2. It is made 0 to 1 here
+              diff_trans = weight[4] / 2.0f;
 
         // Changing the signs in a way that we are always at the front side.
         // Thin BSDF is symmetric !!
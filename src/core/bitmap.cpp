@@ -7,6 +7,9 @@
 #include <mitsuba/core/transform.h>
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/thread.h>
+#include <atomic>
+#include <mutex>
 #include <unordered_map>
 #include <thread>
 
@@ -40,6 +43,9 @@ extern "C" {
 #include <ImfStandardAttributes.h>
 #include <ImfRgbaYca.h>
 #include <ImfOutputFile.h>
+#include <ImfTiledOutputFile.h>
+#include <ImfThreading.h>
+#include <OpenEXRConfig.h>
 #include <ImfChannelList.h>
 #include <ImfStringAttribute.h>
 #include <ImfIntAttribute.h>
@@ -522,8 +528,31 @@ void Bitmap::convert(Bitmap *target) const {
     }
 
     StructConverter conv(m_struct, target_struct, true);
-    bool rv = conv.convert_2d(m_size.x(), m_size.y(), uint8_data(), target->uint8_data());
-    if (!rv)
+
+    /* Convert strips of rows in parallel. Their height is a multiple of the
+       size of the dither matrix, which makes the result independent of the
+       partition. */
+    const size_t strip_height = 256,
+                 strip_count = (m_size.y() + strip_height - 1) / strip_height,
+                 source_row = m_size.x() * m_struct->size(),
+                 target_row = m_size.x() * target_struct->size();
+    std::atomic<bool> success(true);
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, strip_count, 1),
+        [&](const dr::blocked_range<size_t> &range) {
+            for (size_t i = range.begin(); i != range.end(); ++i) {
+                size_t y = i * strip_height,
+                       height = std::min(strip_height, (size_t) m_size.y() - y);
+                if (!conv.convert_2d(m_size.x(), height,
+                                     uint8_data() + y * source_row,
+                                     target->uint8_data() + y * target_row))
+                    success = false;
+            }
+        }
+    );
+
+    if (!success)
         Throw("Bitmap::convert(): conversion kernel indicated a failure!");
 }
 
@@ -773,8 +802,11 @@ void Bitmap::write(Stream *stream, FileFormat format, int quality) const {
     );
 
     switch (format) {
-        case FileFormat::OpenEXR:
-            write_exr(stream, quality);
+        case FileFormat::OpenEXR: {
+                ExrWriteOptions options;
+                options.compression_level = (float) quality;
+                write_exr(stream, options);
+            }
             break;
 
         case FileFormat::PNG:
@@ -815,6 +847,23 @@ void Bitmap::write_async(const fs::path &path, FileFormat format, int quality) c
     Thread::register_task(task);
 }
 
+void Bitmap::write_exr(const fs::path &path, const ExrWriteOptions &options) const {
+    ref<FileStream> fs = new FileStream(path, FileStream::ETruncReadWrite);
+    Log(Debug, "Writing OpenEXR file \"%s\" (%ix%i, %s, %s, %s compression) ..",
+        path.string(), m_size.x(), m_size.y(), m_pixel_format,
+        m_component_format, options.compression);
+    write_exr(fs.get(), options);
+}
+
+void Bitmap::write_exr_async(const fs::path &path, const ExrWriteOptions &options) const {
+    this->inc_ref();
+    Task *task = dr::do_async([path, options, this](){
+        write_exr(path, options);
+        this->dec_ref();
+    });
+    Thread::register_task(task);
+}
+
 bool Bitmap::operator==(const Bitmap &bitmap) const {
     if (m_pixel_format != bitmap.m_pixel_format ||
         m_component_format != bitmap.m_component_format ||
@@ -1323,7 +1372,7 @@ void Bitmap::read_exr(Stream *stream) {
     }
 }
 
-void Bitmap::write_exr(Stream *stream, int quality) const {
+void Bitmap::write_exr(Stream *stream, const ExrWriteOptions &options) const {
     ScopedPhase phase(ProfilerPhase::BitmapWrite);
 
     PixelFormat pixel_format = m_pixel_format;
@@ -1334,6 +1383,22 @@ void Bitmap::write_exr(Stream *stream, int quality) const {
 
     std::vector<std::string> keys = metadata.property_names();
 
+    float level = options.compression_level;
+    Imf::Compression compression;
+    switch (options.compression) {
+        case ExrCompression::Auto:
+            compression = level > 0.f ? Imf::DWAB_COMPRESSION : Imf::PIZ_COMPRESSION;
+            break;
+        case ExrCompression::Uncompressed: compression = Imf::NO_COMPRESSION;   break;
+        case ExrCompression::RLE:          compression = Imf::RLE_COMPRESSION;  break;
+        case ExrCompression::ZIPS:         compression = Imf::ZIPS_COMPRESSION; break;
+        case ExrCompression::ZIP:          compression = Imf::ZIP_COMPRESSION;  break;
+        case ExrCompression::PIZ:          compression = Imf::PIZ_COMPRESSION;  break;
+        case ExrCompression::DWAA:         compression = Imf::DWAA_COMPRESSION; break;
+        case ExrCompression::DWAB:         compression = Imf::DWAB_COMPRESSION; break;
+        default: Throw("write_exr(): invalid compression method!");
+    }
+
     Imf::Header header(
         (int) m_size.x(),  // width
         (int) m_size.y(),  // height,
@@ -1341,11 +1406,30 @@ void Bitmap::write_exr(Stream *stream, int quality) const {
         Imath::V2f(0, 0),  // screenWindowCenter,
         1.f,               // screenWindowWidth
         Imf::INCREASING_Y, // lineOrder
-        quality <= 0 ? Imf::PIZ_COMPRESSION : Imf::DWAB_COMPRESSION // compression
+        compression        // compression
     );
 
-    if (quality > 0)
-        Imf::addDwaCompressionLevel(header, float(quality));
+    if (level > 0.f) {
+        if (compression == Imf::DWAA_COMPRESSION ||
+            compression == Imf::DWAB_COMPRESSION) {
+            Imf::addDwaCompressionLevel(header, level);
+        } else if (compression == Imf::ZIP_COMPRESSION ||
+                   compression == Imf::ZIPS_COMPRESSION) {
+#if OPENEXR_VERSION_MAJOR > 3 || (OPENEXR_VERSION_MAJOR == 3 && OPENEXR_VERSION_MINOR >= 1)
+            header.zipCompressionLevel() = std::min(std::max((int) level, 1), 9);
+#else
+            Log(Warn, "write_exr(): this version of OpenEXR does not support "
+                      "setting the ZIP compression level, ignoring.");
+#endif
+        }
+    }
+
+    if (options.tiled) {
+        if (options.tile_size == 0)
+            Throw("write_exr(): the tile size must be positive!");
+        header.setTileDescription(Imf::TileDescription(
+            options.tile_size, options.tile_size, Imf::ONE_LEVEL));
+    }
 
     for (auto it = keys.begin(); it != keys.end(); ++it) {
         using Type = Properties::Type;
@@ -1420,15 +1504,38 @@ void Bitmap::write_exr(Stream *stream, int quality) const {
             default: Throw("Unexpected field type!");
         }
 
+        // Optionally store floating point channels using a different precision
+        Imf::PixelType file_type = comp_type;
+        auto it = options.channel_formats.find(field.name);
+        if (it != options.channel_formats.end() && comp_type != Imf::UINT) {
+            if (it->second == Struct::Type::Float16)
+                file_type = Imf::HALF;
+            else if (it->second == Struct::Type::Float32)
+                file_type = Imf::FLOAT;
+            else
+                Throw("write_exr(): channel \"%s\" can only be stored as "
+                      "Float16 or Float32!", field.name);
+        }
+
         Imf::Slice slice(comp_type, (char *) (ptr + field.offset), pixel_stride, row_stride);
-        channels.insert(field.name, Imf::Channel(comp_type));
+        channels.insert(field.name, Imf::Channel(file_type));
         framebuffer.insert(field.name, slice);
     }
 
+    /* OpenEXR compresses chunks of the image in parallel using the global
+       thread pool, which dispatches the work to nanothread (EXRThreadPool) */
+    int thread_count = Imf::globalThreadCount();
+
     EXROStream ostr(stream);
-    Imf::OutputFile file(ostr, header);
-    file.setFrameBuffer(framebuffer);
-    file.writePixels((int) m_size.y());
+    if (options.tiled) {
+        Imf::TiledOutputFile file(ostr, header, thread_count);
+        file.setFrameBuffer(framebuffer);
+        file.writeTiles(0, file.numXTiles() - 1, 0, file.numYTiles() - 1);
+    } else {
+        Imf::OutputFile file(ostr, header, thread_count);
+        file.setFrameBuffer(framebuffer);
+        file.writePixels((int) m_size.y());
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -2528,6 +2635,21 @@ std::ostream &operator<<(std::ostream &os, Bitmap::FileFormat value) {
     return os;
 }
 
+std::ostream &operator<<(std::ostream &os, Bitmap::ExrCompression value) {
+    switch (value) {
+        case Bitmap::ExrCompression::Auto:         os << "auto"; break;
+        case Bitmap::ExrCompression::Uncompressed: os << "none"; break;
+        case Bitmap::ExrCompression::RLE:          os << "rle";  break;
+        case Bitmap::ExrCompression::ZIPS:         os << "zips"; break;
+        case Bitmap::ExrCompression::ZIP:          os << "zip";  break;
+        case Bitmap::ExrCompression::PIZ:          os << "piz";  break;
+        case Bitmap::ExrCompression::DWAA:         os << "dwaa"; break;
+        case Bitmap::ExrCompression::DWAB:         os << "dwab"; break;
+        default: Throw("Unknown compression method!");
+    }
+    return os;
+}
+
 std::ostream &operator<<(std::ostream &os, Bitmap::AlphaTransform value) {
     switch (value) {
         case Bitmap::AlphaTransform::Empty:    os << "none";    break;
@@ -2539,11 +2661,71 @@ std::ostream &operator<<(std::ostream &os, Bitmap::AlphaTransform value) {
 }
 
 
+struct PrefetchedBitmap {
+    Task *task = nullptr;
+    ref<Bitmap> bitmap;
+};
+
+static std::mutex prefetch_mutex;
+static std::unordered_map<std::string, std::shared_ptr<PrefetchedBitmap>> prefetch_map;
+
+void Bitmap::prefetch(const fs::path &path) {
+    std::lock_guard<std::mutex> guard(prefetch_mutex);
+    std::shared_ptr<PrefetchedBitmap> &entry = prefetch_map[path.string()];
+    if (entry)
+        return;
+
+    entry = std::make_shared<PrefetchedBitmap>();
+    ThreadEnvironment env;
+    entry->task = dr::do_async([entry = entry.get(), path, env]() mutable {
+        ScopedSetThreadEnvironment set_env(env);
+        try {
+            entry->bitmap = new Bitmap(path);
+        } catch (const std::exception &e) {
+            // Reported when the image is requested
+            Log(Debug, "Bitmap::prefetch(): could not load \"%s\": %s", path, e.what());
+        }
+    });
+}
+
+ref<Bitmap> Bitmap::load_prefetched(const fs::path &path) {
+    std::shared_ptr<PrefetchedBitmap> entry;
+    {
+        std::lock_guard<std::mutex> guard(prefetch_mutex);
+        auto it = prefetch_map.find(path.string());
+        if (it != prefetch_map.end()) {
+            entry = std::move(it->second);
+            prefetch_map.erase(it);
+        }
+    }
+
+    if (entry) {
+        task_wait_and_release(entry->task);
+        if (entry->bitmap)
+            return entry->bitmap;
+    }
+
+    // Not prefetched or failed: load now (and raise the error, if any)
+    return new Bitmap(path);
+}
+
+void Bitmap::clear_prefetched() {
+    std::unordered_map<std::string, std::shared_ptr<PrefetchedBitmap>> entries;
+    {
+        std::lock_guard<std::mutex> guard(prefetch_mutex);
+        entries.swap(prefetch_map);
+    }
+    for (auto &kv : entries)
+        task_wait_and_release(kv.second->task);
+}
+
 void Bitmap::static_initialization() {
     IlmThread::ThreadPool::globalThreadPool().setThreadProvider(new EXRThreadPool());
 }
 
-void Bitmap::static_shutdown() { }
+void Bitmap::static_shutdown() {
+    clear_prefetched();
+}
 
 MI_IMPLEMENT_CLASS(Bitmap, Object)
 
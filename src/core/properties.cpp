@@ -1,14 +1,20 @@
 #if defined(_MSC_VER)
-#  pragma warning (disable: 4324) // warning C4324: 'std::pair<const std::string,mitsuba::Entry>': structure was padded due to alignment specifier
+#  pragma warning (disable: 4324) // warning C4324: 'mitsuba::Entry': structure was padded due to alignment specifier
 #  define _ENABLE_EXTENDED_ALIGNED_STORAGE
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <iostream>
-#include <map>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
 #include <sstream>
 #include <cstring>
 #include <climits>
+#include <string_view>
+#include <unordered_map>
 
 #include <drjit/tensor.h>
 
@@ -41,8 +47,105 @@ using VariantType = variant<
     const void *
 >;
 
+/**
+ * \brief Reference-counted handle to an interned property name
+ *
+ * Plugins are instantiated with the same few dozen parameter names over and
+ * over again. Interning them means that entries only store a pointer, which
+ * makes copying a \ref Properties instance cheap and avoids a string
+ * allocation per entry. Names such as object IDs are not bounded, however,
+ * hence each interned name tracks how many entries refer to it and is removed
+ * from the table once the last one is destroyed.
+ *
+ * References are only created from zero while holding the shared lock and
+ * only dropped to zero while holding the exclusive lock, which ensures that
+ * a name is never looked up while it is being released.
+ */
+class Key {
+public:
+    explicit Key(const std::string &name) {
+        Table &t = table();
+        {
+            std::shared_lock guard(t.mutex);
+            auto it = t.keys.find(name);
+            if (it != t.keys.end()) {
+                m_node = &*it;
+                m_node->second++;
+                return;
+            }
+        }
+
+        std::unique_lock guard(t.mutex);
+        m_node = &*t.keys.try_emplace(name, 0).first;
+        m_node->second++;
+    }
+
+    Key(const Key &k) : m_node(k.m_node) { m_node->second++; }
+    Key(Key &&k) noexcept : m_node(k.m_node) { k.m_node = nullptr; }
+    ~Key() { release(); }
+
+    Key &operator=(const Key &k) {
+        if (m_node != k.m_node) {
+            k.m_node->second++;
+            release();
+            m_node = k.m_node;
+        }
+        return *this;
+    }
+
+    Key &operator=(Key &&k) noexcept {
+        if (this != &k) {
+            release();
+            m_node = k.m_node;
+            k.m_node = nullptr;
+        }
+        return *this;
+    }
+
+    const std::string &operator*() const { return m_node->first; }
+    const std::string *operator->() const { return &m_node->first; }
+
+private:
+    using Node = std::pair<const std::string, std::atomic<uint32_t>>;
+
+    struct Table {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, std::atomic<uint32_t>> keys;
+    };
+
+    static Table &table() {
+        // Leaked so that static Properties instances can still be destroyed
+        static Table *t = new Table();
+        return *t;
+    }
+
+    void release() {
+        if (!m_node)
+            return;
+
+        uint32_t refs = m_node->second.load();
+        while (refs > 1) {
+            if (m_node->second.compare_exchange_weak(refs, refs - 1)) {
+                m_node = nullptr;
+                return;
+            }
+        }
+
+        Table &t = table();
+        std::unique_lock guard(t.mutex);
+        if (--m_node->second == 0)
+            t.keys.erase(t.keys.find(m_node->first));
+        m_node = nullptr;
+    }
+
+private:
+    Node *m_node;
+};
+
 struct alignas(32) Entry {
     VariantType data;
+    /// Interned property name
+    Key key;
     bool queried;
 };
 
@@ -71,24 +174,222 @@ struct SortKey {
 
         return std::strcmp(a_ptr, b_ptr) < 0;
     }
+
+    bool operator()(const Entry *a, const Entry *b) const {
+        return operator()(*a->key, *b->key);
+    }
 };
 
+/**
+ * \brief Vector that stores up to \c N elements inline before switching to
+ * heap storage
+ *
+ * The order of elements is not preserved by \ref swap_remove().
+ */
+template <typename T, size_t N> class SmallVector {
+public:
+    SmallVector() = default;
+
+    SmallVector(const SmallVector &v) { copy_from(v); }
+
+    SmallVector(SmallVector &&v) noexcept { move_from(v); }
+
+    ~SmallVector() { release(); }
+
+    SmallVector &operator=(const SmallVector &v) {
+        if (this != &v) {
+            clear();
+            copy_from(v);
+        }
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&v) noexcept {
+        if (this != &v) {
+            release();
+            move_from(v);
+        }
+        return *this;
+    }
+
+    size_t size() const { return m_size; }
+
+    T &operator[](size_t i) { return m_data[i]; }
+    const T &operator[](size_t i) const { return m_data[i]; }
+
+    T *begin() { return m_data; }
+    T *end() { return m_data + m_size; }
+    const T *begin() const { return m_data; }
+    const T *end() const { return m_data + m_size; }
+
+    template <typename... Args> T &emplace_back(Args &&...args) {
+        if (m_size == m_capacity)
+            reserve(m_capacity * 2);
+        T *ptr = new (m_data + m_size) T{ std::forward<Args>(args)... };
+        m_size++;
+        return *ptr;
+    }
+
+    /// Remove the element at index \c i by moving the last element in its place
+    void swap_remove(size_t i) {
+        if (i + 1 != m_size)
+            m_data[i] = std::move(m_data[m_size - 1]);
+        m_data[--m_size].~T();
+    }
+
+    void clear() {
+        for (size_t i = 0; i < m_size; ++i)
+            m_data[i].~T();
+        m_size = 0;
+    }
+
+    void reserve(size_t capacity) {
+        if (capacity <= m_capacity)
+            return;
+        T *data = (T *) ::operator new(capacity * sizeof(T),
+                                       std::align_val_t(alignof(T)));
+        for (size_t i = 0; i < m_size; ++i) {
+            new (data + i) T(std::move(m_data[i]));
+            m_data[i].~T();
+        }
+        if (!is_inline())
+            ::operator delete(m_data, std::align_val_t(alignof(T)));
+        m_data = data;
+        m_capacity = capacity;
+    }
+
+private:
+    bool is_inline() const { return m_data == (const T *) m_inline; }
+
+    void copy_from(const SmallVector &v) {
+        reserve(v.m_size);
+        for (size_t i = 0; i < v.m_size; ++i)
+            new (m_data + i) T(v.m_data[i]);
+        m_size = v.m_size;
+    }
+
+    /// Take over the contents of 'v' (which must be empty afterwards)
+    void move_from(SmallVector &v) noexcept {
+        if (v.is_inline()) {
+            for (size_t i = 0; i < v.m_size; ++i) {
+                new (m_data + i) T(std::move(v.m_data[i]));
+                v.m_data[i].~T();
+            }
+        } else {
+            m_data = v.m_data;
+            m_capacity = v.m_capacity;
+            v.m_data = (T *) v.m_inline;
+            v.m_capacity = N;
+        }
+        m_size = v.m_size;
+        v.m_size = 0;
+    }
+
+    /// Destroy all elements and return to inline storage
+    void release() {
+        clear();
+        if (!is_inline())
+            ::operator delete(m_data, std::align_val_t(alignof(T)));
+        m_data = (T *) m_inline;
+        m_capacity = N;
+    }
+
+private:
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+    T *m_data = (T *) m_inline;
+    size_t m_size = 0;
+    size_t m_capacity = N;
+};
+
+/**
+ * Entries are stored in a flat array in insertion order. Most plugins only
+ * receive a few parameters that fit into the inline storage, in which case
+ * lookups are a linear scan. Larger instances (e.g. a scene with thousands of
+ * children) additionally maintain a hash table index. Functions that expose
+ * the set of properties sort them using \ref SortKey.
+ */
 struct Properties::PropertiesPrivate {
-    std::map<std::string, Entry, SortKey> entries;
+    /**
+     * Number of entries stored without a heap allocation. This covers the
+     * parameters of a typical shape (e.g. filename, to_world, BSDF reference,
+     * and a few flags).
+     */
+    static constexpr size_t InlineSize = 6;
+    /// Number of entries above which lookups go through the index
+    static constexpr size_t IndexThreshold = 16;
+
+    SmallVector<Entry, InlineSize> entries;
+    std::unordered_map<std::string_view, uint32_t> index;
     std::string id, plugin_name;
-};
 
-using Iterator = typename std::map<std::string, Entry, SortKey>::iterator;
+    Entry *find(const std::string &name) {
+        if (entries.size() > IndexThreshold) {
+            auto it = index.find(name);
+            return it != index.end() ? &entries[it->second] : nullptr;
+        }
+        for (Entry &e : entries) {
+            if (e.key->size() == name.size() &&
+                std::memcmp(e.key->data(), name.data(), name.size()) == 0)
+                return &e;
+        }
+        return nullptr;
+    }
+
+    /// Look up an entry for writing, creating it if necessary
+    Entry &insert(const std::string &name, bool error_duplicates) {
+        Entry *entry = find(name);
+        if (entry) {
+            if (error_duplicates)
+                Log(Error, "Property \"%s\" was specified multiple times!", name);
+            return *entry;
+        }
+        return append(Key(name));
+    }
+
+    Entry &append(Key key) {
+        Entry &entry = entries.emplace_back(VariantType(), std::move(key), false);
+        if (entries.size() == IndexThreshold + 1) {
+            index.reserve(entries.size() * 2);
+            for (size_t i = 0; i < entries.size(); ++i)
+                index.emplace(*entries[i].key, (uint32_t) i);
+        } else if (entries.size() > IndexThreshold) {
+            index.emplace(*entry.key, (uint32_t) entries.size() - 1);
+        }
+        return entry;
+    }
+
+    void remove(Entry *entry) {
+        size_t i = entry - entries.begin(), last = entries.size() - 1;
+        if (!index.empty()) {
+            index.erase(*entry->key);
+            if (i != last)
+                index[*entries[last].key] = (uint32_t) i;
+        }
+        entries.swap_remove(i);
+        if (entries.size() <= IndexThreshold)
+            index.clear();
+    }
+
+    /// Return pointers to all entries in the order defined by \ref SortKey
+    std::vector<Entry *> sorted() {
+        std::vector<Entry *> result;
+        result.reserve(entries.size());
+        for (Entry &e : entries)
+            result.push_back(&e);
+        std::sort(result.begin(), result.end(), SortKey());
+        return result;
+    }
+};
 
 template <typename T, typename T2 = T>
-T get_impl(const Iterator &it) {
-    if (!it->second.data.template is<T>() && !it->second.data.template is<T2>())
+T get_impl(Entry &entry) {
+    if (!entry.data.template is<T>() && !entry.data.template is<T2>())
         Throw("The property \"%s\" has the wrong type (expected <%s> or <%s>, is <%s>)",
-              it->first, typeid(T).name(), typeid(T2).name(), it->second.data.type().name());
-    it->second.queried = true;
-    if (it->second.data.template is<T2>())
-        return (T const &) (T2 const &) it->second.data;
-    return (T const &) it->second.data;
+              *entry.key, typeid(T).name(), typeid(T2).name(), entry.data.type().name());
+    entry.queried = true;
+    if (entry.data.template is<T2>())
+        return (T const &) (T2 const &) entry.data;
+    return (T const &) entry.data;
 }
 
 
@@ -98,108 +399,107 @@ T get_impl(const Iterator &it) {
  * backwards compatibility
  */
 template<>
-Transform3f get_impl<Transform3f, Transform4f>(const Iterator &it) {
-    if (!it->second.data.template is<Transform3f>() && !it->second.data.template is<Transform4f>())
+Transform3f get_impl<Transform3f, Transform4f>(Entry &entry) {
+    if (!entry.data.template is<Transform3f>() && !entry.data.template is<Transform4f>())
         Throw("The property \"%s\" has the wrong type (expected <%s> or <%s>, is <%s>)",
-              it->first, typeid(Transform3f).name(), typeid(Transform4f).name(), it->second.data.type().name());
-    it->second.queried = true;
-    if (it->second.data.template is<Transform4f>())
-        return ((Transform4f const &)it->second.data).extract();
-    return (Transform3f const &) it->second.data;
+              *entry.key, typeid(Transform3f).name(), typeid(Transform4f).name(), entry.data.type().name());
+    entry.queried = true;
+    if (entry.data.template is<Transform4f>())
+        return ((Transform4f const &) entry.data).extract();
+    return (Transform3f const &) entry.data;
 }
 
 template <typename T>
-T get_routing(const Iterator &it) {
+T get_routing(Entry &entry) {
     if constexpr (dr::is_static_array_v<T>) {
         Assert(T::Size == 3);
         if constexpr (std::is_same_v<T, Color<float, 3>> ||
                       std::is_same_v<T, Color<double, 3>>)
-            return (T) get_impl<Color3f, Array3f>(it);
+            return (T) get_impl<Color3f, Array3f>(entry);
         else
-            return (T) get_impl<Array3f>(it);
+            return (T) get_impl<Array3f>(entry);
     }
 
     if constexpr (std::is_same_v<T, TensorHandle>)
-        return get_impl<TensorHandle>(it);
+        return get_impl<TensorHandle>(entry);
 
     if constexpr (std::is_same_v<T, Transform<Point<float, 3>>> ||
                   std::is_same_v<T, Transform<Point<double, 3>>>)
-        return (T) get_impl<Transform3f, Transform4f>(it);
+        return (T) get_impl<Transform3f, Transform4f>(entry);
 
     if constexpr (std::is_same_v<T, Transform<Point<float, 4>>> ||
                   std::is_same_v<T, Transform<Point<double, 4>>>)
-        return (T) get_impl<Transform4f>(it);
+        return (T) get_impl<Transform4f>(entry);
 
     if constexpr (std::is_floating_point_v<T>)
-        return (T) get_impl<Float, int64_t>(it);
+        return (T) get_impl<Float, int64_t>(entry);
 
     if constexpr (std::is_same_v<T, ref<Object>>)
-        return get_impl<ref<Object>>(it);
+        return get_impl<ref<Object>>(entry);
 
     if constexpr (std::is_same_v<T, bool>)
-        return get_impl<T>(it);
+        return get_impl<T>(entry);
 
     if constexpr (std::is_integral_v<T> && !std::is_pointer_v<T>) {
-        int64_t v = get_impl<int64_t>(it);
+        int64_t v = get_impl<int64_t>(entry);
         if constexpr (std::is_unsigned_v<T>) {
             if (v < 0) {
                 Throw("Property \"%s\" has negative value %i, but was queried as a"
-                    " size_t (unsigned).", it->first, v);
+                    " size_t (unsigned).", *entry.key, v);
             }
         }
         return (T) v;
     }
 
     if constexpr (std::is_same_v<T, std::string>)
-        return get_impl<T>(it);
+        return get_impl<T>(entry);
 
     Throw("Unsupported type: <%s>.", typeid(T).name());
 }
 
 template <typename T>
 T Properties::get(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         Throw("Property \"%s\" has not been specified!", name);
-    return get_routing<T>(it);
+    return get_routing<T>(*entry);
 }
 
 template <typename T>
 T Properties::get(const std::string &name, const T &def_val) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         return def_val;
-    return get_routing<T>(it);
+    return get_routing<T>(*entry);
 }
 #define DEFINE_PROPERTY_SETTER(Type, SetterName) \
     void Properties::SetterName(const std::string &name, Type const &value, bool error_duplicates) { \
-        if (has_property(name) && error_duplicates) \
-            Log(Error, "Property \"%s\" was specified multiple times!", name); \
-        d->entries[name].data = (Type) value; \
-        d->entries[name].queried = false; \
+        Entry &entry = d->insert(name, error_duplicates); \
+        entry.data = (Type) value; \
+        entry.queried = false; \
     }
 
 #define DEFINE_PROPERTY_ACCESSOR(Type, TagName, SetterName, GetterName) \
     DEFINE_PROPERTY_SETTER(Type, SetterName) \
     \
     Type const & Properties::GetterName(const std::string &name) const { \
-        const auto it = d->entries.find(name); \
-        if (it == d->entries.end()) \
+        Entry *entry = d->find(name); \
+        if (!entry) \
             Throw("Property \"%s\" has not been specified!", name); \
-        if (!it->second.data.is<Type>()) \
+        if (!entry->data.is<Type>()) \
             Throw("The property \"%s\" has the wrong type (expected <" #TagName ">).", name); \
-        it->second.queried = true; \
-        return (Type const &) it->second.data; \
+        entry->queried = true; \
+        return (Type const &) entry->data; \
     } \
     \
     Type const & Properties::GetterName(const std::string &name, Type const &def_val) const { \
-        const auto it = d->entries.find(name); \
-        if (it == d->entries.end()) \
+        Entry *entry = d->find(name); \
+        if (!entry) \
             return def_val; \
-        if (!it->second.data.is<Type>()) \
+        if (!entry->data.is<Type>()) \
             Throw("The property \"%s\" has the wrong type (expected <" #TagName ">).", name); \
-        it->second.queried = true; \
-        return (Type const &) it->second.data; \
+        entry->queried = true; \
+        return (Type const &) entry->data; \
     }
 
 DEFINE_PROPERTY_SETTER(bool,         set_bool)
@@ -226,14 +526,24 @@ Properties::Properties(const std::string &plugin_name)
 Properties::Properties(const Properties &props)
     : d(new PropertiesPrivate(*props.d)) { }
 
+Properties::Properties(Properties &&props) noexcept
+    : d(std::move(props.d)) { }
+
 Properties::~Properties() { }
 
 void Properties::operator=(const Properties &props) {
-    (*d) = *props.d;
+    if (d)
+        (*d) = *props.d;
+    else
+        d.reset(new PropertiesPrivate(*props.d));
+}
+
+void Properties::operator=(Properties &&props) noexcept {
+    d.swap(props.d);
 }
 
 bool Properties::has_property(const std::string &name) const {
-    return d->entries.find(name) != d->entries.end();
+    return d->find(name) != nullptr;
 }
 
 namespace {
@@ -274,33 +584,33 @@ namespace {
 }
 
 Properties::Type Properties::type(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         Throw("type(): Could not find property named \"%s\"!", name);
 
-    return it->second.data.visit(PropertyTypeVisitor());
+    return entry->data.visit(PropertyTypeVisitor());
 }
 
 bool Properties::mark_queried(const std::string &name) const {
-    auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         return false;
-    it->second.queried = true;
+    entry->queried = true;
     return true;
 }
 
 bool Properties::was_queried(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         Throw("Could not find property named \"%s\"!", name);
-    return it->second.queried;
+    return entry->queried;
 }
 
 bool Properties::remove_property(const std::string &name) {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         return false;
-    d->entries.erase(it);
+    d->remove(entry);
     return true;
 }
 
@@ -323,29 +633,32 @@ void Properties::set_id(const std::string &id) {
 void Properties::copy_attribute(const Properties &properties,
                                 const std::string &source_name,
                                 const std::string &target_name) {
-    const auto it = properties.d->entries.find(source_name);
-    if (it == properties.d->entries.end())
+    Entry *source = properties.d->find(source_name);
+    if (!source)
         Throw("copy_attribute(): Could not find parameter \"%s\"!", source_name);
-    d->entries[target_name] = it->second;
+    Entry entry = *source;
+    Entry &target = d->insert(target_name, false);
+    target.data = std::move(entry.data);
+    target.queried = entry.queried;
 }
 
 std::vector<std::string> Properties::property_names() const {
     std::vector<std::string> result;
-    for (const auto &e : d->entries)
-        result.push_back(e.first);
+    result.reserve(d->entries.size());
+    for (Entry *e : d->sorted())
+        result.push_back(*e->key);
     return result;
 }
 
 std::vector<std::pair<std::string, NamedReference>> Properties::named_references() const {
     std::vector<std::pair<std::string, NamedReference>> result;
     result.reserve(d->entries.size());
-    for (auto &e : d->entries) {
-        auto type = e.second.data.visit(PropertyTypeVisitor());
-        if (type != Type::NamedReference)
+    for (Entry *e : d->sorted()) {
+        if (!e->data.is<NamedReference>())
             continue;
-        auto const &value = (const NamedReference &) e.second.data;
-        result.push_back(std::make_pair(e.first, value));
-        e.second.queried = true;
+        auto const &value = (const NamedReference &) e->data;
+        result.push_back(std::make_pair(*e->key, value));
+        e->queried = true;
     }
     return result;
 }
@@ -353,29 +666,35 @@ std::vector<std::pair<std::string, NamedReference>> Properties::named_references
 std::vector<std::pair<std::string, ref<Object>>> Properties::objects(bool mark_queried) const {
     std::vector<std::pair<std::string, ref<Object>>> result;
     result.reserve(d->entries.size());
-    for (auto &e : d->entries) {
-        auto type = e.second.data.visit(PropertyTypeVisitor());
-        if (type != Type::Object)
+    for (Entry *e : d->sorted()) {
+        if (!e->data.is<ref<Object>>())
             continue;
-        result.push_back(std::make_pair(e.first, (const ref<Object> &) e.second));
+        result.push_back(std::make_pair(*e->key, (const ref<Object> &) e->data));
         if (mark_queried)
-            e.second.queried = true;
+            e->queried = true;
     }
     return result;
 }
 
 std::vector<std::string> Properties::unqueried() const {
     std::vector<std::string> result;
-    for (const auto &e : d->entries) {
-        if (!e.second.queried)
-            result.push_back(e.first);
+    for (Entry &e : d->entries) {
+        if (!e.queried)
+            result.push_back(*e.key);
     }
+    if (result.size() > 1)
+        std::sort(result.begin(), result.end(), SortKey());
     return result;
 }
 
 void Properties::merge(const Properties &p) {
-    for (const auto &e : p.d->entries)
-        d->entries[e.first] = e.second;
+    for (const Entry &e : p.d->entries) {
+        Entry *entry = d->find(*e.key);
+        if (!entry)
+            entry = &d->append(e.key);
+        entry->data = e.data;
+        entry->queried = e.queried;
+    }
 }
 
 bool Properties::operator==(const Properties &p) const {
@@ -384,11 +703,11 @@ bool Properties::operator==(const Properties &p) const {
         d->entries.size() != p.d->entries.size())
         return false;
 
-    for (const auto &e : d->entries) {
-        auto it = p.d->entries.find(e.first);
-        if (it == p.d->entries.end())
+    for (const Entry &e : d->entries) {
+        Entry *entry = p.d->find(*e.key);
+        if (!entry)
             return false;
-        if (e.second.data != it->second.data)
+        if (e.data != entry->data)
             return false;
     }
 
@@ -396,46 +715,34 @@ bool Properties::operator==(const Properties &p) const {
 }
 
 std::string Properties::as_string(const std::string &name) const {
+    Entry *entry = d->find(name);
+    if (!entry)
+        Throw("Property \"%s\" has not been specified!", name);
     std::ostringstream oss;
-    bool found = false;
-    for (auto &e : d->entries) {
-        if (e.first != name)
-            continue;
-        e.second.data.visit(StreamVisitor(oss));
-        found = true;
-        break;
-    }
-    if (!found)
-        Throw("Property \"%s\" has not been specified!", name); \
+    entry->data.visit(StreamVisitor(oss));
     return oss.str();
 }
 
 std::string Properties::as_string(const std::string &name, const std::string &def_val) const {
-    std::ostringstream oss;
-    bool found = false;
-    for (auto &e : d->entries) {
-        if (e.first != name)
-            continue;
-        e.second.data.visit(StreamVisitor(oss));
-        found = true;
-        break;
-    }
-    if (!found)
+    Entry *entry = d->find(name);
+    if (!entry)
         return def_val;
+    std::ostringstream oss;
+    entry->data.visit(StreamVisitor(oss));
     return oss.str();
 }
 
 std::ostream &operator<<(std::ostream &os, const Properties &p) {
-    auto it = p.d->entries.begin();
+    std::vector<Entry *> entries = p.d->sorted();
 
     os << "Properties[" << std::endl
        << "  plugin_name = \"" << (p.d->plugin_name) << "\"," << std::endl
        << "  id = \"" << p.d->id << "\"," << std::endl
        << "  elements = {" << std::endl;
-    while (it != p.d->entries.end()) {
-        os << "    \"" << it->first << "\" -> ";
-        it->second.data.visit(StreamVisitor(os));
-        if (++it != p.d->entries.end()) os << ",";
+    for (size_t i = 0; i < entries.size(); ++i) {
+        os << "    \"" << *entries[i]->key << "\" -> ";
+        entries[i]->data.visit(StreamVisitor(os));
+        if (i + 1 < entries.size()) os << ",";
         os << std::endl;
     }
     os << "  }" << std::endl
@@ -450,18 +757,16 @@ std::ostream &operator<<(std::ostream &os, const Properties &p) {
 
 /// Float setter
 void Properties::set_float(const std::string &name, const Float &value, bool error_duplicates) {
-    if (has_property(name) && error_duplicates)
-        Log(Error, "Property \"%s\" was specified multiple times!", name);
-    d->entries[name].data = (Float) value;
-    d->entries[name].queried = false;
+    Entry &entry = d->insert(name, error_duplicates);
+    entry.data = (Float) value;
+    entry.queried = false;
 }
 
 /// Array3f setter
 void Properties::set_array3f(const std::string &name, const Array3f &value, bool error_duplicates) {
-    if (has_property(name) && error_duplicates)
-        Log(Error, "Property \"%s\" was specified multiple times!", name);
-    d->entries[name].data = (Array3f) value;
-    d->entries[name].queried = false;
+    Entry &entry = d->insert(name, error_duplicates);
+    entry.data = (Array3f) value;
+    entry.queried = false;
 }
 
 #if 0
@@ -469,10 +774,9 @@ void Properties::set_array3f(const std::string &name, const Array3f &value, bool
 void Properties::set_animated_transform(const std::string &name,
                                         ref<AnimatedTransform> value,
                                         bool error_duplicates) {
-    if (has_property(name) && error_duplicates)
-        Log(Error, "Property \"%s\" was specified multiple times!", name);
-    d->entries[name].data = ref<Object>(value.get());
-    d->entries[name].queried = false;
+    Entry &entry = d->insert(name, error_duplicates);
+    entry.data = ref<Object>(value.get());
+    entry.queried = false;
 }
 
 /// AnimatedTransform setter (from a simple Transform).
@@ -485,50 +789,50 @@ void Properties::set_animated_transform(const std::string &name,
 
 /// AnimatedTransform getter (without default value).
 ref<AnimatedTransform> Properties::animated_transform(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         Throw("Property \"%s\" has not been specified!", name);
-    if (it->second.data.is<Transform4f>()) {
+    if (entry->data.is<Transform4f>()) {
         // Also accept simple transforms, from which we can build
         // an AnimatedTransform.
-        it->second.queried = true;
+        entry->queried = true;
         return new AnimatedTransform(
-            static_cast<const Transform4f &>(it->second.data));
+            static_cast<const Transform4f &>(entry->data));
     }
-    if (!it->second.data.is<ref<Object>>()) {
+    if (!entry->data.is<ref<Object>>()) {
         Throw("The property \"%s\" has the wrong type (expected "
               " <animated_transform> or <transform>).", name);
     }
-    ref<Object> o = it->second.data;
+    ref<Object> o = entry->data;
     if (!o->class_()->derives_from(MI_CLASS(AnimatedTransform)))
         Throw("The property \"%s\" has the wrong type (expected "
               " <animated_transform> or <transform>).", name);
-    it->second.queried = true;
+    entry->queried = true;
     return (AnimatedTransform *) o.get();
 }
 
 /// AnimatedTransform getter (with default value).
 ref<AnimatedTransform> Properties::animated_transform(
         const std::string &name, ref<AnimatedTransform> def_val) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         return def_val;
-    if (it->second.data.is<Transform4f>()) {
+    if (entry->data.is<Transform4f>()) {
         // Also accept simple transforms, from which we can build
         // an AnimatedTransform.
-        it->second.queried = true;
+        entry->queried = true;
         return new AnimatedTransform(
-            static_cast<const Transform4f &>(it->second.data));
+            static_cast<const Transform4f &>(entry->data));
     }
-    if (!it->second.data.is<ref<Object>>()) {
+    if (!entry->data.is<ref<Object>>()) {
         Throw("The property \"%s\" has the wrong type (expected "
               " <animated_transform> or <transform>).", name);
     }
-    ref<Object> o = it->second.data;
+    ref<Object> o = entry->data;
     if (!o->class_()->derives_from(MI_CLASS(AnimatedTransform)))
         Throw("The property \"%s\" has the wrong type (expected "
               " <animated_transform> or <transform>).", name);
-    it->second.queried = true;
+    entry->queried = true;
     return (AnimatedTransform *) o.get();
 }
 
@@ -540,14 +844,14 @@ ref<AnimatedTransform> Properties::animated_transform(
 #endif
 
 ref<Object> Properties::find_object(const std::string &name) const {
-    const auto it = d->entries.find(name);
-    if (it == d->entries.end())
+    Entry *entry = d->find(name);
+    if (!entry)
         return ref<Object>();
 
-    if (!it->second.data.is<ref<Object>>())
+    if (!entry->data.is<ref<Object>>())
         Throw("The property \"%s\" has the wrong type.", name);
 
-    return it->second.data;
+    return entry->data;
 }
 
 #define EXPORT_PROPERTY_ACCESSOR(T) \
@@ -44,6 +44,37 @@ MI_PY_EXPORT(Bitmap) {
         .value("Unpremultiply", Bitmap::AlphaTransform::Unpremultiply,
                 D(Bitmap, AlphaTransform, Unpremultiply));
 
+    py::enum_<Bitmap::ExrCompression>(bitmap, "ExrCompression", D(Bitmap, ExrCompression))
+        .value("Auto",         Bitmap::ExrCompression::Auto,
+               D(Bitmap, ExrCompression, Auto))
+        .value("Uncompressed", Bitmap::ExrCompression::Uncompressed,
+               D(Bitmap, ExrCompression, Uncompressed))
+        .value("RLE",          Bitmap::ExrCompression::RLE,
+               D(Bitmap, ExrCompression, RLE))
+        .value("ZIPS",         Bitmap::ExrCompression::ZIPS,
+               D(Bitmap, ExrCompression, ZIPS))
+        .value("ZIP",          Bitmap::ExrCompression::ZIP,
+               D(Bitmap, ExrCompression, ZIP))
+        .value("PIZ",          Bitmap::ExrCompression::PIZ,
+               D(Bitmap, ExrCompression, PIZ))
+        .value("DWAA",         Bitmap::ExrCompression::DWAA,
+               D(Bitmap, ExrCompression, DWAA))
+        .value("DWAB",         Bitmap::ExrCompression::DWAB,
+               D(Bitmap, ExrCompression, DWAB));
+
+    py::class_<Bitmap::ExrWriteOptions>(bitmap, "ExrWriteOptions", D(Bitmap, ExrWriteOptions))
+        .def(py::init<>())
+        .def_readwrite("compression", &Bitmap::ExrWriteOptions::compression,
+                       D(Bitmap, ExrWriteOptions, compression))
+        .def_readwrite("compression_level", &Bitmap::ExrWriteOptions::compression_level,
+                       D(Bitmap, ExrWriteOptions, compression_level))
+        .def_readwrite("tiled", &Bitmap::ExrWriteOptions::tiled,
+                       D(Bitmap, ExrWriteOptions, tiled))
+        .def_readwrite("tile_size", &Bitmap::ExrWriteOptions::tile_size,
+                       D(Bitmap, ExrWriteOptions, tile_size))
+        .def_readwrite("channel_formats", &Bitmap::ExrWriteOptions::channel_formats,
+                       D(Bitmap, ExrWriteOptions, channel_formats));
+
     bitmap
         .def(py::init<Bitmap::PixelFormat, Struct::Type, const Vector2u &, size_t, std::vector<std::string>>(),
              "pixel_format"_a, "component_format"_a, "size"_a, "channel_count"_a = 0, "channel_names"_a = std::vector<std::string>(),
@@ -164,8 +195,20 @@ MI_PY_EXPORT(Bitmap) {
                 &Bitmap::write_async, py::const_),
             "path"_a, "format"_a = Bitmap::FileFormat::Auto, "quality"_a = -1,
             D(Bitmap, write_async))
+        .def("write_exr",
+            py::overload_cast<const fs::path &, const Bitmap::ExrWriteOptions &>(
+                &Bitmap::write_exr, py::const_),
+            "path"_a, "options"_a, D(Bitmap, write_exr),
+            py::call_guard<py::gil_scoped_release>())
+        .def("write_exr_async", &Bitmap::write_exr_async, "path"_a, "options"_a,
+            D(Bitmap, write_exr_async))
         .def("split", &Bitmap::split, D(Bitmap, split))
         .def_static("detect_file_format", &Bitmap::detect_file_format, D(Bitmap, detect_file_format))
+        .def_static("prefetch", &Bitmap::prefetch, "path"_a, D(Bitmap, prefetch))
+        .def_static("load_prefetched", &Bitmap::load_prefetched, "path"_a,
+                    D(Bitmap, load_prefetched), py::call_guard<py::gil_scoped_release>())
+        .def_static("clear_prefetched", &Bitmap::clear_prefetched,
+                    D(Bitmap, clear_prefetched), py::call_guard<py::gil_scoped_release>())
         .def_property_readonly("__array_interface__", [](Bitmap &bitmap) -> py::object {
             if (bitmap.struct_()->size() == 0)
                 return py::none();
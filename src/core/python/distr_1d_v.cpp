@@ -84,6 +84,14 @@ MI_PY_EXPORT(ContinuousDistribution) {
         .def("sample_pdf",
             &ContinuousDistribution::sample_pdf,
             "value"_a, "active"_a = true, D(ContinuousDistribution, sample_pdf))
+        .def_method(ContinuousDistribution, build_alias_table)
+        .def_method(ContinuousDistribution, has_alias_table)
+        .def("sample_alias",
+            &ContinuousDistribution::sample_alias,
+            "value"_a, "active"_a = true, D(ContinuousDistribution, sample_alias))
+        .def("sample_pdf_alias",
+            &ContinuousDistribution::sample_pdf_alias,
+            "value"_a, "active"_a = true, D(ContinuousDistribution, sample_pdf_alias))
         .def_repr(ContinuousDistribution);
 }
 
@@ -0,0 +1,14 @@
+#include <mitsuba/core/sharedcache.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(SharedCache) {
+    auto cache = py::class_<SharedCache>(m, "SharedCache", D(SharedCache))
+        .def_static_method(SharedCache, stats)
+        .def_static_method(SharedCache, reset_stats)
+        .def_static_method(SharedCache, entry_count);
+
+    py::class_<SharedCache::Stats>(cache, "Stats", D(SharedCache, Stats))
+        .def_readonly("requests", &SharedCache::Stats::requests, D(SharedCache, Stats, requests))
+        .def_readonly("hits", &SharedCache::Stats::hits, D(SharedCache, Stats, hits))
+        .def_readonly("bytes_saved", &SharedCache::Stats::bytes_saved, D(SharedCache, Stats, bytes_saved));
+}
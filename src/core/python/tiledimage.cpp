@@ -0,0 +1,44 @@
+#include <mitsuba/core/tiledimage.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(TiledImage) {
+    using ScalarVector2u = TiledImage::ScalarVector2u;
+
+    auto tiled = MI_PY_CLASS(TiledImage, Object)
+        .def(py::init<const mitsuba::filesystem::path &>(),
+            D(TiledImage, TiledImage), "filename"_a)
+        .def_method(TiledImage, level_count)
+        .def_method(TiledImage, size, "level"_a = 0)
+        .def_method(TiledImage, channel_count)
+        .def_method(TiledImage, tile_size)
+        .def_method(TiledImage, raw)
+        .def_method(TiledImage, filename)
+        .def("read", [](const TiledImage &image, uint32_t level,
+                        const ScalarVector2u &pos) {
+                if (level >= image.level_count() ||
+                    dr::any(pos >= image.size(level)))
+                    throw py::index_error("TiledImage.read(): out of bounds!");
+                float value[3];
+                image.read(level, pos, value);
+                return std::vector<float>(value, value + image.channel_count());
+            }, D(TiledImage, read), "level"_a, "pos"_a)
+        .def_static("convert", &TiledImage::convert, D(TiledImage, convert),
+            "input"_a, "output"_a, "tile_size"_a = 64, "raw"_a = false)
+        .def_static_method(TiledImage, set_cache_budget, "bytes"_a)
+        .def_static_method(TiledImage, cache_budget)
+        .def_static_method(TiledImage, cache_stats)
+        .def_static_method(TiledImage, reset_cache_stats)
+        .def_static_method(TiledImage, clear_cache);
+
+    py::class_<TiledImage::CacheStats>(tiled, "CacheStats", D(TiledImage, CacheStats))
+        .def_readonly("hint_hits", &TiledImage::CacheStats::hint_hits, D(TiledImage, CacheStats, hint_hits))
+        .def_readonly("hits", &TiledImage::CacheStats::hits, D(TiledImage, CacheStats, hits))
+        .def_readonly("misses", &TiledImage::CacheStats::misses, D(TiledImage, CacheStats, misses))
+        .def_readonly("evictions", &TiledImage::CacheStats::evictions, D(TiledImage, CacheStats, evictions))
+        .def_readonly("bytes_read", &TiledImage::CacheStats::bytes_read, D(TiledImage, CacheStats, bytes_read))
+        .def_readonly("read_time", &TiledImage::CacheStats::read_time, D(TiledImage, CacheStats, read_time))
+        .def_readonly("resident_bytes", &TiledImage::CacheStats::resident_bytes, D(TiledImage, CacheStats, resident_bytes))
+        .def_readonly("peak_bytes", &TiledImage::CacheStats::peak_bytes, D(TiledImage, CacheStats, peak_bytes))
+        .def("hit_rate", &TiledImage::CacheStats::hit_rate, D(TiledImage, CacheStats, hit_rate));
+}
@@ -108,6 +108,15 @@ MI_PY_EXPORT(xml) {
         "string"_a, "parallel"_a = true,
         D(xml, load_string));
 
+    m.def("set_load_profile", &xml::set_load_profile, "filename"_a,
+          D(xml, set_load_profile));
+
+    m.def("set_keep_object_graph", &xml::set_keep_object_graph, "value"_a,
+          D(xml, set_keep_object_graph));
+
+    m.def("keep_object_graph", &xml::keep_object_graph,
+          D(xml, keep_object_graph));
+
     m.def(
         "load_dict",
         [](const py::dict dict, bool parallel) {
@@ -439,7 +448,7 @@ Task *instantiate_node(DictParseContext &ctx,
         mitsuba::xml::ScopedSetJITScope set_scope(ctx.parallel ? backend : 0u, scope);
 
         auto &inst = ctx.instances[path];
-        Properties props = inst.props;
+        Properties props = std::move(inst.props);
         std::string type = props.plugin_name();
 
         const Class *class_;
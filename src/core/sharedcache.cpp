@@ -0,0 +1,81 @@
+#include <mitsuba/core/sharedcache.h>
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(mitsuba)
+
+struct SharedCacheEntry {
+    /// Held while the entry is being created
+    std::mutex mutex;
+    std::weak_ptr<void> value;
+    size_t bytes = 0;
+};
+
+static std::mutex cache_mutex;
+static std::unordered_map<std::string, std::shared_ptr<SharedCacheEntry>> cache;
+static SharedCache::Stats cache_stats;
+/// Map size at which expired entries are removed next
+static size_t cache_prune_size = 64;
+
+/// Remove entries whose value was released (\c cache_mutex must be held)
+static void prune() {
+    for (auto it = cache.begin(); it != cache.end(); ) {
+        /* When the map holds the only reference, no thread can be in the
+           process of creating the value, which makes it safe to access */
+        if (it->second.use_count() == 1 && it->second->value.expired())
+            it = cache.erase(it);
+        else
+            ++it;
+    }
+    cache_prune_size = std::max(cache_prune_size, 2 * cache.size());
+}
+
+std::shared_ptr<void>
+SharedCache::get_impl(const std::string &key,
+                      const std::function<std::shared_ptr<void>(size_t &)> &create) {
+    std::shared_ptr<SharedCacheEntry> entry;
+    {
+        std::lock_guard<std::mutex> guard(cache_mutex);
+        if (cache.size() >= cache_prune_size)
+            prune();
+        std::shared_ptr<SharedCacheEntry> &e = cache[key];
+        if (!e)
+            e = std::make_shared<SharedCacheEntry>();
+        entry = e;
+        cache_stats.requests++;
+    }
+
+    std::lock_guard<std::mutex> guard(entry->mutex);
+    std::shared_ptr<void> value = entry->value.lock();
+    if (value) {
+        std::lock_guard<std::mutex> guard2(cache_mutex);
+        cache_stats.hits++;
+        cache_stats.bytes_saved += entry->bytes;
+        return value;
+    }
+
+    size_t bytes = 0;
+    value = create(bytes);
+    entry->value = value;
+    entry->bytes = bytes;
+    return value;
+}
+
+SharedCache::Stats SharedCache::stats() {
+    std::lock_guard<std::mutex> guard(cache_mutex);
+    return cache_stats;
+}
+
+void SharedCache::reset_stats() {
+    std::lock_guard<std::mutex> guard(cache_mutex);
+    cache_stats = Stats();
+}
+
+size_t SharedCache::entry_count() {
+    std::lock_guard<std::mutex> guard(cache_mutex);
+    prune();
+    return cache.size();
+}
+
+NAMESPACE_END(mitsuba)
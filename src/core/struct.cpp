@@ -29,10 +29,62 @@ NAMESPACE_BEGIN(detail)
 #  define Float float
 #endif
 
+/* Conversions between records whose fields share a common type are vectorized
+   when the target supports AVX2 (8 records per iteration) or AVX-512 (16) */
+#if MI_STRUCTCONVERTER_USE_JIT == 1 && defined(DRJIT_X86_AVX2) && \
+    defined(DRJIT_X86_FMA) && defined(DRJIT_X86_F16C) && !defined(DOUBLE_PRECISION)
+#  define MI_STRUCTCONVERTER_VECTORIZE 1
+#else
+#  define MI_STRUCTCONVERTER_VECTORIZE 0
+#endif
+
 #if MI_STRUCTCONVERTER_USE_JIT == 1
 
 using namespace asmjit;
 
+/// Coefficients of the sRGB transfer functions used by the JIT-compiled code
+#if !defined(DOUBLE_PRECISION)
+// Rational polynomial fit, rel.err = 2*10^-7
+static const float to_srgb_coeffs[2][6] =
+  { { -0.016202083165206348f, 0.7551545191665577f, 2.0041169284241644f,
+      0.7642611304733891f, 0.03453868659826638f,
+      -0.0016829072605308378f },
+    { 1.f, 1.8970238036421054f, 0.6085338522168684f,
+      0.03467195408529984f, -0.00004375359692957097f,
+      4.178892964897981e-7f } };
+#else
+// Rational polynomial fit, rel.err = 8*10^-15
+static const double to_srgb_coeffs[2][11] =
+  { { -0.0031151377052754843, 0.5838023820686707, 8.450947414259522,
+      27.901125077137042, 32.44669922192121, 15.374469584296442,
+      3.0477578489880823, 0.2263810267005674, 0.002531335520959116,
+      -0.00021805827098915798, -3.7113872202050023e-6 },
+    { 1., 10.723011300050162, 29.70548706952188, 30.50364355650628,
+      13.297981743005433, 2.575446652731678, 0.21749170309546628,
+      0.007244514696840552, 0.00007045228641004039,
+      -8.387527630781522e-9, 2.2380622409188757e-11 } };
+#endif
+
+#if !defined(DOUBLE_PRECISION)
+// Rational polynomial fit, rel.err = 2*10^-7
+static const float from_srgb_coeffs[2][5] =
+    { { -36.04572663838034f, -47.46726633009393f, -11.199318357635072f,
+        -0.7386328024653209f, -0.0163933279112946f },
+      { 1.f, -18.225745396846637f, -59.096406619244426f,
+        -19.140923959601675f, -0.004261480793199332f } };
+#else
+// Rational polynomial fit, rel.err = 1.5*10^-15
+static const double from_srgb_coeffs[2][10] =
+    { { -342.62884098034357, -3483.4445569178347, -9735.250875334352,
+        -10782.158977031822, -5548.704065887224, -1446.951694673217,
+        -200.19589605282445, -14.786385491859248, -0.5489744177844188,
+        -0.008042950896814532 },
+      { 1., -84.8098437770271, -1884.7738197074218, -8059.219012060384,
+        -11916.470977597566, -7349.477378676199, -2013.8039726540235,
+        -237.47722999429413, -9.646075249097724,
+        -2.2132610916769585e-8 } };
+#endif
+
 /// Helper class used to JIT-compile conversion code (in the StructCompiler class)
 class StructCompiler {
 public:
@@ -443,48 +495,6 @@ public:
             y = x;
         }
 
-        #if !defined(DOUBLE_PRECISION)
-            // Rational polynomial fit, rel.err = 2*10^-7
-            float to_srgb_coeffs[2][6] =
-              { { -0.016202083165206348f, 0.7551545191665577f, 2.0041169284241644f,
-                  0.7642611304733891f, 0.03453868659826638f,
-                  -0.0016829072605308378f },
-                { 1.f, 1.8970238036421054f, 0.6085338522168684f,
-                  0.03467195408529984f, -0.00004375359692957097f,
-                  4.178892964897981e-7f } };
-        #else
-            // Rational polynomial fit, rel.err = 8*10^-15
-            double to_srgb_coeffs[2][11] =
-              { { -0.0031151377052754843, 0.5838023820686707, 8.450947414259522,
-                  27.901125077137042, 32.44669922192121, 15.374469584296442,
-                  3.0477578489880823, 0.2263810267005674, 0.002531335520959116,
-                  -0.00021805827098915798, -3.7113872202050023e-6 },
-                { 1., 10.723011300050162, 29.70548706952188, 30.50364355650628,
-                  13.297981743005433, 2.575446652731678, 0.21749170309546628,
-                  0.007244514696840552, 0.00007045228641004039,
-                  -8.387527630781522e-9, 2.2380622409188757e-11 } };
-        #endif
-
-        #if !defined(DOUBLE_PRECISION)
-            // Rational polynomial fit, rel.err = 2*10^-7
-            float from_srgb_coeffs[2][5] =
-                { { -36.04572663838034f, -47.46726633009393f, -11.199318357635072f,
-                    -0.7386328024653209f, -0.0163933279112946f },
-                  { 1.f, -18.225745396846637f, -59.096406619244426f,
-                    -19.140923959601675f, -0.004261480793199332f } };
-        #else
-            // Rational polynomial fit, rel.err = 1.5*10^-15
-            double from_srgb_coeffs[2][10] =
-                { { -342.62884098034357, -3483.4445569178347, -9735.250875334352,
-                    -10782.158977031822, -5548.704065887224, -1446.951694673217,
-                    -200.19589605282445, -14.786385491859248, -0.5489744177844188,
-                    -0.008042950896814532 },
-                  { 1., -84.8098437770271, -1884.7738197074218, -8059.219012060384,
-                    -11916.470977597566, -7349.477378676199, -2013.8039726540235,
-                    -237.47722999429413, -9.646075249097724,
-                    -2.2132610916769585e-8 } };
-        #endif
-
         size_t ncoeffs =
             to_srgb ? std::extent_v<decltype(to_srgb_coeffs), 1> :
                       std::extent_v<decltype(from_srgb_coeffs), 1>;
@@ -1029,6 +1039,385 @@ private:
     std::map<Key, Value> cache;
 };
 
+#if MI_STRUCTCONVERTER_VECTORIZE == 1
+/**
+ * \brief Helper class used to JIT-compile vectorized conversion code
+ *
+ * Handles the common case of records whose fields all share one type (e.g.
+ * RGBA8 or RGB float32 pixels) and are converted field by field. Each call to
+ * \ref compile() generates code that converts a packet of \c Width records
+ * held in as many vector registers as there are fields. The generated
+ * instruction sequence mirrors the one of \ref StructCompiler, hence both
+ * produce identical results.
+ */
+class StructVectorCompiler {
+public:
+#if defined(DRJIT_X86_AVX512)
+    using Vec = x86::Zmm;
+    static constexpr uint32_t Width = 16;
+#else
+    using Vec = x86::Ymm;
+    static constexpr uint32_t Width = 8;
+#endif
+
+    /// Conversion steps, stored as bit masks over the fields of a record
+    struct Plan {
+        Struct::Type source_type, target_type;
+        uint32_t source_size = 0, target_size = 0, field_count = 0;
+        uint32_t normalize = 0, from_srgb = 0, to_srgb = 0, scale = 0,
+                 dither = 0;
+        float normalize_value = 1.f, scale_value = 1.f;
+        float range_min = 0.f, range_max = 0.f;
+    };
+
+    /// Check if the conversion from \c source to \c target can be vectorized
+    static bool analyze(const Struct *source, const Struct *target, bool dither,
+                        Plan &plan) {
+        auto supported = [](Struct::Type type) {
+            return type == Struct::Type::UInt8 || type == Struct::Type::UInt16 ||
+                   type == Struct::Type::Float16 || type == Struct::Type::Float32;
+        };
+
+        size_t field_count = target->field_count();
+        if (field_count == 0 || field_count > 16 ||
+            source->field_count() != field_count ||
+            source->byte_order() == Struct::ByteOrder::BigEndian ||
+            target->byte_order() == Struct::ByteOrder::BigEndian)
+            return false;
+
+        plan.source_type = (*source)[0].type;
+        plan.target_type = (*target)[0].type;
+        plan.source_size = (uint32_t) (*source)[0].size;
+        plan.target_size = (uint32_t) (*target)[0].size;
+        plan.field_count = (uint32_t) field_count;
+
+        // Half precision values are copied verbatim by the scalar code
+        if (!supported(plan.source_type) || !supported(plan.target_type) ||
+            (plan.source_type == Struct::Type::Float16 &&
+             plan.target_type == Struct::Type::Float16) ||
+            source->size() != field_count * plan.source_size ||
+            target->size() != field_count * plan.target_size)
+            return false;
+
+        bool source_alpha = false, target_alpha = false,
+             source_weight = false, target_weight = false;
+        for (const Struct::Field &f : *source) {
+            source_alpha |= has_flag(f.flags, Struct::Flags::Alpha);
+            source_weight |= has_flag(f.flags, Struct::Flags::Weight);
+        }
+        for (const Struct::Field &f : *target) {
+            target_alpha |= has_flag(f.flags, Struct::Flags::Alpha);
+            target_weight |= has_flag(f.flags, Struct::Flags::Weight);
+        }
+        if (source_weight && !target_weight)
+            return false;
+
+        uint32_t flag_mask = Struct::Flags::Normalized | Struct::Flags::Gamma,
+                 special_channels_mask = Struct::Flags::Weight | Struct::Flags::Alpha;
+
+        for (uint32_t i = 0; i < plan.field_count; ++i) {
+            const Struct::Field &s = (*source)[i], &f = (*target)[i];
+
+            if (s.name != f.name || !f.blend.empty() ||
+                s.type != plan.source_type || f.type != plan.target_type ||
+                s.offset != i * s.size || f.offset != i * f.size ||
+                has_flag(s.flags, Struct::Flags::Assert))
+                return false;
+
+            // Alpha (un)premultiplication isn't supported
+            if (source_alpha && target_alpha && (f.flags & special_channels_mask) == 0 &&
+                has_flag(s.flags, Struct::Flags::PremultipliedAlpha) !=
+                has_flag(f.flags, Struct::Flags::PremultipliedAlpha))
+                return false;
+
+            // Same criterion as in the scalar code
+            bool linearize =
+                !((s.type == f.type || (Struct::is_integer(s.type) &&
+                                        Struct::is_integer(f.type) &&
+                                        !has_flag(f.flags, Struct::Flags::Normalized))) &&
+                  ((s.flags & flag_mask) == (f.flags & flag_mask)));
+
+            if (!linearize) {
+                // Integers of different types are copied without conversion
+                if (s.type != f.type)
+                    return false;
+                continue;
+            }
+
+            uint32_t bit = 1u << i;
+            if (Struct::is_integer(s.type) && has_flag(s.flags, Struct::Flags::Normalized))
+                plan.normalize |= bit;
+            if (has_flag(s.flags, Struct::Flags::Gamma))
+                plan.from_srgb |= bit;
+            if (has_flag(f.flags, Struct::Flags::Gamma))
+                plan.to_srgb |= bit;
+            if (Struct::is_integer(f.type) && has_flag(f.flags, Struct::Flags::Normalized)) {
+                plan.scale |= bit;
+                if (dither)
+                    plan.dither |= bit;
+            }
+        }
+
+        plan.normalize_value = (float) (1.0 / Struct::range(plan.source_type).second);
+
+        if (Struct::is_integer(plan.target_type)) {
+            auto range_dbl = Struct::range(plan.target_type);
+            plan.range_min = (float) range_dbl.first;
+            plan.range_max = (float) range_dbl.second;
+            plan.scale_value = plan.range_max;
+        }
+
+        return true;
+    }
+
+    StructVectorCompiler(x86::Compiler &cc, const Plan &plan)
+        : cc(cc), plan(plan) { }
+
+    /// Convert the packet of records at \c input (starting at column \c x) to \c output
+    void compile(const x86::Gp &input, const x86::Gp &output,
+                 const x86::Gp &x, const x86::Gp &y) {
+        #if MI_JIT_LOG_ASSEMBLY == 1
+            cc.comment("# Vectorized conversion");
+        #endif
+
+        Vec dither_row;
+        if (plan.dither) {
+            /* The packet starts at a multiple of 'Width', hence the
+               associated dither matrix entries are contiguous */
+            x86::Gp index = cc.newUInt64();
+            cc.movzx(index.r64(), x.r8Lo());
+            cc.mov(index.r8Hi(), y.r8Lo());
+            x86::Gp base = cc.newUInt64();
+            cc.mov(base.r64(), Imm((uintptr_t) dither_matrix256));
+            dither_row = new_vec();
+            cc.vmovups(dither_row, x86::ptr(base, index, 2, 0, Width * 4));
+        }
+
+        for (uint32_t j = 0; j < plan.field_count; ++j) {
+            Vec value = load(input, (int32_t) (j * Width * plan.source_size));
+
+            if (uint32_t mask = lanes(plan.normalize, j); mask) {
+                Vec temp = new_vec();
+                cc.vmulps(temp, value, broadcast(plan.normalize_value));
+                value = merge(value, temp, mask);
+            }
+
+            if (uint32_t mask = lanes(plan.from_srgb, j); mask)
+                value = merge(value, gamma(value, false), mask);
+
+            if (uint32_t mask = lanes(plan.to_srgb, j); mask)
+                value = merge(value, gamma(value, true), mask);
+
+            if (Struct::is_integer(plan.target_type)) {
+                if (uint32_t mask = lanes(plan.scale, j); mask) {
+                    Vec temp = new_vec();
+                    cc.vmulps(temp, value, broadcast(plan.scale_value));
+                    value = merge(value, temp, mask);
+                }
+
+                if (uint32_t mask = lanes(plan.dither, j); mask) {
+                    Vec dither_value = dither_row;
+                    if (plan.field_count > 1) {
+                        // Replicate the entry of each record for all of its fields
+                        uint8_t perm[Width];
+                        for (uint32_t i = 0; i < Width; ++i)
+                            perm[i] = (uint8_t) ((j * Width + i) / plan.field_count);
+                        x86::Mem perm_mem = cc.newConst(ConstPoolScope::kGlobal, perm, Width);
+                        perm_mem.setSize(Width);
+                        Vec index = new_vec();
+                        cc.vpmovzxbd(index, perm_mem);
+                        dither_value = new_vec();
+                        cc.vpermps(dither_value, index, dither_row);
+                    }
+                    if (mask != full_mask()) {
+                        Vec zero = new_vec();
+                        cc.vxorps(zero, zero, zero);
+                        dither_value = merge(zero, dither_value, mask);
+                    }
+                    Vec temp = new_vec();
+                    cc.vaddps(temp, value, dither_value);
+                    value = temp;
+                }
+
+                Vec temp = new_vec();
+                #if defined(DRJIT_X86_AVX512)
+                    cc.vrndscaleps(temp, value, Imm(8));
+                #else
+                    cc.vroundps(temp, value, Imm(8));
+                #endif
+                cc.vmaxps(temp, temp, broadcast(plan.range_min));
+                cc.vminps(temp, temp, broadcast(plan.range_max));
+                cc.vcvtps2dq(temp, temp);
+                value = temp;
+            }
+
+            save(output, (int32_t) (j * Width * plan.target_size), value);
+        }
+    }
+
+private:
+    Vec new_vec() {
+        #if defined(DRJIT_X86_AVX512)
+            return cc.newZmm();
+        #else
+            return cc.newYmm();
+        #endif
+    }
+
+    static constexpr uint32_t full_mask() { return (1u << Width) - 1; }
+
+    /// Map a field bit mask to the lanes of the j-th register of a packet
+    uint32_t lanes(uint32_t fields, uint32_t j) const {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < Width; ++i) {
+            if (fields & (1u << ((j * Width + i) % plan.field_count)))
+                result |= 1u << i;
+        }
+        return result;
+    }
+
+    /// Broadcast a constant to all lanes
+    Vec broadcast(float value) {
+        Vec result = new_vec();
+        cc.vbroadcastss(result, cc.newFloatConst(ConstPoolScope::kGlobal, value));
+        return result;
+    }
+
+    /// Return a register containing \c b in the lanes selected by \c mask and \c a elsewhere
+    Vec merge(const Vec &a, const Vec &b, uint32_t mask) {
+        if (mask == full_mask())
+            return b;
+        Vec result = new_vec();
+        #if defined(DRJIT_X86_AVX512)
+            x86::Gp bits = cc.newUInt32();
+            cc.mov(bits, Imm(mask));
+            x86::KReg k = cc.newKw();
+            cc.kmovw(k, bits);
+            cc.k(k).vblendmps(result, a, b);
+        #else
+            cc.vblendps(result, a, b, Imm(mask));
+        #endif
+        return result;
+    }
+
+    /// Forward/inverse gamma correction, see \ref StructCompiler::gamma()
+    Vec gamma(const Vec &x, bool to_srgb) {
+        Vec y = x;
+        if (to_srgb) {
+            y = new_vec();
+            cc.vsqrtps(y, x);
+        }
+
+        size_t ncoeffs =
+            to_srgb ? std::extent_v<decltype(to_srgb_coeffs), 1> :
+                      std::extent_v<decltype(from_srgb_coeffs), 1>;
+
+        Vec a, b;
+        for (size_t i = 0; i < ncoeffs; ++i) {
+            for (int j = 0; j < 2; ++j) {
+                Vec &v = (j == 0) ? a : b;
+                Vec coeff = broadcast(to_srgb ? to_srgb_coeffs[j][i]
+                                              : from_srgb_coeffs[j][i]);
+                if (i == 0)
+                    v = coeff;
+                else
+                    cc.vfmadd213ps(v, y, coeff);
+            }
+        }
+        cc.vdivps(a, a, b);
+
+        // Select the linear segment for small values
+        Vec low = broadcast(to_srgb ? 12.92f : (float) (1.0 / 12.92)),
+            threshold = broadcast(to_srgb ? 0.0031308f : 0.04045f);
+        #if defined(DRJIT_X86_AVX512)
+            x86::KReg k = cc.newKw();
+            cc.vcmpps(k, x, threshold, Imm(1));
+            cc.k(k).vblendmps(a, a, low);
+        #else
+            Vec mask = new_vec();
+            cc.vcmpps(mask, x, threshold, Imm(1));
+            cc.vblendvps(a, a, low, mask);
+        #endif
+        cc.vmulps(a, a, x);
+
+        return a;
+    }
+
+    /// Load and convert one register worth of fields to single precision
+    Vec load(const x86::Gp &input, int32_t offset) {
+        Vec value = new_vec();
+        switch (plan.source_type) {
+            case Struct::Type::UInt8:
+                cc.vpmovzxbd(value, x86::ptr(input, offset, Width));
+                cc.vcvtdq2ps(value, value);
+                break;
+
+            case Struct::Type::UInt16:
+                cc.vpmovzxwd(value, x86::ptr(input, offset, Width * 2));
+                cc.vcvtdq2ps(value, value);
+                break;
+
+            case Struct::Type::Float16:
+                cc.vcvtph2ps(value, x86::ptr(input, offset, Width * 2));
+                break;
+
+            case Struct::Type::Float32:
+                cc.vmovups(value, x86::ptr(input, offset, Width * 4));
+                break;
+
+            default: Throw("StructConverter: unsupported field type!");
+        }
+        return value;
+    }
+
+    /// Store one register worth of fields (integers are already converted)
+    void save(const x86::Gp &output, int32_t offset, const Vec &value) {
+        switch (plan.target_type) {
+            case Struct::Type::UInt8:
+                #if defined(DRJIT_X86_AVX512)
+                    cc.vpmovusdb(x86::ptr(output, offset, Width), value);
+                #else
+                    {
+                        x86::Xmm low = value.xmm(), high = cc.newXmm();
+                        cc.vextracti128(high, value, Imm(1));
+                        cc.vpackusdw(low, low, high);
+                        cc.vpackuswb(low, low, low);
+                        cc.vmovq(x86::ptr(output, offset, Width), low);
+                    }
+                #endif
+                break;
+
+            case Struct::Type::UInt16:
+                #if defined(DRJIT_X86_AVX512)
+                    cc.vpmovusdw(x86::ptr(output, offset, Width * 2), value);
+                #else
+                    {
+                        x86::Xmm low = value.xmm(), high = cc.newXmm();
+                        cc.vextracti128(high, value, Imm(1));
+                        cc.vpackusdw(low, low, high);
+                        cc.vmovdqu(x86::ptr(output, offset, Width * 2), low);
+                    }
+                #endif
+                break;
+
+            case Struct::Type::Float16:
+                cc.vcvtps2ph(x86::ptr(output, offset, Width * 2), value, Imm(0));
+                break;
+
+            case Struct::Type::Float32:
+                cc.vmovups(x86::ptr(output, offset, Width * 4), value);
+                break;
+
+            default: Throw("StructConverter: unsupported field type!");
+        }
+    }
+
+private:
+    x86::Compiler &cc;
+    Plan plan;
+};
+#endif
+
 #endif
 
 NAMESPACE_END(detail)
@@ -1286,6 +1675,7 @@ StructConverter::StructConverter(const Struct *source, const Struct *target, boo
     node->setArg(3, output);
 
     // Control flow structure
+    Label loop_row   = cc.newLabel();
     Label loop_start = cc.newLabel();
     Label loop_x_end = cc.newLabel();
     Label loop_y_end = cc.newLabel();
@@ -1301,6 +1691,46 @@ StructConverter::StructConverter(const Struct *source, const Struct *target, boo
     cc.jz(loop_y_end);
     cc.xor_(y, y);
 
+#if MI_STRUCTCONVERTER_VECTORIZE == 1
+    using VectorCompiler = detail::StructVectorCompiler;
+    VectorCompiler::Plan plan;
+    bool vectorize = VectorCompiler::analyze(source, target, dither, plan);
+
+    /* Convert packets of records using vector instructions, and process the
+       remainder of each row with the scalar code below */
+    x86::Gp vector_width;
+    if (vectorize) {
+        vector_width = cc.newInt64("vector_width");
+        cc.mov(vector_width, width);
+        cc.and_(vector_width, Imm(~(int64_t) (VectorCompiler::Width - 1)));
+    }
+
+    cc.bind(loop_row);
+
+    if (vectorize) {
+        Label loop_vector = cc.newLabel(),
+              loop_vector_end = cc.newLabel();
+        VectorCompiler vc(cc, plan);
+
+        cc.cmp(x, vector_width);
+        cc.jae(loop_vector_end);
+
+        cc.bind(loop_vector);
+        vc.compile(input, output, x, y);
+        cc.add(x, Imm(VectorCompiler::Width));
+        cc.add(input,  Imm(VectorCompiler::Width * source->size()));
+        cc.add(output, Imm(VectorCompiler::Width * target->size()));
+        cc.cmp(x, vector_width);
+        cc.jb(loop_vector);
+
+        cc.bind(loop_vector_end);
+        cc.cmp(x, width);
+        cc.je(loop_x_end);
+    }
+#else
+    cc.bind(loop_row);
+#endif
+
     cc.bind(loop_start);
 
     bool has_assert = false;
@@ -1469,7 +1899,7 @@ StructConverter::StructConverter(const Struct *source, const Struct *target, boo
     cc.xor_(x, x);
     cc.inc(y);
     cc.cmp(y, height);
-    cc.jne(loop_start);
+    cc.jne(loop_row);
 
     cc.bind(loop_y_end);
     auto rv = cc.newInt64("rv");
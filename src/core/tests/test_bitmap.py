@@ -428,3 +428,82 @@ def test_check_weight_division(variant_scalar_rgb):
     assert np.all(x[0, 0, :] == (2, 0, 0, 0))
     assert np.all(x[1, 0, :] == (1, 0, 0, 0))
     assert np.all(x[2, 0, :] == (2, 0, 0, 0))
+
+
+def test_convert_large(variant_scalar_rgb, np_rng):
+    # Images with many rows are converted in parallel strips. The dither
+    # pattern repeats every 256 rows, hence periodic data must yield a
+    # periodic result regardless of how the rows were partitioned.
+    data = np.tile(np_rng.random((256, 37, 3)).astype(np.float32), (4, 1, 1))[:1000]
+    b = mi.Bitmap(data).convert(
+        pixel_format=mi.Bitmap.PixelFormat.RGBA,
+        component_format=mi.Struct.Type.UInt8,
+        srgb_gamma=True
+    )
+
+    x = np.array(b, copy=False)
+    assert x.shape == (1000, 37, 4)
+    assert np.all(x[..., 3] == 255)
+    assert np.all(x[256:512] == x[:256])
+    assert np.all(x[768:1000] == x[:232])
+
+
+def test_prefetch(variant_scalar_rgb, tmpdir, np_rng):
+    paths = []
+    for i in range(4):
+        path = str(tmpdir.join('prefetch_%i.exr' % i))
+        mi.Bitmap(np_rng.random((16, 8, 3)).astype(np.float32)).write(path)
+        paths.append(path)
+        mi.Bitmap.prefetch(path)
+
+    for path in paths:
+        assert mi.Bitmap.load_prefetched(path) == mi.Bitmap(path)
+
+    # Files that weren't prefetched (or were already consumed) are loaded directly
+    assert mi.Bitmap.load_prefetched(paths[0]) == mi.Bitmap(paths[0])
+
+    mi.Bitmap.prefetch(paths[1])
+    mi.Bitmap.clear_prefetched()
+
+    with pytest.raises(Exception):
+        mi.Bitmap.load_prefetched(str(tmpdir.join('missing.exr')))
+
+
+@pytest.mark.parametrize('compression', ['Uncompressed', 'RLE', 'ZIPS', 'ZIP', 'PIZ'])
+@pytest.mark.parametrize('tiled', [False, True])
+def test_write_exr_options(variant_scalar_rgb, tmpdir, np_rng, compression, tiled):
+    data = np_rng.random((37, 53, 3)).astype(np.float32)
+    b = mi.Bitmap(data)
+
+    options = mi.Bitmap.ExrWriteOptions()
+    options.compression = getattr(mi.Bitmap.ExrCompression, compression)
+    options.compression_level = 4
+    options.tiled = tiled
+    options.tile_size = 16
+    options.channel_formats = { 'G': mi.Struct.Type.Float16 }
+
+    tmp_file = str(tmpdir.join('out.exr'))
+    b.write_exr(tmp_file, options)
+    x = np.array(mi.Bitmap(tmp_file))
+
+    # Lossless compression, except for the half precision channel
+    assert np.all(x[..., 0] == data[..., 0])
+    assert np.all(x[..., 2] == data[..., 2])
+    assert np.allclose(x[..., 1], data[..., 1], atol=1e-3)
+    assert not np.all(x[..., 1] == data[..., 1])
+
+
+def test_write_exr_async(variant_scalar_rgb, tmpdir, np_rng):
+    data = np_rng.random((64, 64, 4)).astype(np.float32)
+    b = mi.Bitmap(data)
+
+    options = mi.Bitmap.ExrWriteOptions()
+    options.compression = mi.Bitmap.ExrCompression.DWAB
+    options.compression_level = 45
+    tmp_file = str(tmpdir.join('out.exr'))
+    b.write_exr_async(tmp_file, options)
+    mi.Thread.wait_for_tasks()
+
+    x = np.array(mi.Bitmap(tmp_file))
+    assert x.shape == data.shape
+    assert np.mean(np.abs(x - data)) < 0.1
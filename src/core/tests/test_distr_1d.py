@@ -268,3 +268,23 @@ def test18_irrcont_simple_function(variants_vec_backends_once):
                 0.48734, 0.654313, 0.786607, 0.899653, 1.])
          * d.normalization())
     )
+
+
+def test19_cont_alias(variants_vec_backends_once):
+    # Alias table sampling must produce the same distribution and densities
+    y = mi.Float([0.5, 1.0, 0.0, 0.0, 1.5, 0.2, 3.0])
+    d = mi.ContinuousDistribution([-1, 2], y)
+    assert not d.has_alias_table()
+    d.build_alias_table()
+    assert d.has_alias_table()
+
+    n = 100000
+    x, pdf = d.sample_pdf_alias(dr.linspace(mi.Float, 0, 1, n))
+    assert dr.all((x >= -1) & (x <= 2))
+    assert dr.allclose(pdf, d.eval_pdf_normalized(x), atol=1e-4)
+    assert dr.allclose(x, d.sample_alias(dr.linspace(mi.Float, 0, 1, n)))
+
+    # Compare the empirical CDF against the exact one
+    for v in [-0.5, 0.2, 0.9, 1.5]:
+        cdf = dr.count(x < v) / n
+        assert dr.allclose(cdf, d.eval_cdf_normalized(v), atol=1e-3)
@@ -252,3 +252,28 @@ def test13_trailing_zeros_keys(variant_scalar_rgb):
     assert len(props.property_names()) == 2
     assert props[key1] == 4.0
     assert props[key2] == 8.0
+
+
+def test14_many_properties(variant_scalar_rgb):
+    # Large records switch to an indexed lookup
+    p = mi.Properties()
+    for i in reversed(range(100)):
+        p[f'shape_{i}'] = i
+
+    assert p.property_names() == [f'shape_{i}' for i in range(100)]
+    for i in range(100):
+        assert p[f'shape_{i}'] == i
+
+    for i in range(0, 100, 2):
+        assert p.remove_property(f'shape_{i}')
+
+    p2 = mi.Properties(p)
+    for q in [p, p2]:
+        assert q.property_names() == [f'shape_{i}' for i in range(1, 100, 2)]
+        for i in range(100):
+            assert q.has_property(f'shape_{i}') == (i % 2 == 1)
+    assert p == p2
+
+    p2['shape_1'] = 'updated'
+    assert p['shape_1'] == 1
+    assert p2['shape_1'] == 'updated'
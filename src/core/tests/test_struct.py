@@ -443,3 +443,46 @@ def test19_alpha_4():
     dst_data = (src_data_float[0], src_data_float[1], src_data[2])
     check_conversion(s, '@BBB', '@BBB',
                      src_data, dst_data)
+
+
+@pytest.mark.parametrize('channels', [1, 3, 4])
+@pytest.mark.parametrize('conversion', [
+    (Struct.Type.UInt8, True, Struct.Type.Float32, False),
+    (Struct.Type.Float32, False, Struct.Type.UInt8, True),
+    (Struct.Type.Float32, True, Struct.Type.UInt16, False),
+    (Struct.Type.Float32, False, Struct.Type.Float16, False),
+    (Struct.Type.Float16, False, Struct.Type.Float32, True),
+    (Struct.Type.UInt8, True, Struct.Type.UInt8, False)
+])
+def test20_packet_conversion(conversion, channels):
+    """Long runs of records may be converted using vector instructions. The
+    result must match that of converting each record separately"""
+    src_type, src_gamma, dst_type, dst_gamma = conversion
+
+    def make_struct(type_, gamma):
+        s = Struct()
+        for i in range(channels):
+            flags = Struct.Flags.Normalized if Struct.is_integer(type_) else Struct.Flags.Empty
+            if gamma and i < 3:
+                flags |= Struct.Flags.Gamma
+            s.append('c%i' % i, type_, flags)
+        return s
+
+    src, dst = make_struct(src_type, src_gamma), make_struct(dst_type, dst_gamma)
+    s = StructConverter(src, dst)
+
+    # 37 records: several packets followed by a scalar remainder
+    count = 37 * channels
+    rng = np.random.default_rng(seed=12345)
+    if src_type == Struct.Type.UInt8:
+        data = rng.integers(0, 256, count, dtype=np.uint8)
+    else:
+        data = rng.uniform(-0.1, 1.1, count).astype(
+            np.float16 if src_type == Struct.Type.Float16 else np.float32)
+    data = data.tobytes()
+
+    result = s.convert(data)
+    src_size, dst_size = src.size(), dst.size()
+    for i in range(37):
+        record = s.convert(data[i * src_size:(i + 1) * src_size])
+        assert result[i * dst_size:(i + 1) * dst_size] == record
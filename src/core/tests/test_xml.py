@@ -425,3 +425,41 @@ def test31_python_plugins_parallel(variants_vec_backends_once_rgb):
         <bsdf type='dummy'/>
     </scene>
     """, parallel=True)
+
+
+def test32_load_profile(variant_scalar_rgb, tmp_path):
+    import json
+
+    filename = str(tmp_path / 'trace.json')
+    mi.set_load_profile(filename)
+    try:
+        mi.load_string("""
+        <scene version='3.0.0'>
+            <bsdf type='diffuse' id='mat'>
+                <rgb name='reflectance' value='0.5'/>
+            </bsdf>
+            <shape type='sphere' id='s1'>
+                <ref id='mat'/>
+            </shape>
+            <shape type='sphere' id='s2'>
+                <ref id='mat'/>
+            </shape>
+        </scene>
+        """)
+    finally:
+        mi.set_load_profile('')
+
+    with open(filename) as f:
+        trace = json.load(f)
+
+    events = {e['name']: e for e in trace['traceEvents']}
+    assert 'Parse XML' in events
+    for name in ['mat', 's1', 's2']:
+        assert events[name]['ph'] == 'X'
+        assert events[name]['dur'] >= 0
+    assert events['s1']['cat'] == 'shape'
+    assert events['s1']['args']['plugin'] == 'sphere'
+    assert events['mat']['args']['plugin'] == 'diffuse'
+
+    # Dependencies finish before the objects referencing them start
+    assert events['mat']['ts'] + events['mat']['dur'] <= events['s1']['ts']
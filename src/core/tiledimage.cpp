@@ -0,0 +1,486 @@
+#include <mitsuba/core/tiledimage.h>
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/util.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/// Magic number and version of the tiled image file format
+static const char TiledImageMagic[4] = { 'M', 'I', 'T', 'L' };
+static const uint32_t TiledImageVersion = 1;
+
+/// Number of independently locked partitions of the tile cache
+static const uint32_t TileCacheShards = 16;
+
+/// Number of entries of the per-thread hint table (must be a power of two)
+static const uint32_t TileHintSize = 16;
+
+/// Budget of the tile cache when none was specified
+static const size_t TileCacheDefaultBudget = size_t(1) << 30;
+
+using TileData = std::shared_ptr<float[]>;
+
+// =======================================================================
+//! @{ \name Shared tile cache
+// =======================================================================
+
+/* Tiles are identified by a 64 bit key combining the (never reused) ID of
+   the image with the index of the tile in its offset table. Each shard
+   holds its tiles in LRU order and receives an equal part of the budget. */
+struct TileCacheShard {
+    struct Entry {
+        TileData tile;
+        std::list<uint64_t>::iterator lru_it;
+        size_t bytes;
+    };
+
+    std::mutex mutex;
+    std::list<uint64_t> lru;
+    std::unordered_map<uint64_t, Entry> tiles;
+    size_t bytes = 0;
+
+    /// Evict the least recently used tiles until the shard fits the budget
+    size_t shrink(size_t budget) {
+        size_t evictions = 0;
+        while (budget > 0 && bytes > budget && !lru.empty()) {
+            auto it = tiles.find(lru.back());
+            bytes -= it->second.bytes;
+            tiles.erase(it);
+            lru.pop_back();
+            evictions++;
+        }
+        return evictions;
+    }
+};
+
+struct TileCache {
+    TileCacheShard shards[TileCacheShards];
+    std::atomic<size_t> budget { TileCacheDefaultBudget };
+
+    /// Incremented to invalidate the per-thread hint tables
+    std::atomic<uint64_t> generation { 0 };
+    std::atomic<uint32_t> next_id { 0 };
+    std::atomic<uint32_t> image_count { 0 };
+
+    std::atomic<size_t> hint_hits { 0 }, hits { 0 }, misses { 0 },
+                        evictions { 0 }, bytes_read { 0 },
+                        resident_bytes { 0 }, peak_bytes { 0 };
+    std::atomic<uint64_t> read_time_ns { 0 };
+
+    TileCacheShard &shard(uint64_t key) {
+        return shards[(uint32_t) ((key * 0x9E3779B97F4A7C15ull) >> 60) %
+                      TileCacheShards];
+    }
+
+    size_t shard_budget() const {
+        size_t value = budget.load(std::memory_order_relaxed);
+        return value == 0 ? 0 : std::max(value / TileCacheShards, size_t(1));
+    }
+
+    void add_resident(size_t bytes) {
+        size_t value = resident_bytes.fetch_add(bytes) + bytes,
+               peak  = peak_bytes.load(std::memory_order_relaxed);
+        while (value > peak &&
+               !peak_bytes.compare_exchange_weak(peak, value))
+            ;
+    }
+};
+
+static TileCache tile_cache;
+
+/* Small direct-mapped table of the tiles recently accessed by the current
+   thread. The tiles are kept alive by the table, hence a lookup that hits
+   does not need to lock the shared cache. */
+struct TileHintTable {
+    struct Entry {
+        uint64_t key = (uint64_t) -1;
+        TileData tile;
+    };
+
+    Entry entries[TileHintSize];
+    uint64_t generation = 0;
+    size_t hits = 0;
+
+    ~TileHintTable() { flush(); }
+
+    void flush() {
+        if (hits) {
+            tile_cache.hint_hits += hits;
+            hits = 0;
+        }
+    }
+
+    void invalidate(uint64_t new_generation) {
+        for (Entry &e : entries)
+            e = Entry();
+        generation = new_generation;
+    }
+};
+
+static thread_local TileHintTable tile_hints;
+
+//! @}
+// =======================================================================
+
+struct TiledImage::TiledImagePrivate {
+    std::mutex mutex;
+    ref<FileStream> stream;
+};
+
+TiledImage::TiledImage(const fs::path &filename)
+    : m_filename(filename), d(new TiledImagePrivate()) {
+    d->stream = new FileStream(filename, FileStream::ERead);
+
+    char magic[4];
+    d->stream->read(magic, 4);
+    if (memcmp(magic, TiledImageMagic, 4) != 0)
+        Throw("\"%s\": not a tiled image (use TiledImage.convert() to "
+              "create one)!", filename.string());
+
+    uint32_t version, width, height, level_count;
+    uint8_t raw;
+    d->stream->read(version);
+    if (version != TiledImageVersion)
+        Throw("\"%s\": unsupported tiled image version %u (expected %u)!",
+              filename.string(), version, TiledImageVersion);
+
+    d->stream->read(width);
+    d->stream->read(height);
+    d->stream->read(m_channel_count);
+    d->stream->read(m_tile_size);
+    d->stream->read(level_count);
+    d->stream->read(raw);
+    m_raw = raw != 0;
+
+    if (m_channel_count != 1 && m_channel_count != 3)
+        Throw("\"%s\": unsupported channel count %u!", filename.string(),
+              m_channel_count);
+    if (m_tile_size == 0 || level_count == 0 || level_count > 32)
+        Throw("\"%s\": invalid tiled image header!", filename.string());
+
+    size_t tile_total = 0;
+    ScalarVector2u size(width, height);
+    for (uint32_t i = 0; i < level_count; ++i) {
+        Level level;
+        level.size = size;
+        level.tile_count = (size + m_tile_size - 1u) / m_tile_size;
+        level.tile_offset = tile_total;
+        tile_total += (size_t) level.tile_count.x() * level.tile_count.y();
+        m_levels.push_back(level);
+        size = dr::maximum(size / 2u, 1u);
+    }
+
+    m_tile_offsets.resize(tile_total);
+    d->stream->read_array(m_tile_offsets.data(), tile_total);
+
+    m_id = tile_cache.next_id++;
+    tile_cache.image_count++;
+}
+
+TiledImage::~TiledImage() {
+    // Drop the tiles of this image from the cache and the hint tables
+    uint64_t id = (uint64_t) m_id << 32;
+    for (TileCacheShard &shard : tile_cache.shards) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        for (auto it = shard.lru.begin(); it != shard.lru.end(); ) {
+            uint64_t key = *it;
+            if ((key & 0xFFFFFFFF00000000ull) != id) {
+                ++it;
+                continue;
+            }
+            auto entry = shard.tiles.find(key);
+            shard.bytes -= entry->second.bytes;
+            tile_cache.resident_bytes -= entry->second.bytes;
+            shard.tiles.erase(entry);
+            it = shard.lru.erase(it);
+        }
+    }
+    tile_cache.generation++;
+
+    if (--tile_cache.image_count == 0) {
+        CacheStats stats = cache_stats();
+        if (stats.misses > 0) {
+            size_t budget = cache_budget();
+            Log(Info, "Tiled images: %.1f%% hit rate, %zu tiles loaded (%s in "
+                      "%s), %zu evictions, peak residency %s (budget: %s).",
+                100.0 * stats.hit_rate(), stats.misses,
+                util::mem_string(stats.bytes_read),
+                util::time_string((float) (stats.read_time * 1000.0)),
+                stats.evictions, util::mem_string(stats.peak_bytes),
+                budget > 0 ? util::mem_string(budget)
+                           : std::string("unlimited"));
+        }
+        reset_cache_stats();
+    }
+}
+
+void TiledImage::load_tile(uint32_t level, uint32_t tx, uint32_t ty,
+                           float *out) const {
+    const Level &l = m_levels[level];
+    size_t index = l.tile_offset + (size_t) ty * l.tile_count.x() + tx;
+    ScalarVector2u extent =
+        dr::minimum(l.size - ScalarVector2u(tx, ty) * m_tile_size, m_tile_size);
+    size_t bytes = (size_t) dr::prod(extent) * m_channel_count * sizeof(float);
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> guard(d->mutex);
+        d->stream->seek(m_tile_offsets[index]);
+        d->stream->read(out, bytes);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    tile_cache.bytes_read += bytes;
+    tile_cache.read_time_ns += (uint64_t)
+        std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+void TiledImage::read(uint32_t level, const ScalarVector2u &pos,
+                      float *out) const {
+    const Level &l = m_levels[level];
+    uint32_t tx = pos.x() / m_tile_size,
+             ty = pos.y() / m_tile_size;
+    size_t index = l.tile_offset + (size_t) ty * l.tile_count.x() + tx;
+    uint64_t key = ((uint64_t) m_id << 32) | (uint64_t) index;
+
+    // 1. Per-thread hint table
+    uint64_t generation = tile_cache.generation.load(std::memory_order_relaxed);
+    if (unlikely(tile_hints.generation != generation))
+        tile_hints.invalidate(generation);
+
+    TileHintTable::Entry &hint =
+        tile_hints.entries[(uint32_t) (key ^ (key >> 29)) & (TileHintSize - 1)];
+
+    if (likely(hint.key == key)) {
+        tile_hints.hits++;
+    } else {
+        // 2. Shared cache
+        TileCacheShard &shard = tile_cache.shard(key);
+        TileData tile;
+        {
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            auto it = shard.tiles.find(key);
+            if (it != shard.tiles.end()) {
+                shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru_it);
+                tile = it->second.tile;
+                tile_cache.hits++;
+            }
+        }
+
+        // 3. Load from disk without holding the lock
+        if (!tile) {
+            ScalarVector2u extent = dr::minimum(
+                l.size - ScalarVector2u(tx, ty) * m_tile_size, m_tile_size);
+            size_t bytes =
+                (size_t) dr::prod(extent) * m_channel_count * sizeof(float);
+            tile = TileData(new float[bytes / sizeof(float)]);
+            load_tile(level, tx, ty, tile.get());
+            tile_cache.misses++;
+
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            auto it = shard.tiles.find(key);
+            if (it == shard.tiles.end()) {
+                shard.lru.push_front(key);
+                shard.tiles.emplace(key, TileCacheShard::Entry{ tile, shard.lru.begin(), bytes });
+                shard.bytes += bytes;
+                tile_cache.add_resident(bytes);
+
+                size_t before = shard.bytes;
+                size_t evictions = shard.shrink(tile_cache.shard_budget());
+                if (evictions) {
+                    tile_cache.evictions += evictions;
+                    tile_cache.resident_bytes -= before - shard.bytes;
+                }
+            } else {
+                // Another thread loaded the tile in the meantime
+                tile = it->second.tile;
+            }
+        }
+
+        hint.key = key;
+        hint.tile = std::move(tile);
+    }
+
+    uint32_t tile_width = std::min(m_tile_size, l.size.x() - tx * m_tile_size);
+    const float *ptr = hint.tile.get() +
+        ((size_t) (pos.y() - ty * m_tile_size) * tile_width +
+         (pos.x() - tx * m_tile_size)) * m_channel_count;
+    for (uint32_t i = 0; i < m_channel_count; ++i)
+        out[i] = ptr[i];
+}
+
+std::string TiledImage::to_string() const {
+    std::ostringstream oss;
+    oss << "TiledImage[" << std::endl
+        << "  filename = \"" << m_filename.string() << "\"," << std::endl
+        << "  size = " << size() << "," << std::endl
+        << "  channel_count = " << m_channel_count << "," << std::endl
+        << "  tile_size = " << m_tile_size << "," << std::endl
+        << "  level_count = " << level_count() << "," << std::endl
+        << "  raw = " << (int) m_raw << std::endl
+        << "]";
+    return oss.str();
+}
+
+void TiledImage::convert(const fs::path &input, const fs::path &output,
+                         uint32_t tile_size, bool raw) {
+    if (tile_size == 0)
+        Throw("TiledImage::convert(): the tile size must be positive!");
+
+    ref<Bitmap> bitmap = new Bitmap(input);
+
+    Bitmap::PixelFormat pixel_format = bitmap->pixel_format();
+    switch (pixel_format) {
+        case Bitmap::PixelFormat::Y:
+        case Bitmap::PixelFormat::YA:
+            pixel_format = Bitmap::PixelFormat::Y;
+            break;
+
+        case Bitmap::PixelFormat::RGB:
+        case Bitmap::PixelFormat::RGBA:
+        case Bitmap::PixelFormat::XYZ:
+        case Bitmap::PixelFormat::XYZA:
+            pixel_format = Bitmap::PixelFormat::RGB;
+            break;
+
+        default:
+            Throw("TiledImage::convert(): the image needs to have a known "
+                  "pixel format (Y[A], RGB[A], XYZ[A] are supported).");
+    }
+
+    // Don't undo gamma correction in the conversion below
+    if (raw)
+        bitmap->set_srgb_gamma(false);
+
+    bitmap = bitmap->convert(pixel_format, Struct::Type::Float32, false);
+
+    // Build the MIP pyramid (see the 'bitmap' texture plugin)
+    std::vector<ref<Bitmap>> levels = { bitmap };
+    std::pair<float, float> bound = { raw ? -dr::Infinity<float> : 0.f,
+                                      dr::Infinity<float> };
+    while (dr::all(levels.back()->size() >= 4u))
+        levels.push_back(levels.back()->resample(
+            levels.back()->size() / 2u, nullptr,
+            { FilterBoundaryCondition::Repeat, FilterBoundaryCondition::Repeat },
+            bound));
+
+    uint32_t channel_count = (uint32_t) bitmap->channel_count(),
+             level_count   = (uint32_t) levels.size();
+
+    // Compute the offset table
+    size_t header_size = 4 + 6 * sizeof(uint32_t) + sizeof(uint8_t),
+           tile_total = 0;
+    for (const ref<Bitmap> &level : levels) {
+        ScalarVector2u tile_count = (level->size() + tile_size - 1u) / tile_size;
+        tile_total += (size_t) tile_count.x() * tile_count.y();
+    }
+
+    std::vector<uint64_t> offsets;
+    offsets.reserve(tile_total);
+    uint64_t offset = header_size + tile_total * sizeof(uint64_t);
+    for (const ref<Bitmap> &level : levels) {
+        ScalarVector2u size = level->size(),
+                       tile_count = (size + tile_size - 1u) / tile_size;
+        for (uint32_t ty = 0; ty < tile_count.y(); ++ty) {
+            for (uint32_t tx = 0; tx < tile_count.x(); ++tx) {
+                ScalarVector2u extent = dr::minimum(
+                    size - ScalarVector2u(tx, ty) * tile_size, tile_size);
+                offsets.push_back(offset);
+                offset += (uint64_t) dr::prod(extent) * channel_count * sizeof(float);
+            }
+        }
+    }
+
+    ref<FileStream> stream = new FileStream(output, FileStream::ETruncReadWrite);
+    stream->write(TiledImageMagic, 4);
+    stream->write(TiledImageVersion);
+    stream->write((uint32_t) bitmap->width());
+    stream->write((uint32_t) bitmap->height());
+    stream->write(channel_count);
+    stream->write(tile_size);
+    stream->write(level_count);
+    stream->write((uint8_t) (raw ? 1 : 0));
+    stream->write_array(offsets.data(), offsets.size());
+
+    std::vector<float> buffer((size_t) tile_size * tile_size * channel_count);
+    for (const ref<Bitmap> &level : levels) {
+        ScalarVector2u size = level->size(),
+                       tile_count = (size + tile_size - 1u) / tile_size;
+        const float *data = (const float *) level->data();
+        for (uint32_t ty = 0; ty < tile_count.y(); ++ty) {
+            for (uint32_t tx = 0; tx < tile_count.x(); ++tx) {
+                ScalarVector2u extent = dr::minimum(
+                    size - ScalarVector2u(tx, ty) * tile_size, tile_size);
+                size_t row = (size_t) extent.x() * channel_count;
+                for (uint32_t y = 0; y < extent.y(); ++y)
+                    memcpy(buffer.data() + y * row,
+                           data + (((size_t) ty * tile_size + y) * size.x() +
+                                   (size_t) tx * tile_size) * channel_count,
+                           row * sizeof(float));
+                stream->write(buffer.data(), row * extent.y() * sizeof(float));
+            }
+        }
+    }
+    stream->close();
+
+    Log(Info, "Converted \"%s\" into a tiled image with %u levels (%s).",
+        input.filename().string(), level_count, util::mem_string(offset));
+}
+
+void TiledImage::set_cache_budget(size_t bytes) {
+    tile_cache.budget = bytes;
+    size_t budget = tile_cache.shard_budget();
+    for (TileCacheShard &shard : tile_cache.shards) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        size_t before = shard.bytes;
+        tile_cache.evictions += shard.shrink(budget);
+        tile_cache.resident_bytes -= before - shard.bytes;
+    }
+    tile_cache.generation++;
+}
+
+size_t TiledImage::cache_budget() { return tile_cache.budget; }
+
+TiledImage::CacheStats TiledImage::cache_stats() {
+    tile_hints.flush();
+
+    CacheStats stats;
+    stats.hint_hits      = tile_cache.hint_hits;
+    stats.hits           = tile_cache.hits;
+    stats.misses         = tile_cache.misses;
+    stats.evictions      = tile_cache.evictions;
+    stats.bytes_read     = tile_cache.bytes_read;
+    stats.read_time      = tile_cache.read_time_ns * 1e-9;
+    stats.resident_bytes = tile_cache.resident_bytes;
+    stats.peak_bytes     = tile_cache.peak_bytes;
+    return stats;
+}
+
+void TiledImage::reset_cache_stats() {
+    tile_hints.hits = 0;
+    tile_cache.hint_hits = tile_cache.hits = tile_cache.misses = 0;
+    tile_cache.evictions = tile_cache.bytes_read = 0;
+    tile_cache.read_time_ns = 0;
+    tile_cache.peak_bytes = tile_cache.resident_bytes.load();
+}
+
+void TiledImage::clear_cache() {
+    for (TileCacheShard &shard : tile_cache.shards) {
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        tile_cache.resident_bytes -= shard.bytes;
+        shard.lru.clear();
+        shard.tiles.clear();
+        shard.bytes = 0;
+    }
+    tile_cache.generation++;
+}
+
+MI_IMPLEMENT_CLASS(TiledImage, Object)
+NAMESPACE_END(mitsuba)
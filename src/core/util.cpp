@@ -1,4 +1,5 @@
 #include <drjit/packet.h>
+#include <cstdio>
 
 #include <mitsuba/core/util.h>
 #include <mitsuba/core/logger.h>
@@ -16,11 +17,13 @@
 #  include <sys/ioctl.h>
 #elif defined(__APPLE__)
 #  include <sys/sysctl.h>
+#  include <mach/mach.h>
 #  include <mach-o/dyld.h>
 #  include <unistd.h>
 #  include <sys/ioctl.h>
 #elif defined(_WIN32)
 #  include <windows.h>
+#  include <psapi.h>
 #endif
 
 NAMESPACE_BEGIN(mitsuba)
@@ -271,6 +274,33 @@ int terminal_width() {
     return cached_width;
 }
 
+size_t resident_memory() {
+#if defined(__linux__)
+    long pages = 0, resident = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (!f)
+        return 0;
+    if (fscanf(f, "%ld %ld", &pages, &resident) != 2)
+        resident = 0;
+    fclose(f);
+    return (size_t) resident * (size_t) sysconf(_SC_PAGESIZE);
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO,
+                  (task_info_t) &info, &count) != KERN_SUCCESS)
+        return 0;
+    return (size_t) info.resident_size;
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return (size_t) counters.WorkingSetSize;
+#else
+    return 0;
+#endif
+}
+
 std::string info_build(int thread_count) {
     constexpr size_t PacketSize = dr::Packet<float>::Size;
 
@@ -1,19 +1,28 @@
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <cstring>
 #include <fstream>
 #include <set>
+#include <thread>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 #include <map>
 
+#include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/class.h>
 #include <mitsuba/core/config.h>
 #include <mitsuba/core/filesystem.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/hash.h>
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/math.h>
 #include <mitsuba/core/object.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/profiler.h>
+#include <mitsuba/core/sharedcache.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/core/transform.h>
@@ -210,6 +219,41 @@ ColorMode variant_to_color_mode() {
         static_assert(false_v<Float, Spectrum>, "This should never happen!");
 }
 
+/// Timeline of the object instantiations performed while loading a scene
+struct LoadProfile {
+    struct Entry {
+        std::string id, class_name, plugin, source;
+        std::vector<std::string> children;
+        /// Start and end time (in microseconds since loading began)
+        uint64_t start, end;
+        uint32_t thread;
+        /// Change of the resident memory of the process during instantiation
+        int64_t memory;
+    };
+
+    std::string filename;
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    uint64_t parse_end = 0;
+
+    std::mutex mutex;
+    std::vector<Entry> entries;
+    std::unordered_map<std::thread::id, uint32_t> threads;
+
+    LoadProfile(const std::string &filename) : filename(filename) { }
+
+    uint64_t now() const {
+        return (uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_time).count();
+    }
+
+    void record(Entry &&entry) {
+        std::lock_guard<std::mutex> guard(mutex);
+        auto it = threads.emplace(std::this_thread::get_id(), (uint32_t) threads.size()).first;
+        entry.thread = it->second;
+        entries.push_back(std::move(entry));
+    }
+};
+
 struct XMLParseContext {
     std::string variant;
     bool parallel;
@@ -220,6 +264,12 @@ struct XMLParseContext {
     uint32_t id_counter = 0;
     uint32_t backend = 0;
 
+    /// Properties of objects that were instantiated while parsing the XML file
+    std::unordered_map<const Object *, Properties> inline_objects;
+
+    /// Instantiation timeline (only when enabled via \ref set_load_profile())
+    LoadProfile *profile = nullptr;
+
     XMLParseContext(const std::string &variant, bool parallel)
         : variant(variant), parallel(parallel) {
         color_mode = MI_INVOKE_VARIANT(variant, variant_to_color_mode);
@@ -392,6 +442,180 @@ void upgrade_tree(XMLSource &src, pugi::xml_node &node, const Version &version)
             Version(MI_VERSION));
 }
 
+/// Properties of the texture plugin created for an inline <rgb> tag
+static Properties rgb_texture_props(const std::string &name,
+                                    Color<float, 3> color,
+                                    bool within_emitter) {
+    Properties props(within_emitter ? "d65" : "srgb");
+    props.set_color("color", color);
+
+    if (!within_emitter && is_unbounded_spectrum(name))
+        props.set_bool("unbounded", true);
+
+    return props;
+}
+
+/**
+ * Properties of the texture plugin created for an inline <spectrum> tag.
+ *
+ * Irregular and regular spectra reference the contents of \c wavelengths and
+ * \c values, which must hence outlive the returned properties.
+ */
+static Properties spectrum_texture_props(const std::string &name,
+                                         Float const_value,
+                                         std::vector<Float> &wavelengths,
+                                         std::vector<Float> &values,
+                                         bool within_emitter,
+                                         bool is_spectral_mode,
+                                         bool is_monochromatic_mode) {
+    bool is_unbounded = is_unbounded_spectrum(name);
+    if (wavelengths.empty()) {
+        if (!is_spectral_mode && within_emitter && !is_unbounded) {
+            /* A uniform spectrum does not produce a uniform RGB response in the
+               sRGB (which has a D65 white point). The call to 'xyz_to_srgb'
+               computes this purple-ish color and uses it to initialize the
+               'srgb' plugin. This is needed mainly for consistency between RGB
+               and spectral variants of Mitsuba. */
+            Color3f color = const_value * xyz_to_srgb(Color3f(1.0));
+            Properties props("srgb");
+            props.set_color("color", color);
+            props.set_bool("unbounded", true);
+            return props;
+        } else {
+            Properties props("uniform");
+            props.set_float("value", const_value);
+            return props;
+        }
+    } else {
+        /* Detect whether wavelengths are regularly sampled and potentially
+           apply the conversion factor. */
+        Float min_interval = std::numeric_limits<Float>::infinity(),
+              max_interval = 0.0;
+
+        /* Values should be scaled so that integrating the spectrum against the
+           CIE curves and converting to sRGB yields (1, 1, 1) for D65 in
+           non-spectral modes. */
+        Float unit_conversion =
+            !is_spectral_mode ? Float(MI_CIE_Y_NORMALIZATION) : Float(1.f);
+
+        for (size_t n = 0; n < wavelengths.size(); ++n) {
+            values[n] *= unit_conversion;
+
+            if (n <= 0)
+                continue;
+
+            Float distance = (wavelengths[n] - wavelengths[n - 1]);
+            if (distance < 0)
+                Throw("Wavelengths must be specified in increasing order!");
+
+            min_interval = std::min(distance, min_interval);
+            max_interval = std::max(distance, max_interval);
+        }
+
+        if (is_spectral_mode) {
+            Properties props;
+
+            /* The regular spectrum class is more efficient, so tolerate a small
+               amount of imprecision in the parsed interval positions.. */
+            bool is_regular =
+                (max_interval - min_interval) < Float(1e-3) * min_interval;
+
+            if (is_regular) {
+                props.set_plugin_name("regular");
+                props.set_long("size", wavelengths.size());
+                props.set_float("wavelength_min", wavelengths.front());
+                props.set_float("wavelength_max", wavelengths.back());
+                props.set_pointer("values", values.data());
+            } else {
+                props.set_plugin_name("irregular");
+                props.set_long("size", wavelengths.size());
+                props.set_pointer("wavelengths", wavelengths.data());
+                props.set_pointer("values", values.data());
+            }
+
+            return props;
+        } else {
+            /* Pre-integrate against the CIE matching curves. In order to match
+               the behavior of spectral modes, this function should instead
+               pre-integrate against the product of the CIE curves and the CIE
+               D65 curve in the case of reflectance values. */
+            Color3f color = spectrum_list_to_srgb(
+                wavelengths, values,
+                /* bounded */ !(within_emitter || is_unbounded),
+                /* d65 */ !(within_emitter && !is_unbounded));
+
+
+            Properties props;
+            if (is_monochromatic_mode) {
+                props = Properties("uniform");
+                props.set_float("value", luminance(color));
+            } else {
+                props = Properties("srgb");
+                props.set_color("color", color);
+
+                if (within_emitter || is_unbounded)
+                    props.set_bool("unbounded", true);
+            }
+
+            return props;
+        }
+    }
+}
+
+/**
+ * Remember the properties of an object that was instantiated while parsing
+ * (e.g. an inline <rgb> texture), so that it can be written to a snapshot.
+ * Pointer-valued spectral data is converted into its string representation.
+ */
+static void record_inline_object(XMLParseContext &ctx, const Object *object,
+                                 const Properties &props_) {
+    Properties props(props_);
+    if (props.has_property("size")) {
+        size_t size = (size_t) props.get<int64_t>("size");
+        for (const char *key : { "wavelengths", "values" }) {
+            if (!props.has_property(key) ||
+                props.type(key) != Properties::Type::Pointer)
+                continue;
+            const Float *data = (const Float *) props.pointer(key);
+            std::ostringstream oss;
+            oss.precision(17);
+            for (size_t i = 0; i < size; ++i)
+                oss << (i > 0 ? ", " : "") << data[i];
+            props.remove_property(key);
+            props.set_string(key, oss.str());
+        }
+        props.remove_property("size");
+    }
+    ctx.inline_objects.emplace(object, std::move(props));
+}
+
+/**
+ * Start decoding the image referenced by a bitmap texture or environment map
+ * in the background, so that it is ready (or at least underway) once the
+ * object is instantiated. See \ref Bitmap::prefetch().
+ */
+static void prefetch_bitmap(const XMLObject &inst) {
+    const Properties &props = inst.props;
+    const std::string &alias = inst.class_->alias(),
+                      &plugin = props.plugin_name();
+    if (!((alias == "texture" && plugin == "bitmap") ||
+          (alias == "emitter" && plugin == "envmap")) ||
+        !props.has_property("filename") ||
+        props.type("filename") != Properties::Type::String)
+        return;
+
+    // The image isn't decoded when its spectral coefficients are cached on disk
+    if (props.has_property("spectral_cache") &&
+        props.type("spectral_cache") == Properties::Type::Bool &&
+        props.get<bool>("spectral_cache"))
+        return;
+
+    fs::path filename =
+        Thread::thread()->file_resolver()->resolve(props.string("filename"));
+    if (fs::exists(filename))
+        Bitmap::prefetch(filename);
+}
+
 static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseContext &ctx,
                                                      pugi::xml_node &node, Tag parent_tag,
                                                      Properties &props, ParameterList &param,
@@ -539,7 +763,7 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                     }
 
                     auto &inst = ctx.instances[id];
-                    inst.props = props_nested;
+                    inst.props = std::move(props_nested);
                     inst.class_ = it2->second;
                     inst.offset = src.offset;
                     inst.src_id = src.id;
@@ -551,6 +775,8 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                     }
 #endif
                     inst.location = node.offset_debug();
+                    if (ctx.parallel)
+                        prefetch_bitmap(inst);
                     return std::make_pair(name, id);
                 }
                 break;
@@ -772,6 +998,9 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                         std::string name = node.attribute("name").value();
                         ref<Object> obj = detail::create_texture_from_rgb(
                             name, color, ctx.variant, within_emitter);
+                        record_inline_object(
+                            ctx, obj.get(),
+                            rgb_texture_props(name, color, within_emitter));
                         props.set_object(name, obj);
                     } else {
                         props.set_color("color", color);
@@ -827,11 +1056,13 @@ static std::pair<std::string, std::string> parse_xml(XMLSource &src, XMLParseCon
                         }
                     }
 
-                    ref<Object> obj = detail::create_texture_from_spectrum(
-                        name, const_value, wavelengths, values, ctx.variant,
-                        within_emitter,
+                    Properties tex_props = spectrum_texture_props(
+                        name, const_value, wavelengths, values, within_emitter,
                         ctx.color_mode == ColorMode::Spectral,
                         ctx.color_mode == ColorMode::Monochromatic);
+                    ref<Object> obj = PluginManager::instance()->create_object(
+                        tex_props, Class::for_name("Texture", ctx.variant));
+                    record_inline_object(ctx, obj.get(), tex_props);
 
                     props.set_object(name, obj);
                 }
@@ -1007,6 +1238,247 @@ static std::string init_xml_parse_context_from_file(XMLParseContext &ctx,
     return scene_id;
 }
 
+/// Helper function: hash the raw contents of a file in large chunks
+static size_t file_content_hash(const fs::path &filename) {
+    std::ifstream is(filename.native(), std::ios::binary);
+    if (!is.good())
+        Throw("Unable to open \"%s\" for hashing!", filename);
+
+    std::unique_ptr<char[]> buffer(new char[1024 * 1024]);
+    size_t value = 0;
+    while (is.good()) {
+        is.read(buffer.get(), 1024 * 1024);
+        std::streamsize count = is.gcount();
+        if (count <= 0)
+            break;
+        value = hash_combine(value, std::hash<std::string_view>()(
+                                        std::string_view(buffer.get(), (size_t) count)));
+    }
+    return value;
+}
+
+/// Helper function: check whether two files have identical contents
+static bool file_contents_equal(const fs::path &a, const fs::path &b) {
+    if (fs::equivalent(a, b))
+        return true;
+
+    std::ifstream is_a(a.native(), std::ios::binary),
+                  is_b(b.native(), std::ios::binary);
+    if (!is_a.good() || !is_b.good())
+        Throw("Unable to open \"%s\" and \"%s\" for comparison!", a, b);
+
+    const size_t chunk = 1024 * 1024;
+    std::unique_ptr<char[]> buf_a(new char[chunk]), buf_b(new char[chunk]);
+    while (true) {
+        is_a.read(buf_a.get(), chunk);
+        is_b.read(buf_b.get(), chunk);
+        std::streamsize count_a = is_a.gcount(), count_b = is_b.gcount();
+        if (count_a != count_b ||
+            std::memcmp(buf_a.get(), buf_b.get(), (size_t) count_a) != 0)
+            return false;
+        if (count_a <= 0 || !is_a.good() || !is_b.good())
+            return is_a.good() == is_b.good();
+    }
+}
+
+/**
+ * \brief Structural key of an object description, ignoring its \c to_world
+ * transform and its identifier.
+ *
+ * Anonymous child objects (e.g. a nested BSDF) are expanded recursively so
+ * that per-object duplicates of the same material still compare as equal.
+ */
+static std::string structural_key(XMLParseContext &ctx, const Properties &props,
+                                  int depth = 0) {
+    std::ostringstream oss;
+    oss << props.plugin_name() << "{";
+    for (const std::string &name : props.property_names()) {
+        if (depth == 0 && (name == "to_world" || name == "filename"))
+            continue;
+        oss << name << "=";
+        if (props.type(name) == Properties::Type::NamedReference) {
+            const std::string &child_id = props.named_reference(name);
+            auto it = ctx.instances.find(child_id);
+            if (it != ctx.instances.end() && it->second.alias.empty() &&
+                string::starts_with(child_id, "_unnamed_") && depth < 8)
+                oss << structural_key(ctx, it->second.props, depth + 1);
+            else
+                oss << "#" << child_id;
+        } else {
+            oss << props.as_string(name);
+        }
+        oss << ";";
+    }
+    oss << "}";
+    return oss.str();
+}
+
+/**
+ * \brief Scene-load pass that collapses byte-identical meshes into instances
+ *
+ * Mesh loaders bake the \c to_world transform into the vertex positions, so
+ * duplicates can only be detected before the shapes are instantiated. This
+ * pass groups file-based meshes that are direct children of the scene by
+ * their remaining parameters and by their (object-space) file contents,
+ * which are hashed and then compared byte by byte. Each group with more than one member is rewritten into a single
+ * prototype shape within a \c shapegroup, and every original shape is
+ * replaced by an \c instance carrying its former \c to_world transform.
+ *
+ * The pass is enabled by setting the boolean \c auto_instancing property of
+ * the scene.
+ */
+static void auto_instance(XMLParseContext &ctx, const std::string &scene_id) {
+    auto it_scene = ctx.instances.find(scene_id);
+    if (it_scene == ctx.instances.end() || !it_scene->second.class_ ||
+        it_scene->second.class_->alias() != "scene")
+        return;
+
+    Properties &scene_props = it_scene->second.props;
+    if (!scene_props.get<bool>("auto_instancing", false))
+        return;
+
+    Timer timer;
+    ref<FileResolver> fs = Thread::thread()->file_resolver();
+
+    struct Candidate {
+        std::string id;
+        fs::path filename;
+        size_t size;
+    };
+
+    // Group candidate shapes by their structural key and file size
+    std::map<std::pair<std::string, size_t>, std::vector<Candidate>> groups;
+    for (auto &kv : scene_props.named_references()) {
+        const std::string &child_id = kv.second;
+        auto it = ctx.instances.find(child_id);
+        if (it == ctx.instances.end() || !it->second.alias.empty() ||
+            !it->second.class_)
+            continue;
+
+        XMLObject &inst = it->second;
+        const std::string &plugin = inst.props.plugin_name();
+        if (inst.class_->alias() != "shape" ||
+            (plugin != "ply" && plugin != "obj" && plugin != "serialized") ||
+            !inst.props.has_property("filename") ||
+            inst.props.type("filename") != Properties::Type::String)
+            continue;
+
+        // Shapes with attached emitters or sensors cannot be instanced
+        bool instanceable = true;
+        for (auto &kv2 : inst.props.named_references()) {
+            auto it2 = ctx.instances.find(kv2.second);
+            if (it2 == ctx.instances.end() || !it2->second.class_)
+                continue;
+            const std::string &alias = it2->second.class_->alias();
+            if (alias == "emitter" || alias == "sensor")
+                instanceable = false;
+        }
+        if (!instanceable)
+            continue;
+
+        fs::path filename = fs->resolve(inst.props.string("filename"));
+        if (!fs::exists(filename))
+            continue;
+
+        size_t size = fs::file_size(filename);
+        groups[{ structural_key(ctx, inst.props), size }].push_back(
+            Candidate{ child_id, filename, size });
+    }
+
+    size_t shape_count = 0, group_count = 0, bytes_saved = 0;
+    std::unordered_map<std::string, size_t> hash_cache;
+
+    for (auto &kv : groups) {
+        const std::vector<Candidate> &candidates = kv.second;
+        if (candidates.size() < 2)
+            continue;
+
+        // Only hash the contents of files whose size and parameters collide
+        std::unordered_map<size_t, std::vector<const Candidate *>> by_hash;
+        for (const Candidate &c : candidates) {
+            auto it = hash_cache.find(c.filename.string());
+            if (it == hash_cache.end())
+                it = hash_cache.emplace(c.filename.string(),
+                                        file_content_hash(c.filename)).first;
+            by_hash[it->second].push_back(&c);
+        }
+
+        /* The hash only serves as a bucket key: the members of a bucket are
+           compared byte by byte, so that a collision never merges meshes
+           with different contents */
+        std::vector<std::vector<const Candidate *>> classes;
+        for (auto &kv2 : by_hash) {
+            if (kv2.second.size() < 2)
+                continue;
+            size_t first_class = classes.size();
+            for (const Candidate *c : kv2.second) {
+                size_t i = first_class;
+                while (i < classes.size() &&
+                       !file_contents_equal(classes[i][0]->filename, c->filename))
+                    ++i;
+                if (i == classes.size())
+                    classes.emplace_back();
+                classes[i].push_back(c);
+            }
+        }
+
+        for (const std::vector<const Candidate *> &members : classes) {
+            if (members.size() < 2)
+                continue;
+
+            std::string group_id = tfm::format("_autoinst_%zu", group_count++),
+                        proto_id = group_id + "_shape";
+
+            // Prototype shape: parameters of the first member in object space
+            XMLObject &first = ctx.instances.find(members[0]->id)->second;
+            XMLObject &proto = ctx.instances[proto_id];
+            proto.props = first.props;
+            proto.props.set_id(proto_id);
+            proto.props.remove_property("to_world");
+            proto.class_ = first.class_;
+            proto.src_id = first.src_id;
+            proto.offset = first.offset;
+            proto.location = first.location;
+            proto.scope = first.scope;
+
+            XMLObject &group = ctx.instances[group_id];
+            group.props = Properties("shapegroup");
+            group.props.set_id(group_id);
+            group.props.set_named_reference("shape", proto_id);
+            group.class_ = first.class_;
+            group.src_id = first.src_id;
+            group.offset = first.offset;
+            group.location = first.location;
+            group.scope = first.scope;
+
+            // Replace each member by an instance of the shape group
+            for (const Candidate *c : members) {
+                XMLObject &inst = ctx.instances.find(c->id)->second;
+                Properties props("instance");
+                props.set_id(c->id);
+                if (inst.props.has_property("to_world"))
+                    props.copy_attribute(inst.props, "to_world", "to_world");
+                props.set_named_reference("shapegroup", group_id);
+                inst.props = std::move(props);
+            }
+
+            shape_count += members.size();
+            bytes_saved += (members.size() - 1) * members[0]->size;
+        }
+    }
+
+    if (group_count > 0)
+        Log(Info, "Automatic instancing: replaced %zu shapes by instances of "
+                  "%zu shape groups (%s of duplicate geometry data not "
+                  "loaded, took %s). Refer to the acceleration data structure "
+                  "log for the resulting BVH build time.",
+            shape_count, group_count, util::mem_string(bytes_saved),
+            util::time_string((float) timer.value()));
+    else
+        Log(Info, "Automatic instancing: no duplicate meshes found (took %s).",
+            util::time_string((float) timer.value()));
+}
+
 static Task *instantiate_node(XMLParseContext &ctx,
                               const std::string &id,
                               ThreadEnvironment &env,
@@ -1051,6 +1523,13 @@ static Task *instantiate_node(XMLParseContext &ctx,
         Properties &props = inst.props;
         const auto &named_references = props.named_references();
 
+        uint64_t profile_start = 0;
+        size_t profile_memory = 0;
+        if (ctx.profile) {
+            profile_start = ctx.profile->now();
+            profile_memory = util::resident_memory();
+        }
+
         // Populate props with the already instantiated child objects
         for (auto &kv : named_references) {
             const std::string& child_id = kv.second;
@@ -1083,6 +1562,20 @@ static Task *instantiate_node(XMLParseContext &ctx,
                   e.what());
         }
 
+        if (ctx.profile) {
+            LoadProfile::Entry entry;
+            entry.id = id;
+            entry.class_name = inst.class_->name();
+            entry.plugin = props.plugin_name();
+            entry.source = inst.src_id;
+            for (auto &kv : named_references)
+                entry.children.push_back(kv.second);
+            entry.start = profile_start;
+            entry.end = ctx.profile->now();
+            entry.memory = (int64_t) util::resident_memory() - (int64_t) profile_memory;
+            ctx.profile->record(std::move(entry));
+        }
+
         auto unqueried = props.unqueried();
         if (!unqueried.empty()) {
             for (auto &v : unqueried) {
@@ -1144,126 +1637,317 @@ static ref<Object> instantiate_top_node(XMLParseContext &ctx, const std::string
     return ctx.instances.find(id)->second.object;
 }
 
-ref<Object> create_texture_from_rgb(const std::string &name,
-                                    Color<float, 3> color,
-                                    const std::string &variant,
-                                    bool within_emitter) {
-    Properties props(within_emitter ? "d65" : "srgb");
-    props.set_color("color", color);
-
-    if (!within_emitter && is_unbounded_spectrum(name))
-        props.set_bool("unbounded", true);
+/// Object IDs in dependency order along with their (alias-resolved) references
+using GraphOrder = std::vector<std::pair<std::string,
+                               std::vector<std::pair<std::string, std::string>>>>;
 
-    ref<Object> texture = PluginManager::instance()->create_object(
-        props, Class::for_name("Texture", variant));
-    std::vector<ref<Object>> children = texture->expand();
-    if (!children.empty())
-        return (Object *) children[0].get();
-    return texture;
+static std::string resolve_alias(XMLParseContext &ctx, const std::string &id) {
+    std::string result = id;
+    for (int i = 0; ; ++i) {
+        auto it = ctx.instances.find(result);
+        if (it == ctx.instances.end())
+            Throw("reference to unknown object \"%s\"!", result);
+        if (it->second.alias.empty())
+            return result;
+        if (i > (int) ctx.instances.size())
+            Throw("cyclic alias \"%s\"!", id);
+        result = it->second.alias;
+    }
 }
 
-ref<Object> create_texture_from_spectrum(const std::string &name,
-                                         Float const_value,
-                                         std::vector<Float> &wavelengths,
-                                         std::vector<Float> &values,
-                                         const std::string &variant,
-                                         bool within_emitter,
-                                         bool is_spectral_mode,
-                                         bool is_monochromatic_mode) {
-    const Class *class_ = Class::for_name("Texture", variant);
+static void collect_graph_nodes(XMLParseContext &ctx, const std::string &id,
+                                std::unordered_set<std::string> &visited,
+                                GraphOrder &order) {
+    if (!visited.insert(id).second)
+        return;
 
-    bool is_unbounded = is_unbounded_spectrum(name);
-    if (wavelengths.empty()) {
-        if (!is_spectral_mode && within_emitter && !is_unbounded) {
-            /* A uniform spectrum does not produce a uniform RGB response in the
-               sRGB (which has a D65 white point). The call to 'xyz_to_srgb'
-               computes this purple-ish color and uses it to initialize the
-               'srgb' plugin. This is needed mainly for consistency between RGB
-               and spectral variants of Mitsuba. */
-            Color3f color = const_value * xyz_to_srgb(Color3f(1.0));
-            Properties props("srgb");
-            props.set_color("color", color);
-            props.set_bool("unbounded", true);
-            return PluginManager::instance()->create_object(props, class_);
-        } else {
-            Properties props("uniform");
-            props.set_float("value", const_value);
-            return PluginManager::instance()->create_object(props, class_);
-        }
-    } else {
-        /* Detect whether wavelengths are regularly sampled and potentially
-           apply the conversion factor. */
-        Float min_interval = std::numeric_limits<Float>::infinity(),
-              max_interval = 0.0;
+    std::vector<std::pair<std::string, std::string>> refs;
+    for (auto &kv : ctx.instances.find(id)->second.props.named_references()) {
+        std::string child_id = resolve_alias(ctx, kv.second);
+        collect_graph_nodes(ctx, child_id, visited, order);
+        refs.emplace_back(kv.first, child_id);
+    }
 
-        /* Values should be scaled so that integrating the spectrum against the
-           CIE curves and converting to sRGB yields (1, 1, 1) for D65 in
-           non-spectral modes. */
-        Float unit_conversion =
-            !is_spectral_mode ? Float(MI_CIE_Y_NORMALIZATION) : Float(1.f);
+    order.emplace_back(id, std::move(refs));
+}
 
-        for (size_t n = 0; n < wavelengths.size(); ++n) {
-            values[n] *= unit_conversion;
+/**
+ * Attach an empty object graph to the scene before it is instantiated. The
+ * graph is populated by \ref finalize_object_graph() once all objects exist,
+ * which is why the references between objects are recorded here.
+ */
+static ref<ObjectGraph> prepare_object_graph(XMLParseContext &ctx,
+                                             const std::string &scene_id,
+                                             GraphOrder &order) {
+    auto it = ctx.instances.find(scene_id);
+    if (!keep_object_graph() || it == ctx.instances.end() ||
+        !it->second.class_ || it->second.class_->alias() != "scene")
+        return nullptr;
 
-            if (n <= 0)
-                continue;
+    std::unordered_set<std::string> visited;
+    collect_graph_nodes(ctx, scene_id, visited, order);
 
-            Float distance = (wavelengths[n] - wavelengths[n - 1]);
-            if (distance < 0)
-                Throw("Wavelengths must be specified in increasing order!");
+    ref<ObjectGraph> graph = new ObjectGraph(ctx.variant);
+    it->second.props.set_object("_object_graph", graph.get());
+    return graph;
+}
 
-            min_interval = std::min(distance, min_interval);
-            max_interval = std::max(distance, max_interval);
+/// Move the resolved properties of all instantiated objects into the graph
+static void finalize_object_graph(XMLParseContext &ctx, ObjectGraph *graph,
+                                  GraphOrder &order) {
+    std::vector<ObjectGraph::Node> &nodes = graph->nodes();
+    nodes.reserve(order.size());
+    size_t inline_counter = 0;
+
+    for (size_t i = 0; i < order.size(); ++i) {
+        XMLObject &inst = ctx.instances.find(order[i].first)->second;
+        ObjectGraph::Node node { order[i].first, inst.class_->name(),
+                                 std::move(inst.props), nullptr };
+        if (i + 1 < order.size())
+            node.object = inst.object;
+        node.props.remove_property("_object_graph");
+
+        /* Child objects were substituted into the properties during
+           instantiation. Objects created while parsing (e.g. <rgb> tags)
+           turn into separate nodes, all others revert to references. */
+        for (auto &kv : node.props.objects(false)) {
+            node.props.remove_property(kv.first);
+
+            auto it = ctx.inline_objects.find(kv.second.get());
+            if (it == ctx.inline_objects.end())
+                continue;
+
+            std::string inline_id = "_inline_" + std::to_string(inline_counter++);
+            nodes.push_back({ inline_id, "Texture", it->second, kv.second });
+            node.props.set_named_reference(kv.first, inline_id);
         }
 
-        if (is_spectral_mode) {
-            Properties props;
+        for (auto &kv : order[i].second)
+            node.props.set_named_reference(kv.first, kv.second, false);
 
-            /* The regular spectrum class is more efficient, so tolerate a small
-               amount of imprecision in the parsed interval positions.. */
-            bool is_regular =
-                (max_interval - min_interval) < Float(1e-3) * min_interval;
+        nodes.push_back(std::move(node));
+    }
+}
 
-            if (is_regular) {
-                props.set_plugin_name("regular");
-                props.set_long("size", wavelengths.size());
-                props.set_float("wavelength_min", wavelengths.front());
-                props.set_float("wavelength_max", wavelengths.back());
-                props.set_pointer("values", values.data());
-            } else {
-                props.set_plugin_name("irregular");
-                props.set_long("size", wavelengths.size());
-                props.set_pointer("wavelengths", wavelengths.data());
-                props.set_pointer("values", values.data());
-            }
+/// Escape a string so that it can be embedded into a JSON document
+static std::string json_escape(const std::string &str) {
+    std::string result;
+    result.reserve(str.size());
+    for (char c : str) {
+        switch (c) {
+            case '"':  result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if ((unsigned char) c < 0x20)
+                    result += tfm::format("\\u%04x", (int) c);
+                else
+                    result += c;
+        }
+    }
+    return result;
+}
 
-            return PluginManager::instance()->create_object(props, class_);
-        } else {
-            /* Pre-integrate against the CIE matching curves. In order to match
-               the behavior of spectral modes, this function should instead
-               pre-integrate against the product of the CIE curves and the CIE
-               D65 curve in the case of reflectance values. */
-            Color3f color = spectrum_list_to_srgb(
-                wavelengths, values,
-                /* bounded */ !(within_emitter || is_unbounded),
-                /* d65 */ !(within_emitter && !is_unbounded));
+static std::string signed_mem_string(int64_t value) {
+    return (value < 0 ? "-" : "") + util::mem_string((size_t) std::abs(value));
+}
 
+/// Log how many objects shared their data with others (see \ref SharedCache)
+static void log_shared_cache_stats(const SharedCache::Stats &before) {
+    SharedCache::Stats after = SharedCache::stats();
+    size_t requests = after.requests - before.requests,
+           hits = after.hits - before.hits;
+    if (requests == 0 || after.requests < before.requests)
+        return;
+    Log(Info, "Shared data cache: %zu of %zu objects reused data loaded by "
+              "other objects (%s of duplicate data not loaded).",
+        hits, requests, util::mem_string(after.bytes_saved - before.bytes_saved));
+}
 
-            Properties props;
-            if (is_monochromatic_mode) {
-                props = Properties("uniform");
-                props.set_float("value", luminance(color));
-            } else {
-                props = Properties("srgb");
-                props.set_color("color", color);
+/**
+ * Write the instantiation timeline in the Chrome trace event format (which can
+ * be opened with chrome://tracing or https://ui.perfetto.dev) and log a
+ * summary of the most expensive plugin types and objects, along with the
+ * critical path through the dependency graph.
+ */
+static void write_load_profile(LoadProfile &profile) {
+    uint64_t end_time = profile.now();
+    std::vector<LoadProfile::Entry> &entries = profile.entries;
+
+    std::ofstream os(profile.filename);
+    os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [" << std::endl;
+    os << "  {\"name\": \"Parse XML\", \"cat\": \"parse\", \"ph\": \"X\", "
+       << "\"ts\": 0, \"dur\": " << profile.parse_end
+       << ", \"pid\": 0, \"tid\": 0}";
+    for (const LoadProfile::Entry &e : entries) {
+        os << "," << std::endl
+           << "  {\"name\": \"" << json_escape(e.id) << "\", \"cat\": \""
+           << json_escape(string::to_lower(e.class_name)) << "\", \"ph\": \"X\", "
+           << "\"ts\": " << e.start << ", \"dur\": " << e.end - e.start
+           << ", \"pid\": 0, \"tid\": " << e.thread << ", \"args\": {"
+           << "\"plugin\": \"" << json_escape(e.plugin) << "\", "
+           << "\"source\": \"" << json_escape(e.source) << "\", "
+           << "\"memory\": " << e.memory << "}}";
+    }
+    os << std::endl << "]}" << std::endl;
+    if (!os.good())
+        Log(Warn, "Could not write scene load profile to \"%s\"!", profile.filename);
+
+    // Aggregate the cost per plugin type
+    struct Summary {
+        std::string name;
+        size_t count = 0;
+        uint64_t total = 0, max = 0;
+        int64_t memory = 0;
+    };
+    std::unordered_map<std::string, Summary> summary_map;
+    uint64_t total_work = 0;
+    for (const LoadProfile::Entry &e : entries) {
+        std::string name = string::to_lower(e.class_name) + "/" + e.plugin;
+        Summary &s = summary_map[name];
+        uint64_t duration = e.end - e.start;
+        s.name = name;
+        s.count++;
+        s.total += duration;
+        s.max = std::max(s.max, duration);
+        s.memory += e.memory;
+        total_work += duration;
+    }
 
-                if (within_emitter || is_unbounded)
-                    props.set_bool("unbounded", true);
+    std::vector<Summary> summary;
+    for (auto &kv : summary_map)
+        summary.push_back(kv.second);
+    std::sort(summary.begin(), summary.end(),
+              [](const Summary &a, const Summary &b) { return a.total > b.total; });
+
+    // Longest chain of dependent instantiations
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < entries.size(); ++i)
+        index[entries[i].id] = i;
+
+    std::vector<uint64_t> path_length(entries.size(), 0);
+    std::vector<size_t> path_next(entries.size(), (size_t) -1);
+    std::function<uint64_t(size_t)> critical_path = [&](size_t i) -> uint64_t {
+        if (path_length[i] > 0)
+            return path_length[i];
+        uint64_t longest = 0;
+        for (const std::string &child : entries[i].children) {
+            auto it = index.find(child);
+            if (it == index.end())
+                continue;
+            uint64_t length = critical_path(it->second);
+            if (length > longest) {
+                longest = length;
+                path_next[i] = it->second;
             }
+        }
+        path_length[i] = longest + (entries[i].end - entries[i].start) + 1;
+        return path_length[i];
+    };
 
-            return PluginManager::instance()->create_object(props, class_);
+    size_t path_start = (size_t) -1;
+    uint64_t path_max = 0;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        uint64_t length = critical_path(i);
+        if (length > path_max) {
+            path_max = length;
+            path_start = i;
         }
     }
+
+    auto ms = [](uint64_t us) { return util::time_string(us / 1000.f, true); };
+
+    std::ostringstream oss;
+    oss << "Scene load profile (" << entries.size() << " objects, total time "
+        << ms(end_time) << ", XML parsing " << ms(profile.parse_end)
+        << ", trace written to \"" << profile.filename << "\"):" << std::endl
+        << std::endl
+        << tfm::format("  %-28s %8s %12s %12s %12s %12s", "Plugin", "Count",
+                       "Total", "Mean", "Max", "Memory") << std::endl;
+    for (size_t i = 0; i < std::min(summary.size(), (size_t) 20); ++i) {
+        const Summary &s = summary[i];
+        oss << tfm::format("  %-28s %8zu %12s %12s %12s %12s", s.name, s.count,
+                           ms(s.total), ms(s.total / s.count), ms(s.max),
+                           signed_mem_string(s.memory)) << std::endl;
+    }
+    if (summary.size() > 20)
+        oss << "  .. (" << summary.size() - 20 << " more)" << std::endl;
+
+    std::vector<const LoadProfile::Entry *> slowest;
+    for (const LoadProfile::Entry &e : entries)
+        slowest.push_back(&e);
+    size_t slowest_count = std::min(slowest.size(), (size_t) 10);
+    std::partial_sort(slowest.begin(), slowest.begin() + slowest_count, slowest.end(),
+        [](const LoadProfile::Entry *a, const LoadProfile::Entry *b) {
+            return a->end - a->start > b->end - b->start;
+        });
+
+    oss << std::endl << "  Slowest objects:" << std::endl;
+    for (size_t i = 0; i < slowest_count; ++i) {
+        const LoadProfile::Entry &e = *slowest[i];
+        oss << tfm::format("    %-36s %12s %12s  (%s)", "\"" + e.id + "\"",
+                           ms(e.end - e.start), signed_mem_string(e.memory),
+                           string::to_lower(e.class_name) + "/" + e.plugin +
+                           ", " + e.source) << std::endl;
+    }
+
+    if (path_start != (size_t) -1) {
+        size_t path_size = 0;
+        uint64_t path_time = 0;
+        for (size_t i = path_start; i != (size_t) -1; i = path_next[i]) {
+            path_time += entries[i].end - entries[i].start;
+            path_size++;
+        }
+
+        uint64_t instantiation_time = end_time - profile.parse_end;
+        oss << std::endl
+            << "  Critical path: " << ms(path_time) << " (" << path_size
+            << " objects), total work: " << ms(total_work)
+            << ", achieved parallelism: "
+            << tfm::format("%.2fx", instantiation_time > 0
+                                        ? (double) total_work / instantiation_time
+                                        : 1.0)
+            << std::endl;
+        for (size_t i = path_start; i != (size_t) -1; i = path_next[i]) {
+            const LoadProfile::Entry &e = entries[i];
+            oss << tfm::format("    %-36s %12s  (%s)", "\"" + e.id + "\"",
+                               ms(e.end - e.start),
+                               string::to_lower(e.class_name) + "/" + e.plugin)
+                << std::endl;
+        }
+    }
+
+    Log(Info, "%s", oss.str());
+}
+
+ref<Object> create_texture_from_rgb(const std::string &name,
+                                    Color<float, 3> color,
+                                    const std::string &variant,
+                                    bool within_emitter) {
+    Properties props = rgb_texture_props(name, color, within_emitter);
+
+    ref<Object> texture = PluginManager::instance()->create_object(
+        props, Class::for_name("Texture", variant));
+    std::vector<ref<Object>> children = texture->expand();
+    if (!children.empty())
+        return (Object *) children[0].get();
+    return texture;
+}
+
+ref<Object> create_texture_from_spectrum(const std::string &name,
+                                         Float const_value,
+                                         std::vector<Float> &wavelengths,
+                                         std::vector<Float> &values,
+                                         const std::string &variant,
+                                         bool within_emitter,
+                                         bool is_spectral_mode,
+                                         bool is_monochromatic_mode) {
+    Properties props = spectrum_texture_props(
+        name, const_value, wavelengths, values, within_emitter,
+        is_spectral_mode, is_monochromatic_mode);
+    return PluginManager::instance()->create_object(
+        props, Class::for_name("Texture", variant));
 }
 
 std::vector<ref<Object>> expand_node(const ref<Object> &node) {
@@ -1320,11 +2004,32 @@ std::vector<std::pair<std::string, Properties>> xml_to_properties(const fs::path
 
 NAMESPACE_END(detail)
 
+static std::mutex load_profile_mutex;
+static std::string load_profile_filename;
+static std::atomic<bool> keep_object_graph_flag { false };
+
+void set_keep_object_graph(bool value) { keep_object_graph_flag = value; }
+
+bool keep_object_graph() { return keep_object_graph_flag; }
+
+void set_load_profile(const std::string &filename) {
+    std::lock_guard<std::mutex> guard(load_profile_mutex);
+    load_profile_filename = filename;
+}
+
+static std::unique_ptr<detail::LoadProfile> create_load_profile() {
+    std::lock_guard<std::mutex> guard(load_profile_mutex);
+    if (load_profile_filename.empty())
+        return nullptr;
+    return std::make_unique<detail::LoadProfile>(load_profile_filename);
+}
+
 std::vector<ref<Object>> load_string(const std::string &string,
                                      const std::string &variant,
                                      ParameterList param,
                                      bool parallel) {
     ScopedPhase sp(ProfilerPhase::InitScene);
+    std::unique_ptr<detail::LoadProfile> profile = create_load_profile();
     pugi::xml_document doc;
     pugi::xml_parse_result result = doc.load_buffer(string.c_str(), string.length(),
                                                     pugi::parse_default |
@@ -1345,6 +2050,7 @@ std::vector<ref<Object>> load_string(const std::string &string,
     try {
         pugi::xml_node root = doc.document_element();
         detail::XMLParseContext ctx(variant, parallel);
+        ctx.profile = profile.get();
         Properties props;
         size_t arg_counter = 0; // Unused
         auto scene_id = detail::parse_xml(src, ctx, root, Tag::Invalid, props,
@@ -1355,12 +2061,26 @@ std::vector<ref<Object>> load_string(const std::string &string,
                 Throw("Unused parameter \"%s\"!", std::get<0>(p));
         }
 
+        detail::auto_instance(ctx, scene_id);
+        detail::GraphOrder graph_order;
+        ref<ObjectGraph> graph =
+            detail::prepare_object_graph(ctx, scene_id, graph_order);
+        if (profile)
+            profile->parse_end = profile->now();
+        SharedCache::Stats cache_stats = SharedCache::stats();
         ref<Object> top_node = detail::instantiate_top_node(ctx, scene_id);
+        detail::log_shared_cache_stats(cache_stats);
+        if (graph)
+            detail::finalize_object_graph(ctx, graph, graph_order);
+        if (profile)
+            detail::write_load_profile(*profile);
         std::vector<ref<Object>> objects = detail::expand_node(top_node);
 
+        Bitmap::clear_prefetched();
         Thread::thread()->set_file_resolver(fs_backup.get());
         return objects;
     } catch(...) {
+        Bitmap::clear_prefetched();
         Thread::thread()->set_file_resolver(fs_backup.get());
         throw;
     }
@@ -1372,6 +2092,7 @@ std::vector<ref<Object>> load_file(const fs::path &filename,
                                    bool write_update,
                                    bool parallel) {
     ScopedPhase sp(ProfilerPhase::InitScene);
+    std::unique_ptr<detail::LoadProfile> profile = create_load_profile();
 
     if (!fs::exists(filename))
         Throw("\"%s\": file does not exist!", filename);
@@ -1387,11 +2108,25 @@ std::vector<ref<Object>> load_file(const fs::path &filename,
 
     try {
         detail::XMLParseContext ctx(variant, parallel);
+        ctx.profile = profile.get();
         auto scene_id = detail::init_xml_parse_context_from_file(ctx, filename, param, write_update);
 
+        detail::auto_instance(ctx, scene_id);
+        detail::GraphOrder graph_order;
+        ref<ObjectGraph> graph =
+            detail::prepare_object_graph(ctx, scene_id, graph_order);
+        if (profile)
+            profile->parse_end = profile->now();
+        SharedCache::Stats cache_stats = SharedCache::stats();
         ref<Object> top_node = detail::instantiate_top_node(ctx, scene_id);
+        detail::log_shared_cache_stats(cache_stats);
+        if (graph)
+            detail::finalize_object_graph(ctx, graph, graph_order);
+        if (profile)
+            detail::write_load_profile(*profile);
         std::vector<ref<Object>> objects = detail::expand_node(top_node);
 
+        Bitmap::clear_prefetched();
         Thread::thread()->set_file_resolver(fs_backup.get());
 
         Log(Info, "Done loading XML file \"%s\" (took %s).",
@@ -1399,10 +2134,13 @@ std::vector<ref<Object>> load_file(const fs::path &filename,
 
         return objects;
     } catch (...) {
+        Bitmap::clear_prefetched();
         Thread::thread()->set_file_resolver(fs_backup.get());
         throw;
     }
 }
 
+MI_IMPLEMENT_CLASS(ObjectGraph, Object)
+
 NAMESPACE_END(xml)
 NAMESPACE_END(mitsuba)
@@ -128,7 +128,7 @@ public:
             FileResolver *fs = Thread::thread()->file_resolver();
             fs::path file_path = fs->resolve(props.string("filename"));
             m_filename = file_path.filename().string();
-            bitmap = new Bitmap(file_path);
+            bitmap = Bitmap::load_prefetched(file_path);
         }
 
         if (bitmap->width() < 2 || bitmap->height() < 3)
@@ -43,6 +43,29 @@ High dynamic range film (:monosp:`hdrfilm`)
      The options are :monosp:`float16`, :monosp:`float32`, or :monosp:`uint32`.
      (Default: :monosp:`float16`)
 
+ * - exr_compression
+   - |string|
+   - Compression method used when writing OpenEXR files. The options are :monosp:`none`,
+     :monosp:`rle`, :monosp:`zips`, :monosp:`zip`, :monosp:`piz` (lossless), as well as
+     :monosp:`dwaa` and :monosp:`dwab` (lossy). (Default: :monosp:`piz`)
+
+ * - exr_compression_level
+   - |float|
+   - Compression level of the ZIP (zlib level 1-9) and DWA (quantization level, higher values
+     correspond to a lower quality) compressors. (Default: library default)
+
+ * - exr_tiled, exr_tile_size
+   - |bool|, |int|
+   - Write a tiled OpenEXR file using square tiles of the specified size instead of a
+     scanline-based file. (Default: |false|, 64)
+
+ * - exr_float16_channels, exr_float32_channels
+   - |string|
+   - Comma-separated lists of channels that should be stored using :monosp:`float16` or
+     :monosp:`float32` precision in OpenEXR files, overriding :monosp:`component_format`
+     for these channels. This is useful to store e.g. a depth AOV at full precision
+     alongside a half precision color image. (Default: none)
+
  * - crop_offset_x, crop_offset_y, crop_width, crop_height
    - |int|
    - These parameters can optionally be provided to select a sub-rectangle
@@ -99,6 +122,12 @@ For OpenEXR files, Mitsuba 3 also supports fully general multi-channel output; r
 the :ref:`aov <integrator-aov>` or :ref:`stokes <integrator-stokes>` plugins for
 details on how this works.
 
+OpenEXR files are compressed in parallel using the thread pool of Mitsuba. Compression
+and the scanline/tiled layout are configured using the :monosp:`exr_*` parameters above.
+The :monosp:`-w` flag of the :monosp:`mitsuba` command line executable writes the film
+asynchronously, so that rendering of the next scene can start while the previous image
+is being compressed.
+
 The plugin can also write RLE-compressed files in the Radiance RGBE format pioneered by Greg Ward
 (set :monosp:`file_format=rgbe`), as well as the Portable Float Map format
 (set :monosp:`file_format=pfm`). In the former case, the :monosp:`component_format` and
@@ -224,6 +253,52 @@ public:
             }
         }
 
+        std::string exr_compression = string::to_lower(
+            props.string("exr_compression", "piz"));
+        if (exr_compression == "none")
+            m_exr_options.compression = Bitmap::ExrCompression::Uncompressed;
+        else if (exr_compression == "rle")
+            m_exr_options.compression = Bitmap::ExrCompression::RLE;
+        else if (exr_compression == "zips")
+            m_exr_options.compression = Bitmap::ExrCompression::ZIPS;
+        else if (exr_compression == "zip")
+            m_exr_options.compression = Bitmap::ExrCompression::ZIP;
+        else if (exr_compression == "piz")
+            m_exr_options.compression = Bitmap::ExrCompression::PIZ;
+        else if (exr_compression == "dwaa")
+            m_exr_options.compression = Bitmap::ExrCompression::DWAA;
+        else if (exr_compression == "dwab")
+            m_exr_options.compression = Bitmap::ExrCompression::DWAB;
+        else
+            Throw("The \"exr_compression\" parameter must either be equal to "
+                  "\"none\", \"rle\", \"zips\", \"zip\", \"piz\", \"dwaa\" "
+                  "or \"dwab\". Found %s instead.", exr_compression);
+
+        m_exr_options.compression_level =
+            props.get<ScalarFloat>("exr_compression_level", -1.f);
+        m_exr_options.tiled = props.get<bool>("exr_tiled", false);
+        m_exr_options.tile_size = props.get<uint32_t>("exr_tile_size", 64);
+        if (m_exr_options.tile_size == 0)
+            Throw("The \"exr_tile_size\" parameter must be positive!");
+
+        std::pair<const char *, Struct::Type> channel_formats[] = {
+            { "exr_float16_channels", Struct::Type::Float16 },
+            { "exr_float32_channels", Struct::Type::Float32 }
+        };
+        for (auto [key, type] : channel_formats) {
+            for (const std::string &name : string::tokenize(props.string(key, ""), ", "))
+                m_exr_options.channel_formats[name] = type;
+        }
+
+        if (!m_exr_options.channel_formats.empty()) {
+            if (m_file_format != Bitmap::FileFormat::OpenEXR)
+                Log(Warn, "Per-channel formats are only supported by the "
+                          "OpenEXR format, ignoring..");
+            else if (m_component_format == Struct::Type::UInt32)
+                Throw("Per-channel formats cannot be combined with "
+                      "component_format=\"uint32\"!");
+        }
+
         m_compensate = props.get<bool>("compensate", false);
 
         props.mark_queried("banner"); // no banner in Mitsuba 3
@@ -544,44 +619,21 @@ public:
     }
 
     void write(const fs::path &path) const override {
-        fs::path filename = path;
-        std::string proper_extension;
+        fs::path filename;
+        ref<Bitmap> target = output_bitmap(path, filename);
         if (m_file_format == Bitmap::FileFormat::OpenEXR)
-            proper_extension = ".exr";
-        else if (m_file_format == Bitmap::FileFormat::RGBE)
-            proper_extension = ".rgbe";
+            target->write_exr(filename, m_exr_options);
         else
-            proper_extension = ".pfm";
-
-        std::string extension = string::to_lower(filename.extension().string());
-        if (extension != proper_extension)
-            filename.replace_extension(proper_extension);
-
-        #if !defined(_WIN32)
-            Log(Info, "\U00002714  Developing \"%s\" ..", filename.string());
-        #else
-            Log(Info, "Developing \"%s\" ..", filename.string());
-        #endif
-
-        ref<Bitmap> source = bitmap();
-        if (m_component_format != struct_type_v<ScalarFloat>) {
-            // Mismatch between the current format and the one expected by the film
-            // Conversion is necessary before saving to disk
-            std::vector<std::string> channel_names;
-            for (size_t i = 0; i < source->channel_count(); i++)
-                channel_names.push_back(source->struct_()->operator[](i).name);
-            ref<Bitmap> target = new Bitmap(
-                source->pixel_format(),
-                m_component_format,
-                source->size(),
-                source->channel_count(),
-                channel_names);
-            source->convert(target);
-
             target->write(filename, m_file_format);
-        } else {
-            source->write(filename, m_file_format);
-        }
+    }
+
+    void write_async(const fs::path &path) const override {
+        fs::path filename;
+        ref<Bitmap> target = output_bitmap(path, filename);
+        if (m_file_format == Bitmap::FileFormat::OpenEXR)
+            target->write_exr_async(filename, m_exr_options);
+        else
+            target->write_async(filename, m_file_format);
     }
 
     void schedule_storage() override {
@@ -600,15 +652,74 @@ public:
             << "  file_format = " << m_file_format << "," << std::endl
             << "  pixel_format = " << m_pixel_format << "," << std::endl
             << "  component_format = " << m_component_format << "," << std::endl
+            << "  exr_compression = " << m_exr_options.compression << "," << std::endl
+            << "  exr_tiled = " << m_exr_options.tiled << "," << std::endl
             << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS()
+protected:
+    /**
+     * \brief Develop the film into a bitmap of the desired component format
+     * and determine the filename (with a proper extension) to write it to
+     */
+    ref<Bitmap> output_bitmap(const fs::path &path, fs::path &filename) const {
+        filename = path;
+        std::string proper_extension;
+        if (m_file_format == Bitmap::FileFormat::OpenEXR)
+            proper_extension = ".exr";
+        else if (m_file_format == Bitmap::FileFormat::RGBE)
+            proper_extension = ".rgbe";
+        else
+            proper_extension = ".pfm";
+
+        std::string extension = string::to_lower(filename.extension().string());
+        if (extension != proper_extension)
+            filename.replace_extension(proper_extension);
+
+        #if !defined(_WIN32)
+            Log(Info, "\U00002714  Developing \"%s\" ..", filename.string());
+        #else
+            Log(Info, "Developing \"%s\" ..", filename.string());
+        #endif
+
+        /* Channels stored at a higher precision than the component format
+           are kept as single precision floats in memory. OpenEXR converts
+           all other channels to half precision while writing. */
+        Struct::Type component_format = m_component_format;
+        if (m_file_format == Bitmap::FileFormat::OpenEXR &&
+            component_format == Struct::Type::Float16) {
+            for (auto &[name, type] : m_exr_options.channel_formats) {
+                if (type == Struct::Type::Float32)
+                    component_format = Struct::Type::Float32;
+            }
+        }
+
+        ref<Bitmap> source = bitmap();
+        if (component_format == struct_type_v<ScalarFloat>)
+            return source;
+
+        // Mismatch between the current format and the one expected by the film
+        // Conversion is necessary before saving to disk
+        std::vector<std::string> channel_names;
+        for (size_t i = 0; i < source->channel_count(); i++)
+            channel_names.push_back(source->struct_()->operator[](i).name);
+        ref<Bitmap> target = new Bitmap(
+            source->pixel_format(),
+            component_format,
+            source->size(),
+            source->channel_count(),
+            channel_names);
+        source->convert(target);
+        return target;
+    }
+
 protected:
     Bitmap::FileFormat m_file_format;
     Bitmap::PixelFormat m_pixel_format;
     Struct::Type m_component_format;
+    Bitmap::ExrWriteOptions m_exr_options;
     bool m_compensate;
     ref<ImageBlock> m_storage;
     mutable std::mutex m_mutex;
@@ -237,3 +237,51 @@ def test07_luminance_alpha_mono(variants_all):
     image = mi.TensorXf(film.bitmap())
 
     assert image.shape[2] == 2
+
+
+@pytest.mark.parametrize('write_async', [False, True])
+def test08_exr_options(variant_scalar_rgb, tmpdir, write_async):
+    import numpy as np
+
+    rng = np.random.default_rng(seed=1234)
+    film = mi.load_dict({
+        'type': 'hdrfilm',
+        'width': 41,
+        'height': 37,
+        'component_format': 'float16',
+        'exr_compression': 'zip',
+        'exr_compression_level': 9,
+        'exr_tiled': True,
+        'exr_tile_size': 16,
+        'exr_float32_channels': 'R, B',
+        'filter': {'type': 'box'}
+    })
+
+    contents = rng.uniform(size=(film.size()[1], film.size()[0], 4))
+    contents[:, :, 3] = 1.0
+
+    block = mi.ImageBlock(film.size(), [0, 0], 4, film.rfilter())
+    for x in range(film.size()[1]):
+        for y in range(film.size()[0]):
+            block.put([y+0.5, x+0.5], contents[x, y, :])
+
+    film.prepare([])
+    film.put_block(block)
+
+    filename = str(tmpdir.join('test_image.exr'))
+    if write_async:
+        film.write_async(filename)
+        mi.Thread.wait_for_tasks()
+    else:
+        film.write(filename)
+
+    img = np.array(mi.Bitmap(filename).convert(component_format=mi.Struct.Type.Float32))
+
+    # The red and blue channels are stored at full precision
+    assert np.allclose(img[:, :, 0], contents[:, :, 0], atol=1e-6)
+    assert np.allclose(img[:, :, 2], contents[:, :, 2], atol=1e-6)
+    assert np.allclose(img[:, :, 1], contents[:, :, 1], atol=1e-3)
+    assert not np.allclose(img[:, :, 1], contents[:, :, 1], atol=1e-6)
+
+    with pytest.raises(RuntimeError):
+        mi.load_dict({ 'type': 'hdrfilm', 'exr_compression': 'lzma' })
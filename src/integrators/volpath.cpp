@@ -36,6 +36,25 @@ Volumetric path tracer (:monosp:`volpath`)
    - |bool|
    - Hide directly visible emitters. (Default: no, i.e. |false|)
 
+ * - transmittance_estimator
+   - |string|
+   - Estimator of the transmittance along shadow rays through participating
+     media. Ratio tracking (``ratio``) weights each tentative collision by
+     the ratio of null and majorant extinction. Residual ratio tracking
+     (``residual``) evaluates the transmittance of a control extinction
+     analytically and only estimates the residual, which requires far fewer
+     collisions in thin or nearly constant media. (Default: ``ratio``)
+
+ * - lod_spread
+   - |float|
+   - Spread angle (in radians) that every non-specular scattering event adds
+     to the ray cone of a path. When positive, media look up their volumes
+     at a level of detail matching the width of the cone (see the
+     ``mip_levels`` parameter of :ref:`gridvolume <volume-gridvolume>`), so
+     that deep bounces use coarse and cache-friendly data. The cone of camera
+     rays has zero width, hence they always see the full resolution.
+     (Default: 0, i.e. disabled)
+
 This plugin provides a volumetric path tracer that can be used to compute approximate solutions
 of the radiative transfer equation. Its implementation makes use of multiple importance sampling
 to combine BSDF and phase function sampling with direct illumination sampling strategies. On
@@ -48,6 +67,12 @@ has a :ref:`null <bsdf-null>` or :ref:`thin dielectric <bsdf-thindielectric>` BS
 to it (as compared to, say, a :ref:`dielectric <bsdf-dielectric>` or
 :ref:`roughdielectric <bsdf-roughdielectric>` BSDF).
 
+Emissive media (see the ``radiance`` parameter of :ref:`heterogeneous
+<medium-heterogeneous>`) are handled by next event estimation towards their
+emission grid at every non-specular vertex. Their emission is only collected
+along rays leaving the camera or a specular interaction, which next event
+estimation can't account for.
+
 .. note:: This integrator does not implement good sampling strategies to render
     participating media with a spectrally varying extinction coefficient. For these cases,
     it is better to use the more advanced :ref:`volumetric path tracer with
@@ -78,6 +103,18 @@ public:
                      Medium, MediumPtr, PhaseFunctionContext)
 
     VolumetricPathIntegrator(const Properties &props) : Base(props) {
+        std::string estimator = props.string("transmittance_estimator", "ratio");
+        if (estimator == "residual")
+            m_residual_tracking = true;
+        else if (estimator == "ratio")
+            m_residual_tracking = false;
+        else
+            Throw("Invalid transmittance estimator \"%s\", must be either "
+                  "\"ratio\" or \"residual\"!", estimator);
+
+        m_lod_spread = props.get<ScalarFloat>("lod_spread", 0.f);
+        if (m_lod_spread < 0.f)
+            Throw("The LOD spread angle must be non-negative!");
     }
 
     MI_INLINE
@@ -127,6 +164,9 @@ public:
         Interaction3f last_scatter_event = dr::zeros<Interaction3f>();
         Float last_scatter_direction_pdf = 1.f;
 
+        // Ray cone whose width selects the level of detail of volume lookups
+        Float cone_width = 0.f, cone_spread = 0.f;
+
         /* Set up a Dr.Jit loop (optimizes away to a normal loop in scalar mode,
            generates wavefront or megakernel renderer based on configuration).
            Register everything that changes as part of the loop here */
@@ -134,7 +174,8 @@ public:
                             /* loop state: */ active, depth, ray, throughput,
                             result, si, mei, medium, eta, last_scatter_event,
                             last_scatter_direction_pdf, needs_intersection,
-                            specular_chain, valid_ray, sampler);
+                            specular_chain, valid_ray, cone_width,
+                            cone_spread, sampler);
 
         while (loop(active)) {
             // ----------------- Handle termination of paths ------------------
@@ -167,7 +208,7 @@ public:
             }
 
             if (dr::any_or<true>(active_medium)) {
-                mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
+                mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, cone_width, active_medium);
                 dr::masked(ray.maxt, active_medium && medium->is_homogeneous() && mei.is_valid()) = mei.t;
                 Mask intersect = needs_intersection && active_medium;
                 if (dr::any_or<true>(intersect))
@@ -183,6 +224,22 @@ public:
 
                 escaped_medium = active_medium && !mei.is_valid();
                 active_medium &= mei.is_valid();
+                if (m_lod_spread > 0.f)
+                    dr::masked(cone_width, active_medium) += cone_spread * mei.t;
+
+                /* Collect the emission of the medium at every tentative
+                   collision, unless the previous vertex already sampled it */
+                Mask active_emission = active_medium && specular_chain &&
+                                       medium->is_emitter();
+                if (dr::any_or<true>(active_emission)) {
+                    UnpolarizedSpectrum emission =
+                        medium->get_emission(mei, active_emission);
+                    // The free-flight pdf was already divided out on spectral lanes
+                    dr::masked(emission, not_spectral) /=
+                        index_spectrum(mei.combined_extinction, channel);
+                    dr::masked(result, active_emission) +=
+                        throughput * depolarizer<Spectrum>(emission);
+                }
 
                 // Handle null and real scatter events
                 Mask null_scatter = sampler->next_1d(active_medium) >= index_spectrum(mei.sigma_t, channel) / index_spectrum(mei.combined_extinction, channel);
@@ -197,6 +254,8 @@ public:
 
                 dr::masked(depth, act_medium_scatter) += 1;
                 dr::masked(last_scatter_event, act_medium_scatter) = mei;
+                if (m_lod_spread > 0.f)
+                    dr::masked(cone_spread, act_medium_scatter) += m_lod_spread;
             }
 
             // Dont estimate lighting if we exceeded number of bounces
@@ -226,7 +285,7 @@ public:
 
                 Mask active_e = act_medium_scatter && sample_emitters;
                 if (dr::any_or<true>(active_e)) {
-                    auto [emitted, ds] = sample_emitter(mei, scene, sampler, medium, channel, active_e);
+                    auto [emitted, ds] = sample_emitter(mei, scene, sampler, medium, channel, cone_width, active_e);
                     auto [phase_val, phase_pdf] = phase->eval_pdf(phase_ctx, mei, ds.d, active_e);
                     dr::masked(result, active_e) += throughput * phase_val * emitted *
                                                     mis_weight(ds.pdf, dr::select(ds.delta, 0.f, phase_pdf));
@@ -273,6 +332,8 @@ public:
                 }
             }
             active_surface &= si.is_valid();
+            if (m_lod_spread > 0.f)
+                dr::masked(cone_width, active_surface) += cone_spread * si.t;
             if (dr::any_or<true>(active_surface)) {
                 // --------------------- Emitter sampling ---------------------
                 BSDFContext ctx;
@@ -280,7 +341,7 @@ public:
                 Mask active_e = active_surface && has_flag(bsdf->flags(), BSDFFlags::Smooth) && (depth + 1 < (uint32_t) m_max_depth);
 
                 if (likely(dr::any_or<true>(active_e))) {
-                    auto [emitted, ds] = sample_emitter(si, scene, sampler, medium, channel, active_e);
+                    auto [emitted, ds] = sample_emitter(si, scene, sampler, medium, channel, cone_width, active_e);
 
                     // Query the BSDF for that emitter-sampled direction
                     Vector3f wo       = si.to_local(ds.d);
@@ -307,6 +368,8 @@ public:
 
                 Mask non_null_bsdf = active_surface && !has_flag(bs.sampled_type, BSDFFlags::Null);
                 dr::masked(depth, non_null_bsdf) += 1;
+                if (m_lod_spread > 0.f)
+                    dr::masked(cone_spread, non_null_bsdf && !has_flag(bs.sampled_type, BSDFFlags::Delta)) += m_lod_spread;
 
                 // update the last scatter PDF event if we encountered a non-null scatter event
                 dr::masked(last_scatter_event, non_null_bsdf) = si;
@@ -330,7 +393,7 @@ public:
     std::tuple<Spectrum, DirectionSample3f>
     sample_emitter(const Interaction &ref_interaction, const Scene *scene,
                    Sampler *sampler, MediumPtr medium,
-                   UInt32 channel, Mask active) const {
+                   UInt32 channel, Float footprint, Mask active) const {
         Spectrum transmittance(1.0f);
 
         auto [ds, emitter_val] = scene->sample_emitter_direction(ref_interaction, sampler->next_2d(active), false, active);
@@ -369,8 +432,23 @@ public:
             Mask active_medium  = active && dr::neq(medium, nullptr);
             Mask active_surface = active && !active_medium;
 
-            if (dr::any_or<true>(active_medium)) {
-                auto mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
+            if (dr::any_or<true>(active_medium) && m_residual_tracking) {
+                Mask intersect = needs_intersection && active_medium;
+                if (dr::any_or<true>(intersect))
+                    dr::masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                needs_intersection &= !active_medium;
+
+                /* Estimate the transmittance up to the next surface at once
+                   and continue as if the ray had escaped the medium */
+                Ray3f segment = ray;
+                segment.maxt = dr::minimum(si.t, remaining_dist);
+                dr::masked(transmittance, active_medium) *=
+                    medium->eval_transmittance(segment, sampler->next_1d(active_medium), active_medium);
+
+                escaped_medium = active_medium;
+                active_medium  = false;
+            } else if (dr::any_or<true>(active_medium)) {
+                auto mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, footprint, active_medium);
                 dr::masked(ray.maxt, active_medium && medium->is_homogeneous() && mei.is_valid()) = dr::minimum(mei.t, remaining_dist);
                 Mask intersect = needs_intersection && active_medium;
                 if (dr::any_or<true>(intersect))
@@ -450,9 +528,13 @@ public:
     std::string to_string() const override {
         return tfm::format("VolumetricSimplePathIntegrator[\n"
                            "  max_depth = %i,\n"
-                           "  rr_depth = %i\n"
+                           "  rr_depth = %i,\n"
+                           "  transmittance_estimator = %s,\n"
+                           "  lod_spread = %f\n"
                            "]",
-                           m_max_depth, m_rr_depth);
+                           m_max_depth, m_rr_depth,
+                           m_residual_tracking ? "residual" : "ratio",
+                           m_lod_spread);
     }
 
     Float mis_weight(Float pdf_a, Float pdf_b) const {
@@ -463,6 +545,11 @@ public:
     };
 
     MI_DECLARE_CLASS()
+private:
+    /// Estimate the transmittance of shadow rays using residual ratio tracking
+    bool m_residual_tracking;
+    /// Spread angle added to the ray cone at each non-specular scattering event
+    ScalarFloat m_lod_spread;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(VolumetricPathIntegrator, MonteCarloIntegrator);
@@ -40,6 +40,16 @@ Volumetric path tracer with spectral MIS (:monosp:`volpathmis`)
    - |bool|
    - Hide directly visible emitters. (Default: no, i.e. |false|)
 
+ * - transmittance_estimator
+   - |string|
+   - Estimator of the transmittance along shadow rays through participating
+     media, either ratio tracking (``ratio``) or residual ratio tracking
+     (``residual``). See the :ref:`volumetric path tracer
+     <integrator-volpath>` for details. The null collisions of residual ratio
+     tracking can't be combined with unidirectional paths by MIS, hence
+     emitters reached through a medium are then only accounted for by
+     emitter sampling. (Default: ``ratio``)
+
 This plugin provides a volumetric path tracer that can be used to compute approximate solutions
 of the radiative transfer equation. Its implementation performs MIS both for directional sampling
 as well as free-flight distance sampling. In particular, this integrator is well suited
@@ -75,6 +85,8 @@ public:
 
     VolumetricMisPathIntegrator(const Properties &props) : Base(props) {
         m_use_spectral_mis = props.get<bool>("use_spectral_mis", true);
+        // Parsed by the specialized implementation
+        props.mark_queried("transmittance_estimator");
         m_props = props;
     }
 
@@ -108,7 +120,16 @@ public:
         std::conditional_t<SpectralMis, dr::Matrix<Float, dr::array_size_v<UnpolarizedSpectrum>>,
                            UnpolarizedSpectrum>;
 
-    VolpathMisIntegratorImpl(const Properties &props) : Base(props) {}
+    VolpathMisIntegratorImpl(const Properties &props) : Base(props) {
+        std::string estimator = props.string("transmittance_estimator", "ratio");
+        if (estimator == "residual")
+            m_residual_tracking = true;
+        else if (estimator == "ratio")
+            m_residual_tracking = false;
+        else
+            Throw("Invalid transmittance estimator \"%s\", must be either "
+                  "\"ratio\" or \"residual\"!", estimator);
+    }
 
     MI_INLINE
     Float index_spectrum(const UnpolarizedSpectrum &spec, const UInt32 &idx) const {
@@ -164,6 +185,9 @@ public:
         Mask needs_intersection = true, last_event_was_null = false;
         Interaction3f last_scatter_event = dr::zeros<Interaction3f>();
 
+        // Whether the path entered a medium since the last scattering event
+        Mask crossed_medium = false;
+
         /* Set up a Dr.Jit loop (optimizes away to a normal loop in scalar mode,
            generates wavefront or megakernel renderer based on configuration).
            Register everything that changes as part of the loop here */
@@ -171,7 +195,8 @@ public:
                             /* loop state: */
                             active, depth, ray, p_over_f, p_over_f_nee, result,
                             si, mei, medium, eta, last_scatter_event, sampler,
-                            needs_intersection, specular_chain, valid_ray);
+                            needs_intersection, specular_chain, valid_ray,
+                            crossed_medium);
 
         while (loop(active)) {
             // ----------------- Handle termination of paths ------------------
@@ -197,6 +222,8 @@ public:
             Mask active_surface = active && !active_medium;
             Mask act_null_scatter = false, act_medium_scatter = false,
                  escaped_medium = false;
+            if (m_residual_tracking)
+                crossed_medium |= active_medium;
 
             // If the medium does not have a spectrally varying extinction,
             // we can perform a few optimizations to speed up rendering
@@ -208,7 +235,7 @@ public:
             }
 
             if (dr::any_or<true>(active_medium)) {
-                mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
+                mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, 0.f, active_medium);
                 dr::masked(ray.maxt, active_medium && medium->is_homogeneous() && mei.is_valid()) = mei.t;
                 Mask intersect = needs_intersection && active_medium;
                 if (dr::any_or<true>(intersect))
@@ -225,6 +252,21 @@ public:
                 active_medium &= mei.is_valid();
                 is_spectral &= active_medium;
                 not_spectral &= active_medium;
+
+                /* Collect the emission of the medium at every tentative
+                   collision, unless the previous vertex already sampled it */
+                Mask active_emission = active_medium && specular_chain &&
+                                       medium->is_emitter();
+                if (dr::any_or<true>(active_emission)) {
+                    UnpolarizedSpectrum emission =
+                        medium->get_emission(mei, active_emission);
+                    // The free-flight pdf is already part of p_over_f on spectral lanes
+                    WeightMatrix p_over_f_emission = p_over_f;
+                    update_weights(p_over_f_emission, mei.combined_extinction,
+                                   1.f, channel, not_spectral && active_emission);
+                    dr::masked(result, active_emission) +=
+                        mis_weight(p_over_f_emission) * emission;
+                }
             }
 
             if (dr::any_or<true>(active_medium)) {
@@ -236,6 +278,7 @@ public:
                 // Count this as a bounce
                 dr::masked(depth, act_medium_scatter) += 1;
                 dr::masked(last_scatter_event, act_medium_scatter) = mei;
+                dr::masked(crossed_medium, act_medium_scatter) = false;
                 Mask sample_emitters = mei.medium->use_emitter_sampling();
 
                 active &= depth < (uint32_t) m_max_depth;
@@ -312,6 +355,10 @@ public:
                 Mask count_direct = ray_from_camera || specular_chain;
                 EmitterPtr emitter = si.emitter(scene);
                 Mask active_e = active_surface && dr::neq(emitter, nullptr) && !(dr::eq(depth, 0u) && m_hide_emitters);
+                /* Emitter sampling with residual ratio tracking alone accounts
+                   for emitters that are reached through a medium */
+                if (m_residual_tracking)
+                    active_e &= count_direct || !crossed_medium;
                 if (dr::any_or<true>(active_e)) {
                     if (dr::any_or<true>(active_e && !count_direct)) {
                         // Get the PDF of sampling this emitter using next event estimation
@@ -359,6 +406,7 @@ public:
                 specular_chain &= !(active_surface && has_flag(bs.sampled_type, BSDFFlags::Smooth));
                 dr::masked(depth, non_null_bsdf) += 1;
                 dr::masked(last_scatter_event, non_null_bsdf) = si;
+                dr::masked(crossed_medium, non_null_bsdf) = false;
 
                 // Update NEE weights only if the BSDF is not null
                 dr::masked(p_over_f_nee, non_null_bsdf) = p_over_f;
@@ -403,10 +451,10 @@ public:
         Float total_dist = 0.f;
         SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
 
-        Mask needs_intersection = true;
+        Mask needs_intersection = true, crossed_medium = false;
         dr::Loop<Mask> loop("Volpath MIS integrator emitter sampling");
         loop.put(active, ray, total_dist, needs_intersection, medium, si,
-                 p_over_f_nee, p_over_f_uni);
+                 p_over_f_nee, p_over_f_uni, crossed_medium);
         sampler->loop_put(loop);
         loop.init();
         while (loop(dr::detach(active))) {
@@ -420,8 +468,25 @@ public:
             Mask active_medium  = active && dr::neq(medium, nullptr);
             Mask active_surface = active && !active_medium;
 
-            if (dr::any_or<true>(active_medium)) {
-                auto mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, active_medium);
+            if (dr::any_or<true>(active_medium) && m_residual_tracking) {
+                Mask intersect = needs_intersection && active_medium;
+                if (dr::any_or<true>(intersect))
+                    dr::masked(si, intersect) = scene->ray_intersect(ray, intersect);
+                needs_intersection &= !active_medium;
+
+                /* Estimate the transmittance up to the next surface at once
+                   and continue as if the ray had escaped the medium */
+                Ray3f segment = ray;
+                segment.maxt = dr::minimum(si.t, remaining_dist);
+                UnpolarizedSpectrum tr = medium->eval_transmittance(
+                    segment, sampler->next_1d(active_medium), active_medium);
+                update_weights(p_over_f_nee, 1.f, tr, channel, active_medium);
+
+                crossed_medium |= active_medium;
+                escaped_medium = active_medium;
+                active_medium  = false;
+            } else if (dr::any_or<true>(active_medium)) {
+                auto mei = medium->sample_interaction(ray, sampler->next_1d(active_medium), channel, 0.f, active_medium);
                 dr::masked(ray.maxt, active_medium && medium->is_homogeneous() && mei.is_valid()) = dr::minimum(mei.t, remaining_dist);
                 Mask intersect = needs_intersection && active_medium;
                 if (dr::any_or<true>(intersect))
@@ -497,6 +562,9 @@ public:
             }
         }
 
+        // Unidirectional paths through media don't count with residual tracking
+        dr::masked(p_over_f_uni, crossed_medium) = dr::zeros<WeightMatrix>();
+
         return { p_over_f_nee, p_over_f_uni, emitter_val, ds};
     }
 
@@ -561,12 +629,17 @@ public:
     std::string to_string() const override {
         return tfm::format("VolumetricMisPathIntegrator[\n"
                            "  max_depth = %i,\n"
-                           "  rr_depth = %i\n"
+                           "  rr_depth = %i,\n"
+                           "  transmittance_estimator = %s\n"
                            "]",
-                           m_max_depth, m_rr_depth);
+                           m_max_depth, m_rr_depth,
+                           m_residual_tracking ? "residual" : "ratio");
     }
 
     MI_DECLARE_CLASS()
+private:
+    /// Estimate the transmittance of shadow rays using residual ratio tracking
+    bool m_residual_tracking;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(VolumetricMisPathIntegrator, MonteCarloIntegrator);
@@ -1,7 +1,9 @@
+#include <mitsuba/core/distr_1d.h>
 #include <mitsuba/core/frame.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/warp.h>
+#include <mitsuba/render/emitter.h>
 #include <mitsuba/render/interaction.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/phase.h>
@@ -11,6 +13,240 @@
 
 NAMESPACE_BEGIN(mitsuba)
 
+/* Emitter that samples positions inside an emissive heterogeneous medium.
+   It is created by the medium (see the 'radiance' parameter below) and
+   tabulates a conservative bound of the emission on a coarse grid of cells,
+   which are sampled proportionally to this bound. */
+template <typename Float, typename Spectrum>
+class HeterogeneousMediumEmitter final : public Emitter<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Emitter, m_flags, m_needs_sample_3)
+    MI_IMPORT_TYPES(Volume)
+
+    using FloatStorage = DynamicBuffer<Float>;
+
+    /// Maximum resolution of the grid of cells along each axis
+    static constexpr int MaxCellResolution = 64;
+
+    HeterogeneousMediumEmitter(Volume *sigmat, Volume *albedo, Volume *radiance)
+        : Base(Properties("heterogeneous_emitter")), m_sigmat(sigmat),
+          m_albedo(albedo), m_radiance(radiance) {
+        m_needs_sample_3 = false;
+        m_flags = +EmitterFlags::SpatiallyVarying;
+        dr::set_attr(this, "flags", m_flags);
+    }
+
+    /// (Re)compute the sampling distribution over the cells
+    void update(ScalarFloat scale) {
+        m_scale = scale;
+
+        ScalarTransform4f to_world = m_sigmat->world_transform();
+        auto aligned = [&](const Volume *volume) {
+            return dr::all_nested(
+                dr::eq(volume->world_transform().matrix, to_world.matrix));
+        };
+        bool aligned_radiance = aligned(m_radiance.get()),
+             aligned_albedo   = aligned(m_albedo.get());
+
+        m_resolution = m_sigmat->resolution();
+        if (aligned_radiance)
+            m_resolution = dr::maximum(m_resolution, m_radiance->resolution());
+        m_resolution = dr::minimum(m_resolution, MaxCellResolution);
+
+        /* Bound the emission sigma_t * (1 - albedo) * radiance in each cell.
+           Volumes that aren't aligned with the extinction contribute their
+           global bound instead. */
+        FloatStorage weights = m_sigmat->local_majorants(m_resolution, scale).array();
+        if (aligned_radiance)
+            weights *= m_radiance->local_majorants(m_resolution).array();
+        else
+            weights *= m_radiance->max();
+        if (aligned_albedo)
+            weights *= dr::maximum(
+                1.f - m_albedo->local_minorants(m_resolution).array(), 0.f);
+        m_cell_distr = DiscreteDistribution<Float>(weights);
+
+        m_cell_to_world = to_world * ScalarTransform4f::scale(
+            dr::rcp(ScalarVector3f(m_resolution)));
+        m_world_to_cell = m_cell_to_world.inverse();
+        m_cell_volume = dr::abs(dr::det(m_cell_to_world.matrix));
+        m_bbox = m_sigmat->bbox();
+    }
+
+    /// Evaluate the emitted radiance per unit length at a given position
+    UnpolarizedSpectrum eval_emission(const Interaction3f &it, Float footprint,
+                                      Mask active) const {
+        auto [sigmat, albedo] =
+            m_sigmat->eval_pair(m_albedo.get(), it, footprint, active);
+        return m_scale * sigmat * (1.f - albedo) *
+               m_radiance->eval_lod(it, footprint, active);
+    }
+
+    std::pair<Ray3f, Spectrum> sample_ray(Float time, Float wavelength_sample,
+                                          const Point2f &pos_sample,
+                                          const Point2f &dir_sample,
+                                          Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleRay, active);
+
+        auto [ps, pos_weight] = sample_position(time, pos_sample, active);
+
+        SurfaceInteraction3f si(ps, dr::zeros<Wavelength>());
+        auto [wavelengths, weight] =
+            sample_wavelengths(si, wavelength_sample, active);
+
+        weight *= pos_weight * 4.f * dr::Pi<Float>;
+
+        Ray3f ray(ps.p, warp::square_to_uniform_sphere(dir_sample), time,
+                  wavelengths);
+
+        return { ray, weight };
+    }
+
+    std::pair<DirectionSample3f, Spectrum> sample_direction(const Interaction3f &it,
+                                                            const Point2f &sample,
+                                                            Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointSampleDirection, active);
+
+        auto [p, pdf] = sample_volume(sample, active);
+
+        DirectionSample3f ds = dr::zeros<DirectionSample3f>();
+        ds.p       = p;
+        ds.time    = it.time;
+        ds.delta   = true;
+        ds.emitter = this;
+        ds.d       = ds.p - it.p;
+
+        Float dist2 = dr::squared_norm(ds.d);
+        ds.dist = dr::sqrt(dist2);
+        ds.d *= dr::rsqrt(dist2);
+
+        // Convert the density per unit volume to solid angle
+        ds.pdf = pdf * dist2;
+        active &= ds.pdf > 0.f;
+
+        UnpolarizedSpectrum spec =
+            eval_emission(to_interaction(p, it), 0.f, active) / ds.pdf;
+
+        return { ds, depolarizer<Spectrum>(dr::select(active, spec, 0.f)) };
+    }
+
+    /* Volume emission can't be reached by sampling a direction, hence
+       positions are sampled like a delta emitter, without MIS. */
+    Float pdf_direction(const Interaction3f &, const DirectionSample3f &,
+                        Mask) const override {
+        return 0.f;
+    }
+
+    Spectrum eval_direction(const Interaction3f &it, const DirectionSample3f &ds,
+                            Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointEvaluate, active);
+        return depolarizer<Spectrum>(
+            eval_emission(to_interaction(ds.p, it), 0.f, active));
+    }
+
+    std::pair<PositionSample3f, Float>
+    sample_position(Float time, const Point2f &sample,
+                    Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointSamplePosition, active);
+
+        auto [p, pdf] = sample_volume(sample, active);
+
+        PositionSample3f ps = dr::zeros<PositionSample3f>();
+        ps.p    = p;
+        ps.time = time;
+        ps.pdf  = pdf;
+
+        return { ps, dr::select(active && pdf > 0.f, dr::rcp(pdf), 0.f) };
+    }
+
+    Float pdf_position(const PositionSample3f &ps, Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::EndpointEvaluate, active);
+
+        Point3f p = m_world_to_cell.transform_affine(ps.p);
+        active &= dr::all(p >= 0.f && p < ScalarVector3f(m_resolution));
+
+        Vector3u cell = Vector3u(dr::minimum(Vector3i(p), m_resolution - 1));
+        UInt32 index = (cell.z() * m_resolution.y() + cell.y()) * m_resolution.x() + cell.x();
+
+        return dr::select(active,
+                          m_cell_distr.eval_pmf_normalized(index, active) / m_cell_volume,
+                          0.f);
+    }
+
+    std::pair<Wavelength, Spectrum>
+    sample_wavelengths(const SurfaceInteraction3f &si, Float sample,
+                       Mask active) const override {
+        auto [wavelengths, weight] =
+            sample_wavelength<Float, UnpolarizedSpectrum>(sample);
+
+        Interaction3f it = to_interaction(si.p, si);
+        it.wavelengths = wavelengths;
+        weight *= eval_emission(it, 0.f, active);
+
+        return { wavelengths, depolarizer<Spectrum>(weight) };
+    }
+
+    Spectrum eval(const SurfaceInteraction3f &, Mask) const override {
+        return 0.f;
+    }
+
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "HeterogeneousMediumEmitter[" << std::endl
+            << "  radiance = " << string::indent(m_radiance) << "," << std::endl
+            << "  resolution = " << m_resolution << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+private:
+    /// Sample a position and return its density per unit volume
+    std::pair<Point3f, Float> sample_volume(const Point2f &sample,
+                                            Mask active) const {
+        auto [index, sample_x, pmf] =
+            m_cell_distr.sample_reuse_pmf(sample.x(), active);
+
+        /* Emitters only receive 2D samples, hence the second dimension is
+           split into the remaining two coordinates inside the cell. Both
+           stay stratified, the y coordinate with a resolution of 1/4096. */
+        Float scaled   = sample.y() * 4096.f,
+              y_offset = dr::floor(scaled);
+        Point3f offset(sample_x, y_offset * (1.f / 4096.f),
+                       dr::minimum(scaled - y_offset, dr::OneMinusEpsilon<Float>));
+
+        UInt32 x  = index % m_resolution.x(),
+               yz = index / m_resolution.x(),
+               y  = yz % m_resolution.y(),
+               z  = yz / m_resolution.y();
+
+        Point3f p = m_cell_to_world.transform_affine(
+            Point3f(Vector3u(x, y, z)) + offset);
+        return { p, pmf / m_cell_volume };
+    }
+
+    /// Create an interaction to evaluate the emission at the given position
+    Interaction3f to_interaction(const Point3f &p, const Interaction3f &ref) const {
+        Interaction3f it = dr::zeros<Interaction3f>();
+        it.p           = p;
+        it.time        = ref.time;
+        it.wavelengths = ref.wavelengths;
+        return it;
+    }
+
+private:
+    ref<Volume> m_sigmat, m_albedo, m_radiance;
+    ScalarFloat m_scale = 1.f;
+
+    DiscreteDistribution<Float> m_cell_distr;
+    ScalarVector3i m_resolution;
+    ScalarTransform4f m_cell_to_world, m_world_to_cell;
+    ScalarFloat m_cell_volume;
+    ScalarBoundingBox3f m_bbox;
+};
+
 
 /**!
 
@@ -38,6 +274,33 @@ Heterogeneous medium (:monosp:`heterogeneous`)
      units, or to simply tweak the density of the medium. (Default: 1)
    - |exposed|
 
+ * - majorant_resolution_factor
+   - |int|
+   - When set to a positive value, free-flight distances are sampled using a
+     coarse grid of local majorants, whose cells cover this many voxels of the
+     extinction volume along each axis. This can drastically reduce the number
+     of null collisions in media with a large dynamic range, e.g. a cloud with
+     a few dense regions. When set to zero, a single global majorant is used.
+     (Default: 0)
+
+ * - decomposition
+   - |bool|
+   - Use decomposition tracking to sample free-flight distances. The
+     extinction is split into a control component, which is the local
+     minorant of the majorant grid (or the minimum of the extinction volume
+     without one), and a residual. Collisions with the control component
+     don't evaluate the extinction volume at all, which saves many lookups
+     in thick media with a large homogeneous base density. Requires an
+     extinction coefficient that doesn't vary with the wavelength.
+     (Default: |false|)
+
+ * - radiance
+   - |float|, |spectrum| or |volume|
+   - Optional radiance emitted by the medium. The emission per unit length is
+     the product of this radiance and the absorption coefficient
+     :math:`\sigma_t (1 - \alpha)`. (Default: none)
+   - |exposed|, |differentiable|
+
  * - sample_emitters
    - |bool|
    - Flag to specify whether shadow rays should be cast from inside the volume (Default: |true|)
@@ -68,6 +331,43 @@ meters and the coefficients are in inverse millimeters, set scale to 1000.
 Both the albedo and the extinction coefficient can either be constant or textured,
 and both parameters are allowed to be spectrally varying.
 
+The majorant grid is computed from the extinction volume when the medium is
+created and whenever its parameters are updated. It bounds the extinction
+coefficient over the support of the interpolation filter of each cell, hence
+its values are always valid majorants. Both the free-flight sampling and the
+transmittance estimates of the volumetric path tracers then step through its
+cells using a 3D DDA.
+
+The grid also stores local minorants of the extinction coefficient (except
+with microflake phase functions, whose extinction depends on the direction).
+Residual ratio tracking (see the ``transmittance_estimator`` parameter of
+:ref:`volpath <integrator-volpath>`) uses the midpoint between both bounds as
+the control extinction of a cell, so that shadow rays through nearly constant
+regions need very few tentative collisions.
+
+When a ``radiance`` is specified, the medium also acts as an emitter, e.g. to
+model fire or explosions. Emission along the path is collected by the
+volumetric path tracers (:ref:`volpath <integrator-volpath>`,
+:ref:`volpathmis <integrator-volpathmis>` and ``prbvolpath``) after camera
+rays and specular interactions, while all other vertices perform next event
+estimation: the
+medium then provides a grid of up to 64 cells per axis, aligned with the
+extinction volume, which bounds the emission in each cell. Positions are sampled
+according to this grid, so that emissive regions are found directly. The
+medium must be attached to a shape enclosing the bounding box of the
+extinction volume. The scene discovers its emitter through the shapes and
+sensors that reference the medium.
+
+When the extinction and albedo are :ref:`gridvolume <volume-gridvolume>`
+instances with the same resolution, transformation, filter and wrap mode,
+both are looked up at once: the position is transformed and the trilinear
+interpolation weights are computed a single time for both grids.
+
+Both volumes are evaluated at the level of detail matching the footprint of
+the path (see the ``lod_spread`` parameter of :ref:`volpath
+<integrator-volpath>`) when they provide several levels, e.g. a
+:ref:`gridvolume <volume-gridvolume>` with ``mip_levels`` greater than one.
+
 .. tabs::
     .. code-tab:: xml
         :name: lst-heterogeneous
@@ -149,9 +449,13 @@ template <typename Float, typename Spectrum>
 class HeterogeneousMedium final : public Medium<Float, Spectrum> {
 public:
     MI_IMPORT_BASE(Medium, m_is_homogeneous, m_has_spectral_extinction,
-                    m_phase_function)
+                    m_phase_function, m_emitter, has_majorant_grid, set_majorant_grid,
+                    eval_majorant_grid, m_majorant_resolution, m_decomposition,
+                    set_control_extinction)
     MI_IMPORT_TYPES(Scene, Sampler, Texture, Volume)
 
+    using VolumeEmitter = HeterogeneousMediumEmitter<Float, Spectrum>;
+
     HeterogeneousMedium(const Properties &props) : Base(props) {
         m_is_homogeneous = false;
         m_albedo = props.volume<Volume>("albedo", 0.75f);
@@ -162,6 +466,40 @@ public:
 
         m_max_density = dr::opaque<Float>(m_scale * m_sigmat->max());
 
+        int factor = props.get<int>("majorant_resolution_factor", 0);
+        if (factor < 0)
+            Throw("The majorant resolution factor must be non-negative!");
+        m_majorant_resolution_factor = (uint32_t) factor;
+        update_majorant_grid();
+
+        m_decomposition = props.get<bool>("decomposition", false);
+        if (m_decomposition) {
+            if (has_flag(m_phase_function->flags(), PhaseFunctionFlags::Microflake))
+                Throw("Decomposition tracking is not supported with microflake "
+                      "phase functions!");
+            if (m_has_spectral_extinction && !is_monochromatic_v<Spectrum>)
+                Throw("Decomposition tracking requires an extinction "
+                      "coefficient that doesn't vary with the wavelength (set "
+                      "\"has_spectral_extinction\" to false)!");
+            ScalarFloat control = update_control_extinction();
+            if (!has_majorant_grid() && control <= 0.f)
+                Log(Warn, "Decomposition tracking has no effect, as the "
+                          "extinction coefficient has no positive lower bound "
+                          "(consider setting \"majorant_resolution_factor\")");
+        }
+
+        if (props.has_property("radiance")) {
+            if (has_flag(m_phase_function->flags(), PhaseFunctionFlags::Microflake))
+                Throw("Emissive media are not supported with microflake phase "
+                      "functions!");
+            m_radiance = props.volume<Volume>("radiance", 0.f);
+            m_volume_emitter = new VolumeEmitter(m_sigmat.get(), m_albedo.get(),
+                                                 m_radiance.get());
+            m_volume_emitter->update(m_scale);
+            m_emitter = m_volume_emitter;
+            dr::set_attr(this, "emitter", m_emitter.get());
+        }
+
         dr::set_attr(this, "is_homogeneous", m_is_homogeneous);
         dr::set_attr(this, "has_spectral_extinction", m_has_spectral_extinction);
     }
@@ -170,17 +508,27 @@ public:
         callback->put_parameter("scale", m_scale,        +ParamFlags::NonDifferentiable);
         callback->put_object("albedo",   m_albedo.get(), +ParamFlags::Differentiable);
         callback->put_object("sigma_t",  m_sigmat.get(), +ParamFlags::Differentiable);
+        if (m_radiance)
+            callback->put_object("radiance", m_radiance.get(), +ParamFlags::Differentiable);
         Base::traverse(callback);
     }
 
     void parameters_changed(const std::vector<std::string> &/*keys*/ = {}) override {
         m_max_density = dr::opaque<Float>(m_scale * m_sigmat->max());
+        update_majorant_grid();
+        update_control_extinction();
+        if (m_volume_emitter) {
+            m_volume_emitter->update(m_scale);
+            m_volume_emitter->parameters_changed();
+        }
     }
 
     UnpolarizedSpectrum
-    get_majorant(const MediumInteraction3f & /* mi */,
+    get_majorant(const MediumInteraction3f &mi,
                  Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        if (has_majorant_grid())
+            return eval_majorant_grid(mi.p, active);
         return m_max_density;
     }
 
@@ -189,15 +537,32 @@ public:
                                 Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
 
-        auto sigmat = m_scale * m_sigmat->eval(mi, active);
+        // Co-located grids share the interpolation weights of both lookups
+        auto [sigmat, albedo] =
+            m_sigmat->eval_pair(m_albedo.get(), mi, mi.footprint, active);
+        sigmat *= m_scale;
         if (has_flag(m_phase_function->flags(), PhaseFunctionFlags::Microflake))
             sigmat *= m_phase_function->projected_area(mi, active);
 
-        auto sigmas = sigmat * m_albedo->eval(mi, active);
-        auto sigman = m_max_density - sigmat;
+        auto sigmas = sigmat * albedo;
+        auto sigman = get_majorant(mi, active) - sigmat;
         return { sigmas, sigman, sigmat };
     }
 
+    UnpolarizedSpectrum get_albedo(const MediumInteraction3f &mi,
+                                   Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        return m_albedo->eval_lod(mi, mi.footprint, active);
+    }
+
+    UnpolarizedSpectrum get_emission(const MediumInteraction3f &mi,
+                                     Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+        if (!m_volume_emitter)
+            return 0.f;
+        return m_volume_emitter->eval_emission(mi, mi.footprint, active);
+    }
+
     std::tuple<Mask, Float, Float>
     intersect_aabb(const Ray3f &ray) const override {
         return m_sigmat->bbox().ray_intersect(ray);
@@ -207,20 +572,62 @@ public:
         std::ostringstream oss;
         oss << "HeterogeneousMedium[" << std::endl
             << "  albedo  = " << string::indent(m_albedo) << std::endl
-            << "  sigma_t = " << string::indent(m_sigmat) << std::endl
-            << "  scale   = " << string::indent(m_scale) << std::endl
+            << "  sigma_t = " << string::indent(m_sigmat) << std::endl;
+        if (m_radiance)
+            oss << "  radiance = " << string::indent(m_radiance) << std::endl;
+        oss
+            << "  scale   = " << string::indent(m_scale) << "," << std::endl;
+        if (has_majorant_grid())
+            oss << "  majorant_grid = " << m_majorant_resolution << "," << std::endl;
+        oss << "  decomposition = " << m_decomposition << std::endl
             << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS()
 private:
-    ref<Volume> m_sigmat, m_albedo;
+    /// (Re)compute the local majorants from the extinction volume
+    void update_majorant_grid() {
+        if (m_majorant_resolution_factor == 0)
+            return;
+
+        ScalarVector3i res = m_sigmat->resolution();
+        ScalarVector3i grid_res =
+            (res + (int) m_majorant_resolution_factor - 1) /
+            (int) m_majorant_resolution_factor;
+
+        TensorXf minorants;
+        if (!has_flag(m_phase_function->flags(), PhaseFunctionFlags::Microflake))
+            minorants = m_sigmat->local_minorants(grid_res, m_scale);
+
+        set_majorant_grid(m_sigmat->local_majorants(grid_res, m_scale),
+                          m_sigmat->world_transform(), minorants);
+    }
+
+    /// (Re)compute the control extinction used by decomposition tracking and return it
+    ScalarFloat update_control_extinction() {
+        if (!m_decomposition)
+            return 0.f;
+
+        // The local minorants of the majorant grid take precedence
+        ScalarFloat control = 0.f;
+        if (!has_majorant_grid())
+            control = dr::slice(
+                m_sigmat->local_minorants(ScalarVector3i(1), m_scale).array(), 0);
+        set_control_extinction(control);
+        return control;
+    }
+
+private:
+    ref<Volume> m_sigmat, m_albedo, m_radiance;
+    ref<VolumeEmitter> m_volume_emitter;
     ScalarFloat m_scale;
+    uint32_t m_majorant_resolution_factor;
 
     Float m_max_density;
 };
 
+MI_IMPLEMENT_CLASS_VARIANT(HeterogeneousMediumEmitter, Emitter)
 MI_IMPLEMENT_CLASS_VARIANT(HeterogeneousMedium, Medium)
 MI_EXPORT_PLUGIN(HeterogeneousMedium, "Heterogeneous Medium")
 NAMESPACE_END(mitsuba)
@@ -0,0 +1,258 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def make_medium(factor, decomposition=False):
+    import numpy as np
+    # Thin fog for x < 0.5 and a dense region for x >= 0.5
+    data = np.full((8, 8, 8, 1), 0.1, dtype=np.float32)
+    data[:, :, 4:] = 5.0
+    return mi.load_dict({
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf(data),
+            'raw': True,
+            'filter_type': 'nearest'
+        },
+        'albedo': 0.5,
+        'majorant_resolution_factor': factor,
+        'decomposition': decomposition,
+        'has_spectral_extinction': not decomposition
+    })
+
+
+def delta_tracking(medium, o, d, n=100000):
+    """Estimate the transmittance along a ray and count null collisions"""
+    rng = mi.PCG32(size=n)
+    ray = mi.Ray3f(mi.Point3f(dr.full(mi.Float, o[0], n), o[1], o[2]), d)
+    active = mi.Bool(True)
+    escaped = mi.Bool(False)
+    collisions = 0
+
+    for i in range(500):
+        mei = medium.sample_interaction(ray, rng.next_float32(), mi.UInt32(0), 0.0, active)
+        escaped |= active & ~mei.is_valid()
+        active &= mei.is_valid()
+        null = rng.next_float32() >= mei.sigma_t[0] / mei.combined_extinction[0]
+        active &= null
+        collisions += dr.count(active)
+        ray.o = dr.select(active, mei.p, ray.o)
+        if dr.none(active):
+            break
+
+    return dr.count(escaped) / n, collisions / n
+
+
+def test01_majorant_grid(variants_vec_rgb):
+    medium = make_medium(factor=4)
+    assert medium.has_majorant_grid()
+    assert not make_medium(factor=0).has_majorant_grid()
+
+    mei = dr.zeros(mi.MediumInteraction3f)
+    mei.p = [0.2, 0.5, 0.5]
+    assert dr.allclose(medium.get_majorant(mei)[0], 0.1)
+    mei.p = [0.8, 0.5, 0.5]
+    assert dr.allclose(medium.get_majorant(mei)[0], 5.0)
+
+
+@pytest.mark.parametrize('direction', ['sparse', 'crossing'])
+def test02_sample_interaction(variants_vec_rgb, direction):
+    if direction == 'sparse':
+        # Ray through the thin fog only
+        o, d, tau = [0.25, 0.5, 0.0], [0, 0, 1], 0.1
+    else:
+        # Ray crossing both regions
+        o, d, tau = [0.0, 0.5, 0.5], [1, 0, 0], 0.5 * 0.1 + 0.5 * 5.0
+
+    tr_global, collisions_global = delta_tracking(make_medium(factor=0), o, d)
+    tr_grid, collisions_grid = delta_tracking(make_medium(factor=4), o, d)
+
+    assert dr.allclose(tr_global, dr.exp(-tau), atol=5e-3)
+    assert dr.allclose(tr_grid, dr.exp(-tau), atol=5e-3)
+    assert collisions_grid < collisions_global
+
+    # Without a footprint, the finest level of detail is used
+    medium = make_medium(factor=4)
+    ray = mi.Ray3f(o, d)
+    mei_lod = medium.sample_interaction(ray, 0.5, 0, 0.0, True)
+    mei = medium.sample_interaction(ray, 0.5, 0, True)
+    assert dr.allclose(mei.t, mei_lod.t)
+
+
+@pytest.mark.parametrize('direction', ['sparse', 'crossing'])
+def test03_eval_transmittance(variants_vec_rgb, direction):
+    import numpy as np
+    if direction == 'sparse':
+        o, d, tau = [0.25, 0.5, 0.0], [0, 0, 1], 0.1
+    else:
+        o, d, tau = [0.0, 0.5, 0.5], [1, 0, 0], 0.5 * 0.1 + 0.5 * 5.0
+
+    n = 100000
+    rng = mi.PCG32(size=n)
+    ray = mi.Ray3f(mi.Point3f(dr.full(mi.Float, o[0], n), o[1], o[2]), d)
+
+    # Residual tracking w.r.t. half of the global majorant
+    tr_global = np.array(make_medium(factor=0).eval_transmittance(ray, rng.next_float32())[0])
+    assert dr.allclose(np.mean(tr_global), dr.exp(-tau), atol=5e-3)
+
+    # The minorants and majorants match in all cells, the estimate is exact
+    tr_grid = np.array(make_medium(factor=4).eval_transmittance(ray, rng.next_float32())[0])
+    assert np.allclose(tr_grid, np.exp(-tau), rtol=1e-4)
+    assert np.var(tr_grid) < np.var(tr_global)
+
+    # Rays that miss the medium are unaffected
+    ray.o = mi.Point3f(2, 2, 2)
+    assert dr.allclose(make_medium(factor=4).eval_transmittance(ray, 0.5), 1.0)
+
+
+@pytest.mark.parametrize('direction', ['sparse', 'crossing'])
+def test04_decomposition_tracking(variants_vec_rgb, direction):
+    if direction == 'sparse':
+        o, d, tau = [0.25, 0.5, 0.0], [0, 0, 1], 0.1
+    else:
+        o, d, tau = [0.0, 0.5, 0.5], [1, 0, 0], 0.5 * 0.1 + 0.5 * 5.0
+
+    # The control extinction is the global minimum of the density
+    tr_global, _ = delta_tracking(make_medium(factor=0, decomposition=True), o, d)
+    assert dr.allclose(tr_global, dr.exp(-tau), atol=5e-3)
+
+    # The minorants match the density in all cells: no null collisions remain
+    medium = make_medium(factor=4, decomposition=True)
+    tr_grid, collisions_grid = delta_tracking(medium, o, d)
+    assert dr.allclose(tr_grid, dr.exp(-tau), atol=5e-3)
+    assert collisions_grid == 0
+
+    # Collisions with the control extinction report the medium's albedo
+    ray = mi.Ray3f(mi.Point3f(dr.full(mi.Float, o[0], 1000), o[1], o[2]), d)
+    rng = mi.PCG32(size=1000)
+    mei = medium.sample_interaction(ray, rng.next_float32(), mi.UInt32(0), 0.0, True)
+    valid = mei.is_valid()
+    assert dr.all(~valid | dr.eq(mei.sigma_t[0], mei.combined_extinction[0]))
+    assert dr.allclose(dr.select(valid, mei.sigma_s[0] / mei.sigma_t[0], 0.5), 0.5)
+
+    # Constant volumes provide their value as the control extinction
+    medium = mi.load_dict({
+        'type': 'heterogeneous',
+        'sigma_t': 2.0,
+        'decomposition': True,
+        'has_spectral_extinction': False
+    })
+    tr_const, collisions_const = delta_tracking(medium, o, d)
+    assert dr.allclose(tr_const, dr.exp(-2.0), atol=5e-3)
+    assert collisions_const == 0
+
+
+def test05_emission(variants_vec_rgb):
+    import numpy as np
+    # Emission is limited to a small hot spot inside the dense region
+    sigma_t = np.full((8, 8, 8, 1), 0.1, dtype=np.float32)
+    sigma_t[:, :, 4:] = 5.0
+    radiance = np.zeros((8, 8, 8, 1), dtype=np.float32)
+    radiance[2:4, 2:4, 5:7] = 4.0
+    medium = mi.load_dict({
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf(sigma_t),
+            'raw': True,
+            'filter_type': 'nearest'
+        },
+        'albedo': 0.5,
+        'radiance': {
+            'type': 'gridvolume',
+            'data': mi.TensorXf(radiance),
+            'raw': True,
+            'filter_type': 'nearest'
+        }
+    })
+    assert medium.is_emitter()
+    assert not make_medium(factor=0).is_emitter()
+
+    mei = dr.zeros(mi.MediumInteraction3f)
+    mei.p = [0.75, 0.3, 0.3]
+    assert dr.allclose(medium.get_emission(mei)[0], 5.0 * 0.5 * 4.0)
+    mei.p = [0.25, 0.3, 0.3]
+    assert dr.allclose(medium.get_emission(mei)[0], 0.0)
+
+    # Sampled positions are confined to the emissive cells
+    emitter = medium.emitter()
+    n = 100000
+    rng = mi.PCG32(size=n)
+    ps, weight = emitter.sample_position(0.0, [rng.next_float32(), rng.next_float32()])
+    mei.p = ps.p
+    assert dr.all(medium.get_emission(mei)[0] > 0.0)
+
+    # The estimate of the total emitted power is exact (uniform emission)
+    total = dr.sum(medium.get_emission(mei)[0] * weight)[0] / n
+    assert dr.allclose(total, 5.0 * 0.5 * 4.0 * 8 / 512, rtol=1e-3)
+    assert dr.allclose(emitter.pdf_position(ps), 1.0 / weight)
+
+    # Stratified samples remain stratified along all three in-cell coordinates
+    n = 65536
+    y = (np.arange(n, dtype=np.float64) + 0.5) / n
+    ps, _ = emitter.sample_position(0.0, [dr.full(mi.Float, 0.5, n), mi.Float(y)])
+    z = np.array(ps.p.z) * 8
+    counts = np.histogram(z - np.floor(z), bins=16, range=(0, 1))[0]
+    assert np.all(counts == n // 16)
+
+    # The medium's emitter is registered with the scene
+    scene = mi.load_dict({
+        'type': 'scene',
+        'cube': {
+            'type': 'cube',
+            'to_world': mi.ScalarTransform4f.translate(0.5).scale(0.5),
+            'bsdf': { 'type': 'null' },
+            'interior': medium
+        }
+    })
+    assert len(scene.emitters()) == 1
+
+    # .. also when it is only referenced by a sensor
+    scene = mi.load_dict({
+        'type': 'scene',
+        'sensor': { 'type': 'perspective', 'medium': medium }
+    })
+    assert len(scene.emitters()) == 1
+
+
+@pytest.mark.parametrize('integrator', ['volpath', 'volpathmis', 'prbvolpath'])
+def test06_emission_camera_paths(variants_all_ad_rgb, integrator):
+    import numpy as np
+    # Camera rays cross a purely absorbing medium of unit thickness
+    grid = lambda value: {
+        'type': 'gridvolume',
+        'data': mi.TensorXf(np.full((2, 2, 2, 1), value, dtype=np.float32)),
+        'raw': True
+    }
+    scene = mi.load_dict({
+        'type': 'scene',
+        'integrator': { 'type': integrator, 'max_depth': 8 },
+        'sensor': {
+            'type': 'orthographic',
+            'to_world': mi.ScalarTransform4f.look_at(origin=[0.5, 0.5, -2],
+                                                     target=[0.5, 0.5, 0.5],
+                                                     up=[0, 1, 0]).scale(0.25),
+            'film': {
+                'type': 'hdrfilm', 'width': 2, 'height': 2,
+                'rfilter': { 'type': 'box' }, 'pixel_format': 'rgb'
+            },
+            'sampler': { 'type': 'independent', 'sample_count': 1024 }
+        },
+        'cube': {
+            'type': 'cube',
+            'to_world': mi.ScalarTransform4f.translate(0.5).scale(0.5),
+            'bsdf': { 'type': 'null' },
+            'interior': {
+                'type': 'heterogeneous',
+                'sigma_t': grid(1.0),
+                'albedo': 0.0,
+                'radiance': grid(2.0)
+            }
+        }
+    })
+
+    # Only the emission collected at collisions reaches the camera
+    image = np.array(mi.render(scene))
+    assert np.allclose(image, 2.0 * (1.0 - np.exp(-1.0)), rtol=0.05)
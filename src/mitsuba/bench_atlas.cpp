@@ -0,0 +1,207 @@
+/*
+    Benchmark of texture atlas packing in JIT variants
+
+    Renders a scene containing a grid of rectangles, each with its own diffuse
+    material referencing a small random bitmap texture, with and without the
+    'texture_atlas' scene property. Reports the size of the generated rendering
+    kernels (number of operations and length of the IR), the time needed to
+    compile them, and the time needed to render the image once the kernels
+    are cached.
+
+    Usage: mitsuba-bench-atlas [variant] [textures] [resolution] [spp]
+*/
+
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/jit.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/scene.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+using namespace mitsuba;
+
+/// Statistics of the kernels launched since the previous call
+struct KernelStats {
+    size_t kernels = 0, operations = 0, ir_size = 0;
+    double codegen_time = 0.0, backend_time = 0.0, execution_time = 0.0;
+};
+
+KernelStats kernel_stats() {
+    KernelStats stats;
+    KernelHistoryEntry *history = jit_kernel_history();
+    for (KernelHistoryEntry *e = history; e && (uint32_t) e->backend; ++e) {
+        if (e->type == KernelType::JIT) {
+            stats.kernels++;
+            stats.operations += e->operation_count;
+            stats.codegen_time += e->codegen_time;
+            stats.backend_time += e->backend_time;
+            stats.execution_time += e->execution_time;
+            if (e->ir) {
+                stats.ir_size += strlen(e->ir);
+                free(e->ir);
+            }
+        }
+    }
+    free(history);
+    return stats;
+}
+
+template <typename Float, typename Spectrum>
+void scene_static_accel_initialization() {
+    Scene<Float, Spectrum>::static_accel_initialization();
+}
+
+template <typename Float, typename Spectrum>
+void scene_static_accel_shutdown() {
+    Scene<Float, Spectrum>::static_accel_shutdown();
+}
+
+template <typename Float, typename Spectrum>
+void run(size_t count, uint32_t resolution, uint32_t spp) {
+    MI_IMPORT_TYPES(Scene, Integrator, Film, Sensor, Emitter, Texture, BSDF, Shape)
+    PluginManager *pmgr = PluginManager::instance();
+
+    if constexpr (!dr::is_jit_v<Float>) {
+        DRJIT_MARK_USED(count);
+        DRJIT_MARK_USED(resolution);
+        DRJIT_MARK_USED(spp);
+        DRJIT_MARK_USED(pmgr);
+        Throw("This benchmark requires a JIT variant!");
+    } else {
+        std::cout << tfm::format("%zu textures of %ux%u texels, %u spp", count,
+                                 resolution, resolution, spp) << std::endl
+                  << tfm::format("%-8s %8s %12s %10s %10s %12s", "atlas",
+                                 "kernels", "operations", "IR size",
+                                 "compile", "render") << std::endl;
+
+        uint32_t grid = (uint32_t) std::ceil(std::sqrt((double) count));
+
+        for (bool atlas : { false, true }) {
+            Properties scene_props("scene");
+            scene_props.set_bool("texture_atlas", atlas);
+
+            Properties film_props("hdrfilm");
+            film_props.set_int("width", 512);
+            film_props.set_int("height", 512);
+
+            Properties sensor_props("perspective");
+            sensor_props.set_transform("to_world", ScalarTransform4f::look_at(
+                ScalarPoint3f(0.f, 0.f, 2.5f), ScalarPoint3f(0.f),
+                ScalarVector3f(0.f, 1.f, 0.f)));
+            sensor_props.set_object("film", pmgr->create_object(film_props, MI_CLASS(Film)));
+            scene_props.set_object("sensor", pmgr->create_object(sensor_props, MI_CLASS(Sensor)));
+
+            Properties emitter_props("constant");
+            scene_props.set_object("emitter", pmgr->create_object(emitter_props, MI_CLASS(Emitter)));
+
+            Properties integrator_props("direct");
+            ref<Integrator> integrator = pmgr->create_object<Integrator>(integrator_props);
+
+            for (size_t i = 0; i < count; ++i) {
+                ref<Bitmap> bitmap = new Bitmap(Bitmap::PixelFormat::RGB,
+                                                struct_type_v<ScalarFloat>,
+                                                ScalarVector2u(resolution));
+                ScalarFloat *data = (ScalarFloat *) bitmap->data();
+                for (size_t j = 0; j < bitmap->pixel_count() * 3; ++j)
+                    data[j] = (ScalarFloat) sample_tea_float32((uint32_t) i, (uint32_t) j);
+
+                Properties texture_props("bitmap");
+                texture_props.set_object("bitmap", ref<Object>(bitmap.get()));
+                texture_props.set_bool("raw", true);
+
+                Properties bsdf_props("diffuse");
+                bsdf_props.set_object("reflectance", pmgr->create_object(texture_props, MI_CLASS(Texture)));
+
+                ScalarFloat cell = 2.f / grid;
+                Properties shape_props("rectangle");
+                shape_props.set_transform("to_world",
+                    ScalarTransform4f::translate(ScalarVector3f(
+                        ((i % grid) + .5f) * cell - 1.f,
+                        ((i / grid) + .5f) * cell - 1.f, 0.f)) *
+                    ScalarTransform4f::scale(ScalarVector3f(.45f * cell)));
+                shape_props.set_object("bsdf", pmgr->create_object(bsdf_props, MI_CLASS(BSDF)));
+                scene_props.set_object("shape_" + std::to_string(i),
+                                       pmgr->create_object(shape_props, MI_CLASS(Shape)));
+            }
+
+            ref<Scene> scene = pmgr->create_object<Scene>(scene_props);
+
+            jit_set_flag(JitFlag::KernelHistory, true);
+            kernel_stats(); // clear the history
+
+            // The first rendering compiles the kernels
+            TensorXf image = integrator->render(scene.get(), 0, 0, spp, true, true);
+            dr::eval(image);
+            dr::sync_thread();
+            KernelStats compile = kernel_stats();
+
+            auto start = std::chrono::high_resolution_clock::now();
+            image = integrator->render(scene.get(), 0, 1, spp, true, true);
+            dr::eval(image);
+            dr::sync_thread();
+            auto end = std::chrono::high_resolution_clock::now();
+            kernel_stats();
+            jit_set_flag(JitFlag::KernelHistory, false);
+
+            std::cout << tfm::format(
+                "%-8s %8zu %12zu %10s %7.1f ms %9.1f ms", atlas ? "yes" : "no",
+                compile.kernels, compile.operations,
+                util::mem_string(compile.ir_size),
+                compile.codegen_time + compile.backend_time,
+                std::chrono::duration<double, std::milli>(end - start).count())
+                      << std::endl;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Jit::static_initialization();
+    Class::static_initialization();
+    Thread::static_initialization();
+    Logger::static_initialization();
+    Bitmap::static_initialization();
+    librender_nop();
+
+    std::string mode = argc > 1 ? argv[1] : "llvm_rgb";
+    size_t count = argc > 2 ? (size_t) std::stoull(argv[2]) : 1024;
+    uint32_t resolution = argc > 3 ? (uint32_t) std::stoul(argv[3]) : 32;
+    uint32_t spp = argc > 4 ? (uint32_t) std::stoul(argv[4]) : 16;
+
+    bool cuda = string::starts_with(mode, "cuda_"),
+         llvm = string::starts_with(mode, "llvm_");
+#if defined(MI_ENABLE_CUDA)
+    if (cuda)
+        jit_init((uint32_t) JitBackend::CUDA);
+#endif
+#if defined(MI_ENABLE_LLVM)
+    if (llvm)
+        jit_init((uint32_t) JitBackend::LLVM);
+#endif
+    color_management_static_initialization(cuda, llvm);
+    MI_INVOKE_VARIANT(mode, scene_static_accel_initialization);
+
+    int result = 0;
+    try {
+        MI_INVOKE_VARIANT(mode, run, count, resolution, spp);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        result = 1;
+    }
+
+    MI_INVOKE_VARIANT(mode, scene_static_accel_shutdown);
+    color_management_static_shutdown();
+    Bitmap::static_shutdown();
+    Logger::static_shutdown();
+    Thread::static_shutdown();
+    Class::static_shutdown();
+    Jit::static_shutdown();
+    return result;
+}
@@ -0,0 +1,239 @@
+/*
+    Benchmark of free-flight sampling in heterogeneous media
+
+    Creates a procedural cloud, either dense (smoothly varying density) or
+    sparse (a few dense blobs surrounded by thin fog), and compares several
+    resolutions of the majorant grid of the 'heterogeneous' medium (a factor
+    of 0 denotes a single global majorant), as well as the storage formats of
+    the 'gridvolume' density. For each configuration, it reports the memory
+    used by the density, the average number of null collisions encountered by
+    delta tracking along random rays through the medium, along with the time
+    needed to render the cloud with the 'volpath' integrator once the kernels
+    are compiled.
+
+    Usage: mitsuba-bench-media [variant] [resolution] [spp]
+*/
+
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/jit.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/warp.h>
+#include <mitsuba/render/integrator.h>
+#include <mitsuba/render/medium.h>
+#include <mitsuba/render/scene.h>
+#include <chrono>
+#include <iostream>
+
+using namespace mitsuba;
+
+/// Procedural density in [0, 1]^3, using a few Gaussian blobs
+float cloud_density(float x, float y, float z, bool sparse) {
+    const float blobs[4][4] = { { .3f, .4f, .5f, .20f }, { .7f, .6f, .4f, .15f },
+                                { .5f, .3f, .7f, .10f }, { .6f, .7f, .6f, .05f } };
+    float value = 0.f;
+    for (const float *b : blobs) {
+        float d2 = dr::sqr(x - b[0]) + dr::sqr(y - b[1]) + dr::sqr(z - b[2]),
+              r  = sparse ? b[3] * .3f : b[3] * 2.f;
+        value += std::exp(-d2 / dr::sqr(r));
+    }
+    return sparse ? .01f + 50.f * value : value;
+}
+
+template <typename Float, typename Spectrum>
+void scene_static_accel_initialization() {
+    Scene<Float, Spectrum>::static_accel_initialization();
+}
+
+template <typename Float, typename Spectrum>
+void scene_static_accel_shutdown() {
+    Scene<Float, Spectrum>::static_accel_shutdown();
+}
+
+/// Average number of null collisions of delta tracking along random rays
+template <typename Float, typename Spectrum>
+double null_collisions(const Medium<Float, Spectrum> *medium, uint32_t rays) {
+    MI_IMPORT_TYPES()
+
+    UInt32 index = dr::arange<UInt32>(rays);
+    PCG32<UInt32> rng(rays, index);
+
+    // Rays start inside the medium's bounding box [-1, 1]^3
+    Point3f o(rng.next_float32(), rng.next_float32(), rng.next_float32());
+    Vector3f d = warp::square_to_uniform_sphere(
+        Point2f(rng.next_float32(), rng.next_float32()));
+    Ray3f ray(dr::fmadd(o, 2.f, -1.f), d);
+
+    Mask active = true;
+    UInt32 count = 0;
+    for (size_t i = 0; i < 10000; ++i) {
+        MediumInteraction3f mei =
+            medium->sample_interaction(ray, rng.next_float32(), 0u, 0.f, active);
+        active &= mei.is_valid();
+
+        Mask null_scatter = active && rng.next_float32() >=
+                                          mei.sigma_t[0] / mei.combined_extinction[0];
+        dr::masked(count, null_scatter) += 1u;
+        dr::masked(ray.o, null_scatter) = mei.p;
+        active = null_scatter;
+
+        dr::eval(ray.o, active, count);
+        if (dr::none(active))
+            break;
+    }
+
+    return (double) dr::slice(dr::sum(count)) / rays;
+}
+
+template <typename Float, typename Spectrum>
+void run(uint32_t resolution, uint32_t spp) {
+    MI_IMPORT_TYPES(Scene, Integrator, Medium, Volume, Film, Sensor, Emitter,
+                    BSDF, Shape)
+    PluginManager *pmgr = PluginManager::instance();
+
+    if constexpr (!dr::is_jit_v<Float>) {
+        DRJIT_MARK_USED(resolution);
+        DRJIT_MARK_USED(spp);
+        DRJIT_MARK_USED(pmgr);
+        Throw("This benchmark requires a JIT variant!");
+    } else {
+        std::cout << tfm::format("%u^3 voxels, %u spp", resolution, spp)
+                  << std::endl
+                  << tfm::format("%-8s %8s %8s %10s %16s %12s", "cloud",
+                                 "factor", "storage", "memory",
+                                 "null collisions", "render") << std::endl;
+
+        struct Config { int factor; const char *storage; size_t bytes; };
+        const Config configs[] = {
+            { 0, "float32", 4 }, { 16, "float32", 4 }, { 8, "float32", 4 },
+            { 4, "float32", 4 }, { 8, "float16", 2 }, { 8, "unorm16", 2 },
+            { 8, "unorm8", 1 }
+        };
+
+        for (bool sparse : { false, true }) {
+            std::unique_ptr<ScalarFloat[]> data(
+                new ScalarFloat[(size_t) resolution * resolution * resolution]);
+            for (uint32_t z = 0; z < resolution; ++z)
+                for (uint32_t y = 0; y < resolution; ++y)
+                    for (uint32_t x = 0; x < resolution; ++x)
+                        data[((size_t) z * resolution + y) * resolution + x] =
+                            cloud_density((x + .5f) / resolution,
+                                          (y + .5f) / resolution,
+                                          (z + .5f) / resolution, sparse);
+            size_t shape[4] = { resolution, resolution, resolution, 1 };
+            auto density = std::make_shared<TensorXf>(data.get(), 4, shape);
+
+            for (const Config &config : configs) {
+                Properties volume_props("gridvolume");
+                volume_props.set_tensor_handle("data", density);
+                volume_props.set_bool("raw", true);
+                volume_props.set_string("storage", config.storage);
+                volume_props.set_transform("to_world",
+                    ScalarTransform4f::translate(ScalarVector3f(-1.f)) *
+                    ScalarTransform4f::scale(ScalarVector3f(2.f)));
+
+                Properties medium_props("heterogeneous");
+                medium_props.set_object("sigma_t", pmgr->create_object(volume_props, MI_CLASS(Volume)));
+                medium_props.set_float("scale", 20.f);
+                medium_props.set_float("albedo", .8f);
+                medium_props.set_int("majorant_resolution_factor", config.factor);
+                ref<Medium> medium = pmgr->create_object<Medium>(medium_props);
+
+                double collisions = null_collisions(medium.get(), 1u << 18);
+
+                Properties film_props("hdrfilm");
+                film_props.set_int("width", 256);
+                film_props.set_int("height", 256);
+
+                Properties sensor_props("perspective");
+                sensor_props.set_transform("to_world", ScalarTransform4f::look_at(
+                    ScalarPoint3f(0.f, 0.f, 4.f), ScalarPoint3f(0.f),
+                    ScalarVector3f(0.f, 1.f, 0.f)));
+                sensor_props.set_object("film", pmgr->create_object(film_props, MI_CLASS(Film)));
+
+                Properties shape_props("cube");
+                shape_props.set_object("bsdf", pmgr->create_object(Properties("null"), MI_CLASS(BSDF)));
+                shape_props.set_object("interior", ref<Object>(medium.get()));
+
+                Properties scene_props("scene");
+                scene_props.set_object("sensor", pmgr->create_object(sensor_props, MI_CLASS(Sensor)));
+                scene_props.set_object("emitter", pmgr->create_object(Properties("constant"), MI_CLASS(Emitter)));
+                scene_props.set_object("shape", pmgr->create_object(shape_props, MI_CLASS(Shape)));
+                ref<Scene> scene = pmgr->create_object<Scene>(scene_props);
+
+                Properties integrator_props("volpath");
+                integrator_props.set_int("max_depth", 16);
+                ref<Integrator> integrator = pmgr->create_object<Integrator>(integrator_props);
+
+                // The first rendering compiles the kernels
+                TensorXf image = integrator->render(scene.get(), 0, 0, spp, true, true);
+                dr::eval(image);
+                dr::sync_thread();
+
+                auto start = std::chrono::high_resolution_clock::now();
+                image = integrator->render(scene.get(), 0, 1, spp, true, true);
+                dr::eval(image);
+                dr::sync_thread();
+                auto end = std::chrono::high_resolution_clock::now();
+
+                size_t memory = (size_t) resolution * resolution * resolution * config.bytes;
+                std::cout << tfm::format(
+                    "%-8s %8s %8s %10s %16.2f %9.1f ms",
+                    sparse ? "sparse" : "dense",
+                    config.factor == 0 ? std::string("-")
+                                       : std::to_string(config.factor),
+                    config.storage, util::mem_string(memory), collisions,
+                    std::chrono::duration<double, std::milli>(end - start).count())
+                          << std::endl;
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Jit::static_initialization();
+    Class::static_initialization();
+    Thread::static_initialization();
+    Logger::static_initialization();
+    Bitmap::static_initialization();
+    librender_nop();
+
+    std::string mode = argc > 1 ? argv[1] : "llvm_rgb";
+    uint32_t resolution = argc > 2 ? (uint32_t) std::stoul(argv[2]) : 128;
+    uint32_t spp = argc > 3 ? (uint32_t) std::stoul(argv[3]) : 16;
+
+    bool cuda = string::starts_with(mode, "cuda_"),
+         llvm = string::starts_with(mode, "llvm_");
+#if defined(MI_ENABLE_CUDA)
+    if (cuda)
+        jit_init((uint32_t) JitBackend::CUDA);
+#endif
+#if defined(MI_ENABLE_LLVM)
+    if (llvm)
+        jit_init((uint32_t) JitBackend::LLVM);
+#endif
+    color_management_static_initialization(cuda, llvm);
+    MI_INVOKE_VARIANT(mode, scene_static_accel_initialization);
+
+    int result = 0;
+    try {
+        MI_INVOKE_VARIANT(mode, run, resolution, spp);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        result = 1;
+    }
+
+    MI_INVOKE_VARIANT(mode, scene_static_accel_shutdown);
+    color_management_static_shutdown();
+    Bitmap::static_shutdown();
+    Logger::static_shutdown();
+    Thread::static_shutdown();
+    Class::static_shutdown();
+    Jit::static_shutdown();
+    return result;
+}
@@ -0,0 +1,197 @@
+/*
+    Micro-benchmark of the Properties container
+
+    Measures the throughput of the three operations that dominate plugin
+    construction when loading large scenes (filling a Properties record,
+    querying it from a plugin constructor, and copying it) and compares it
+    to the previous std::map-based layout, which is reproduced below.
+
+    Usage: mitsuba-bench-properties [iterations]
+*/
+
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/core/variant.h>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <map>
+
+using namespace mitsuba;
+
+using Float         = Properties::Float;
+using Array3f       = Properties::Array3f;
+using Color3f       = Properties::Color3f;
+using Transform3f   = Properties::Transform3f;
+using Transform4f   = Properties::Transform4f;
+using TensorHandle  = Properties::TensorHandle;
+
+/// Previous implementation: ordered map with one heap node and key per entry
+class LegacyProperties {
+public:
+    using VariantType = variant<bool, int64_t, Float, Array3f, std::string,
+                                Transform3f, Transform4f, TensorHandle,
+                                Color3f, NamedReference, ref<Object>,
+                                const void *>;
+
+    struct alignas(32) Entry {
+        VariantType data;
+        bool queried;
+    };
+
+    struct SortKey {
+        bool operator()(const std::string &a, const std::string &b) const {
+            size_t i = 0;
+            while (i < a.size() && i < b.size() && a[i] == b[i])
+                ++i;
+            while (i > 0 && std::isdigit(a[i-1]))
+                --i;
+            const char *a_ptr = a.c_str() + i, *b_ptr = b.c_str() + i;
+            if (std::isdigit(*a_ptr) && std::isdigit(*b_ptr)) {
+                char *a_end, *b_end;
+                long long l1 = std::strtoll(a_ptr, &a_end, 10);
+                long long l2 = std::strtoll(b_ptr, &b_end, 10);
+                if (a_end == (a.c_str() + a.size()) &&
+                    b_end == (b.c_str() + b.size()) &&
+                    l1 != LLONG_MAX && l2 != LLONG_MAX &&
+                    !((l1 == l2) && (a.size() != b.size())))
+                    return l1 < l2;
+            }
+            return std::strcmp(a_ptr, b_ptr) < 0;
+        }
+    };
+
+    LegacyProperties(const std::string &plugin_name)
+        : d(new Private()) { d->plugin_name = plugin_name; }
+    LegacyProperties(const LegacyProperties &p)
+        : d(new Private(*p.d)) { }
+
+    template <typename T>
+    void set(const std::string &name, const T &value) {
+        if (d->entries.find(name) != d->entries.end())
+            Throw("Property \"%s\" was specified multiple times!", name);
+        d->entries[name].data = (T) value;
+        d->entries[name].queried = false;
+    }
+
+    template <typename T> T get(const std::string &name, const T &def_val) const {
+        auto it = d->entries.find(name);
+        if (it == d->entries.end())
+            return def_val;
+        if (!it->second.data.template is<T>())
+            Throw("The property \"%s\" has the wrong type", name);
+        it->second.queried = true;
+        return (const T &) it->second.data;
+    }
+
+    std::vector<std::string> unqueried() const {
+        std::vector<std::string> result;
+        for (const auto &e : d->entries)
+            if (!e.second.queried)
+                result.push_back(e.first);
+        return result;
+    }
+
+private:
+    struct Private {
+        std::map<std::string, Entry, SortKey> entries;
+        std::string id, plugin_name;
+    };
+    std::unique_ptr<Private> d;
+};
+
+static const Transform4f to_world = Transform4f::translate(Vector<double, 3>(1, 2, 3));
+
+/// Parameters of a typical mesh plugin
+template <typename P> P make(const P *) {
+    P props("ply");
+    props.set_string("filename", "meshes/object.ply");
+    props.set_transform("to_world", to_world);
+    props.set_named_reference("bsdf", NamedReference("material"));
+    props.set_bool("face_normals", true);
+    props.set_float("max_smooth_angle", 30.0);
+    return props;
+}
+
+LegacyProperties make(const LegacyProperties *) {
+    LegacyProperties props("ply");
+    props.set("filename", std::string("meshes/object.ply"));
+    props.set("to_world", to_world);
+    props.set("bsdf", NamedReference("material"));
+    props.set("face_normals", true);
+    props.set("max_smooth_angle", 30.0);
+    return props;
+}
+
+/// Queries issued by the plugin constructor, including a few missing keys
+template <typename P> size_t query(const P &props) {
+    size_t result = props.template get<std::string>("filename", "").size();
+    result += (size_t) props.template get<Transform4f>("to_world", Transform4f()).matrix(0, 3);
+    result += (size_t) props.template get<bool>("face_normals", false);
+    result += (size_t) props.template get<bool>("flip_normals", false);
+    result += (size_t) props.template get<Float>("max_smooth_angle", -1.0);
+    result += (size_t) props.template get<int64_t>("shape_index", 0);
+    result += props.unqueried().size();
+    return result;
+}
+
+template <typename Func> double measure(size_t iterations, Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+        func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           (double) iterations;
+}
+
+template <typename P> std::array<double, 3> run(size_t iterations) {
+    std::array<double, 3> result;
+    volatile size_t sink = 0;
+
+    result[0] = measure(iterations, [&] {
+        P props = make((const P *) nullptr);
+        sink = sink + (size_t) &props;
+    });
+
+    P props = make((const P *) nullptr);
+    result[1] = measure(iterations, [&] { sink = sink + query(props); });
+
+    result[2] = measure(iterations, [&] {
+        P copy(props);
+        sink = sink + (size_t) &copy;
+    });
+
+    return result;
+}
+
+int main(int argc, char *argv[]) {
+    Class::static_initialization();
+    Thread::static_initialization();
+    Logger::static_initialization();
+
+    size_t iterations = argc > 1 ? (size_t) std::stoull(argv[1]) : 1000000;
+
+    // Warm up (interns the property names, faults in allocator pages)
+    run<Properties>(iterations / 10);
+    run<LegacyProperties>(iterations / 10);
+
+    auto current = run<Properties>(iterations),
+         legacy  = run<LegacyProperties>(iterations);
+
+    const char *names[] = { "construct", "query", "copy" };
+    std::cout << tfm::format("%-10s %12s %12s %9s", "operation", "legacy",
+                             "current", "speedup") << std::endl;
+    for (size_t i = 0; i < 3; ++i)
+        std::cout << tfm::format("%-10s %9.1f ns %9.1f ns %8.2fx", names[i],
+                                 legacy[i], current[i], legacy[i] / current[i])
+                  << std::endl;
+
+    Logger::static_shutdown();
+    Thread::static_shutdown();
+    Class::static_shutdown();
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*
+    Micro-benchmark of bitmap texture lookups
+
+    Evaluates a bitmap texture at many random (incoherent) or scanline-ordered
+    (coherent) positions using each of the storage formats supported by the
+    'bitmap' plugin and reports the memory footprint of the texture along
+    with the throughput of the lookups. The texture is initialized from an
+    8-bit sRGB image, i.e. all formats represent the same data.
+
+    Usage: mitsuba-bench-texture [variant] [resolution] [lookups]
+*/
+
+#include <mitsuba/core/bitmap.h>
+#include <mitsuba/core/jit.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/thread.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/scene.h>
+#include <mitsuba/render/texture.h>
+#include <chrono>
+#include <iostream>
+
+using namespace mitsuba;
+
+template <typename Float, typename Spectrum>
+double measure(const Texture<Float, Spectrum> *texture, size_t lookups,
+               bool coherent) {
+    MI_IMPORT_TYPES()
+
+    auto start = std::chrono::high_resolution_clock::now();
+    if constexpr (dr::is_jit_v<Float>) {
+        UInt32 index = dr::arange<UInt32>((uint32_t) lookups);
+        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+        if (coherent) {
+            uint32_t width = (uint32_t) std::sqrt((double) lookups);
+            si.uv = Point2f(Float(index % width), Float(index / width)) / (ScalarFloat) width;
+        } else {
+            si.uv = Point2f(sample_tea_float32(index, 0u), sample_tea_float32(index, 1u));
+        }
+        si.wavelengths = 550.f;
+        dr::eval(si.uv);
+        dr::sync_thread();
+
+        start = std::chrono::high_resolution_clock::now();
+        UnpolarizedSpectrum value = texture->eval(si);
+        dr::eval(value);
+        dr::sync_thread();
+    } else {
+        SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+        si.wavelengths = 550.f;
+        uint32_t width = (uint32_t) std::sqrt((double) lookups);
+        volatile ScalarFloat sink = 0.f;
+        for (uint32_t i = 0; i < (uint32_t) lookups; ++i) {
+            if (coherent)
+                si.uv = Point2f((ScalarFloat) (i % width), (ScalarFloat) (i / width)) / (ScalarFloat) width;
+            else
+                si.uv = Point2f(sample_tea_float32(i, 0u), sample_tea_float32(i, 1u));
+            sink = sink + dr::sum(texture->eval(si));
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           (double) lookups;
+}
+
+template <typename Float, typename Spectrum>
+void run(const Bitmap *bitmap, size_t lookups) {
+    using TextureT = Texture<Float, Spectrum>;
+
+    std::cout << tfm::format("%-8s %12s %14s %14s", "format", "memory",
+                             "coherent", "random") << std::endl;
+
+    double reference[2] = { 0.0, 0.0 };
+    for (const char *format : { "float32", "float16", "uint8" }) {
+        Properties props("bitmap");
+        props.set_object("bitmap", ref<Object>(const_cast<Bitmap *>(bitmap)));
+        props.set_string("format", format);
+        ref<TextureT> texture =
+            PluginManager::instance()->create_object<TextureT>(props);
+
+        // Warm up (compiles kernels in JIT variants)
+        measure(texture.get(), lookups, true);
+        measure(texture.get(), lookups, false);
+
+        double timing[2] = { measure(texture.get(), lookups, true),
+                             measure(texture.get(), lookups, false) };
+        if (reference[0] == 0.0) {
+            reference[0] = timing[0];
+            reference[1] = timing[1];
+        }
+
+        // Extract the memory usage reported by the plugin
+        std::string desc = texture->to_string(), memory = "-";
+        size_t pos = desc.find("memory = ");
+        if (pos != std::string::npos)
+            memory = desc.substr(pos + 9, desc.find(',', pos) - pos - 9);
+        else
+            memory = util::mem_string(bitmap->pixel_count() *
+                                      bitmap->channel_count() * sizeof(float));
+
+        std::cout << tfm::format("%-8s %12s %6.2f ns %4.2fx %6.2f ns %4.2fx",
+                                 format, memory, timing[0],
+                                 reference[0] / timing[0], timing[1],
+                                 reference[1] / timing[1])
+                  << std::endl;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Jit::static_initialization();
+    Class::static_initialization();
+    Thread::static_initialization();
+    Logger::static_initialization();
+    Bitmap::static_initialization();
+    librender_nop();
+
+    std::string mode = argc > 1 ? argv[1] : MI_DEFAULT_VARIANT;
+    uint32_t resolution = argc > 2 ? (uint32_t) std::stoul(argv[2]) : 4096;
+    size_t lookups = argc > 3 ? (size_t) std::stoull(argv[3]) : 1u << 22;
+
+    bool cuda = string::starts_with(mode, "cuda_"),
+         llvm = string::starts_with(mode, "llvm_");
+#if defined(MI_ENABLE_CUDA)
+    if (cuda)
+        jit_init((uint32_t) JitBackend::CUDA);
+#endif
+#if defined(MI_ENABLE_LLVM)
+    if (llvm)
+        jit_init((uint32_t) JitBackend::LLVM);
+#endif
+    color_management_static_initialization(cuda, llvm);
+
+    // Random 8-bit sRGB image
+    ref<Bitmap> bitmap = new Bitmap(Bitmap::PixelFormat::RGB, Struct::Type::UInt8,
+                                    Vector<uint32_t, 2>(resolution, resolution));
+    bitmap->set_srgb_gamma(true);
+    uint8_t *data = (uint8_t *) bitmap->data();
+    for (size_t i = 0; i < bitmap->buffer_size(); ++i)
+        data[i] = (uint8_t) sample_tea_32((uint32_t) i, 0u).first;
+
+    std::cout << tfm::format("Variant %s, %ux%u texture, %zu lookups", mode,
+                             resolution, resolution, lookups) << std::endl;
+
+    MI_INVOKE_VARIANT(mode, run, bitmap.get(), lookups);
+
+    color_management_static_shutdown();
+    Bitmap::static_shutdown();
+    Logger::static_shutdown();
+    Thread::static_shutdown();
+    Class::static_shutdown();
+    Jit::static_shutdown();
+    return 0;
+}
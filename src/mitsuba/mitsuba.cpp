@@ -65,6 +65,16 @@ Options:
     -o <filename>, --output <filename>
         Write the output image to the file "filename".
 
+    -w, --write-async
+        Write output images asynchronously, i.e. start loading and
+        rendering the next scene while the previous image is being
+        compressed and written to disk.
+
+    -P <filename>, --load-profile <filename>
+        Record a timeline of the objects instantiated while loading the
+        scene and write it to "filename" (Chrome trace JSON format). A
+        summary of the most expensive objects is printed as well.
+
  === The following options are only relevant for JIT (CUDA/LLVM) modes ===
 
     -O [0-5]
@@ -105,7 +115,7 @@ void scene_static_accel_shutdown() {
 }
 
 template <typename Float, typename Spectrum>
-void render(Object *scene_, size_t sensor_i, fs::path filename) {
+void render(Object *scene_, size_t sensor_i, fs::path filename, bool write_async) {
     auto *scene = dynamic_cast<Scene<Float, Spectrum> *>(scene_);
     if (!scene)
         Throw("Root element of the input file must be a <scene> tag!");
@@ -135,7 +145,10 @@ void render(Object *scene_, size_t sensor_i, fs::path filename) {
         develop_callback = nullptr;
     }
 
-    film->write(filename);
+    if (write_async)
+        film->write_async(filename);
+    else
+        film->write(filename);
 }
 
 #if !defined(_WIN32)
@@ -166,6 +179,8 @@ int main(int argc, char *argv[]) {
     auto arg_define    = parser.add(StringVec{ "-D", "--define" }, true);
     auto arg_sensor_i  = parser.add(StringVec{ "-s", "--sensor" }, true);
     auto arg_output    = parser.add(StringVec{ "-o", "--output" }, true);
+    auto arg_async     = parser.add(StringVec{ "-w", "--write-async" }, false);
+    auto arg_profile   = parser.add(StringVec{ "-P", "--load-profile" }, true);
     auto arg_update    = parser.add(StringVec{ "-u", "--update" }, false);
     auto arg_help      = parser.add(StringVec{ "-h", "--help" });
     auto arg_mode      = parser.add(StringVec{ "-m", "--mode" }, true);
@@ -312,6 +327,9 @@ int main(int argc, char *argv[]) {
 
         size_t sensor_i  = (*arg_sensor_i ? arg_sensor_i->as_int() : 0);
 
+        if (*arg_profile)
+            xml::set_load_profile(arg_profile->as_string());
+
         // Append the mitsuba directory to the FileResolver search path list
         ref<Thread> thread = Thread::thread();
         ref<FileResolver> fr = thread->file_resolver();
@@ -362,9 +380,13 @@ int main(int argc, char *argv[]) {
                 Throw("Root element of the input file is expanded into "
                       "multiple objects, only a single object is expected!");
 
-            MI_INVOKE_VARIANT(mode, render, parsed[0].get(), sensor_i, filename);
+            MI_INVOKE_VARIANT(mode, render, parsed[0].get(), sensor_i,
+                              filename, (bool) *arg_async);
             arg_extra = arg_extra->next();
         }
+
+        // Wait for asynchronous writes of output images
+        Thread::wait_for_tasks();
     } catch (const std::exception &e) {
         error_msg = std::string("Caught a critical exception: ") + e.what();
     } catch (...) {
@@ -398,6 +420,11 @@ int main(int argc, char *argv[]) {
 #endif
     }
 
+    // Pending writes must complete before the bitmap/thread subsystems shut down
+    try {
+        Thread::wait_for_tasks();
+    } catch (...) { }
+
     MI_INVOKE_VARIANT(mode, scene_static_accel_shutdown);
     color_management_static_shutdown();
     Profiler::static_shutdown();
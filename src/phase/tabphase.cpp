@@ -33,6 +33,8 @@ function of the cosine of the scattering angle.
      scattering.
    * Lookup table points are regularly spaced between -1 and 1.
    * Phase function values are automatically normalized.
+   * Sampling relies on an alias table over the lookup table intervals and
+     runs in constant time regardless of the table resolution.
 */
 
 template <typename Float, typename Spectrum>
@@ -58,6 +60,7 @@ public:
 
             m_distr = ContinuousDistribution<Float>(ScalarVector2f(-1.f, 1.f),
                                                     data.data(), data.size());
+            m_distr.build_alias_table();
         } else {
             Throw("'values' must be a string");
         }
@@ -83,8 +86,9 @@ public:
         MI_MASKED_FUNCTION(ProfilerPhase::PhaseFunctionSample, active);
 
         // Sample a direction in physics convention.
-        // We sample cos θ' = cos(π - θ) = -cos θ.
-        Float cos_theta_prime = m_distr.sample(sample2.x());
+        // We sample cos θ' = cos(π - θ) = -cos θ. The alias table selects the
+        // table interval in constant time and also yields the exact density.
+        auto [cos_theta_prime, pdf] = m_distr.sample_pdf_alias(sample2.x(), active);
         Float sin_theta_prime =
             dr::safe_sqrt(1.f - cos_theta_prime * cos_theta_prime);
         auto [sin_phi, cos_phi] =
@@ -96,11 +100,7 @@ public:
         // computed direction to world coordinates
         wo = -mi.to_world(wo);
 
-        // Retrieve the PDF value from the physics convention-sampled angle
-        Float pdf = m_distr.eval_pdf_normalized(cos_theta_prime, active) *
-                    dr::InvTwoPi<ScalarFloat>;
-
-        return { wo, 1.f, pdf };
+        return { wo, 1.f, pdf * dr::InvTwoPi<ScalarFloat> };
     }
 
     std::pair<Spectrum, Float> eval_pdf(const PhaseFunctionContext & /* ctx */,
@@ -178,3 +178,26 @@ def test05_sample_components(variant_scalar_rgb):
     expected_b = weight * dr.inv_four_pi * (1 - g) / (1 + g) ** 2
     wo_b, w_b, pdf_b = phase.sample(ctx, mei, 0.1, [0.0, 0.0])
     assert dr.allclose(pdf_b, expected_b)
+
+
+def test06_chi2_tabulated(variants_vec_backends_once_rgb):
+    # Two tabulated lobes, each sampled through its alias table
+    sample_func, pdf_func = mi.chi2.PhaseFunctionAdapter(
+        "blendphase",
+        """<float name="weight" value="0.3"/>
+           <phase name="phase_0" type="tabphase">
+               <string name="values" value="0.1, 0.5, 2.0, 4.0"/>
+           </phase>
+           <phase name="phase_1" type="tabphase">
+               <string name="values" value="3.0, 0.2, 0.0, 0.0, 1.0"/>
+           </phase>""",
+    )
+
+    chi2 = mi.chi2.ChiSquareTest(
+        domain=mi.chi2.SphericalDomain(),
+        sample_func=sample_func,
+        pdf_func=pdf_func,
+        sample_dim=3,
+    )
+
+    assert chi2.run()
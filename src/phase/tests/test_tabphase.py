@@ -133,3 +133,17 @@ def test_traverse(variant_scalar_rgb):
     mei.wi = np.array([0, 0, -1])
     wo = [0, 0, 1]
     assert dr.allclose(phase.eval_pdf(ctx, mei, wo)[0], dr.inv_two_pi * 1.5 / ref_integral)
+
+
+def test_sample_pdf(variants_vec_backends_once_rgb):
+    # The density returned by sample() must match eval_pdf() exactly
+    tab = mi.load_dict({"type": "tabphase", "values": "0.2, 0.0, 0.0, 1.0, 3.5, 0.5"})
+    ctx = mi.PhaseFunctionContext(None)
+    mei = dr.zeros(mi.MediumInteraction3f, 1024)
+    mei.sh_frame = mi.Frame3f([0, 0, 1])
+    mei.wi = [0, 0, 1]
+
+    rng = mi.PCG32(size=1024)
+    wo, w, pdf = tab.sample(ctx, mei, 0, [rng.next_float32(), rng.next_float32()])
+    assert dr.allclose(w, 1.0)
+    assert dr.allclose(pdf, tab.eval_pdf(ctx, mei, wo)[1], rtol=1e-3, atol=1e-5)
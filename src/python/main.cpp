@@ -26,7 +26,9 @@ MI_PY_DECLARE(MemoryStream);
 MI_PY_DECLARE(ZStream);
 MI_PY_DECLARE(ProgressReporter);
 MI_PY_DECLARE(rfilter);
+MI_PY_DECLARE(SharedCache);
 MI_PY_DECLARE(Thread);
+MI_PY_DECLARE(TiledImage);
 MI_PY_DECLARE(Timer);
 MI_PY_DECLARE(util);
 
@@ -132,7 +134,9 @@ PYBIND11_MODULE(mitsuba_ext, m) {
     MI_PY_IMPORT(MemoryStream);
     MI_PY_IMPORT(ZStream);
     MI_PY_IMPORT(ProgressReporter);
+    MI_PY_IMPORT(SharedCache);
     MI_PY_IMPORT(Thread);
+    MI_PY_IMPORT(TiledImage);
     MI_PY_IMPORT(Timer);
     MI_PY_IMPORT(util);
 
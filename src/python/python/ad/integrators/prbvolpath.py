@@ -159,7 +159,7 @@ class PRBVolpathIntegrator(RBIntegrator):
 
                 # Handle medium sampling and potential medium escape
                 u = sampler.next_1d(active_medium)
-                mei = medium.sample_interaction(ray, u, channel, active_medium)
+                mei = medium.sample_interaction(ray, u, channel, 0.0, active_medium)
                 mei.t = dr.detach(mei.t)
 
                 ray.maxt[active_medium & medium.is_homogeneous() & mei.is_valid()] = mei.t
@@ -178,6 +178,15 @@ class PRBVolpathIntegrator(RBIntegrator):
                 escaped_medium = active_medium & ~mei.is_valid()
                 active_medium &= mei.is_valid()
 
+                # Collect the emission of the medium at every tentative collision,
+                # unless the previous vertex already sampled it
+                active_emission = active_medium & specular_chain & medium.is_emitter()
+                emission = medium.get_emission(mei, active_emission)
+                contrib = throughput * weight * emission
+                L[active_emission] += dr.detach(contrib if is_primal else -contrib)
+                if not is_primal and dr.grad_enabled(contrib):
+                    dr.backward(δL * contrib)
+
                 # Handle null and real scatter events
                 if self.handle_null_scattering:
                     scatter_prob = index_spectrum(mei.sigma_t, channel) / index_spectrum(mei.combined_extinction, channel)
@@ -380,7 +389,7 @@ class PRBVolpathIntegrator(RBIntegrator):
             active_surface = active & ~active_medium
 
             # Handle medium interactions / transmittance
-            mei = medium.sample_interaction(ray, sampler.next_1d(active_medium), channel, active_medium)
+            mei = medium.sample_interaction(ray, sampler.next_1d(active_medium), channel, 0.0, active_medium)
             mei.t[active_medium & (si.t < mei.t)] = dr.inf
             mei.t = dr.detach(mei.t)
 
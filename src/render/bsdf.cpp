@@ -7,7 +7,17 @@
 NAMESPACE_BEGIN(mitsuba)
 
 MI_VARIANT BSDF<Float, Spectrum>::BSDF(const Properties &props)
-    : m_flags(+BSDFFlags::Empty), m_id(props.id()) { }
+    : m_flags(+BSDFFlags::Empty), m_texture_differentials(false),
+      m_id(props.id()) {
+    // Textures report the needs of their own nested textures
+    for (auto &[name, obj] : props.objects(false)) {
+        Texture *texture = dynamic_cast<Texture *>(obj.get());
+        BSDF *bsdf = dynamic_cast<BSDF *>(obj.get());
+        if ((texture && texture->needs_differentials()) ||
+            (bsdf && bsdf->needs_differentials()))
+            m_texture_differentials = true;
+    }
+}
 
 MI_VARIANT BSDF<Float, Spectrum>::~BSDF() { }
 
@@ -105,6 +105,10 @@ MI_VARIANT void Film<Float, Spectrum>::set_size(const ScalarPoint2u &size) {
     set_crop_window(ScalarVector2u(0, 0), m_size);
 }
 
+MI_VARIANT void Film<Float, Spectrum>::write_async(const fs::path &path) const {
+    write(path);
+}
+
 MI_VARIANT std::string Film<Float, Spectrum>::to_string() const {
     std::ostringstream oss;
     oss << "Film[" << std::endl
@@ -1,5 +1,7 @@
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/random.h>
+#include <mitsuba/render/emitter.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/phase.h>
 #include <mitsuba/render/scene.h>
@@ -29,6 +31,7 @@ MI_VARIANT Medium<Float, Spectrum>::Medium(const Properties &props) : m_id(props
     m_sample_emitters = props.get<bool>("sample_emitters", true);
     dr::set_attr(this, "use_emitter_sampling", m_sample_emitters);
     dr::set_attr(this, "phase_function", m_phase_function.get());
+    dr::set_attr(this, "emitter", m_emitter.get());
 }
 
 MI_VARIANT Medium<Float, Spectrum>::~Medium() {}
@@ -37,10 +40,29 @@ MI_VARIANT void Medium<Float, Spectrum>::traverse(TraversalCallback *callback) {
     callback->put_object("phase_function", m_phase_function.get(), +ParamFlags::Differentiable);
 }
 
+MI_VARIANT
+typename Medium<Float, Spectrum>::UnpolarizedSpectrum
+Medium<Float, Spectrum>::get_albedo(const MediumInteraction3f &mi,
+                                    Mask active) const {
+    MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+
+    auto [sigma_s, sigma_n, sigma_t] = get_scattering_coefficients(mi, active);
+    DRJIT_MARK_USED(sigma_n);
+    return dr::select(dr::neq(sigma_t, 0.f), sigma_s / sigma_t, 0.f);
+}
+
+MI_VARIANT
+typename Medium<Float, Spectrum>::UnpolarizedSpectrum
+Medium<Float, Spectrum>::get_emission(const MediumInteraction3f & /* mi */,
+                                      Mask /* active */) const {
+    return 0.f;
+}
+
 MI_VARIANT
 typename Medium<Float, Spectrum>::MediumInteraction3f
 Medium<Float, Spectrum>::sample_interaction(const Ray3f &ray, Float sample,
-                                            UInt32 channel, Mask active) const {
+                                            UInt32 channel, Float footprint,
+                                            Mask active) const {
     MI_MASKED_FUNCTION(ProfilerPhase::MediumSample, active);
 
     // initialize basic medium interaction fields
@@ -49,6 +71,7 @@ Medium<Float, Spectrum>::sample_interaction(const Ray3f &ray, Float sample,
     mei.sh_frame    = Frame3f(mei.wi);
     mei.time        = ray.time;
     mei.wavelengths = ray.wavelengths;
+    mei.footprint   = footprint;
 
     auto [aabb_its, mint, maxt] = intersect_aabb(ray);
     aabb_its &= (dr::isfinite(mint) || dr::isfinite(maxt));
@@ -59,28 +82,273 @@ Medium<Float, Spectrum>::sample_interaction(const Ray3f &ray, Float sample,
     mint = dr::maximum(0.f, mint);
     maxt = dr::minimum(ray.maxt, maxt);
 
-    auto combined_extinction = get_majorant(mei, active);
-    Float m                  = combined_extinction[0];
-    if constexpr (is_rgb_v<Spectrum>) { // Handle RGB rendering
-        dr::masked(m, dr::eq(channel, 1u)) = combined_extinction[1];
-        dr::masked(m, dr::eq(channel, 2u)) = combined_extinction[2];
-    } else {
+    UnpolarizedSpectrum combined_extinction;
+    Float sampled_t, m, control = m_control_extinction;
+    if (has_majorant_grid()) {
+        // The local majorants don't depend on the channel
         DRJIT_MARK_USED(channel);
+        Float minorant;
+        std::tie(sampled_t, m, minorant, std::ignore) =
+            sample_majorant_grid(ray, mint, maxt, -dr::log(1 - sample), false,
+                                 active);
+        combined_extinction = m;
+        if (m_decomposition)
+            control = minorant;
+    } else {
+        combined_extinction = get_majorant(mei, active);
+        m                   = combined_extinction[0];
+        if constexpr (is_rgb_v<Spectrum>) { // Handle RGB rendering
+            dr::masked(m, dr::eq(channel, 1u)) = combined_extinction[1];
+            dr::masked(m, dr::eq(channel, 2u)) = combined_extinction[2];
+        } else {
+            DRJIT_MARK_USED(channel);
+        }
+        sampled_t = mint + (-dr::log(1 - sample) / m);
     }
 
-    Float sampled_t = mint + (-dr::log(1 - sample) / m);
     Mask valid_mi   = active && (sampled_t <= maxt);
     mei.t           = dr::select(valid_mi, sampled_t, dr::Infinity<Float>);
     mei.p           = ray(sampled_t);
     mei.medium      = this;
     mei.mint        = mint;
+    mei.combined_extinction = combined_extinction;
+
+    if (m_decomposition) {
+        /* Decomposition tracking: attribute the collision to the control
+           extinction with probability control / majorant. The extra uniform
+           variate is derived from a hash of 'sample', since samplers can't
+           be used within a virtual function call. */
+        control = dr::minimum(control, m);
+        UInt32 seed = dr::reinterpret_array<UInt32>(dr::float32_array_t<Float>(sample));
+        Mask control_hit = valid_mi && Float(sample_tea_float32(seed, UInt32(0))) * m < control,
+             residual    = valid_mi && !control_hit;
+
+        // Only the albedo is needed at collisions with the control extinction
+        UnpolarizedSpectrum albedo = get_albedo(mei, control_hit);
+
+        auto [sigma_s, sigma_n, sigma_t] =
+            get_scattering_coefficients(mei, residual);
+        DRJIT_MARK_USED(sigma_n);
+
+        /* Rescale the residual so that the integrator accepts it with
+           probability (sigma_t - control) / (majorant - control) */
+        UnpolarizedSpectrum residual_t =
+            dr::maximum(sigma_t - control, 0.f) * combined_extinction /
+            (combined_extinction - control);
+        UnpolarizedSpectrum residual_s =
+            dr::select(dr::neq(sigma_t, 0.f), sigma_s * residual_t / sigma_t, 0.f);
+
+        mei.sigma_t = dr::select(control_hit, combined_extinction,
+                                 dr::select(residual, residual_t, 0.f));
+        mei.sigma_s = dr::select(control_hit, albedo * combined_extinction,
+                                 dr::select(residual, residual_s, 0.f));
+        mei.sigma_n = combined_extinction - mei.sigma_t;
+        return mei;
+    }
 
     std::tie(mei.sigma_s, mei.sigma_n, mei.sigma_t) =
         get_scattering_coefficients(mei, valid_mi);
-    mei.combined_extinction = combined_extinction;
+
+    /* Positions on a cell boundary may be attributed to the neighboring cell
+       by get_scattering_coefficients(), keep the null coefficient consistent
+       with the majorant that was used for sampling */
+    if (has_majorant_grid())
+        mei.sigma_n = combined_extinction - mei.sigma_t;
+
     return mei;
 }
 
+MI_VARIANT
+typename Medium<Float, Spectrum>::UnpolarizedSpectrum
+Medium<Float, Spectrum>::eval_transmittance(const Ray3f &ray, Float sample,
+                                            Mask active) const {
+    MI_MASKED_FUNCTION(ProfilerPhase::MediumEvaluate, active);
+
+    auto [aabb_its, mint, maxt] = intersect_aabb(ray);
+    active &= aabb_its && (dr::isfinite(mint) || dr::isfinite(maxt));
+    mint = dr::maximum(0.f, mint);
+    maxt = dr::minimum(ray.maxt, maxt);
+    active &= mint < maxt;
+
+    MediumInteraction3f mei = dr::zeros<MediumInteraction3f>();
+    mei.wi          = -ray.d;
+    mei.sh_frame    = Frame3f(mei.wi);
+    mei.time        = ray.time;
+    mei.wavelengths = ray.wavelengths;
+    mei.medium      = this;
+    mei.p           = ray(mint);
+
+    if (m_is_homogeneous) {
+        // Closed-form transmittance
+        UnpolarizedSpectrum sigma_t =
+            std::get<2>(get_scattering_coefficients(mei, active));
+        return dr::select(active, dr::exp(-(maxt - mint) * sigma_t), 1.f);
+    }
+
+    /* Without a majorant grid, the control extinction is half of the global
+       majorant, which bounds the residual by the same amount */
+    Float global_majorant = 0.f;
+    if (!has_majorant_grid())
+        global_majorant = dr::max(get_majorant(mei, active));
+
+    /* Tentative collisions can't consume samples from a sampler within a
+       virtual function call. Derive them from a hash of 'sample' instead. */
+    UInt32 seed  = dr::reinterpret_array<UInt32>(dr::float32_array_t<Float>(sample)),
+           index = 0;
+
+    Float t = mint, tau_control = 0.f;
+    UnpolarizedSpectrum weight(1.f);
+
+    dr::Loop<Mask> loop("Medium::eval_transmittance", active, t, index,
+                        tau_control, weight);
+    while (loop(dr::detach(active))) {
+        Float tau = -dr::log(1.f - Float(sample_tea_float32(seed, index)));
+        index += 1;
+
+        Float sampled_t, majorant, minorant, tau_c;
+        if (has_majorant_grid()) {
+            std::tie(sampled_t, majorant, minorant, tau_c) =
+                sample_majorant_grid(ray, t, maxt, tau, true, active);
+        } else {
+            majorant  = global_majorant;
+            minorant  = 0.f;
+            sampled_t = t + tau / (.5f * majorant);
+            tau_c     = .5f * majorant * (dr::minimum(sampled_t, maxt) - t);
+        }
+        dr::masked(tau_control, active) += tau_c;
+
+        // Weight each collision by the ratio of residual and residual majorant
+        Mask collision = active && sampled_t < maxt;
+        mei.p = ray(sampled_t);
+        UnpolarizedSpectrum sigma_t =
+            std::get<2>(get_scattering_coefficients(mei, collision));
+        Float control = .5f * (majorant + minorant),
+              rate    = .5f * (majorant - minorant);
+        dr::masked(weight, collision) *= 1.f - (sigma_t - control) / rate;
+
+        dr::masked(t, collision) = sampled_t;
+        active = collision && dr::any(dr::neq(weight, 0.f));
+    }
+
+    return weight * dr::exp(-tau_control);
+}
+
+MI_VARIANT
+std::tuple<Float, Float, Float, Float>
+Medium<Float, Spectrum>::sample_majorant_grid(const Ray3f &ray, Float mint,
+                                              Float maxt, Float tau,
+                                              bool residual,
+                                              Mask active) const {
+    MI_MASK_ARGUMENT(active);
+    const ScalarVector3i res = m_majorant_resolution;
+
+    // Express the ray in grid coordinates, where cells have unit size
+    Point3f o  = m_majorant_to_grid * ray.o;
+    Vector3f d = m_majorant_to_grid * ray.d;
+
+    Vector3i cell = dr::clamp(dr::floor2int<Vector3i>(dr::fmadd(d, mint, o)),
+                              0, res - 1);
+
+    // Ray parameters at which the next cell boundary is crossed along each axis
+    dr::mask_t<Vector3f> positive = d >= 0.f, parallel = dr::eq(d, 0.f);
+    Vector3f inv_d     = dr::rcp(d);
+    Vector3i cell_step = dr::select(positive, Vector3i(1), Vector3i(-1));
+    Vector3f delta_t   = dr::select(parallel, dr::Infinity<Float>, dr::abs(inv_d)),
+             next_t    = dr::select(
+                 parallel, dr::Infinity<Float>,
+                 (Vector3f(cell) + dr::select(positive, 1.f, 0.f) - o) * inv_d);
+
+    Float t = mint, sampled_t = dr::Infinity<Float>, majorant = 0.f,
+          minorant = 0.f, tau_control = 0.f;
+    Mask active_dda = active && mint < maxt;
+
+    dr::Loop<Mask> loop("Medium::sample_majorant_grid", active_dda, t, tau,
+                        cell, next_t, sampled_t, majorant, minorant,
+                        tau_control);
+    while (loop(dr::detach(active_dda))) {
+        UInt32 index = UInt32((cell.z() * res.y() + cell.y()) * res.x() + cell.x());
+        dr::masked(majorant, active_dda) =
+            dr::gather<Float>(m_majorant_grid, index, active_dda);
+
+        if ((residual || m_decomposition) && dr::width(m_minorant_grid) != 0)
+            dr::masked(minorant, active_dda) =
+                dr::gather<Float>(m_minorant_grid, index, active_dda);
+
+        /* Residual tracking samples the deviation from the midpoint between
+           the local minorant and majorant */
+        Float rate = majorant, control = 0.f;
+        if (residual) {
+            rate    = .5f * (majorant - minorant);
+            control = .5f * (majorant + minorant);
+        }
+
+        // Optical depth of the sampling rate along the current cell
+        Float t_exit   = dr::minimum(dr::min(next_t), maxt),
+              tau_cell = rate * (t_exit - t);
+
+        Mask hit = active_dda && tau_cell >= tau && rate > 0.f;
+        dr::masked(sampled_t, hit) = t + tau / rate;
+        dr::masked(tau_control, active_dda) +=
+            control * (dr::select(hit, sampled_t, t_exit) - t);
+        dr::masked(tau, active_dda) -= tau_cell;
+        dr::masked(t, active_dda) = t_exit;
+
+        // Advance to the next cell (along several axes at cell corners)
+        dr::mask_t<Vector3f> advance = active_dda && dr::eq(next_t, dr::min(next_t));
+        dr::masked(cell, advance) += cell_step;
+        dr::masked(next_t, advance) += delta_t;
+
+        active_dda &= !hit && t_exit < maxt && dr::all(cell >= 0 && cell < res);
+    }
+
+    return { sampled_t, majorant, minorant, tau_control };
+}
+
+MI_VARIANT void
+Medium<Float, Spectrum>::set_majorant_grid(const TensorXf &majorants,
+                                           const ScalarTransform4f &to_world,
+                                           const TensorXf &minorants) {
+    m_minorant_grid = DynamicBuffer<Float>();
+    if (dr::width(majorants.array()) == 0) {
+        m_majorant_grid = DynamicBuffer<Float>();
+        return;
+    }
+
+    if (majorants.ndim() != 4 || majorants.shape(3) != 1)
+        Throw("set_majorant_grid(): expected a tensor of shape (z, y, x, 1)!");
+
+    if (dr::width(minorants.array()) != 0) {
+        if (minorants.ndim() != 4 ||
+            dr::width(minorants.array()) != dr::width(majorants.array()))
+            Throw("set_majorant_grid(): the minorants must have the same "
+                  "shape as the majorants!");
+        m_minorant_grid = minorants.array();
+    }
+
+    m_majorant_resolution = ScalarVector3i((int) majorants.shape(2),
+                                           (int) majorants.shape(1),
+                                           (int) majorants.shape(0));
+    m_majorant_grid = majorants.array();
+    m_majorant_to_grid =
+        ScalarTransform4f::scale(ScalarVector3f(m_majorant_resolution)) *
+        to_world.inverse();
+}
+
+MI_VARIANT void
+Medium<Float, Spectrum>::set_control_extinction(ScalarFloat control) {
+    m_decomposition      = control >= 0.f;
+    m_control_extinction = dr::opaque<Float>(dr::maximum(control, 0.f));
+}
+
+MI_VARIANT Float
+Medium<Float, Spectrum>::eval_majorant_grid(const Point3f &p, Mask active) const {
+    const ScalarVector3i res = m_majorant_resolution;
+    Vector3i cell = dr::clamp(dr::floor2int<Vector3i>(m_majorant_to_grid * p),
+                              0, res - 1);
+    UInt32 index = UInt32((cell.z() * res.y() + cell.y()) * res.x() + cell.x());
+    return dr::gather<Float>(m_majorant_grid, index, active);
+}
+
 MI_VARIANT
 std::pair<typename Medium<Float, Spectrum>::UnpolarizedSpectrum,
           typename Medium<Float, Spectrum>::UnpolarizedSpectrum>
@@ -108,6 +108,7 @@ MI_PY_EXPORT(MediumInteraction) {
         .def_field(MediumInteraction3f, sigma_t,    D(MediumInteraction, sigma_t))
         .def_field(MediumInteraction3f, combined_extinction, D(MediumInteraction, combined_extinction))
         .def_field(MediumInteraction3f, mint, D(MediumInteraction, mint))
+        .def_field(MediumInteraction3f, footprint, D(MediumInteraction, footprint))
 
         // Methods
         .def(py::init<>(), D(MediumInteraction, MediumInteraction))
@@ -118,7 +119,7 @@ MI_PY_EXPORT(MediumInteraction) {
 
     MI_PY_DRJIT_STRUCT(mi, MediumInteraction3f, t, time, wavelengths, p, n,
                        medium, sh_frame, wi, sigma_s, sigma_n, sigma_t,
-                       combined_extinction, mint)
+                       combined_extinction, mint, footprint)
 }
 
 MI_PY_EXPORT(PreliminaryIntersection) {
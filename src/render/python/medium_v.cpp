@@ -1,4 +1,5 @@
 #include <mitsuba/core/properties.h>
+#include <mitsuba/render/emitter.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/phase.h>
 #include <mitsuba/render/scene.h>
@@ -26,6 +27,14 @@ public:
         PYBIND11_OVERRIDE_PURE(Return, Medium, get_scattering_coefficients, mi, active);
     }
 
+    UnpolarizedSpectrum get_albedo(const MediumInteraction3f &mi, Mask active = true) const override {
+        PYBIND11_OVERRIDE(UnpolarizedSpectrum, Medium, get_albedo, mi, active);
+    }
+
+    UnpolarizedSpectrum get_emission(const MediumInteraction3f &mi, Mask active = true) const override {
+        PYBIND11_OVERRIDE(UnpolarizedSpectrum, Medium, get_emission, mi, active);
+    }
+
     std::string to_string() const override {
         PYBIND11_OVERRIDE_PURE(std::string, Medium, to_string, );
     }
@@ -58,6 +67,12 @@ template <typename Ptr, typename Cls> void bind_medium_generic(Cls &cls) {
        .def("has_spectral_extinction",
             [](Ptr ptr) { return ptr->has_spectral_extinction(); },
             D(Medium, has_spectral_extinction))
+       .def("is_emitter",
+            [](Ptr ptr) { return ptr->is_emitter(); },
+            D(Medium, is_emitter))
+       .def("emitter",
+            [](Ptr ptr) { return ptr->emitter(); },
+            D(Medium, emitter))
        .def("get_majorant",
             [](Ptr ptr, const MediumInteraction3f &mi, Mask active) {
                 return ptr->get_majorant(mi, active); },
@@ -69,21 +84,43 @@ template <typename Ptr, typename Cls> void bind_medium_generic(Cls &cls) {
             "ray"_a,
             D(Medium, intersect_aabb))
        .def("sample_interaction",
-            [](Ptr ptr, const Ray3f &ray, Float sample, UInt32 channel, Mask active) {
+            [](Ptr ptr, const Ray3f &ray, Float sample, UInt32 channel,
+               Float footprint, Mask active) {
+                return ptr->sample_interaction(ray, sample, channel, footprint, active); },
+            "ray"_a, "sample"_a, "channel"_a, "footprint"_a, "active"_a,
+            D(Medium, sample_interaction))
+       .def("sample_interaction",
+            [](Ptr ptr, const Ray3f &ray, Float sample, UInt32 channel,
+               Mask active) {
                 return ptr->sample_interaction(ray, sample, channel, active); },
             "ray"_a, "sample"_a, "channel"_a, "active"_a,
-            D(Medium, sample_interaction))
+            D(Medium, sample_interaction, 2))
        .def("transmittance_eval_pdf",
             [](Ptr ptr, const MediumInteraction3f &mi,
                const SurfaceInteraction3f &si, Mask active) {
                 return ptr->transmittance_eval_pdf(mi, si, active); },
             "mi"_a, "si"_a, "active"_a,
             D(Medium, transmittance_eval_pdf))
+       .def("eval_transmittance",
+            [](Ptr ptr, const Ray3f &ray, Float sample, Mask active) {
+                return ptr->eval_transmittance(ray, sample, active); },
+            "ray"_a, "sample"_a, "active"_a=true,
+            D(Medium, eval_transmittance))
        .def("get_scattering_coefficients",
             [](Ptr ptr, const MediumInteraction3f &mi, Mask active = true) {
                 return ptr->get_scattering_coefficients(mi, active); },
             "mi"_a, "active"_a=true,
-            D(Medium, get_scattering_coefficients));
+            D(Medium, get_scattering_coefficients))
+       .def("get_albedo",
+            [](Ptr ptr, const MediumInteraction3f &mi, Mask active = true) {
+                return ptr->get_albedo(mi, active); },
+            "mi"_a, "active"_a=true,
+            D(Medium, get_albedo))
+       .def("get_emission",
+            [](Ptr ptr, const MediumInteraction3f &mi, Mask active = true) {
+                return ptr->get_emission(mi, active); },
+            "mi"_a, "active"_a=true,
+            D(Medium, get_emission));
 
     if constexpr (dr::is_array_v<Ptr>)
         bind_drjit_ptr_array(cls);
@@ -96,6 +133,7 @@ MI_PY_EXPORT(Medium) {
     auto medium = MI_PY_TRAMPOLINE_CLASS(PyMedium, Medium, Object)
             .def(py::init<const Properties &>())
             .def_method(Medium, id)
+            .def_method(Medium, has_majorant_grid)
             .def_property("m_sample_emitters",
                 [](PyMedium &medium){ return medium.m_sample_emitters; },
                 [](PyMedium &medium, bool value){
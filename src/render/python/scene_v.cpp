@@ -146,5 +146,9 @@ MI_PY_EXPORT(Scene) {
              },
              D(Scene, integrator))
         .def_method(Scene, shapes_grad_enabled)
+        .def("save_snapshot", &Scene::save_snapshot, "filename"_a,
+             D(Scene, save_snapshot), py::call_guard<py::gil_scoped_release>())
+        .def_static("load_snapshot", &Scene::load_snapshot, "filename"_a,
+             D(Scene, load_snapshot), py::call_guard<py::gil_scoped_release>())
         .def("__repr__", &Scene::to_string);
 }
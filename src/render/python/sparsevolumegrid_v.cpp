@@ -0,0 +1,41 @@
+#include <mitsuba/render/sparsevolumegrid.h>
+#include <mitsuba/render/volumegrid.h>
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/stream.h>
+#include <mitsuba/python/python.h>
+
+MI_PY_EXPORT(SparseVolumeGrid) {
+    MI_PY_IMPORT_TYPES(SparseVolumeGrid, VolumeGrid)
+    MI_PY_CLASS(SparseVolumeGrid, Object)
+        .def(py::init<const fs::path &, ScalarFloat>(), "path"_a,
+            "tolerance"_a = 0.f, D(SparseVolumeGrid, SparseVolumeGrid),
+            py::call_guard<py::gil_scoped_release>())
+        .def(py::init<Stream *, ScalarFloat>(), "stream"_a,
+            "tolerance"_a = 0.f, D(SparseVolumeGrid, SparseVolumeGrid, 2),
+            py::call_guard<py::gil_scoped_release>())
+        .def(py::init<const VolumeGrid *, ScalarFloat>(), "grid"_a,
+            "tolerance"_a = 0.f, D(SparseVolumeGrid, SparseVolumeGrid, 3),
+            py::call_guard<py::gil_scoped_release>())
+
+        .def_method(SparseVolumeGrid, size)
+        .def_method(SparseVolumeGrid, tile_count)
+        .def_method(SparseVolumeGrid, channel_count)
+        .def_method(SparseVolumeGrid, brick_count)
+        .def_method(SparseVolumeGrid, brick_max, "brick"_a)
+        .def_method(SparseVolumeGrid, max)
+        .def("max_per_channel",
+            [] (const SparseVolumeGrid *volgrid) {
+                std::vector<ScalarFloat> max_values(volgrid->channel_count());
+                volgrid->max_per_channel(max_values.data());
+                return max_values;
+            },
+            D(SparseVolumeGrid, max_per_channel))
+        .def_method(SparseVolumeGrid, bbox)
+        .def_method(SparseVolumeGrid, buffer_size)
+        .def("write", py::overload_cast<Stream *>(&SparseVolumeGrid::write, py::const_),
+            "stream"_a, D(SparseVolumeGrid, write, 2), py::call_guard<py::gil_scoped_release>())
+        .def("write", py::overload_cast<const fs::path &>(
+                &SparseVolumeGrid::write, py::const_), "path"_a,
+                D(SparseVolumeGrid, write),
+                py::call_guard<py::gil_scoped_release>());
+}
@@ -73,6 +73,10 @@ public:
         PYBIND11_OVERRIDE(bool, Texture, is_spatially_varying);
     }
 
+    bool needs_differentials() const override {
+        PYBIND11_OVERRIDE(bool, Texture, needs_differentials);
+    }
+
     std::string to_string() const override {
         PYBIND11_OVERRIDE(std::string, Texture, to_string);
     }
@@ -85,9 +89,18 @@ MI_PY_EXPORT(Texture) {
     MI_PY_TRAMPOLINE_CLASS(PyTexture, Texture, Object)
         .def(py::init<const Properties &>(), "props"_a)
         .def_static("D65", py::overload_cast<ScalarFloat>(&Texture::D65), "scale"_a = 1.f)
+        .def_static("eval_1_batch",
+            [](const std::vector<const Texture *> &textures,
+               const SurfaceInteraction3f &si, Mask active) {
+                std::vector<Float> out(textures.size(), Float(0.f));
+                Texture::eval_1_batch(textures.data(), textures.size(), si,
+                                      out.data(), active);
+                return out;
+            }, "textures"_a, "si"_a, "active"_a = true, D(Texture, eval_1_batch))
         .def_method(Texture, mean, D(Texture, mean))
         .def_method(Texture, max, D(Texture, max))
         .def_method(Texture, is_spatially_varying)
+        .def_method(Texture, needs_differentials)
         .def_method(Texture, eval, "si"_a, "active"_a = true)
         .def_method(Texture, eval_1, "si"_a, "active"_a = true)
         .def_method(Texture, eval_1_grad, "si"_a, "active"_a = true)
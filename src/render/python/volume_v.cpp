@@ -58,6 +58,11 @@ MI_PY_EXPORT(Volume) {
         .def_method(Volume, bbox)
         .def_method(Volume, channel_count)
         .def_method(Volume, max)
+        .def_method(Volume, local_majorants, "grid_resolution"_a,
+                    "value_scale"_a = 1.f)
+        .def_method(Volume, local_minorants, "grid_resolution"_a,
+                    "value_scale"_a = 1.f)
+        .def_method(Volume, world_transform)
         .def("max_per_channel",
             [] (const Volume *volume) {
                 std::vector<ScalarFloat> max_values(volume->channel_count());
@@ -68,6 +73,10 @@ MI_PY_EXPORT(Volume) {
         .def_method(Volume, eval, "it"_a, "active"_a = true)
         .def_method(Volume, eval_1, "it"_a, "active"_a = true)
         .def_method(Volume, eval_3, "it"_a, "active"_a = true)
+        .def_method(Volume, eval_lod, "it"_a, "footprint"_a, "active"_a = true)
+        .def_method(Volume, eval_pair, "other"_a, "it"_a, "footprint"_a,
+                    "active"_a = true)
+        .def_method(Volume, is_colocated, "other"_a)
         .def("eval_6",
                 [](const Volume &volume, const Interaction3f &it, const Mask active) {
                     dr::Array<Float, 6> result = volume.eval_6(it, active);
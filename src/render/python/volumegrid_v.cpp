@@ -56,18 +56,20 @@ MI_PY_EXPORT(VolumeGrid) {
             D(VolumeGrid, set_max_per_channel))
         .def_method(VolumeGrid, bytes_per_voxel)
         .def_method(VolumeGrid, buffer_size)
-        .def("write", py::overload_cast<Stream *>(&VolumeGrid::write, py::const_),
-            "stream"_a, D(VolumeGrid, write), py::call_guard<py::gil_scoped_release>())
-        .def("write", py::overload_cast<const fs::path &>(
-                &VolumeGrid::write, py::const_), "path"_a, D(VolumeGrid, write, 2),
-                py::call_guard<py::gil_scoped_release>())
+        .def_method(VolumeGrid, is_memory_mapped)
+        .def("write", py::overload_cast<Stream *, uint32_t>(&VolumeGrid::write, py::const_),
+            "stream"_a, "version"_a = 3, D(VolumeGrid, write, 2),
+            py::call_guard<py::gil_scoped_release>())
+        .def("write", py::overload_cast<const fs::path &, uint32_t>(
+                &VolumeGrid::write, py::const_), "path"_a, "version"_a = 3,
+                D(VolumeGrid, write), py::call_guard<py::gil_scoped_release>())
 
         .def(py::init<const fs::path &>(), "path"_a,
             py::call_guard<py::gil_scoped_release>())
         .def(py::init<Stream *>(), "stream"_a,
             py::call_guard<py::gil_scoped_release>())
 
-        .def_property_readonly("__array_interface__", [](VolumeGrid &grid) -> py::object {
+        .def_property_readonly("__array_interface__", [](const VolumeGrid &grid) -> py::object {
             py::dict result;
             auto size = grid.size();
             if (grid.channel_count() == 1)
@@ -89,7 +91,8 @@ MI_PY_EXPORT(VolumeGrid) {
                 result["typestr"] = py::bytes(code);
             #endif
 
-            result["data"] = py::make_tuple(size_t(grid.data()), false);
+            // Memory-mapped grids are read-only
+            result["data"] = py::make_tuple(size_t(grid.data()), grid.is_memory_mapped());
             result["version"] = 3;
             return py::object(result);
         });
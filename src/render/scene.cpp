@@ -1,10 +1,19 @@
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/mmap.h>
 #include <mitsuba/core/properties.h>
 #include <mitsuba/core/plugin.h>
+#include <mitsuba/core/profiler.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/core/xml.h>
 #include <mitsuba/render/bsdf.h>
 #include <mitsuba/render/medium.h>
 #include <mitsuba/render/mesh.h>
 #include <mitsuba/render/scene.h>
 #include <mitsuba/render/integrator.h>
+#include <mitsuba/render/texture.h>
+#include <unordered_set>
 
 #if defined(MI_ENABLE_EMBREE)
 #  include "scene_embree.inl"
@@ -20,7 +29,28 @@
 NAMESPACE_BEGIN(mitsuba)
 
 MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
+    /* Automatic instancing of duplicate meshes is performed by the XML
+       loader before any shape is instantiated. The build time of the
+       acceleration data structure is reported below to assess its effect. */
+    bool auto_instancing = props.get<bool>("auto_instancing", false);
+
+    // Emissive media provide an emitter that samples their volume
+    auto add_medium_emitter = [&](const Medium *medium) {
+        if (!medium || !medium->is_emitter())
+            return;
+        Emitter *medium_emitter = const_cast<Emitter *>(medium->emitter());
+        if (std::find(m_emitters.begin(), m_emitters.end(), medium_emitter) ==
+            m_emitters.end())
+            m_emitters.push_back(medium_emitter);
+    };
+
     for (auto &[k, v] : props.objects()) {
+        // Provided by the XML loader, only needed to write snapshots
+        if (k == "_object_graph") {
+            m_object_graph = v;
+            continue;
+        }
+
         Scene *scene           = dynamic_cast<Scene *>(v.get());
         Shape *shape           = dynamic_cast<Shape *>(v.get());
         Mesh *mesh             = dynamic_cast<Mesh *>(v.get());
@@ -36,6 +66,8 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
                 m_emitters.push_back(shape->emitter());
             if (shape->is_sensor())
                 m_sensors.push_back(shape->sensor());
+            add_medium_emitter(shape->interior_medium());
+            add_medium_emitter(shape->exterior_medium());
             if (shape->is_shapegroup()) {
                 m_shapegroups.push_back((ShapeGroup*)shape);
             } else {
@@ -63,15 +95,38 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
         }
     }
 
+    // Sensors may be placed inside an emissive medium
+    for (const Sensor *sensor : m_sensors)
+        add_medium_emitter(sensor->medium());
+
     // Create sensors' shapes (environment sensors)
     for (Sensor *sensor: m_sensors)
         sensor->set_scene(this);
 
+    bool texture_atlas = props.get<bool>("texture_atlas", false);
+    uint32_t atlas_max_size = props.get<uint32_t>("texture_atlas_max_size", 256);
+    if constexpr (dr::is_jit_v<Float>) {
+        if (texture_atlas)
+            pack_texture_atlases(atlas_max_size);
+    } else {
+        DRJIT_MARK_USED(texture_atlas);
+        DRJIT_MARK_USED(atlas_max_size);
+    }
+
+    Timer timer;
     if constexpr (dr::is_cuda_v<Float>)
         accel_init_gpu(props);
     else
         accel_init_cpu(props);
 
+    size_t instance_count = 0;
+    for (const Shape *shape : m_shapes)
+        instance_count += shape->is_instance() ? 1 : 0;
+    Log(auto_instancing ? Info : Debug,
+        "Acceleration data structure of %zu shapes (%zu instances) built in %s.",
+        m_shapes.size(), instance_count,
+        util::time_string((float) timer.value()));
+
     if (!m_emitters.empty()) {
         // Inform environment emitters etc. about the scene bounds
         for (Emitter *emitter: m_emitters)
@@ -95,6 +150,53 @@ MI_VARIANT Scene<Float, Spectrum>::Scene(const Properties &props) {
     m_shapes_grad_enabled = false;
 }
 
+/// Traversal callback that collects the textures referenced by a scene graph
+template <typename Texture>
+class TextureCollector : public TraversalCallback {
+public:
+    void put_object(const std::string &, Object *obj, uint32_t) override {
+        if (!obj || !m_visited.insert(obj).second)
+            return;
+
+        // Don't traverse textures, which may copy shared data to allow updates
+        if (Texture *texture = dynamic_cast<Texture *>(obj))
+            textures.push_back(texture);
+        else
+            obj->traverse(this);
+    }
+
+    std::vector<Texture *> textures;
+
+protected:
+    void put_parameter_impl(const std::string &, void *, uint32_t,
+                            const std::type_info &) override { }
+
+private:
+    std::unordered_set<Object *> m_visited;
+};
+
+MI_VARIANT void Scene<Float, Spectrum>::pack_texture_atlases(uint32_t max_size) {
+    ScopedPhase sp(ProfilerPhase::InitScene);
+    Timer timer;
+
+    using TextureT = Texture<Float, Spectrum>;
+    TextureCollector<TextureT> collector;
+    for (Object *child : m_children)
+        collector.put_object("", child, +ParamFlags::NonDifferentiable);
+
+    // Textures that were already packed are removed from the candidates
+    std::vector<TextureT *> textures = collector.textures;
+    for (size_t i = 0; i < textures.size(); ++i) {
+        if (!textures[i])
+            continue;
+        for (size_t index : textures[i]->pack_atlas(textures, i, max_size))
+            textures[index] = nullptr;
+    }
+
+    Log(Debug, "Texture atlases of %zu textures created in %s.",
+        textures.size(), util::time_string((float) timer.value()));
+}
+
 MI_VARIANT
 void Scene<Float, Spectrum>::update_emitter_sampling_distribution() {
     // Check if we need to use non-uniform emitter sampling.
@@ -543,6 +645,462 @@ MI_VARIANT std::string Scene<Float, Spectrum>::to_string() const {
     return oss.str();
 }
 
+// -----------------------------------------------------------------------
+//! @{ \name Scene snapshots
+// -----------------------------------------------------------------------
+
+/// Identifies scene snapshot files
+static const std::string snapshot_magic = "MI_SCENE_SNAPSHOT";
+
+/// Version of the snapshot format, must be incremented whenever it changes
+static constexpr uint32_t snapshot_version = 1;
+
+/// Alignment of the buffers stored at the end of a snapshot file
+static constexpr size_t snapshot_alignment = 64;
+
+static size_t snapshot_align(size_t size) {
+    return (size + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+}
+
+template <typename Matrix>
+static void write_snapshot_matrix(Stream *stream, const Matrix &m) {
+    for (size_t i = 0; i < Matrix::Size; ++i)
+        for (size_t j = 0; j < Matrix::Size; ++j)
+            stream->write((double) m(i, j));
+}
+
+template <typename Matrix>
+static Matrix read_snapshot_matrix(Stream *stream) {
+    Matrix m;
+    for (size_t i = 0; i < Matrix::Size; ++i)
+        for (size_t j = 0; j < Matrix::Size; ++j)
+            stream->read(m(i, j));
+    return m;
+}
+
+static void write_snapshot_properties(Stream *stream, const Properties &props) {
+    using Type = Properties::Type;
+
+    stream->write(props.plugin_name());
+    stream->write(props.id());
+
+    std::vector<std::string> names = props.property_names();
+    stream->write((uint32_t) names.size());
+
+    for (const std::string &name : names) {
+        Type type = props.type(name);
+        stream->write(name);
+        stream->write((uint8_t) type);
+
+        switch (type) {
+            case Type::Bool:
+                stream->write((uint8_t) props.get<bool>(name));
+                break;
+
+            case Type::Long:
+                stream->write(props.get<int64_t>(name));
+                break;
+
+            case Type::Float:
+                stream->write(props.get<double>(name));
+                break;
+
+            case Type::Array3f: {
+                    Properties::Array3f v = props.get<Properties::Array3f>(name);
+                    stream->write_array(v.data(), 3);
+                }
+                break;
+
+            case Type::Color: {
+                    Properties::Color3f v = props.get<Properties::Color3f>(name);
+                    stream->write_array(v.data(), 3);
+                }
+                break;
+
+            case Type::Transform3f:
+                write_snapshot_matrix(
+                    stream, props.get<Properties::Transform3f>(name).matrix);
+                break;
+
+            case Type::Transform4f:
+                write_snapshot_matrix(
+                    stream, props.get<Properties::Transform4f>(name).matrix);
+                break;
+
+            case Type::String:
+                stream->write(props.string(name));
+                break;
+
+            case Type::NamedReference:
+                stream->write((const std::string &) props.named_reference(name));
+                break;
+
+            default:
+                Throw("Property \"%s\" of plugin \"%s\" cannot be stored in a "
+                      "scene snapshot (unsupported type).", name,
+                      props.plugin_name());
+        }
+    }
+}
+
+static Properties read_snapshot_properties(Stream *stream) {
+    using Type = Properties::Type;
+
+    std::string plugin_name, id;
+    stream->read(plugin_name);
+    stream->read(id);
+
+    Properties props(plugin_name);
+    props.set_id(id);
+
+    uint32_t count = 0;
+    stream->read(count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        std::string name;
+        uint8_t type = 0;
+        stream->read(name);
+        stream->read(type);
+
+        switch ((Type) type) {
+            case Type::Bool: {
+                    uint8_t v = 0;
+                    stream->read(v);
+                    props.set_bool(name, v != 0);
+                }
+                break;
+
+            case Type::Long: {
+                    int64_t v = 0;
+                    stream->read(v);
+                    props.set_long(name, v);
+                }
+                break;
+
+            case Type::Float: {
+                    double v = 0;
+                    stream->read(v);
+                    props.set_float(name, v);
+                }
+                break;
+
+            case Type::Array3f: {
+                    Properties::Array3f v;
+                    stream->read_array(v.data(), 3);
+                    props.set_array3f(name, v);
+                }
+                break;
+
+            case Type::Color: {
+                    Properties::Color3f v;
+                    stream->read_array(v.data(), 3);
+                    props.set_color(name, v);
+                }
+                break;
+
+            case Type::Transform3f:
+                props.set_transform3f(name, Properties::Transform3f(
+                    read_snapshot_matrix<Properties::Matrix3f>(stream)));
+                break;
+
+            case Type::Transform4f:
+                props.set_transform(name, Properties::Transform4f(
+                    read_snapshot_matrix<Properties::Matrix4f>(stream)));
+                break;
+
+            case Type::String: {
+                    std::string v;
+                    stream->read(v);
+                    props.set_string(name, v);
+                }
+                break;
+
+            case Type::NamedReference: {
+                    std::string v;
+                    stream->read(v);
+                    props.set_named_reference(name, v);
+                }
+                break;
+
+            default:
+                Throw("Invalid property type %i in scene snapshot.", (int) type);
+        }
+    }
+
+    return props;
+}
+
+MI_VARIANT void Scene<Float, Spectrum>::save_snapshot(const std::string &filename) const {
+    using FloatStorage = typename Mesh::FloatStorage;
+    using InputFloat = typename Mesh::InputFloat;
+
+    const xml::ObjectGraph *graph =
+        dynamic_cast<const xml::ObjectGraph *>(m_object_graph.get());
+    if (!graph)
+        Throw("save_snapshot(): only scenes that were loaded from an XML file "
+              "or string while the object graph was retained (see "
+              "xml::set_keep_object_graph()) can be written to a snapshot!");
+
+    Timer timer;
+    ref<FileStream> stream = new FileStream(filename, FileStream::ETruncReadWrite);
+
+    stream->write(snapshot_magic);
+    stream->write(snapshot_version);
+    stream->write(graph->variant());
+
+    // Placeholder for the position of the buffer section
+    size_t buffers_pos = stream->tell();
+    stream->write((uint64_t) 0);
+
+    const auto &nodes = graph->nodes();
+    stream->write((uint64_t) nodes.size());
+
+    /* Write the object graph. Mesh geometry is referenced using offsets into
+       the buffer section, which is written afterwards */
+    std::vector<const Mesh *> meshes;
+    uint64_t buffer_offset = 0;
+    auto write_buffer_ref = [&](size_t size) {
+        stream->write(buffer_offset);
+        buffer_offset += snapshot_align(size);
+    };
+
+    for (const auto &node : nodes) {
+        stream->write(node.id);
+        stream->write(node.class_name);
+        write_snapshot_properties(stream, node.props);
+
+        const Mesh *mesh = dynamic_cast<const Mesh *>(node.object.get());
+        stream->write((uint8_t) (mesh ? 1 : 0));
+        if (!mesh)
+            continue;
+        meshes.push_back(mesh);
+
+        size_t vertex_count = mesh->vertex_count(),
+               face_count   = mesh->face_count();
+        std::vector<std::string> attributes = mesh->attribute_names();
+
+        stream->write((uint32_t) vertex_count);
+        stream->write((uint32_t) face_count);
+        stream->write((uint8_t) mesh->has_vertex_normals());
+        stream->write((uint8_t) mesh->has_vertex_texcoords());
+        stream->write((uint32_t) attributes.size());
+
+        write_buffer_ref(vertex_count * 3 * sizeof(InputFloat));
+        if (mesh->has_vertex_normals())
+            write_buffer_ref(vertex_count * 3 * sizeof(InputFloat));
+        if (mesh->has_vertex_texcoords())
+            write_buffer_ref(vertex_count * 2 * sizeof(InputFloat));
+        write_buffer_ref(face_count * 3 * sizeof(uint32_t));
+
+        for (const std::string &name : attributes) {
+            size_t size = dr::width(const_cast<Mesh *>(mesh)->attribute_buffer(name));
+            stream->write(name);
+            stream->write((uint64_t) size);
+            write_buffer_ref(size * sizeof(InputFloat));
+        }
+    }
+
+    // Write the buffer section
+    size_t buffers_start = snapshot_align(stream->tell());
+    std::vector<uint8_t> padding(snapshot_alignment, 0);
+    stream->write(padding.data(), buffers_start - stream->tell());
+
+    auto write_buffer = [&](const auto &buffer, size_t size) {
+        auto &&host = dr::migrate(buffer, AllocType::Host);
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+        stream->write(host.data(), size);
+        stream->write(padding.data(), snapshot_align(size) - size);
+    };
+
+    for (const Mesh *mesh : meshes) {
+        size_t vertex_count = mesh->vertex_count(),
+               face_count   = mesh->face_count();
+
+        write_buffer(mesh->vertex_positions_buffer(),
+                     vertex_count * 3 * sizeof(InputFloat));
+        if (mesh->has_vertex_normals())
+            write_buffer(mesh->vertex_normals_buffer(),
+                         vertex_count * 3 * sizeof(InputFloat));
+        if (mesh->has_vertex_texcoords())
+            write_buffer(mesh->vertex_texcoords_buffer(),
+                         vertex_count * 2 * sizeof(InputFloat));
+        write_buffer(mesh->faces_buffer(), face_count * 3 * sizeof(uint32_t));
+
+        for (const std::string &name : mesh->attribute_names()) {
+            const FloatStorage &buffer = const_cast<Mesh *>(mesh)->attribute_buffer(name);
+            write_buffer(buffer, dr::width(buffer) * sizeof(InputFloat));
+        }
+    }
+
+    size_t file_size = stream->tell();
+    stream->seek(buffers_pos);
+    stream->write((uint64_t) buffers_start);
+    stream->close();
+
+    Log(Info, "Wrote scene snapshot \"%s\" (%zu objects, %zu meshes, %s in %s).",
+        filename, nodes.size(), meshes.size(), util::mem_string(file_size),
+        util::time_string((float) timer.value()));
+}
+
+MI_VARIANT ref<Scene<Float, Spectrum>>
+Scene<Float, Spectrum>::load_snapshot(const std::string &filename) {
+    using FloatStorage = typename Mesh::FloatStorage;
+    using InputFloat = typename Mesh::InputFloat;
+
+    ScopedPhase sp(ProfilerPhase::InitScene);
+    Timer timer;
+
+    ref<FileStream> stream = new FileStream(filename);
+
+    std::string magic, variant;
+    uint32_t version = 0;
+    uint64_t buffers_start = 0, node_count = 0;
+
+    stream->read(magic);
+    if (magic != snapshot_magic)
+        Throw("\"%s\": not a scene snapshot!", filename);
+    stream->read(version);
+    if (version != snapshot_version)
+        Throw("\"%s\": unsupported scene snapshot version %i (expected %i)!",
+              filename, version, snapshot_version);
+    stream->read(variant);
+    if (variant != MI_CLASS(Scene)->variant())
+        Throw("\"%s\": the scene snapshot was created with variant \"%s\", "
+              "but variant \"%s\" is active!", filename, variant,
+              MI_CLASS(Scene)->variant());
+    stream->read(buffers_start);
+    stream->read(node_count);
+
+    ref<MemoryMappedFile> mmap = new MemoryMappedFile(filename);
+    if (buffers_start > mmap->size())
+        Throw("\"%s\": scene snapshot is truncated!", filename);
+    const uint8_t *buffers = (const uint8_t *) mmap->data() + buffers_start;
+
+    auto read_buffer = [&](size_t size) -> const uint8_t * {
+        uint64_t offset = 0;
+        stream->read(offset);
+        if (buffers_start + offset + size > mmap->size())
+            Throw("\"%s\": scene snapshot is truncated!", filename);
+        return buffers + offset;
+    };
+
+    ref<xml::ObjectGraph> graph = new xml::ObjectGraph(variant);
+    std::vector<xml::ObjectGraph::Node> &nodes = graph->nodes();
+    nodes.reserve(node_count);
+
+    std::unordered_map<std::string, ref<Object>> objects;
+    ref<Object> top_node;
+
+    for (uint64_t i = 0; i < node_count; ++i) {
+        xml::ObjectGraph::Node node;
+        stream->read(node.id);
+        stream->read(node.class_name);
+        node.props = read_snapshot_properties(stream);
+
+        // Substitute references with the (expanded) child objects
+        Properties props(node.props);
+        for (auto &kv : node.props.named_references()) {
+            auto it = objects.find(kv.second);
+            if (it == objects.end())
+                Throw("\"%s\": reference to unknown object \"%s\" in scene "
+                      "snapshot!", filename, (const std::string &) kv.second);
+
+            std::vector<ref<Object>> children = it->second->expand();
+            if (children.empty()) {
+                props.set_object(kv.first, it->second, false);
+            } else if (children.size() == 1) {
+                props.set_object(kv.first, children[0], false);
+            } else {
+                int ctr = 0;
+                for (auto c : children)
+                    props.set_object(kv.first + "_" + std::to_string(ctr++), c, false);
+            }
+        }
+
+        bool is_top_node = i + 1 == node_count;
+        if (is_top_node && xml::keep_object_graph())
+            props.set_object("_object_graph", graph.get());
+
+        uint8_t is_mesh = 0;
+        stream->read(is_mesh);
+
+        ref<Object> object;
+        if (is_mesh) {
+            // Recreate the mesh directly from the stored buffers
+            uint32_t vertex_count = 0, face_count = 0, attribute_count = 0;
+            uint8_t has_normals = 0, has_texcoords = 0;
+            stream->read(vertex_count);
+            stream->read(face_count);
+            stream->read(has_normals);
+            stream->read(has_texcoords);
+            stream->read(attribute_count);
+
+            ref<Mesh> mesh = new Mesh(node.id, vertex_count, face_count, props,
+                                      has_normals != 0, has_texcoords != 0);
+
+            mesh->vertex_positions_buffer() = dr::load<FloatStorage>(
+                read_buffer(vertex_count * 3 * sizeof(InputFloat)), vertex_count * 3);
+            if (has_normals)
+                mesh->vertex_normals_buffer() = dr::load<FloatStorage>(
+                    read_buffer(vertex_count * 3 * sizeof(InputFloat)), vertex_count * 3);
+            if (has_texcoords)
+                mesh->vertex_texcoords_buffer() = dr::load<FloatStorage>(
+                    read_buffer(vertex_count * 2 * sizeof(InputFloat)), vertex_count * 2);
+            mesh->faces_buffer() = dr::load<DynamicBuffer<UInt32>>(
+                read_buffer(face_count * 3 * sizeof(uint32_t)), face_count * 3);
+
+            for (uint32_t j = 0; j < attribute_count; ++j) {
+                std::string name;
+                uint64_t size = 0;
+                stream->read(name);
+                stream->read(size);
+                const uint8_t *data = read_buffer(size * sizeof(InputFloat));
+
+                /* Attributes are stored after conversion (e.g. to spectral
+                   coefficients), hence their contents are set directly */
+                size_t count = name.find("vertex_") == 0 ? vertex_count : face_count;
+                mesh->add_attribute(name, count > 0 ? size / count : 0,
+                                    std::vector<InputFloat>(size));
+                mesh->attribute_buffer(name) = dr::load<FloatStorage>(data, size);
+            }
+
+            mesh->initialize();
+            object = mesh;
+        } else {
+            try {
+                object = PluginManager::instance()->create_object(
+                    props, Class::for_name(node.class_name, variant));
+            } catch (const std::exception &e) {
+                Throw("\"%s\": could not instantiate %s plugin of type \"%s\" "
+                      "from scene snapshot: %s", filename,
+                      string::to_lower(node.class_name),
+                      props.plugin_name(), e.what());
+            }
+        }
+
+        objects[node.id] = object;
+        if (is_top_node)
+            top_node = object;
+        else
+            node.object = object;
+        if (xml::keep_object_graph())
+            nodes.push_back(std::move(node));
+    }
+
+    ref<Scene> scene = dynamic_cast<Scene *>(top_node.get());
+    if (!scene)
+        Throw("\"%s\": the scene snapshot does not contain a scene!", filename);
+
+    Log(Info, "Loaded scene snapshot \"%s\" (%zu objects, took %s).", filename,
+        (size_t) node_count, util::time_string((float) timer.value(), true));
+
+    return scene;
+}
+
+//! @}
+// -----------------------------------------------------------------------
+
 MI_VARIANT void Scene<Float, Spectrum>::static_accel_initialization() {
     if constexpr (dr::is_cuda_v<Float>)
         Scene::static_accel_initialization_gpu();
@@ -0,0 +1,318 @@
+#include <mitsuba/render/sparsevolumegrid.h>
+#include <mitsuba/render/volumegrid.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/logger.h>
+#include <mitsuba/core/stream.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/util.h>
+
+NAMESPACE_BEGIN(mitsuba)
+
+MI_VARIANT
+SparseVolumeGrid<Float, Spectrum>::SparseVolumeGrid(const fs::path &path,
+                                                    ScalarFloat tolerance) {
+    ref<FileStream> fs = new FileStream(path);
+    read(fs, tolerance);
+}
+
+MI_VARIANT
+SparseVolumeGrid<Float, Spectrum>::SparseVolumeGrid(Stream *stream,
+                                                    ScalarFloat tolerance) {
+    read(stream, tolerance);
+}
+
+MI_VARIANT
+SparseVolumeGrid<Float, Spectrum>::SparseVolumeGrid(
+    const VolumeGrid<Float, Spectrum> *grid, ScalarFloat tolerance) {
+    init(grid->size(), (uint32_t) grid->channel_count());
+
+    ScalarTransform4f to_world = grid->bbox_transform().inverse();
+    m_bbox = ScalarBoundingBox3f(to_world * ScalarPoint3f(0.f),
+                                 to_world * ScalarPoint3f(1.f));
+
+    size_t slab_size = (size_t) m_size.x() * m_size.y() * BrickSize *
+                       m_channel_count;
+    for (uint32_t tile_z = 0; tile_z < m_tile_count.z(); ++tile_z)
+        add_slab(grid->data() + tile_z * slab_size, tile_z, tolerance);
+
+    m_constant_bricks.clear();
+    update_max();
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::init(const ScalarVector3u &size,
+                                             uint32_t channel_count) {
+    if (dr::any(dr::eq(size, 0u)) || channel_count == 0)
+        Throw("SparseVolumeGrid: invalid grid size %s with %u channels!",
+              size, channel_count);
+
+    m_size          = size;
+    m_channel_count = channel_count;
+    m_tile_count    = (size + (BrickSize - 1)) / BrickSize;
+    m_bbox = ScalarBoundingBox3f(ScalarPoint3f(0.f), ScalarPoint3f(1.f));
+
+    m_index.assign((size_t) m_tile_count.x() * m_tile_count.y() *
+                       m_tile_count.z(), 0u);
+    m_data.clear();
+    m_brick_max.clear();
+    m_constant_bricks.clear();
+}
+
+MI_VARIANT
+template <typename T>
+void SparseVolumeGrid<Float, Spectrum>::add_slab(const T *slab, uint32_t tile_z,
+                                                 ScalarFloat tolerance) {
+    const size_t channels = m_channel_count,
+                 brick_values = BrickVoxels * channels;
+    const uint32_t depth = std::min(BrickSize, m_size.z() - tile_z * BrickSize);
+
+    std::vector<ScalarFloat> brick(brick_values), lo(channels), hi(channels);
+
+    for (uint32_t tile_y = 0; tile_y < m_tile_count.y(); ++tile_y) {
+        for (uint32_t tile_x = 0; tile_x < m_tile_count.x(); ++tile_x) {
+            /* Gather the voxels of the tile. Voxels beyond the end of the grid
+               replicate the last voxel, which keeps them from preventing a
+               tile from being constant. They are never accessed by lookups. */
+            ScalarFloat *dst = brick.data();
+            for (uint32_t z = 0; z < BrickSize; ++z) {
+                size_t sz = std::min(z, depth - 1);
+                for (uint32_t y = 0; y < BrickSize; ++y) {
+                    size_t sy = std::min(tile_y * BrickSize + y, m_size.y() - 1);
+                    for (uint32_t x = 0; x < BrickSize; ++x) {
+                        size_t sx = std::min(tile_x * BrickSize + x, m_size.x() - 1);
+                        const T *src =
+                            slab + ((sz * m_size.y() + sy) * m_size.x() + sx) * channels;
+                        for (size_t c = 0; c < channels; ++c)
+                            *dst++ = (ScalarFloat) src[c];
+                    }
+                }
+            }
+
+            for (size_t c = 0; c < channels; ++c)
+                lo[c] = hi[c] = brick[c];
+            for (size_t i = 0; i < brick_values; ++i) {
+                size_t c = i % channels;
+                lo[c] = dr::minimum(lo[c], brick[i]);
+                hi[c] = dr::maximum(hi[c], brick[i]);
+            }
+
+            bool constant = true;
+            for (size_t c = 0; c < channels; ++c)
+                constant &= hi[c] - lo[c] <= tolerance;
+
+            uint32_t id = (uint32_t) (m_data.size() / brick_values);
+            if (constant) {
+                std::vector<ScalarFloat> value(channels);
+                for (size_t c = 0; c < channels; ++c)
+                    value[c] = tolerance == 0.f ? lo[c] : .5f * (lo[c] + hi[c]);
+
+                auto [it, inserted] = m_constant_bricks.emplace(value, id);
+                if (inserted) {
+                    for (size_t i = 0; i < brick_values; ++i)
+                        m_data.push_back(value[i % channels]);
+                } else {
+                    id = it->second;
+                }
+            } else {
+                m_data.insert(m_data.end(), brick.begin(), brick.end());
+            }
+
+            m_index[((size_t) tile_z * m_tile_count.y() + tile_y) *
+                        m_tile_count.x() + tile_x] = id;
+        }
+    }
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::update_max() {
+    const size_t channels = m_channel_count,
+                 brick_values = BrickVoxels * channels,
+                 count = m_data.size() / brick_values;
+
+    m_max = -dr::Infinity<ScalarFloat>;
+    m_max_per_channel.assign(channels, -dr::Infinity<ScalarFloat>);
+    m_brick_max.assign(count, -dr::Infinity<ScalarFloat>);
+
+    const ScalarFloat *ptr = m_data.data();
+    for (size_t b = 0; b < count; ++b) {
+        ScalarFloat value = -dr::Infinity<ScalarFloat>;
+        for (size_t i = 0; i < brick_values; ++i) {
+            size_t c = i % channels;
+            m_max_per_channel[c] = dr::maximum(m_max_per_channel[c], ptr[i]);
+            value = dr::maximum(value, ptr[i]);
+        }
+        m_brick_max[b] = value;
+        m_max = dr::maximum(m_max, value);
+        ptr += brick_values;
+    }
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::read(Stream *stream,
+                                             ScalarFloat tolerance) {
+    char header[3];
+    stream->read(header, 3);
+
+    if (header[0] == 'S' && header[1] == 'V' && header[2] == 'L') {
+        read_sparse(stream);
+        return;
+    }
+
+    if (header[0] != 'V' || header[1] != 'O' || header[2] != 'L')
+        Throw("Invalid volume file!");
+
+    uint8_t version;
+    stream->read(version);
+    if (version != 3 && version != 4)
+        Throw("Invalid version, currently only versions 3 and 4 are supported (found %d)", version);
+
+    int32_t data_type;
+    stream->read(data_type);
+    if (data_type != 1)
+        Throw("Wrong type, currently only type == 1 (Float32) data is "
+              "supported (found type = %d)", data_type);
+
+    int32_t size_x, size_y, size_z, channel_count;
+    stream->read(size_x);
+    stream->read(size_y);
+    stream->read(size_z);
+    stream->read(channel_count);
+    init(ScalarVector3u((uint32_t) size_x, (uint32_t) size_y, (uint32_t) size_z),
+         (uint32_t) channel_count);
+
+    float dims[6];
+    stream->read_array(dims, 6);
+    m_bbox = ScalarBoundingBox3f(ScalarPoint3f(dims[0], dims[1], dims[2]),
+                                 ScalarPoint3f(dims[3], dims[4], dims[5]));
+
+    if (version == 4) {
+        // Skip the precomputed maxima and the padding of the header
+        size_t header_size = 52 + 4 * (size_t) channel_count;
+        std::vector<char> skipped((header_size + 63) / 64 * 64 - 48);
+        stream->read(skipped.data(), skipped.size());
+    }
+
+    // Convert the dense grid one slab of tiles at a time
+    Timer timer;
+    size_t slice_size = (size_t) m_size.x() * m_size.y() * m_channel_count;
+    std::unique_ptr<float[]> slab(new float[slice_size * BrickSize]);
+    for (uint32_t tile_z = 0; tile_z < m_tile_count.z(); ++tile_z) {
+        uint32_t depth = std::min(BrickSize, m_size.z() - tile_z * BrickSize);
+        stream->read_array(slab.get(), slice_size * depth);
+        add_slab(slab.get(), tile_z, tolerance);
+    }
+
+    m_constant_bricks.clear();
+    update_max();
+
+    Log(Debug, "Converted dense volume grid (dimensions %s) into %zu bricks "
+        "(%s instead of %s, took %s)", m_size, brick_count(),
+        util::mem_string(buffer_size()),
+        util::mem_string(slice_size * m_size.z() * sizeof(float)),
+        util::time_string((float) timer.value()));
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::read_sparse(Stream *stream) {
+    uint8_t version;
+    stream->read(version);
+    if (version != 1)
+        Throw("Invalid version, currently only version 1 of the sparse volume "
+              "format is supported (found %d)", version);
+
+    int32_t size_x, size_y, size_z, channel_count;
+    stream->read(size_x);
+    stream->read(size_y);
+    stream->read(size_z);
+    stream->read(channel_count);
+    init(ScalarVector3u((uint32_t) size_x, (uint32_t) size_y, (uint32_t) size_z),
+         (uint32_t) channel_count);
+
+    float dims[6];
+    stream->read_array(dims, 6);
+    m_bbox = ScalarBoundingBox3f(ScalarPoint3f(dims[0], dims[1], dims[2]),
+                                 ScalarPoint3f(dims[3], dims[4], dims[5]));
+
+    uint32_t count;
+    stream->read(count);
+    stream->read_array(m_index.data(), m_index.size());
+    for (uint32_t id : m_index) {
+        if (id >= count)
+            Throw("Invalid sparse volume file: tile references brick %u, but "
+                  "the file only contains %u bricks!", id, count);
+    }
+
+    m_data.resize((size_t) count * BrickVoxels * m_channel_count);
+    if constexpr (std::is_same_v<ScalarFloat, float>) {
+        stream->read_array(m_data.data(), m_data.size());
+    } else {
+        std::vector<float> values(m_data.size());
+        stream->read_array(values.data(), values.size());
+        for (size_t i = 0; i < values.size(); ++i)
+            m_data[i] = values[i];
+    }
+
+    update_max();
+    Log(Debug, "Loaded sparse volume grid: dimensions %s, %u bricks, max value %f",
+        m_size, count, m_max);
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::max_per_channel(ScalarFloat *out) const {
+    for (size_t i = 0; i < m_channel_count; ++i)
+        out[i] = m_max_per_channel[i];
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::write(const fs::path &path) const {
+    ref<FileStream> fs = new FileStream(path, FileStream::ETruncReadWrite);
+    write(fs);
+}
+
+MI_VARIANT
+void SparseVolumeGrid<Float, Spectrum>::write(Stream *stream) const {
+    stream->write("SVL", 3);
+    stream->write(uint8_t(1)); // file format version
+    stream->write(int32_t(m_size.x()));
+    stream->write(int32_t(m_size.y()));
+    stream->write(int32_t(m_size.z()));
+    stream->write(int32_t(m_channel_count));
+
+    stream->write(float(m_bbox.min.x()));
+    stream->write(float(m_bbox.min.y()));
+    stream->write(float(m_bbox.min.z()));
+    stream->write(float(m_bbox.max.x()));
+    stream->write(float(m_bbox.max.y()));
+    stream->write(float(m_bbox.max.z()));
+
+    stream->write(uint32_t(brick_count()));
+    stream->write_array(m_index.data(), m_index.size());
+
+    if constexpr (std::is_same_v<ScalarFloat, float>) {
+        stream->write_array(m_data.data(), m_data.size());
+    } else {
+        // Need to convert data to single precision before writing to disk
+        std::vector<float> output(m_data.begin(), m_data.end());
+        stream->write_array(output.data(), output.size());
+    }
+}
+
+MI_VARIANT
+std::string SparseVolumeGrid<Float, Spectrum>::to_string() const {
+    std::ostringstream oss;
+    oss << "SparseVolumeGrid[" << std::endl
+        << "  size = " << m_size << "," << std::endl
+        << "  channels = " << m_channel_count << "," << std::endl
+        << "  tiles = " << m_tile_count << "," << std::endl
+        << "  bricks = " << brick_count() << "," << std::endl
+        << "  max = " << m_max << "," << std::endl
+        << "  data = [ " << util::mem_string(buffer_size())
+        << " of volume data ]" << std::endl
+        << "]";
+    return oss.str();
+}
+
+MI_IMPLEMENT_CLASS_VARIANT(SparseVolumeGrid, Object)
+MI_INSTANTIATE_CLASS(SparseVolumeGrid)
+
+NAMESPACE_END(mitsuba)
@@ -4,6 +4,8 @@
 #include <mitsuba/render/texture.h>
 #include <mitsuba/render/srgb.h>
 #include <rgb2spec.h>
+#include <nanothread/nanothread.h>
+#include <atomic>
 #include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
@@ -11,9 +13,8 @@ NAMESPACE_BEGIN(mitsuba)
 static RGB2Spec *model = nullptr;
 static std::mutex model_mutex;
 
-dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
-    using Array3f = dr::Array<float, 3>;
-
+/// Load the upsampling model upon first use
+static RGB2Spec *srgb_model() {
     if (unlikely(model == nullptr)) {
         std::lock_guard<std::mutex> lock(model_mutex);
         if (model == nullptr) {
@@ -26,7 +27,13 @@ dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
             atexit([]{ rgb2spec_free(model); });
         }
     }
+    return model;
+}
+
+dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
+    using Array3f = dr::Array<float, 3>;
 
+    RGB2Spec *model = srgb_model();
     float rgb[3] = { (float) c.r(), (float) c.g(), (float) c.b() };
     float out[3];
     rgb2spec_fetch(model, rgb, out);
@@ -34,6 +41,154 @@ dr::Array<float, 3> srgb_model_fetch(const Color<float, 3> &c) {
     return Array3f(out[0], out[1], out[2]);
 }
 
+using FloatP   = dr::Packet<float, 16>;
+using UInt32P  = dr::uint32_array_t<FloatP>;
+using MaskP    = dr::mask_t<FloatP>;
+using Color3fP = Color<FloatP, 3>;
+using Array3fP = dr::Array<FloatP, 3>;
+
+/// Vectorized version of \c rgb2spec_fetch()
+static Array3fP srgb_model_fetch_packet(const RGB2Spec *model,
+                                        const Color3fP &rgb_) {
+    Color3fP rgb = dr::clamp(rgb_, 0.f, 1.f);
+    uint32_t res = model->res;
+
+    // Monochromatic case, solve analytically
+    MaskP mono = dr::eq(rgb.r(), rgb.g()) && dr::eq(rgb.g(), rgb.b());
+    FloatP v = rgb.r(),
+           r = dr::select(dr::eq(v, 0.f), -dr::Infinity<float>,
+               dr::select(dr::eq(v, 1.f), dr::Infinity<float>,
+                          (v - .5f) * dr::rsqrt(v * (1.f - v))));
+
+    // Determine the largest RGB component (the last one in case of ties)
+    UInt32P i = 0;
+    FloatP z = rgb.r(), x = rgb.g(), y = rgb.b();
+    MaskP m = rgb.g() >= z;
+    i = dr::select(m, 1u, i);
+    z = dr::select(m, rgb.g(), z);
+    x = dr::select(m, rgb.b(), x);
+    y = dr::select(m, rgb.r(), y);
+    m = rgb.b() >= z;
+    i = dr::select(m, 2u, i);
+    z = dr::select(m, rgb.b(), z);
+    x = dr::select(m, rgb.r(), x);
+    y = dr::select(m, rgb.g(), y);
+
+    // Avoid invalid indices in the monochromatic case (z may be zero)
+    z = dr::select(mono, 1.f, z);
+    FloatP scale = (float) (res - 1) / z;
+    x *= scale;
+    y *= scale;
+
+    // Branchless binary search for the interval of 'z' in 'model->scale'
+    UInt32P zi = 0;
+    uint32_t last_interval = res - 2, step = 1;
+    while (step * 2 <= last_interval)
+        step *= 2;
+    for (; step > 0; step /= 2) {
+        UInt32P probe = zi + step;
+        MaskP valid = probe <= last_interval;
+        valid &= dr::gather<FloatP>(model->scale, probe, valid) <= z;
+        zi = dr::select(valid, probe, zi);
+    }
+
+    // Trilinearly interpolated lookup
+    UInt32P xi = dr::minimum(UInt32P(x), last_interval),
+            yi = dr::minimum(UInt32P(y), last_interval),
+            offset = (((i * res + zi) * res + yi) * res + xi) * RGB2SPEC_N_COEFFS;
+    uint32_t dx = RGB2SPEC_N_COEFFS,
+             dy = RGB2SPEC_N_COEFFS * res,
+             dz = RGB2SPEC_N_COEFFS * res * res;
+
+    FloatP z_lo = dr::gather<FloatP>(model->scale, zi),
+           z_hi = dr::gather<FloatP>(model->scale, zi + 1);
+
+    FloatP x1 = x - FloatP(xi), x0 = 1.f - x1,
+           y1 = y - FloatP(yi), y0 = 1.f - y1,
+           z1 = (z - z_lo) / (z_hi - z_lo),
+           z0 = 1.f - z1;
+
+    auto fetch = [&](uint32_t delta) {
+        return dr::gather<FloatP>(model->data, offset + delta, !mono);
+    };
+
+    Array3fP result;
+    for (uint32_t j = 0; j < RGB2SPEC_N_COEFFS; ++j) {
+        result[j] = ((fetch(j          ) * x0 + fetch(j + dx          ) * x1) * y0 +
+                     (fetch(j + dy     ) * x0 + fetch(j + dy + dx     ) * x1) * y1) * z0 +
+                    ((fetch(j + dz     ) * x0 + fetch(j + dz + dx     ) * x1) * y0 +
+                     (fetch(j + dz + dy) * x0 + fetch(j + dz + dy + dx) * x1) * y1) * z1;
+    }
+
+    return dr::select(mono, Array3fP(0.f, 0.f, r), result);
+}
+
+/// Vectorized version of \ref srgb_model_mean()
+static FloatP srgb_model_mean_packet(const Array3fP &coeff) {
+    FloatP result = 0.f;
+    for (int k = 0; k < 16; ++k) {
+        float lambda = MI_CIE_MIN + (MI_CIE_MAX - MI_CIE_MIN) * k / 15.f;
+        FloatP v = dr::fmadd(dr::fmadd(coeff.x(), lambda, coeff.y()), lambda, coeff.z());
+        result += dr::maximum(0.f, dr::fmadd(.5f * v, dr::rsqrt(dr::fmadd(v, v, 1.f)), .5f));
+    }
+    return dr::select(dr::isinf(coeff.z()), dr::fmadd(dr::sign(coeff.z()), .5f, .5f),
+                      result * (1.f / 16.f));
+}
+
+template <typename Value>
+double srgb_model_fetch(const Value *rgb, Value *coeff, size_t count,
+                        bool *exceed_unit_range) {
+    const RGB2Spec *model = srgb_model();
+
+    const size_t packet_count = (count + FloatP::Size - 1) / FloatP::Size;
+    std::atomic<bool> exceed(false);
+    std::mutex mutex;
+    double total = 0.0;
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, packet_count, 1024),
+        [&](const dr::blocked_range<size_t> &range) {
+            double partial = 0.0;
+            bool partial_exceed = false;
+
+            for (size_t p = range.begin(); p != range.end(); ++p) {
+                UInt32P index = dr::arange<UInt32P>() + uint32_t(p * FloatP::Size);
+                MaskP active = index < (uint32_t) count;
+                index *= 3u;
+
+                Color3fP value;
+                for (uint32_t c = 0; c < 3; ++c)
+                    value[c] = FloatP(dr::gather<dr::Packet<Value, FloatP::Size>>(
+                        rgb, index + c, active));
+
+                MaskP in_range = dr::all(value >= 0.f && value <= 1.f);
+                partial_exceed |= dr::any(active && !in_range);
+
+                Array3fP result = srgb_model_fetch_packet(model, value);
+                for (uint32_t c = 0; c < 3; ++c)
+                    dr::scatter(coeff, dr::Packet<Value, FloatP::Size>(result[c]),
+                                index + c, active);
+
+                FloatP mean = srgb_model_mean_packet(result);
+                partial += (double) dr::sum(dr::select(active, mean, 0.f));
+            }
+
+            if (partial_exceed)
+                exceed = true;
+            std::lock_guard<std::mutex> guard(mutex);
+            total += partial;
+        }
+    );
+
+    if (exceed_unit_range)
+        *exceed_unit_range = exceed;
+
+    return total;
+}
+
+template MI_EXPORT_LIB double srgb_model_fetch(const float *, float *, size_t, bool *);
+template MI_EXPORT_LIB double srgb_model_fetch(const double *, double *, size_t, bool *);
+
 #if 0
 Color<float, 3> srgb_model_eval_rgb(const dr::Array<float, 3> &coeff) {
     using Array3f = dr::Array<float, 3>;
@@ -315,3 +315,67 @@ def test11_sample_silhouette_bijective(variants_vec_rgb):
     out = scene.invert_silhouette_sample(ss)
     assert dr.all(dr.neq(ss.discontinuity_type, mi.DiscontinuityFlags.Empty.value))
     assert dr.allclose(valid_samples, valid_out, atol=1e-6)
+
+
+def test12_scene_snapshot(variant_scalar_rgb, tmp_path):
+    xml = """<scene version="3.0.0">
+        <bsdf type="diffuse" id="mat">
+            <rgb name="reflectance" value="0.2, 0.4, 0.6"/>
+        </bsdf>
+        <shape type="cube" id="box">
+            <transform name="to_world">
+                <scale value="0.5"/>
+                <translate x="1" y="2" z="3"/>
+            </transform>
+            <ref id="mat"/>
+        </shape>
+        <shape type="sphere">
+            <point name="center" x="-2" y="0" z="0"/>
+            <emitter type="area">
+                <rgb name="radiance" value="5"/>
+            </emitter>
+        </shape>
+        <sensor type="perspective">
+            <float name="fov" value="45"/>
+        </sensor>
+    </scene>"""
+
+    # The object graph is only retained on request
+    filename = str(tmp_path / 'scene.snapshot')
+    with pytest.raises(RuntimeError, match='snapshot'):
+        mi.load_string(xml).save_snapshot(filename)
+
+    mi.set_keep_object_graph(True)
+    try:
+        scene = mi.load_string(xml)
+        scene.save_snapshot(filename)
+        scene2 = mi.Scene.load_snapshot(filename)
+
+        # Snapshots of snapshots are supported as well
+        scene2.save_snapshot(str(tmp_path / 'scene2.snapshot'))
+        scene3 = mi.Scene.load_snapshot(str(tmp_path / 'scene2.snapshot'))
+    finally:
+        mi.set_keep_object_graph(False)
+
+    assert len(scene2.shapes()) == len(scene.shapes())
+    assert len(scene2.emitters()) == len(scene.emitters())
+    assert len(scene2.sensors()) == len(scene.sensors())
+    assert dr.allclose(scene2.bbox().min, scene.bbox().min)
+    assert dr.allclose(scene2.bbox().max, scene.bbox().max)
+
+    for origin in [[1, 2, 0], [-2, 0, -3]]:
+        ray = mi.Ray3f(origin, [0, 0, 1])
+        si, si2 = scene.ray_intersect(ray), scene2.ray_intersect(ray)
+        assert si2.is_valid() and si.is_valid()
+        assert dr.allclose(si2.t, si.t)
+        assert dr.allclose(si2.n, si.n)
+        assert dr.allclose(si2.bsdf().eval_diffuse_reflectance(si2),
+                           si.bsdf().eval_diffuse_reflectance(si))
+        assert si2.shape.is_emitter() == si.shape.is_emitter()
+
+    assert len(scene3.shapes()) == len(scene.shapes())
+
+    # Only scenes loaded from XML provide the necessary information
+    scene4 = mi.load_dict({'type': 'scene', 'shape': {'type': 'sphere'}})
+    with pytest.raises(RuntimeError, match='snapshot'):
+        scene4.save_snapshot(filename)
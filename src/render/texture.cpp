@@ -11,7 +11,13 @@ NAMESPACE_BEGIN(mitsuba)
 // =======================================================================
 
 MI_VARIANT Texture<Float, Spectrum>::Texture(const Properties &props)
-    : m_id(props.id()) { }
+    : m_id(props.id()), m_nested_differentials(false) {
+    for (auto &[name, obj] : props.objects(false)) {
+        Texture *texture = dynamic_cast<Texture *>(obj.get());
+        if (texture && texture->needs_differentials())
+            m_nested_differentials = true;
+    }
+}
 
 MI_VARIANT Texture<Float, Spectrum>::~Texture() { }
 
@@ -46,6 +52,43 @@ Texture<Float, Spectrum>::eval_3(const SurfaceInteraction3f &, Mask) const {
     NotImplementedError("eval_3");
 }
 
+MI_VARIANT void
+Texture<Float, Spectrum>::eval_1_batch(const Texture *const *textures,
+                                       size_t count,
+                                       const SurfaceInteraction3f &si,
+                                       Float *out, Mask active) {
+    if (count > 64)
+        Throw("eval_1_batch(): at most 64 textures can be evaluated at once!");
+
+    uint64_t pending = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (textures[i])
+            pending |= 1ull << i;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (pending & (1ull << i))
+            textures[i]->eval_1_batch_impl(textures, count, i, pending, si,
+                                           out, active);
+    }
+}
+
+MI_VARIANT void
+Texture<Float, Spectrum>::eval_1_batch_impl(const Texture *const *,
+                                            size_t, size_t index,
+                                            uint64_t &pending,
+                                            const SurfaceInteraction3f &si,
+                                            Float *out, Mask active) const {
+    out[index] = eval_1(si, active);
+    pending &= ~(1ull << index);
+}
+
+MI_VARIANT std::vector<size_t>
+Texture<Float, Spectrum>::pack_atlas(const std::vector<Texture *> &,
+                                     size_t index, uint32_t) {
+    return { index };
+}
+
 MI_VARIANT Float
 Texture<Float, Spectrum>::mean() const {
     NotImplementedError("mean");
@@ -48,6 +48,24 @@ Volume<Float, Spectrum>::eval_gradient(const Interaction3f & /*it*/, Mask /*acti
     NotImplementedError("eval_gradient");
 }
 
+MI_VARIANT typename Volume<Float, Spectrum>::UnpolarizedSpectrum
+Volume<Float, Spectrum>::eval_lod(const Interaction3f &it, Float /* footprint */,
+                                  Mask active) const {
+    return eval(it, active);
+}
+
+MI_VARIANT std::pair<typename Volume<Float, Spectrum>::UnpolarizedSpectrum,
+                      typename Volume<Float, Spectrum>::UnpolarizedSpectrum>
+Volume<Float, Spectrum>::eval_pair(const Volume *other, const Interaction3f &it,
+                                   Float footprint, Mask active) const {
+    return { eval_lod(it, footprint, active),
+             other->eval_lod(it, footprint, active) };
+}
+
+MI_VARIANT bool Volume<Float, Spectrum>::is_colocated(const Volume * /* other */) const {
+    return false;
+}
+
 MI_VARIANT typename Volume<Float, Spectrum>::ScalarFloat
 Volume<Float, Spectrum>::max() const { NotImplementedError("max"); }
 
@@ -56,6 +74,27 @@ Volume<Float, Spectrum>::max_per_channel(ScalarFloat * /*out*/) const {
     NotImplementedError("max_per_channel");
 }
 
+MI_VARIANT typename Volume<Float, Spectrum>::TensorXf
+Volume<Float, Spectrum>::local_majorants(const ScalarVector3i &grid_resolution,
+                                         ScalarFloat value_scale) const {
+    size_t shape[4] = { (size_t) grid_resolution.z(),
+                        (size_t) grid_resolution.y(),
+                        (size_t) grid_resolution.x(), 1 };
+    std::vector<ScalarFloat> values(shape[0] * shape[1] * shape[2],
+                                    max() * value_scale);
+    return TensorXf(values.data(), 4, shape);
+}
+
+MI_VARIANT typename Volume<Float, Spectrum>::TensorXf
+Volume<Float, Spectrum>::local_minorants(const ScalarVector3i &grid_resolution,
+                                         ScalarFloat /* value_scale */) const {
+    size_t shape[4] = { (size_t) grid_resolution.z(),
+                        (size_t) grid_resolution.y(),
+                        (size_t) grid_resolution.x(), 1 };
+    std::vector<ScalarFloat> values(shape[0] * shape[1] * shape[2], 0.f);
+    return TensorXf(values.data(), 4, shape);
+}
+
 MI_VARIANT typename Volume<Float, Spectrum>::ScalarVector3i
 Volume<Float, Spectrum>::resolution() const {
     return ScalarVector3i(1, 1, 1);
@@ -3,16 +3,39 @@
 #include <mitsuba/core/logger.h>
 #include <mitsuba/core/fstream.h>
 #include <mitsuba/core/util.h>
+#include <nanothread/nanothread.h>
+#include <mutex>
+#include <utility>
 
 NAMESPACE_BEGIN(mitsuba)
 
 MI_VARIANT
-VolumeGrid<Float, Spectrum>::VolumeGrid(Stream *stream) { read(stream); }
+VolumeGrid<Float, Spectrum>::VolumeGrid(Stream *stream) {
+    read_data(stream, read_header(stream));
+}
 
 MI_VARIANT
 VolumeGrid<Float, Spectrum>::VolumeGrid(const fs::path &filename) {
     ref<FileStream> fs = new FileStream(filename);
-    read(fs);
+    uint8_t version = read_header(fs);
+
+    /* Version 4 files store the voxels in the representation used in memory,
+       map them instead of reading them */
+    if (std::is_same_v<ScalarFloat, float> && version == 4 &&
+        !fs->needs_endianness_swap()) {
+        size_t offset = data_offset();
+        if (fs->size() < offset + buffer_size())
+            Throw("\"%s\": volume file is truncated!", filename);
+        fs->close();
+
+        m_mmap = new MemoryMappedFile(filename);
+        m_mapped_data = (const ScalarFloat *) ((const uint8_t *) m_mmap->data() + offset);
+        Log(Debug, "Mapped grid volume data from file: dimensions %s, max value %f",
+            m_size, m_max);
+        return;
+    }
+
+    read_data(fs, version);
 }
 
 MI_VARIANT
@@ -20,13 +43,25 @@ VolumeGrid<Float, Spectrum>::VolumeGrid(ScalarVector3u size,
                                         ScalarUInt32 channel_count)
     : m_size(size), m_channel_count(channel_count),
       m_bbox(ScalarBoundingBox3f(ScalarPoint3f(0.f), ScalarPoint3f(1.f))),
-      m_max_per_channel(channel_count, 0.f) {
+      m_max(0.f), m_max_per_channel(channel_count, 0.f) {
     m_data = std::unique_ptr<ScalarFloat[]>(
-        new ScalarFloat[dr::prod(m_size) * m_channel_count]);
+        new ScalarFloat[buffer_size() / sizeof(ScalarFloat)]);
+}
+
+MI_VARIANT
+typename VolumeGrid<Float, Spectrum>::ScalarFloat *VolumeGrid<Float, Spectrum>::data() {
+    if (m_mmap) {
+        m_data = std::unique_ptr<ScalarFloat[]>(
+            new ScalarFloat[buffer_size() / sizeof(ScalarFloat)]);
+        memcpy(m_data.get(), m_mapped_data, buffer_size());
+        m_mmap = nullptr;
+        m_mapped_data = nullptr;
+    }
+    return m_data.get();
 }
 
 MI_VARIANT
-void VolumeGrid<Float, Spectrum>::read(Stream *stream) {
+uint8_t VolumeGrid<Float, Spectrum>::read_header(Stream *stream) {
     char header[3];
     stream->read(header, 3);
 
@@ -35,8 +70,8 @@ void VolumeGrid<Float, Spectrum>::read(Stream *stream) {
     uint8_t version;
     stream->read(version);
 
-    if (version != 3)
-        Throw("Invalid version, currently only version 3 is supported (found %d)", version);
+    if (version != 3 && version != 4)
+        Throw("Invalid version, currently only versions 3 and 4 are supported (found %d)", version);
 
     int32_t data_type;
     stream->read(data_type);
@@ -52,7 +87,6 @@ void VolumeGrid<Float, Spectrum>::read(Stream *stream) {
     m_size.y() = uint32_t(size_y);
     m_size.z() = uint32_t(size_z);
 
-    size_t size = dr::prod(m_size);
     int32_t channel_count;
     stream->read(channel_count);
     m_channel_count = channel_count;
@@ -64,24 +98,86 @@ void VolumeGrid<Float, Spectrum>::read(Stream *stream) {
                                  ScalarPoint3f(dims[3], dims[4], dims[5]));
 
     m_max = -dr::Infinity<ScalarFloat>;
-    m_max_per_channel.resize(m_channel_count, -dr::Infinity<ScalarFloat>);
-
-    m_data = std::unique_ptr<ScalarFloat[]>(new ScalarFloat[size * m_channel_count]);
-    size_t k = 0;
-    for (size_t i = 0; i < size; ++i) {
-        for (size_t j = 0; j < m_channel_count; ++j) {
-            float val;
-            stream->read(val);
-            m_data[k] = val;
-            m_max     = dr::maximum(m_max, val);
-            m_max_per_channel[j] = dr::maximum(m_max_per_channel[j], val);
-            ++k;
+    m_max_per_channel.assign(m_channel_count, -dr::Infinity<ScalarFloat>);
+
+    if (version == 4) {
+        // Precomputed maxima, followed by padding up to the voxel data
+        float max;
+        stream->read(max);
+        m_max = max;
+
+        std::vector<float> max_per_channel(m_channel_count);
+        stream->read_array(max_per_channel.data(), m_channel_count);
+        for (size_t i = 0; i < m_channel_count; ++i)
+            m_max_per_channel[i] = max_per_channel[i];
+
+        char padding[64];
+        stream->read(padding, data_offset() - (52 + 4 * (size_t) m_channel_count));
+    }
+
+    return version;
+}
+
+MI_VARIANT
+void VolumeGrid<Float, Spectrum>::read_data(Stream *stream, uint8_t version) {
+    size_t count = buffer_size() / sizeof(ScalarFloat);
+    m_data = std::unique_ptr<ScalarFloat[]>(new ScalarFloat[count]);
+
+    if constexpr (std::is_same_v<ScalarFloat, float>) {
+        stream->read_array(m_data.get(), count);
+    } else {
+        // Convert the data to double precision in chunks
+        const size_t chunk_size = 1 << 20;
+        std::unique_ptr<float[]> chunk(new float[std::min(count, chunk_size)]);
+        for (size_t i = 0; i < count; i += chunk_size) {
+            size_t size = std::min(count - i, chunk_size);
+            stream->read_array(chunk.get(), size);
+            for (size_t j = 0; j < size; ++j)
+                m_data[i + j] = chunk[j];
         }
     }
+
+    if (version == 3)
+        update_max();
+
     Log(Debug, "Loaded grid volume data from file: dimensions %s, max value %f",
         m_size, m_max);
 }
 
+MI_VARIANT
+void VolumeGrid<Float, Spectrum>::update_max() {
+    m_max = compute_max(m_max_per_channel);
+}
+
+MI_VARIANT typename VolumeGrid<Float, Spectrum>::ScalarFloat
+VolumeGrid<Float, Spectrum>::compute_max(std::vector<ScalarFloat> &max_per_channel) const {
+    const size_t channels = m_channel_count;
+    const ScalarFloat *values = data();
+    std::mutex mutex;
+
+    ScalarFloat max = -dr::Infinity<ScalarFloat>;
+    max_per_channel.assign(channels, -dr::Infinity<ScalarFloat>);
+
+    dr::parallel_for(
+        dr::blocked_range<size_t>(0, buffer_size() / bytes_per_voxel(), 1 << 16),
+        [&](const dr::blocked_range<size_t> &range) {
+            std::vector<ScalarFloat> local_max(channels, -dr::Infinity<ScalarFloat>);
+            const ScalarFloat *ptr = values + range.begin() * channels;
+            for (size_t i = range.begin(); i != range.end(); ++i)
+                for (size_t j = 0; j < channels; ++j)
+                    local_max[j] = dr::maximum(local_max[j], *ptr++);
+
+            std::lock_guard<std::mutex> guard(mutex);
+            for (size_t j = 0; j < channels; ++j) {
+                max_per_channel[j] = dr::maximum(max_per_channel[j], local_max[j]);
+                max = dr::maximum(max, local_max[j]);
+            }
+        }
+    );
+
+    return max;
+}
+
 MI_VARIANT
 void VolumeGrid<Float, Spectrum>::max_per_channel(ScalarFloat *out) const {
     for (size_t i=0; i<m_channel_count; ++i)
@@ -89,15 +185,18 @@ void VolumeGrid<Float, Spectrum>::max_per_channel(ScalarFloat *out) const {
 }
 
 MI_VARIANT
-void VolumeGrid<Float, Spectrum>::write(const fs::path &path) const {
+void VolumeGrid<Float, Spectrum>::write(const fs::path &path, uint32_t version) const {
     ref<FileStream> fs = new FileStream(path, FileStream::ETruncReadWrite);
-    write(fs);
+    write(fs, version);
 }
 
 MI_VARIANT
-void VolumeGrid<Float, Spectrum>::write(Stream *stream) const {
+void VolumeGrid<Float, Spectrum>::write(Stream *stream, uint32_t version) const {
+    if (version != 3 && version != 4)
+        Throw("write(): unsupported file format version %u, must be 3 or 4!", version);
+
     stream->write("VOL", 3);
-    stream->write(uint8_t(3)); // file format version
+    stream->write(uint8_t(version)); // file format version
     stream->write(int32_t(1)); // data_type
     stream->write(int32_t(m_size.x()));
     stream->write(int32_t(m_size.y()));
@@ -111,14 +210,28 @@ void VolumeGrid<Float, Spectrum>::write(Stream *stream) const {
     stream->write(float(m_bbox.max.y()));
     stream->write(float(m_bbox.max.z()));
 
+    if (version == 4) {
+        /* The stored maximum may be out of date, e.g. following changes
+           through data() or when it wasn't computed at construction */
+        std::vector<ScalarFloat> max_per_channel;
+        ScalarFloat max = compute_max(max_per_channel);
+        stream->write(float(max));
+        for (size_t i = 0; i < m_channel_count; ++i)
+            stream->write(float(max_per_channel[i]));
+
+        const char padding[64] = { };
+        stream->write(padding, data_offset() - (52 + 4 * (size_t) m_channel_count));
+    }
+
+    const size_t count = buffer_size() / sizeof(ScalarFloat);
     if constexpr (std::is_same<ScalarFloat, float>::value)
-        stream->write_array(m_data.get(), dr::prod(m_size) * m_channel_count);
+        stream->write_array(data(), count);
     else {
         // Need to convert data to single precision before writing to disk
-        std::vector<float> output(dr::prod(m_size) * m_channel_count);
-        for (size_t i = 0; i < dr::prod(m_size) * m_channel_count; ++i)
-            output[i] = m_data[i];
-        stream->write_array(output.data(), dr::prod(m_size) * m_channel_count);
+        std::vector<float> output(count);
+        for (size_t i = 0; i < count; ++i)
+            output[i] = data()[i];
+        stream->write_array(output.data(), count);
     }
 }
 
@@ -135,7 +248,7 @@ std::string VolumeGrid<Float, Spectrum>::to_string() const {
     oss << std::endl;
     oss << "  ],"  << std::endl
         << "  data = [ " << util::mem_string(buffer_size())
-        << " of volume data ]" << std::endl
+        << " of " << (m_mmap ? "memory-mapped " : "") << "volume data ]" << std::endl
         << "]";
     return oss.str();
 }
@@ -0,0 +1,758 @@
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#include <mitsuba/core/filesystem.h>
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/plugin.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/timer.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/fwd.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/mesh.h>
+#include <mitsuba/render/shape.h>
+
+#if defined(MI_ENABLE_EMBREE)
+#  include <embree3/rtcore.h>
+#else
+#  include <mitsuba/render/kdtree.h>
+#endif
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _shape-deferred:
+
+Deferred mesh (:monosp:`deferred`)
+-------------------------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename of the mesh file that should be loaded on demand. The mesh
+     loader (:ref:`ply <shape-ply>`, :ref:`obj <shape-obj>`, or
+     :ref:`serialized <shape-serialized>`) is selected based on the file
+     extension.
+
+ * - bbox_min, bbox_max
+   - |point|
+   - Object-space bounding box of the mesh. When not specified, the bounding
+     box is read from a sidecar file (see below). (Default: none)
+
+ * - residency_budget
+   - |float|
+   - Maximum amount of memory (in MiB) that all deferred meshes may occupy
+     at the same time. When the budget is exceeded, the least recently used
+     meshes are evicted and reloaded when they are needed again. The budget
+     is shared by all deferred meshes; if it is specified several times,
+     the smallest value is used. (Default: 0, i.e. unlimited)
+
+ * - to_world
+   - |transform|
+   - Specifies an optional linear object-to-world transformation.
+     (Default: none, i.e. object space = world space)
+
+All other parameters (e.g. ``face_normals``, ``flip_normals``, or
+``shape_index``) are forwarded to the underlying mesh loader.
+
+This plugin postpones loading the geometry of a triangle mesh until the
+acceleration data structure first needs its primitives, i.e. until a ray
+enters the bounding box of the shape. At scene load time, only the bounding box
+is known. Scenes where the camera only sees a small subset of the assets hence
+only pay for the meshes that are actually reached by rays.
+
+The bounding box is either specified explicitly, or it is read from a sidecar
+file named ``<filename>.bbox`` (``<filename>.<shape_index>.bbox`` for
+``serialized`` files) that is stored next to the mesh. When the sidecar file
+does not exist, the mesh is loaded once to compute the bounding box, and the
+sidecar file is created so that subsequent loads can skip this step.
+
+The number of mesh loads and evictions is reported once all deferred meshes
+have been released. If a mesh cannot be loaded during rendering, a warning is
+logged and the shape is treated as empty.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: deferred
+
+        <shape type="deferred">
+            <string name="filename" value="building_42.ply"/>
+            <float name="residency_budget" value="4096"/>
+            <bsdf type="diffuse"/>
+        </shape>
+
+    .. code-tab:: python
+
+        'building_42': {
+            'type': 'deferred',
+            'filename': 'building_42.ply',
+            'residency_budget': 4096.0,
+            'bsdf': {
+                'type': 'diffuse'
+            }
+        }
+
+.. warning::
+
+    - Deferred loading is only supported in scalar variants. In JIT variants,
+      the mesh is loaded eagerly and replaces this shape.
+    - Deferred meshes cannot have attached emitters or sensors.
+ */
+
+template <typename Float, typename Spectrum>
+class DeferredMesh final : public Shape<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Shape, m_id, m_to_world, initialize, is_emitter, is_sensor)
+    MI_IMPORT_TYPES(Mesh, ShapeKDTree)
+
+    using typename Base::ScalarSize;
+    using typename Base::ScalarRay3f;
+
+    /// Geometry and acceleration data of a deferred mesh while it is resident
+    struct Resident {
+        ref<Mesh> mesh;
+        size_t bytes = 0;
+#if defined(MI_ENABLE_EMBREE)
+        RTCScene scene = nullptr;
+        ~Resident() {
+            if (scene)
+                rtcReleaseScene(scene);
+        }
+#else
+        ref<ShapeKDTree> kdtree;
+#endif
+    };
+
+    /// Value of \ref ThreadState::epoch while a thread holds no geometry
+    static constexpr uint64_t Idle = (uint64_t) -1;
+
+    /**
+     * \brief Per-thread state of the epoch-based reclamation of evicted
+     * geometry
+     *
+     * While a thread uses resident geometry, it publishes the reclamation
+     * epoch observed before loading the pointer. Evicted geometry is only
+     * released once every thread has either become idle or moved past the
+     * epoch of the eviction. Compared to reference counting, a lookup only
+     * writes to memory owned by the calling thread.
+     */
+    struct ThreadState {
+        std::atomic<uint64_t> epoch { Idle };
+        uint32_t depth = 0;
+    };
+
+    /// Residency bookkeeping shared by all deferred meshes of a variant
+    struct ResidencyCache {
+        std::mutex mutex;
+        std::vector<DeferredMesh *> shapes;
+        size_t budget = 0;
+        size_t resident_bytes = 0, peak_bytes = 0;
+        size_t loads = 0, evictions = 0;
+        /// Approximate LRU clock (incremented by every load)
+        std::atomic<uint64_t> epoch { 0 };
+
+        /// Reclamation epoch (incremented by every eviction)
+        std::atomic<uint64_t> reclaim_epoch { 0 };
+        /// Threads that have accessed resident geometry
+        std::vector<ThreadState *> threads;
+        /// Evicted geometry along with the reclamation epoch of its eviction
+        std::vector<std::pair<Resident *, uint64_t>> retired;
+    };
+
+    /// Resident geometry that cannot be released while this handle exists
+    struct Handle {
+        ThreadState *thread;
+        /// Resident geometry, or \c nullptr if the mesh could not be loaded
+        const Resident *resident = nullptr;
+
+        Handle(ThreadState *thread) : thread(thread) {
+            if (thread->depth++ == 0)
+                thread->epoch.store(s_cache.reclaim_epoch.load());
+        }
+
+        Handle(Handle &&h) : thread(h.thread), resident(h.resident) {
+            h.thread = nullptr;
+        }
+
+        Handle(const Handle &) = delete;
+        Handle &operator=(const Handle &) = delete;
+
+        ~Handle() {
+            if (thread && --thread->depth == 0)
+                thread->epoch.store(Idle, std::memory_order_release);
+        }
+
+        const Resident *operator->() const { return resident; }
+        explicit operator bool() const { return resident != nullptr; }
+    };
+
+    DeferredMesh(const Properties &props) : Base(props) {
+        auto fs = Thread::thread()->file_resolver();
+        fs::path file_path = fs->resolve(props.string("filename"));
+        m_name = file_path.filename().string();
+
+        if (!fs::exists(file_path))
+            Throw("Error while loading deferred mesh \"%s\": file not found!", m_name);
+        if (!std::ifstream(file_path.native(), std::ios::binary).good())
+            Throw("Error while loading deferred mesh \"%s\": file is not "
+                  "readable!", m_name);
+
+        std::string extension = string::to_lower(file_path.extension().string());
+        std::string plugin;
+        if (extension == ".ply")
+            plugin = "ply";
+        else if (extension == ".obj")
+            plugin = "obj";
+        else if (extension == ".serialized")
+            plugin = "serialized";
+        else
+            Throw("Error while loading deferred mesh \"%s\": unsupported file "
+                  "extension \"%s\"!", m_name, extension);
+
+        // Parameters that are forwarded to the underlying mesh plugin
+        m_mesh_props = Properties(plugin);
+        m_mesh_props.set_id(m_id);
+        m_mesh_props.set_string("filename", file_path.string());
+        for (const std::string &name : props.property_names()) {
+            if (name == "filename" || name == "residency_budget" ||
+                name == "bbox_min" || name == "bbox_max")
+                continue;
+            // Child objects are owned by this shape in scalar variants
+            if (!dr::is_jit_v<Float> &&
+                props.type(name) == Properties::Type::Object)
+                continue;
+            m_mesh_props.copy_attribute(props, name, name);
+            props.mark_queried(name);
+        }
+
+        PluginManager::instance()->ensure_plugin_loaded(plugin);
+
+        if constexpr (dr::is_jit_v<Float>) {
+            Log(Debug, "\"%s\": deferred loading is only supported in scalar "
+                       "variants, loading the mesh eagerly.", m_name);
+            m_mesh = load_mesh(m_mesh_props);
+            return;
+        }
+
+        if (is_emitter() || is_sensor())
+            Throw("Deferred mesh \"%s\": attached emitters and sensors are "
+                  "not supported!", m_name);
+
+        ScalarBoundingBox3f bbox;
+        if (props.has_property("bbox_min") != props.has_property("bbox_max"))
+            Throw("Deferred mesh \"%s\": both \"bbox_min\" and \"bbox_max\" "
+                  "must be specified!", m_name);
+
+        if (props.has_property("bbox_min"))
+            bbox = ScalarBoundingBox3f(props.get<ScalarPoint3f>("bbox_min"),
+                                       props.get<ScalarPoint3f>("bbox_max"));
+        else
+            bbox = sidecar_bbox(file_path);
+
+        for (int i = 0; i < 8; ++i)
+            m_bbox.expand(m_to_world.scalar() * bbox.corner(i));
+
+        size_t budget = (size_t) (props.get<ScalarFloat>("residency_budget", 0.f) *
+                                  1024.f * 1024.f);
+
+        std::lock_guard<std::mutex> guard(s_cache.mutex);
+        if (budget > 0 && (s_cache.budget == 0 || budget < s_cache.budget))
+            s_cache.budget = budget;
+        s_cache.shapes.push_back(this);
+
+        initialize();
+    }
+
+    ~DeferredMesh() {
+        if constexpr (!dr::is_jit_v<Float>) {
+            // The scene is no longer traversed, the geometry can be released
+            delete m_resident.exchange(nullptr);
+
+            std::lock_guard<std::mutex> guard(s_cache.mutex);
+            auto it = std::find(s_cache.shapes.begin(), s_cache.shapes.end(), this);
+            if (it == s_cache.shapes.end())
+                return;
+            s_cache.shapes.erase(it);
+            s_cache.resident_bytes -= m_resident_bytes;
+
+            if (s_cache.shapes.empty()) {
+                if (s_cache.loads > 0)
+                    Log(Info, "Deferred meshes: %zu loads, %zu evictions, peak "
+                              "residency %s (budget: %s).",
+                        s_cache.loads, s_cache.evictions,
+                        util::mem_string(s_cache.peak_bytes),
+                        s_cache.budget > 0 ? util::mem_string(s_cache.budget)
+                                           : std::string("unlimited"));
+                s_cache.budget = s_cache.resident_bytes = s_cache.peak_bytes = 0;
+                s_cache.loads = s_cache.evictions = 0;
+
+                for (auto &[resident, epoch] : s_cache.retired)
+                    delete resident;
+                s_cache.retired.clear();
+            }
+        }
+    }
+
+    std::vector<ref<Object>> expand() const override {
+        if (m_mesh)
+            return { ref<Object>(m_mesh.get()) };
+        return { };
+    }
+
+    // =============================================================
+    //! @{ \name Bounding box and geometric queries
+    // =============================================================
+
+    ScalarBoundingBox3f bbox() const override { return m_bbox; }
+
+    ScalarSize primitive_count() const override { return 1; }
+
+    Float surface_area() const override {
+        Handle resident = acquire();
+        return resident ? resident->mesh->surface_area() : Float(0.f);
+    }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Ray tracing routines
+    // =============================================================
+
+#if !defined(MI_ENABLE_EMBREE)
+    std::tuple<ScalarFloat, ScalarPoint2f, ScalarUInt32, ScalarUInt32>
+    ray_intersect_preliminary_scalar(const ScalarRay3f &ray) const override {
+        Handle resident = acquire();
+        if (!resident)
+            return { dr::Infinity<ScalarFloat>, ScalarPoint2f(0.f),
+                     (ScalarUInt32) -1, (ScalarUInt32) -1 };
+        auto pi = resident->kdtree->template ray_intersect_scalar<false>(ray);
+        // Report the triangle index, this shape is not an instance
+        return { pi.t, pi.prim_uv, (ScalarUInt32) -1, pi.prim_index };
+    }
+
+    bool ray_test_scalar(const ScalarRay3f &ray) const override {
+        Handle resident = acquire();
+        return resident &&
+               resident->kdtree->template ray_intersect_scalar<true>(ray).is_valid();
+    }
+#else
+    RTCGeometry embree_geometry(RTCDevice device) override {
+        if constexpr (!dr::is_jit_v<Float>) {
+            m_embree_device = device;
+            RTCGeometry geom = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_USER);
+            rtcSetGeometryUserPrimitiveCount(geom, 1);
+            rtcSetGeometryUserData(geom, (void *) this);
+            rtcSetGeometryBoundsFunction(geom, embree_bbox, nullptr);
+            rtcSetGeometryIntersectFunction(geom, embree_intersect);
+            rtcSetGeometryOccludedFunction(geom, embree_occluded);
+            rtcCommitGeometry(geom);
+            return geom;
+        } else {
+            return Base::embree_geometry(device);
+        }
+    }
+#endif
+
+    SurfaceInteraction3f compute_surface_interaction(const Ray3f &ray,
+                                                     const PreliminaryIntersection3f &pi,
+                                                     uint32_t ray_flags,
+                                                     uint32_t recursion_depth,
+                                                     Mask active) const override {
+        MI_MASK_ARGUMENT(active);
+
+        if constexpr (!dr::is_jit_v<Float>) {
+            // Hold on to the geometry until the interaction is computed
+            Handle resident = acquire();
+            if (!resident) {
+                SurfaceInteraction3f si = dr::zeros<SurfaceInteraction3f>();
+                si.t = dr::Infinity<Float>;
+                return si;
+            }
+
+            PreliminaryIntersection3f pi_mesh = pi;
+            pi_mesh.shape = resident->mesh.get();
+
+            SurfaceInteraction3f si = resident->mesh->compute_surface_interaction(
+                ray, pi_mesh, ray_flags, recursion_depth, active);
+            si.shape = this;
+            return si;
+        } else {
+            DRJIT_MARK_USED(ray);
+            DRJIT_MARK_USED(pi);
+            DRJIT_MARK_USED(ray_flags);
+            DRJIT_MARK_USED(recursion_depth);
+            NotImplementedError("compute_surface_interaction");
+        }
+    }
+
+    //! @}
+    // =============================================================
+
+    // =============================================================
+    //! @{ \name Mesh attributes (forwarded to the resident mesh)
+    // =============================================================
+
+    Mask has_attribute(const std::string &name, Mask active = true) const override {
+        if (Base::has_attribute(name, active))
+            return true;
+        Handle resident = acquire();
+        if (!resident)
+            return false;
+        return resident->mesh->has_attribute(name, active);
+    }
+
+    UnpolarizedSpectrum eval_attribute(const std::string &name,
+                                       const SurfaceInteraction3f &si,
+                                       Mask active = true) const override {
+        if (Base::has_attribute(name, active))
+            return Base::eval_attribute(name, si, active);
+        Handle resident = acquire();
+        if (!resident)
+            return dr::zeros<UnpolarizedSpectrum>();
+        return resident->mesh->eval_attribute(name, si, active);
+    }
+
+    Float eval_attribute_1(const std::string &name,
+                           const SurfaceInteraction3f &si,
+                           Mask active = true) const override {
+        if (Base::has_attribute(name, active))
+            return Base::eval_attribute_1(name, si, active);
+        Handle resident = acquire();
+        if (!resident)
+            return dr::zeros<Float>();
+        return resident->mesh->eval_attribute_1(name, si, active);
+    }
+
+    Color3f eval_attribute_3(const std::string &name,
+                             const SurfaceInteraction3f &si,
+                             Mask active = true) const override {
+        if (Base::has_attribute(name, active))
+            return Base::eval_attribute_3(name, si, active);
+        Handle resident = acquire();
+        if (!resident)
+            return dr::zeros<Color3f>();
+        return resident->mesh->eval_attribute_3(name, si, active);
+    }
+
+    //! @}
+    // =============================================================
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "DeferredMesh[" << std::endl
+            << "  name = \"" << m_name << "\"," << std::endl
+            << "  bbox = " << string::indent(m_bbox) << "," << std::endl
+            << "  resident = " << (m_resident.load() ? "true" : "false") << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+private:
+    /// Instantiate the underlying mesh plugin
+    ref<Mesh> load_mesh(const Properties &props) const {
+        ref<Object> object =
+            PluginManager::instance()->create_object(props, MI_CLASS(Base));
+        Mesh *mesh = dynamic_cast<Mesh *>(object.get());
+        if (!mesh)
+            Throw("Deferred mesh \"%s\": the loaded shape is not a triangle "
+                  "mesh!", m_name);
+        return mesh;
+    }
+
+    /// Read (or create) the sidecar file storing the object-space bounding box
+    ScalarBoundingBox3f sidecar_bbox(const fs::path &file_path) const {
+        std::string sidecar = file_path.string();
+        if (m_mesh_props.has_property("shape_index"))
+            sidecar += "." + m_mesh_props.as_string("shape_index");
+        sidecar += ".bbox";
+
+        // The size of the mesh file is stored to detect stale sidecar files
+        size_t file_size = fs::file_size(file_path);
+
+        std::ifstream is(sidecar);
+        if (is.good()) {
+            size_t stored_size = 0;
+            ScalarPoint3f p_min, p_max;
+            is >> stored_size >> p_min.x() >> p_min.y() >> p_min.z()
+               >> p_max.x() >> p_max.y() >> p_max.z();
+            if (!is.fail() && stored_size == file_size)
+                return ScalarBoundingBox3f(p_min, p_max);
+            Log(Warn, "\"%s\": ignoring stale or invalid bounding box sidecar "
+                      "file \"%s\".", m_name, sidecar);
+        }
+
+        // Load the mesh once in object space to compute its bounding box
+        Properties props(m_mesh_props);
+        props.remove_property("to_world");
+        ScalarBoundingBox3f bbox = load_mesh(props)->bbox();
+
+        std::ofstream os(sidecar);
+        os.precision(9);
+        os << file_size << " " << bbox.min.x() << " " << bbox.min.y() << " "
+           << bbox.min.z() << " " << bbox.max.x() << " " << bbox.max.y() << " "
+           << bbox.max.z() << std::endl;
+        if (!os.good())
+            Log(Warn, "\"%s\": could not write bounding box sidecar file "
+                      "\"%s\".", m_name, sidecar);
+
+        return bbox;
+    }
+
+    /// Return the state of the calling thread, registering it if necessary
+    static ThreadState *thread_state() {
+        struct Registration {
+            ThreadState state;
+            Registration() {
+                std::lock_guard<std::mutex> guard(s_cache.mutex);
+                s_cache.threads.push_back(&state);
+            }
+            ~Registration() {
+                std::lock_guard<std::mutex> guard(s_cache.mutex);
+                auto &threads = s_cache.threads;
+                threads.erase(std::find(threads.begin(), threads.end(), &state));
+            }
+        };
+        static thread_local Registration registration;
+        return &registration.state;
+    }
+
+    /**
+     * \brief Return the resident geometry, loading it first if necessary
+     *
+     * The geometry remains valid while the returned handle exists, even if
+     * another thread evicts it in the meantime.
+     */
+    MI_INLINE Handle acquire() const {
+        Handle handle(thread_state());
+        handle.resident = m_resident.load();
+        if (likely(handle.resident)) {
+            // Approximate LRU: remember the epoch (number of loads) of the last use
+            uint64_t epoch = s_cache.epoch.load(std::memory_order_relaxed);
+            if (m_last_use.load(std::memory_order_relaxed) != epoch)
+                m_last_use.store(epoch, std::memory_order_relaxed);
+        } else if (!m_failed.load(std::memory_order_relaxed)) {
+            handle.resident = load();
+        }
+        return handle;
+    }
+
+    /**
+     * \brief Load the geometry and evict other meshes to fit the budget
+     *
+     * Must be called while the calling thread holds a \ref Handle. Returns
+     * \c nullptr if the mesh could not be loaded, which is reported once.
+     */
+    const Resident *load() const {
+        std::lock_guard<std::mutex> guard(m_load_mutex);
+
+        // Another thread may have loaded the mesh in the meantime
+        Resident *resident = m_resident.load();
+        if (resident || m_failed.load())
+            return resident;
+
+        Timer timer;
+        std::unique_ptr<Resident> result(new Resident());
+        try {
+            result->mesh = load_mesh(m_mesh_props);
+
+            const Mesh *mesh = result->mesh.get();
+            result->bytes =
+                (dr::width(mesh->vertex_positions_buffer()) +
+                 dr::width(mesh->vertex_normals_buffer()) +
+                 dr::width(mesh->vertex_texcoords_buffer())) * sizeof(float) +
+                dr::width(mesh->faces_buffer()) * sizeof(uint32_t);
+
+#if defined(MI_ENABLE_EMBREE)
+            result->scene = rtcNewScene(m_embree_device);
+            RTCGeometry geom = result->mesh->embree_geometry(m_embree_device);
+            rtcAttachGeometry(result->scene, geom);
+            rtcReleaseGeometry(geom);
+            rtcCommitScene(result->scene);
+#else
+            result->kdtree = new ShapeKDTree(Properties());
+            result->kdtree->add_shape(result->mesh.get());
+            result->kdtree->build();
+#endif
+        } catch (const std::exception &e) {
+            /* This function runs during traversal (possibly within an Embree
+               callback), hence the shape is treated as empty instead */
+            m_failed.store(true);
+            Log(Warn, "\"%s\": could not load deferred mesh, the shape will "
+                      "be treated as empty: %s", m_name, e.what());
+            return nullptr;
+        }
+
+        resident = result.release();
+        m_resident.store(resident);
+
+        // Evicted geometry is released after the lock has been dropped
+        std::vector<Resident *> released;
+        size_t evicted = 0;
+        {
+            std::lock_guard<std::mutex> guard2(s_cache.mutex);
+            m_last_use.store(++s_cache.epoch, std::memory_order_relaxed);
+            m_resident_bytes = resident->bytes;
+            s_cache.resident_bytes += resident->bytes;
+            s_cache.peak_bytes = std::max(s_cache.peak_bytes, s_cache.resident_bytes);
+            s_cache.loads++;
+
+            while (s_cache.budget > 0 && s_cache.resident_bytes > s_cache.budget) {
+                DeferredMesh *victim = nullptr;
+                uint64_t oldest = (uint64_t) -1;
+                for (DeferredMesh *shape : s_cache.shapes) {
+                    if (shape == this || shape->m_resident_bytes == 0)
+                        continue;
+                    uint64_t last_use = shape->m_last_use.load(std::memory_order_relaxed);
+                    if (last_use < oldest) {
+                        oldest = last_use;
+                        victim = shape;
+                    }
+                }
+                if (!victim)
+                    break;
+
+                /* Unpublish the geometry before advancing the epoch: threads
+                   that start using geometry afterwards cannot observe it */
+                Resident *victim_resident = victim->m_resident.exchange(nullptr);
+                uint64_t epoch = s_cache.reclaim_epoch.fetch_add(1);
+                s_cache.retired.emplace_back(victim_resident, epoch);
+                s_cache.resident_bytes -= victim->m_resident_bytes;
+                victim->m_resident_bytes = 0;
+                s_cache.evictions++;
+                evicted++;
+            }
+
+            // Release geometry that no thread can still be using
+            uint64_t min_epoch = Idle;
+            for (const ThreadState *thread : s_cache.threads)
+                min_epoch = std::min(min_epoch, thread->epoch.load());
+
+            auto &retired = s_cache.retired;
+            for (size_t i = 0; i < retired.size(); ) {
+                if (retired[i].second < min_epoch) {
+                    released.push_back(retired[i].first);
+                    retired[i] = retired.back();
+                    retired.pop_back();
+                } else {
+                    ++i;
+                }
+            }
+        }
+
+        for (Resident *r : released)
+            delete r;
+
+        Log(Debug, "\"%s\": loaded deferred mesh (%s, took %s, %zu meshes evicted).",
+            m_name, util::mem_string(resident->bytes),
+            util::time_string((float) timer.value()), evicted);
+
+        return resident;
+    }
+
+#if defined(MI_ENABLE_EMBREE)
+    static void embree_bbox(const RTCBoundsFunctionArguments *args) {
+        const DeferredMesh *shape = (const DeferredMesh *) args->geometryUserPtr;
+        ScalarBoundingBox3f bbox = shape->bbox();
+        RTCBounds *bounds_o = args->bounds_o;
+        bounds_o->lower_x = (float) bbox.min.x();
+        bounds_o->lower_y = (float) bbox.min.y();
+        bounds_o->lower_z = (float) bbox.min.z();
+        bounds_o->upper_x = (float) bbox.max.x();
+        bounds_o->upper_y = (float) bbox.max.y();
+        bounds_o->upper_z = (float) bbox.max.z();
+    }
+
+    static void embree_intersect(const RTCIntersectFunctionNArguments *args) {
+        // Scalar variants only trace single rays
+        Assert(args->N == 1);
+        if (!args->valid[0])
+            return;
+
+        const DeferredMesh *shape = (const DeferredMesh *) args->geometryUserPtr;
+        Handle resident = shape->acquire();
+        if (!resident)
+            return;
+        RTCRayHit *rh_o = (RTCRayHit *) args->rayhit;
+
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+
+        RTCRayHit rh = *rh_o;
+        rh.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+        rh.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+        rtcIntersect1(resident->scene, &context, &rh);
+
+        if (rh.hit.geomID != RTC_INVALID_GEOMETRY_ID) {
+            // Report the triangle index so that it reaches compute_surface_interaction()
+            rh_o->ray.tfar      = rh.ray.tfar;
+            rh_o->hit.u         = rh.hit.u;
+            rh_o->hit.v         = rh.hit.v;
+            rh_o->hit.Ng_x      = rh.hit.Ng_x;
+            rh_o->hit.Ng_y      = rh.hit.Ng_y;
+            rh_o->hit.Ng_z      = rh.hit.Ng_z;
+            rh_o->hit.primID    = rh.hit.primID;
+            rh_o->hit.geomID    = args->geomID;
+            rh_o->hit.instID[0] = args->context->instID[0];
+        }
+    }
+
+    static void embree_occluded(const RTCOccludedFunctionNArguments *args) {
+        // Scalar variants only trace single rays
+        Assert(args->N == 1);
+        if (!args->valid[0])
+            return;
+
+        const DeferredMesh *shape = (const DeferredMesh *) args->geometryUserPtr;
+        Handle resident = shape->acquire();
+        if (!resident)
+            return;
+        RTCRay *ray_o = (RTCRay *) args->ray;
+
+        RTCIntersectContext context;
+        rtcInitIntersectContext(&context);
+
+        RTCRay ray = *ray_o;
+        rtcOccluded1(resident->scene, &context, &ray);
+        if (ray.tfar < 0.f)
+            ray_o->tfar = -dr::Infinity<float>;
+    }
+#endif
+
+private:
+    std::string m_name;
+    ScalarBoundingBox3f m_bbox;
+    Properties m_mesh_props;
+
+    /// Eagerly loaded mesh (JIT variants only)
+    ref<Mesh> m_mesh;
+
+    mutable std::atomic<Resident *> m_resident { nullptr };
+    /// Set when loading the mesh failed (reported once)
+    mutable std::atomic<bool> m_failed { false };
+    mutable std::atomic<uint64_t> m_last_use { 0 };
+    mutable std::mutex m_load_mutex;
+    /// Size of the resident geometry (guarded by the residency cache mutex)
+    mutable size_t m_resident_bytes = 0;
+
+#if defined(MI_ENABLE_EMBREE)
+    RTCDevice m_embree_device = nullptr;
+#endif
+
+    static ResidencyCache s_cache;
+};
+
+template <typename Float, typename Spectrum>
+typename DeferredMesh<Float, Spectrum>::ResidencyCache DeferredMesh<Float, Spectrum>::s_cache;
+
+MI_IMPLEMENT_CLASS_VARIANT(DeferredMesh, Shape)
+MI_EXPORT_PLUGIN(DeferredMesh, "Deferred mesh");
+NAMESPACE_END(mitsuba)
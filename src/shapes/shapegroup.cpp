@@ -95,6 +95,14 @@ where only a few distinct types of trees have to be kept in memory. An example i
             }
         }
 
+Scenes exported from other tools often contain many byte-identical meshes that
+only differ in their ``to_world`` transformation. When loading such a scene from
+an XML file, setting the boolean ``auto_instancing`` property of the scene
+(``<boolean name="auto_instancing" value="true"/>``) will automatically collapse
+``ply``, ``obj``, and ``serialized`` shapes with identical file contents and
+parameters into a shape group referenced through :ref:`shape-instance` shapes.
+Shapes with attached emitters or sensors are left untouched.
+
  */
 
 template <typename Float, typename Spectrum>
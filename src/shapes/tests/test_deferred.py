@@ -0,0 +1,124 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def write_quad(path, offset=0.0):
+    with open(path, 'w') as f:
+        f.write(f'v -1 -1 {offset}\nv 1 -1 {offset}\nv 1 1 {offset}\nv -1 1 {offset}\n'
+                'vn 0 0 1\nvn 0 0 1\nvn 0 0 1\nvn 0 0 1\n'
+                'f 1//1 2//2 3//3\nf 1//1 3//3 4//4\n')
+    return str(path)
+
+
+def test01_create(variant_scalar_rgb, tmp_path):
+    filename = write_quad(tmp_path / 'quad.obj')
+    s = mi.load_dict({
+        'type': 'deferred',
+        'filename': filename,
+        'bbox_min': [-1, -1, 0],
+        'bbox_max': [1, 1, 0],
+        'to_world': mi.ScalarTransform4f().translate([0, 0, 2])
+    })
+
+    assert s is not None
+    assert s.primitive_count() == 1
+    assert dr.allclose(s.bbox().min, [-1, -1, 2])
+    assert dr.allclose(s.bbox().max, [1, 1, 2])
+    # Nothing has been loaded so far
+    assert 'resident = false' in str(s)
+
+
+def test02_sidecar_bbox(variant_scalar_rgb, tmp_path):
+    filename = write_quad(tmp_path / 'quad.obj', offset=0.5)
+
+    s = mi.load_dict({ 'type': 'deferred', 'filename': filename })
+    assert (tmp_path / 'quad.obj.bbox').exists()
+    assert dr.allclose(s.bbox().min, [-1, -1, 0.5])
+    assert dr.allclose(s.bbox().max, [1, 1, 0.5])
+
+    # Second load uses the sidecar file
+    s = mi.load_dict({ 'type': 'deferred', 'filename': filename })
+    assert dr.allclose(s.bbox().min, [-1, -1, 0.5])
+
+
+def test03_ray_intersect(variant_scalar_rgb, tmp_path):
+    filename = write_quad(tmp_path / 'quad.obj')
+
+    def make_scene(shape_type):
+        return mi.load_dict({
+            'type': 'scene',
+            'shape': {
+                'type': shape_type,
+                'filename': filename,
+                'to_world': mi.ScalarTransform4f().translate([0, 0, 2]),
+            }
+        })
+
+    scene_ref = make_scene('obj')
+    scene = make_scene('deferred')
+    assert dr.allclose(scene.bbox().min, scene_ref.bbox().min)
+    assert dr.allclose(scene.bbox().max, scene_ref.bbox().max)
+
+    for x in [-1.5, -0.5, 0.0, 0.3, 0.9, 1.5]:
+        for y in [-0.7, 0.2, 1.2]:
+            ray = mi.Ray3f([x, y, 0], [0, 0, 1])
+            si_ref = scene_ref.ray_intersect(ray)
+            si = scene.ray_intersect(ray)
+            assert si.is_valid() == si_ref.is_valid()
+            assert scene.ray_test(ray) == scene_ref.ray_test(ray)
+            if si_ref.is_valid():
+                assert dr.allclose(si.t, si_ref.t)
+                assert dr.allclose(si.p, si_ref.p)
+                assert dr.allclose(si.n, si_ref.n)
+                assert dr.allclose(si.uv, si_ref.uv)
+                assert si.shape == scene.shapes()[0]
+
+
+def test04_eviction(variant_scalar_rgb, tmp_path):
+    # Two meshes that cannot be resident at the same time
+    scene = mi.load_dict({
+        'type': 'scene',
+        'left': {
+            'type': 'deferred',
+            'filename': write_quad(tmp_path / 'left.obj'),
+            'to_world': mi.ScalarTransform4f().translate([-3, 0, 2]),
+            'residency_budget': 1e-4
+        },
+        'right': {
+            'type': 'deferred',
+            'filename': write_quad(tmp_path / 'right.obj'),
+            'to_world': mi.ScalarTransform4f().translate([3, 0, 2]),
+            'residency_budget': 1e-4
+        }
+    })
+
+    # Alternate between both meshes, forcing them to be reloaded
+    for i in range(4):
+        x = -3 if i % 2 == 0 else 3
+        si = scene.ray_intersect(mi.Ray3f([x, 0, 0], [0, 0, 1]))
+        assert si.is_valid()
+        assert dr.allclose(si.p, [x, 0, 2])
+
+
+def test05_load_failure(variant_scalar_rgb, tmp_path):
+    # The file exists but cannot be parsed, which is only detected once a ray
+    # reaches the bounding box
+    filename = tmp_path / 'broken.ply'
+    filename.write_text('this is not a PLY file\n')
+
+    scene = mi.load_dict({
+        'type': 'scene',
+        'shape': {
+            'type': 'deferred',
+            'filename': str(filename),
+            'bbox_min': [-1, -1, 2],
+            'bbox_max': [1, 1, 2]
+        }
+    })
+
+    # The shape is treated as empty instead of raising during traversal
+    for i in range(2):
+        ray = mi.Ray3f([0, 0, 0], [0, 0, 1])
+        assert not scene.ray_intersect(ray).is_valid()
+        assert not scene.ray_test(ray)
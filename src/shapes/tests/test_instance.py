@@ -216,3 +216,45 @@ def test03_ray_intersect_instance(variants_all_rgb, width):
         assert 'instance = nullptr' in str(pi)
     else:
         assert ('instance = [' + '0x0, ' * (width - 1) + '0x0]') in str(pi)
+
+
+@fresolver_append_path
+def test04_auto_instancing(variant_scalar_rgb):
+    shape_xml = """
+        <shape type="obj">
+            <string name="filename" value="resources/data/common/meshes/rectangle.obj"/>
+            <ref id="mat"/>
+            <transform name="to_world">
+                <translate x="{}"/>
+            </transform>
+        </shape>
+    """
+
+    def load(auto_instancing):
+        return mi.load_string(f"""
+            <scene version="3.0.0">
+                <boolean name="auto_instancing" value="{auto_instancing}"/>
+                <bsdf type="diffuse" id="mat"/>
+                {shape_xml.format(-3)}
+                {shape_xml.format(3)}
+                <shape type="sphere"/>
+            </scene>
+        """)
+
+    s = load('false')
+    s_inst = load('true')
+
+    assert len(s.shapes()) == 3 and len(s_inst.shapes()) == 3
+    assert sum(sh.class_().name() == 'Instance' for sh in s_inst.shapes()) == 2
+    assert sum(sh.class_().name() == 'Instance' for sh in s.shapes()) == 0
+    assert dr.allclose(s.bbox().min, s_inst.bbox().min)
+    assert dr.allclose(s.bbox().max, s_inst.bbox().max)
+
+    for x in [-3, 3]:
+        ray = mi.Ray3f(o=[x + 0.1, 0.2, -8], d=[0.0, 0.0, 1.0])
+        si = s.ray_intersect(ray)
+        si_inst = s_inst.ray_intersect(ray)
+        assert si.is_valid() and si_inst.is_valid()
+        assert si_inst.instance is not None
+        assert dr.allclose(si.p, si_inst.p)
+        assert dr.allclose(si.t, si_inst.t)
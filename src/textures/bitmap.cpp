@@ -1,7 +1,10 @@
 #include <mitsuba/core/bitmap.h>
 #include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/fstream.h>
+#include <mitsuba/core/hash.h>
 #include <mitsuba/core/plugin.h>
 #include <mitsuba/core/properties.h>
+#include <mitsuba/core/sharedcache.h>
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/distr_2d.h>
 #include <mitsuba/render/interaction.h>
@@ -9,7 +12,19 @@
 #include <mitsuba/render/srgb.h>
 #include <drjit/tensor.h>
 #include <drjit/texture.h>
+#include <nanothread/nanothread.h>
+#include <atomic>
+#include <cstring>
+#include <map>
 #include <mutex>
+#include <numeric>
+#include <thread>
+
+#if defined(_WIN32)
+#  include <process.h>
+#else
+#  include <unistd.h>
+#endif
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -49,6 +64,25 @@ Bitmap texture (:monosp:`bitmap`)
      - ``nearest``: disable filtering and interpolation. In this mode, the plugin
        performs nearest neighbor lookups of texture values.
 
+     - ``trilinear``: build a MIP map pyramid and interpolate bilinearly
+       between the two levels whose resolution best matches the footprint of
+       the pixel in texture space.
+
+     - ``ewa``: build a MIP map pyramid and filter anisotropic footprints by
+       placing several Gaussian-weighted trilinear lookups along the major
+       axis of the footprint ellipse (an approximation of the elliptically
+       weighted average filter).
+
+     The footprint is derived from the ray differentials generated by the
+     sensor, hence primary rays benefit from the last two modes, while later
+     bounces perform bilinear lookups into the full resolution image.
+
+ * - max_anisotropy
+   - |float|
+   - Maximum eccentricity of the footprint ellipse considered by the ``ewa``
+     filter, which also bounds the number of lookups. More elongated
+     footprints are blurred along their minor axis. (Default: 8)
+
  * - wrap_mode
    - |string|
    - Controls the behavior of texture evaluations that fall outside of the
@@ -66,6 +100,27 @@ Bitmap texture (:monosp:`bitmap`)
      spectral upsampling) be disabled? You will want to enable this when working
      with bitmaps storing normal maps that use a linear encoding. (Default: false)
 
+ * - format
+   - |string|
+   - Specifies the precision of the texture data kept in memory. The following
+     options are currently available:
+
+     - ``float32`` (default): single precision floating point values.
+
+     - ``float16``: half precision floating point values.
+
+     - ``uint8``: 8-bit values, which are sRGB-encoded unless
+       :paramtype:`raw` is set. In spectral modes, the coefficients of
+       upsampled spectra are stored using ``float16`` instead.
+
+     - ``auto``: keep the precision of the input file, i.e. use ``uint8`` for
+       8-bit images, ``float16`` for half precision images, and ``float32``
+       otherwise.
+
+     Reduced precision formats decrease the memory usage and bandwidth of
+     lookups, but they can't be modified or differentiated, and
+     :paramtype:`accel` has no effect.
+
  * - to_uv
    - |transform|
    - Specifies an optional 3x3 transformation matrix that will be applied to UV
@@ -79,16 +134,55 @@ Bitmap texture (:monosp:`bitmap`)
      cause small differences as hardware interpolation methods typically have a
      loss of precision (not exactly 32-bit arithmetic). (Default: true)
 
+ * - spectral_cache
+   - |bool|
+   - In spectral modes, store the spectral coefficients of the texture in a
+     file next to the image (with the extension :monosp:`.spec`), which
+     subsequent loads read instead of decoding and upsampling the image. The
+     cache is recreated when the image is modified. (Default: false)
+
 This plugin provides a bitmap texture that performs interpolated lookups given
 a JPEG, PNG, OpenEXR, RGBE, TGA, or BMP input file.
 
+By default, the image data is converted to single precision floating point
+values, which quadruples the memory usage of 8-bit images. The
+:paramtype:`format` parameter keeps the data in a more compact form that is
+decoded during texture lookups.
+
+The MIP map pyramid used by the ``trilinear`` and ``ewa`` filters is built
+when the texture is loaded by repeatedly downsampling the image by a factor of
+two with a Lanczos filter. It increases the memory usage of the texture by
+roughly one third; the exact amount is reported in the log.
+
+Textures that load the same file with identical parameters share a single
+copy of the converted data in memory, which is common when materials are
+duplicated per object. The number of shared textures is reported in the log
+once the scene is loaded. A texture receives a private copy of the data when
+its parameters are exposed for modification (e.g. via :monosp:`mi.traverse()`).
+
+In JIT variants, scenes with many small textures can set the boolean
+``texture_atlas`` property of the scene (``<boolean name="texture_atlas"
+value="true"/>``). Textures with a resolution of up to
+``texture_atlas_max_size`` (an integer property of the scene, 256 by default)
+are then packed into shared atlases, grouped by their channel count and filter
+type. Each texture then only stores the index of its image, whose placement
+is looked up in a table shared by the atlas. Since all textures of an atlas
+generate the same code, the JIT compiler merges the virtual function calls of
+the materials referencing them, which reduces the size and compilation time of
+the rendering kernel. Textures using
+the ``trilinear`` or ``ewa`` filters or a reduced precision
+:paramtype:`format` are not packed. A texture whose data is modified
+afterwards reverts to its own copy of the data.
+
 When loading the plugin, the data is first converted into a usable color representation
 for the renderer:
 
 * In :monosp:`rgb` modes, sRGB textures are converted into a linear color space.
 * In :monosp:`spectral` modes, sRGB textures are *spectrally upsampled* to plausible
   smooth spectra :cite:`Jakob2019Spectral` and stored an intermediate representation
-  that enables efficient queries at render time.
+  that enables efficient queries at render time. The conversion is parallelized
+  over all cores, and its result can be cached on disk using the
+  :paramtype:`spectral_cache` parameter.
 * In :monosp:`monochrome` modes, sRGB textures are converted to grayscale.
 
 These conversions can alternatively be disabled with the :paramtype:`raw` flag,
@@ -112,6 +206,10 @@ at all.
 
 */
 
+/// Magic number and version of the on-disk cache of spectral coefficients
+static const char SpectralCacheMagic[4] = { 'M', 'I', 'S', 'P' };
+static const uint32_t SpectralCacheVersion = 1;
+
 template <typename Float, typename Spectrum>
 class BitmapTexture final : public Texture<Float, Spectrum> {
 public:
@@ -124,6 +222,7 @@ public:
 
         ref<Bitmap> bitmap = nullptr;
         TensorXf* tensor = nullptr;
+        fs::path file_path;
 
         if (props.has_property("bitmap")) {
             // Creates a Bitmap texture directly from an existing Bitmap object
@@ -139,10 +238,8 @@ public:
         } else if (props.has_property("filename")) {
             // Creates a Bitmap texture by loading an image from the filesystem
             FileResolver* fs = Thread::thread()->file_resolver();
-            fs::path file_path = fs->resolve(props.string("filename"));
+            file_path = fs->resolve(props.string("filename"));
             m_name = file_path.filename().string();
-            Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
-            bitmap = new Bitmap(file_path);
         } else if (props.has_property("data")) {
             tensor = props.tensor<TensorXf>("data");
             if (tensor->ndim() != 3)
@@ -154,14 +251,21 @@ public:
         }
 
         std::string filter_mode_str = props.string("filter_type", "bilinear");
-        dr::FilterMode filter_mode;
+        dr::FilterMode filter_mode = dr::FilterMode::Linear;
+        m_mip_filter = MIPFilter::None;
         if (filter_mode_str == "nearest")
             filter_mode = dr::FilterMode::Nearest;
-        else if (filter_mode_str == "bilinear")
-            filter_mode = dr::FilterMode::Linear;
-        else
-            Throw("Invalid filter type \"%s\", must be one of: \"nearest\", or "
-                  "\"bilinear\"!", filter_mode_str);
+        else if (filter_mode_str == "trilinear")
+            m_mip_filter = MIPFilter::Trilinear;
+        else if (filter_mode_str == "ewa")
+            m_mip_filter = MIPFilter::EWA;
+        else if (filter_mode_str != "bilinear")
+            Throw("Invalid filter type \"%s\", must be one of: \"nearest\", "
+                  "\"bilinear\", \"trilinear\", or \"ewa\"!", filter_mode_str);
+
+        m_max_anisotropy = props.get<ScalarFloat>("max_anisotropy", 8.f);
+        if (m_max_anisotropy < 1.f)
+            Throw("The \"max_anisotropy\" parameter must be >= 1!");
 
         std::string wrap_mode_str = props.string("wrap_mode", "repeat");
         typename dr::WrapMode wrap_mode;
@@ -179,15 +283,35 @@ public:
            (e.g. sRGB to linear, spectral upsampling, etc.) */
         m_raw = props.get<bool>("raw", false);
         m_accel = props.get<bool>("accel", true);
+        m_spectral_cache = props.get<bool>("spectral_cache", false);
+
+        std::string format_str = props.string("format", "float32");
+        bool auto_format = format_str == "auto";
+        if (format_str == "float32" || auto_format)
+            m_format = StorageFormat::Float32;
+        else if (format_str == "float16")
+            m_format = StorageFormat::Float16;
+        else if (format_str == "uint8")
+            m_format = StorageFormat::UInt8;
+        else
+            Throw("Invalid format \"%s\", must be one of: \"float32\", "
+                  "\"float16\", \"uint8\", or \"auto\"!", format_str);
+
+        m_storage = std::make_shared<Storage>();
 
         if (tensor) {
             Log(Debug, "Loading bitmap texture from tensor...");
+            if (m_format != StorageFormat::Float32)
+                Throw("Bitmap \"format\" must be \"float32\" when "
+                      "initializing using tensor data!");
             if (!m_raw)
                 Throw("Bitmap \"raw\" parameter must be `true` when "
                       "initializing using tensor data! Use a `Bitmap` "
                       "object or a file if transformation of color data is "
                       "required.");
-            m_texture = Texture2f(TensorXf(*tensor), m_accel, m_accel, filter_mode, wrap_mode);
+            m_storage->texture = Texture2f(TensorXf(*tensor), m_accel, m_accel, filter_mode, wrap_mode);
+            if (m_mip_filter != MIPFilter::None)
+                build_mipmap(base_bitmap().get(), wrap_mode, false);
             const size_t pixel_count = tensor->shape(1) * tensor->shape(0);
             const size_t ch_count = tensor->shape(2);
 
@@ -209,122 +333,70 @@ public:
             else
                 m_mean = dr::sum(tensor->array()) / pixel_count;
 
+        } else if (!file_path.empty()) {
+            /* Share the data with other instances that load the same file
+               using the same parameters. The size and modification time
+               ensure that a file which was overwritten since (e.g. between
+               two renders in the same session) is loaded again. */
+            std::string key = tfm::format(
+                "bitmap:%s:%s:%zu:%lld:%d:%d:%d:%d:%d:%s",
+                this->class_()->variant(), file_path.string(),
+                fs::file_size(file_path),
+                (long long) fs::last_write_time(file_path), (int) m_raw,
+                (int) m_accel, (int) filter_mode, (int) wrap_mode,
+                (int) m_mip_filter, format_str);
+
+            m_storage = SharedCache::get<Storage>(key, [&]() {
+                m_storage = std::make_shared<Storage>();
+                init_storage(nullptr, file_path, filter_mode, wrap_mode,
+                             auto_format);
+                return m_storage;
+            });
+            m_shared = true;
+            m_format = m_storage->format;
+            m_mean = m_storage->mean;
         } else {
-            /* Convert to linear RGB float bitmap, will be converted
-               into spectral profile coefficients below (in place) */
-            Bitmap::PixelFormat pixel_format = bitmap->pixel_format();
-            switch (pixel_format) {
-                case Bitmap::PixelFormat::Y:
-                case Bitmap::PixelFormat::YA:
-                    pixel_format = Bitmap::PixelFormat::Y;
-                    break;
-
-                case Bitmap::PixelFormat::RGB:
-                case Bitmap::PixelFormat::RGBA:
-                case Bitmap::PixelFormat::XYZ:
-                case Bitmap::PixelFormat::XYZA:
-                    pixel_format = Bitmap::PixelFormat::RGB;
-                    break;
-
-                default:
-                    Throw("The texture needs to have a known pixel "
-                          "format (Y[A], RGB[A], XYZ[A] are supported).");
-            }
-
-            if (m_raw) {
-                /* Don't undo gamma correction in the conversion below.
-                   This is needed, e.g., for normal maps. */
-                bitmap->set_srgb_gamma(false);
-            }
-
-            // Convert the image into the working floating point representation
-            bitmap =
-                bitmap->convert(pixel_format, struct_type_v<ScalarFloat>, false);
-
-            if (dr::any(bitmap->size() < 2)) {
-                Log(Warn,
-                    "Image must be at least 2x2 pixels in size, up-sampling..");
-                using ReconstructionFilter = Bitmap::ReconstructionFilter;
-                ref<ReconstructionFilter> rfilter =
-                    PluginManager::instance()->create_object<ReconstructionFilter>(
-                        Properties("tent"));
-                bitmap =
-                    bitmap->resample(dr::maximum(bitmap->size(), 2), rfilter);
-            }
-
-            ScalarFloat *ptr = (ScalarFloat *) bitmap->data();
-            size_t pixel_count = bitmap->pixel_count();
-            bool exceed_unit_range = false;
-
-            double mean = 0.0;
-            if (bitmap->channel_count() == 3) {
-                if (is_spectral_v<Spectrum> && !m_raw) {
-                    for (size_t i = 0; i < pixel_count; ++i) {
-                        ScalarColor3f value = dr::load<ScalarColor3f>(ptr);
-                        if (!all(value >= 0 && value <= 1))
-                            exceed_unit_range = true;
-                        value = srgb_model_fetch(value);
-                        mean += (double) srgb_model_mean(value);
-                        dr::store(ptr, value);
-                        ptr += 3;
-                    }
-                } else {
-                    for (size_t i = 0; i < pixel_count; ++i) {
-                        ScalarColor3f value = dr::load<ScalarColor3f>(ptr);
-                        if (!all(value >= 0 && value <= 1))
-                            exceed_unit_range = true;
-                        mean += (double) luminance(value);
-                        ptr += 3;
-                    }
-                }
-            } else if (bitmap->channel_count() == 1) {
-                for (size_t i = 0; i < pixel_count; ++i) {
-                    ScalarFloat value = ptr[i];
-                    if (!(value >= 0 && value <= 1))
-                        exceed_unit_range = true;
-                    mean += (double) value;
-                }
-            } else {
-                Throw("Unsupported channel count: %d (expected 1 or 3)",
-                      bitmap->channel_count());
-            }
-
-            if (exceed_unit_range && !m_raw)
-                Log(Warn,
-                    "BitmapTexture: texture named \"%s\" contains pixels that "
-                    "exceed the [0, 1] range!",
-                    m_name);
-
-            m_mean = Float(mean / pixel_count);
-
-            size_t channels = bitmap->channel_count();
-            ScalarVector2i res = ScalarVector2i(bitmap->size());
-            size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), channels };
-            m_texture = Texture2f(TensorXf(bitmap->data(), 3, shape), m_accel,
-                                  m_accel, filter_mode, wrap_mode);
+            init_storage(bitmap, fs::path(), filter_mode, wrap_mode,
+                         auto_format);
         }
     }
 
     void traverse(TraversalCallback *callback) override {
-        callback->put_parameter("data",  m_texture.tensor(), +ParamFlags::Differentiable);
+        // Data stored in reduced precision can't be updated
+        if (m_format == StorageFormat::Float32) {
+            // The data may be modified through the callback
+            detach_storage();
+            callback->put_parameter("data",  m_storage->texture.tensor(), +ParamFlags::Differentiable);
+        }
         callback->put_parameter("to_uv", m_transform,        +ParamFlags::NonDifferentiable);
     }
 
     void
     parameters_changed(const std::vector<std::string> &keys = {}) override {
-        if (keys.empty() || string::contains(keys, "data")) {
-            const size_t channels = m_texture.shape()[2];
+        if (m_format == StorageFormat::Float32 &&
+            (keys.empty() || string::contains(keys, "data"))) {
+            const size_t channels = m_storage->texture.shape()[2];
             if (channels != 1 && channels != 3)
                 Throw("parameters_changed(): The bitmap texture %s was changed "
                       "to have %d channels, only textures with 1 or 3 channels "
                       "are supported!",
                       to_string(), channels);
-            else if (m_texture.shape()[0] < 2 || m_texture.shape()[1] < 2)
+            else if (m_storage->texture.shape()[0] < 2 || m_storage->texture.shape()[1] < 2)
                 Throw("parameters_changed(): The bitmap texture %s was changed,"
                       " it must be at least 2x2 pixels in size!",
                       to_string());
 
-            m_texture.set_tensor(m_texture.tensor());
+            m_storage->texture.set_tensor(m_storage->texture.tensor());
+
+            // The atlas holds a copy of the previous data
+            m_atlas = nullptr;
+
+            /* Rebuild the pyramid from the new data. In spectral modes, the
+               data consists of spectral coefficients that are downsampled
+               directly, which is only an approximation. */
+            if (m_mip_filter != MIPFilter::None)
+                build_mipmap(base_bitmap().get(), m_storage->texture.wrap_mode(), false);
+
             rebuild_internals(true, m_distr2d != nullptr);
         }
     }
@@ -333,7 +405,7 @@ public:
                              Mask active) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = channel_count();
         if (channels == 3 && is_spectral_v<Spectrum> && m_raw) {
             DRJIT_MARK_USED(si);
             Throw("The bitmap texture %s was queried for a spectrum, but "
@@ -367,7 +439,7 @@ public:
                  Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = channel_count();
         if (channels == 3 && is_spectral_v<Spectrum> && !m_raw) {
             DRJIT_MARK_USED(si);
             Throw("eval_1(): The bitmap texture %s was queried for a "
@@ -389,7 +461,7 @@ public:
                          Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = channel_count();
         if (channels == 3 && is_spectral_v<Spectrum> && !m_raw) {
             DRJIT_MARK_USED(si);
             Throw(
@@ -401,7 +473,7 @@ public:
             if (dr::none_or<false>(active))
                 return dr::zeros<Vector2f>();
 
-            if (m_texture.filter_mode() == dr::FilterMode::Linear) {
+            if (filter_mode() == dr::FilterMode::Linear) {
                 if constexpr (!dr::is_array_v<Mask>)
                     active = true;
 
@@ -415,10 +487,9 @@ public:
                     fetch_values[2] = &f01;
                     fetch_values[3] = &f11;
 
-                    if (m_accel)
-                        m_texture.eval_fetch(uv, fetch_values, active);
-                    else
-                        m_texture.eval_fetch_nonaccel(uv, fetch_values, active);
+                    dispatch_texture([&](const auto &texture) {
+                        fetch_texture(texture, uv, fetch_values, active);
+                    });
                 } else { // 3 channels
                     Color3f v00, v10, v01, v11;
                     dr::Array<Float *, 4> fetch_values;
@@ -427,10 +498,9 @@ public:
                     fetch_values[2] = v01.data();
                     fetch_values[3] = v11.data();
 
-                    if (m_accel)
-                        m_texture.eval_fetch(uv, fetch_values, active);
-                    else
-                        m_texture.eval_fetch_nonaccel(uv, fetch_values, active);
+                    dispatch_texture([&](const auto &texture) {
+                        fetch_texture(texture, uv, fetch_values, active);
+                    });
 
                     f00 = luminance(v00);
                     f10 = luminance(v10);
@@ -468,7 +538,7 @@ public:
                    Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = channel_count();
         if (channels != 3) {
             DRJIT_MARK_USED(si);
             Throw("eval_3(): The bitmap texture %s was queried for a RGB "
@@ -501,13 +571,13 @@ public:
         ScalarVector2i res = resolution();
         ScalarVector2f inv_resolution = dr::rcp(ScalarVector2f(res));
 
-        if (m_texture.filter_mode() == dr::FilterMode::Nearest) {
+        if (filter_mode() == dr::FilterMode::Nearest) {
             sample2 = (Point2f(pos) + sample2) * inv_resolution;
         } else {
             sample2 = (Point2f(pos) + 0.5f + warp::square_to_tent(sample2)) *
                       inv_resolution;
 
-            switch (m_texture.wrap_mode()) {
+            switch (wrap_mode()) {
                 case dr::WrapMode::Repeat:
                     sample2[sample2 < 0.f] += 1.f;
                     sample2[sample2 > 1.f] -= 1.f;
@@ -536,7 +606,7 @@ public:
             init_distr();
 
         ScalarVector2i res = resolution();
-        if (m_texture.filter_mode() == dr::FilterMode::Linear) {
+        if (filter_mode() == dr::FilterMode::Linear) {
             // Scale to bitmap resolution and apply shift
             Point2f uv = dr::fmadd(pos_, res, -.5f);
 
@@ -547,13 +617,13 @@ public:
             Point2f w1 = uv - Point2f(uv_i),
                     w0 = 1.f - w1;
 
-            Float v00 = m_distr2d->pdf(m_texture.wrap(uv_i + Point2i(0, 0)),
+            Float v00 = m_distr2d->pdf(wrap(uv_i + Point2i(0, 0)),
                                        active),
-                  v10 = m_distr2d->pdf(m_texture.wrap(uv_i + Point2i(1, 0)),
+                  v10 = m_distr2d->pdf(wrap(uv_i + Point2i(1, 0)),
                                        active),
-                  v01 = m_distr2d->pdf(m_texture.wrap(uv_i + Point2i(0, 1)),
+                  v01 = m_distr2d->pdf(wrap(uv_i + Point2i(0, 1)),
                                        active),
-                  v11 = m_distr2d->pdf(m_texture.wrap(uv_i + Point2i(1, 1)),
+                  v11 = m_distr2d->pdf(wrap(uv_i + Point2i(1, 1)),
                                        active);
 
             Float v0 = dr::fmadd(w0.x(), v00, w1.x() * v10),
@@ -565,7 +635,7 @@ public:
             Point2f uv = pos_ * res;
 
             // Integer pixel positions for nearest-neighbor interpolation
-            Vector2i uv_i = m_texture.wrap(dr::floor2int<Vector2i>(uv));
+            Vector2i uv_i = wrap(dr::floor2int<Vector2i>(uv));
 
             return m_distr2d->pdf(uv_i, active) * dr::prod(res);
         }
@@ -592,7 +662,9 @@ public:
     }
 
     ScalarVector2i resolution() const override {
-        const size_t *shape = m_texture.shape();
+        const size_t *shape = dispatch_texture([](const auto &texture) {
+            return texture.shape();
+        });
         return { (int) shape[1], (int) shape[0] };
     }
 
@@ -600,20 +672,315 @@ public:
 
     bool is_spatially_varying() const override { return true; }
 
+    bool needs_differentials() const override {
+        return m_mip_filter != MIPFilter::None;
+    }
+
+    std::vector<size_t> pack_atlas(const std::vector<Texture *> &textures,
+                                   size_t index, uint32_t max_size) override {
+        std::vector<size_t> processed = { index };
+        if (!atlas_candidate(max_size))
+            return processed;
+
+        // Gather compatible textures, which must share the atlas' sampler
+        std::vector<BitmapTexture *> group = { this };
+        for (size_t i = index + 1; i < textures.size(); ++i) {
+            BitmapTexture *other = dynamic_cast<BitmapTexture *>(textures[i]);
+            if (other && other->atlas_candidate(max_size) &&
+                other->channel_count() == channel_count() &&
+                other->filter_mode() == filter_mode() &&
+                other->m_accel == m_accel) {
+                group.push_back(other);
+                processed.push_back(i);
+            }
+        }
+
+        if (group.size() < 2)
+            return processed;
+
+        /* Each distinct image (textures may share their storage) occupies a
+           rectangle of the atlas. It is surrounded by a border of one texel
+           that replicates the wrap mode, so that filtered lookups near the
+           edges don't pick up data of neighboring images. */
+        struct Slot {
+            Storage *storage;
+            dr::WrapMode wrap_mode;
+            ScalarVector2u size, pos;
+        };
+
+        std::vector<Slot> slots;
+        std::vector<uint32_t> slot_index(group.size());
+        std::map<std::pair<Storage *, dr::WrapMode>, uint32_t> slot_map;
+        for (size_t i = 0; i < group.size(); ++i) {
+            Storage *storage = group[i]->m_storage.get();
+            dr::WrapMode wrap_mode = group[i]->wrap_mode();
+            auto [it, inserted] = slot_map.try_emplace(
+                { storage, wrap_mode }, (uint32_t) slots.size());
+            if (inserted)
+                slots.push_back({ storage, wrap_mode,
+                                  ScalarVector2u(group[i]->resolution()),
+                                  ScalarVector2u(0) });
+            slot_index[i] = it->second;
+        }
+
+        // Shelf packing, in order of decreasing height
+        uint64_t area = 0;
+        uint32_t max_width = 0;
+        for (const Slot &slot : slots) {
+            area += (uint64_t) (slot.size.x() + 2) * (slot.size.y() + 2);
+            max_width = std::max(max_width, slot.size.x() + 2);
+        }
+        uint32_t width_limit =
+            std::max(max_width, (uint32_t) std::ceil(std::sqrt((double) area)));
+
+        std::vector<size_t> order(slots.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return slots[a].size.y() > slots[b].size.y();
+        });
+
+        uint32_t x = 0, y = 0, shelf_height = 0, atlas_width = 0;
+        for (size_t i : order) {
+            Slot &slot = slots[i];
+            if (x + slot.size.x() + 2 > width_limit) {
+                x = 0;
+                y += shelf_height;
+                shelf_height = 0;
+            }
+            slot.pos = ScalarVector2u(x, y);
+            x += slot.size.x() + 2;
+            shelf_height = std::max(shelf_height, slot.size.y() + 2);
+            atlas_width = std::max(atlas_width, x);
+        }
+        ScalarVector2u atlas_res(atlas_width, y + shelf_height);
+
+        // Copy the images (including their borders) into the atlas
+        size_t channels = channel_count();
+        std::unique_ptr<ScalarFloat[]> data(
+            new ScalarFloat[(size_t) atlas_res.x() * atlas_res.y() * channels]());
+
+        for (const Slot &slot : slots) {
+            auto &&values = dr::migrate(slot.storage->texture.tensor().array(),
+                                        AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+            const ScalarFloat *src = values.data();
+
+            int w = (int) slot.size.x(), h = (int) slot.size.y();
+            auto border = [&](int i, int n) {
+                // Texel -1 and n are only accessed by filtered lookups
+                if (slot.wrap_mode == dr::WrapMode::Repeat)
+                    return (i + n) % n;
+                else // Clamp and Mirror
+                    return std::clamp(i, 0, n - 1);
+            };
+
+            for (int ty = -1; ty <= h; ++ty) {
+                ScalarFloat *dst = data.get() +
+                    ((size_t) (slot.pos.y() + 1 + ty) * atlas_res.x() + slot.pos.x()) * channels;
+                for (int tx = -1; tx <= w; ++tx) {
+                    const ScalarFloat *texel =
+                        src + ((size_t) border(ty, h) * w + border(tx, w)) * channels;
+                    std::memcpy(dst, texel, sizeof(ScalarFloat) * channels);
+                    dst += channels;
+                }
+            }
+        }
+
+        // Scale and offset of each image within the atlas
+        std::vector<ScalarFloat> rects(slots.size() * 4);
+        for (size_t i = 0; i < slots.size(); ++i) {
+            ScalarVector2f res(atlas_res),
+                           scale = ScalarVector2f(slots[i].size) / res,
+                           offset = (ScalarVector2f(slots[i].pos) + 1.f) / res;
+            rects[i * 4 + 0] = scale.x();
+            rects[i * 4 + 1] = scale.y();
+            rects[i * 4 + 2] = offset.x();
+            rects[i * 4 + 3] = offset.y();
+        }
+
+        size_t shape[3] = { atlas_res.y(), atlas_res.x(), channels };
+        std::shared_ptr<Storage> atlas = std::make_shared<Storage>();
+        atlas->texture = Texture2f(TensorXf(data.get(), 3, shape), m_accel,
+                                   m_accel, filter_mode(), dr::WrapMode::Clamp);
+        atlas->atlas_rects = dr::load<FloatStorage>(rects.data(), rects.size());
+
+        for (size_t i = 0; i < group.size(); ++i) {
+            BitmapTexture *texture = group[i];
+            texture->m_atlas = atlas;
+            texture->m_atlas_wrap = slots[slot_index[i]].wrap_mode;
+            texture->m_atlas_index = slot_index[i];
+            dr::make_opaque(texture->m_atlas_index);
+        }
+
+        Log(Debug, "Packed %zu bitmap textures (%zu distinct images) into a "
+            "%ux%u atlas.", group.size(), slots.size(), atlas_res.x(),
+            atlas_res.y());
+        return processed;
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "BitmapTexture[" << std::endl
             << "  name = \"" << m_name << "\"," << std::endl
             << "  resolution = \"" << resolution() << "\"," << std::endl
             << "  raw = " << (int) m_raw << "," << std::endl
-            << "  mean = " << m_mean << "," << std::endl
-            << "  transform = " << string::indent(m_transform) << std::endl
+            << "  mean = " << m_mean << "," << std::endl;
+        if (m_format != StorageFormat::Float32)
+            oss << "  format = " << (m_format == StorageFormat::UInt8 ? "uint8" : "float16")
+                << "," << std::endl
+                << "  memory = " << util::mem_string(m_storage->packed.bytes()) << "," << std::endl;
+        if (m_mip_filter != MIPFilter::None)
+            oss << "  mip_levels = " << mip_level_count() << "," << std::endl
+                << "  mip_memory = " << util::mem_string(m_storage->mip_chain.bytes()) << "," << std::endl;
+        if (m_atlas)
+            oss << "  atlas = " << m_atlas->texture.shape()[1] << "x"
+                << m_atlas->texture.shape()[0] << "," << std::endl;
+        oss << "  transform = " << string::indent(m_transform) << std::endl
             << "]";
         return oss.str();
     }
 
     MI_DECLARE_CLASS()
 
+protected:
+    void eval_1_batch_impl(const Texture *const *textures, size_t count,
+                           size_t index, uint64_t &pending,
+                           const SurfaceInteraction3f &si, Float *out,
+                           Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        /* JIT variants already evaluate each lookup for many shading points
+           at once, fusing the fetches would not reduce the work there */
+        if constexpr (dr::is_jit_v<Float>) {
+            Texture::eval_1_batch_impl(textures, count, index, pending, si,
+                                       out, active);
+        } else {
+            if (!batch_compatible(this)) {
+                Texture::eval_1_batch_impl(textures, count, index, pending,
+                                           si, out, active);
+                return;
+            }
+
+            // Texel positions and filter weights shared by all fused textures
+            const size_t *shape = m_storage->texture.shape();
+            ScalarVector2i res = { (int) shape[1], (int) shape[0] };
+            Point2f uv = m_transform.transform_affine(si.uv);
+
+            UInt32 offset[4];
+            Float weight[4];
+            size_t taps;
+            if (filter_mode() == dr::FilterMode::Linear) {
+                uv = dr::fmadd(uv, res, -.5f);
+                Vector2i uv_i = dr::floor2int<Vector2i>(uv);
+                Point2f w1 = uv - Point2f(uv_i), w0 = 1.f - w1;
+
+                const ScalarVector2i corner[4] = { { 0, 0 }, { 1, 0 },
+                                                   { 0, 1 }, { 1, 1 } };
+                for (size_t k = 0; k < 4; ++k) {
+                    Vector2i p = wrap(uv_i + corner[k]);
+                    offset[k] = UInt32(dr::fmadd(p.y(), res.x(), p.x()));
+                }
+                weight[0] = w0.x() * w0.y();
+                weight[1] = w1.x() * w0.y();
+                weight[2] = w0.x() * w1.y();
+                weight[3] = w1.x() * w1.y();
+                taps = 4;
+            } else {
+                Vector2i p = wrap(dr::floor2int<Vector2i>(uv * res));
+                offset[0] = UInt32(dr::fmadd(p.y(), res.x(), p.x()));
+                weight[0] = 1.f;
+                taps = 1;
+            }
+
+            for (size_t i = index; i < count; ++i) {
+                if (!(pending & (1ull << i)))
+                    continue;
+
+                const BitmapTexture *other =
+                    i == index ? this : dynamic_cast<const BitmapTexture *>(textures[i]);
+                if (!other || !batch_compatible(other))
+                    continue;
+
+                const ScalarFloat *data = other->m_storage->texture.value().data();
+                size_t channels = other->channel_count();
+
+                Float value = 0.f;
+                if (dr::any_or<true>(active)) {
+                    for (size_t k = 0; k < taps; ++k) {
+                        const ScalarFloat *texel = data + offset[k] * channels;
+                        Float v = channels == 1
+                                      ? Float(texel[0])
+                                      : luminance(Color3f(texel[0], texel[1], texel[2]));
+                        value = dr::fmadd(weight[k], v, value);
+                    }
+                }
+
+                out[i] = value;
+                pending &= ~(1ull << i);
+            }
+        }
+    }
+
+    /// Can this texture be packed into an atlas by \ref pack_atlas()?
+    bool atlas_candidate(uint32_t max_size) const {
+        ScalarVector2i res = resolution();
+        return !m_atlas && m_format == StorageFormat::Float32 &&
+               m_mip_filter == MIPFilter::None &&
+               res.x() <= (int) max_size && res.y() <= (int) max_size;
+    }
+
+    /**
+     * \brief Map texture coordinates (after \ref m_transform) to the
+     * coordinates of the image within its atlas
+     *
+     * The atlas is sampled in clamp mode, hence the wrap mode of the texture
+     * is applied here. The placement of the image is fetched from the table
+     * of the atlas using \ref m_atlas_index.
+     */
+    MI_INLINE Point2f atlas_uv(Point2f uv, Mask active) const {
+        switch (m_atlas_wrap) {
+            case dr::WrapMode::Repeat:
+                uv -= dr::floor(uv);
+                break;
+
+            case dr::WrapMode::Clamp:
+                uv = dr::clamp(uv, 0.f, 1.f);
+                break;
+
+            default: // Mirror
+                uv = 1.f - dr::abs(dr::fnmadd(2.f, dr::floor(.5f * uv), uv) - 1.f);
+                break;
+        }
+        Vector4f rect = dr::gather<Vector4f>(m_atlas->atlas_rects,
+                                             m_atlas_index, active);
+        return dr::fmadd(uv, Point2f(rect.x(), rect.y()),
+                         Point2f(rect.z(), rect.w()));
+    }
+
+    /**
+     * \brief Can \c other be evaluated along with this texture by \ref
+     * eval_1_batch_impl()?
+     *
+     * This requires identical sampling parameters and single precision
+     * storage without a MIP pyramid.
+     */
+    bool batch_compatible(const BitmapTexture *other) const {
+        if (other->m_format != StorageFormat::Float32 ||
+            other->m_mip_filter != MIPFilter::None ||
+            (is_spectral_v<Spectrum> && !other->m_raw &&
+             other->channel_count() == 3))
+            return false;
+
+        if (other == this)
+            return m_format == StorageFormat::Float32;
+
+        return other->resolution() == resolution() &&
+               other->filter_mode() == filter_mode() &&
+               other->wrap_mode() == wrap_mode() &&
+               other->m_transform == m_transform;
+    }
+
 protected:
     /**
      * \brief Evaluates the texture at the given surface interaction using
@@ -626,7 +993,83 @@ protected:
 
         Point2f uv = m_transform.transform_affine(si.uv);
 
-        if (m_texture.filter_mode() == dr::FilterMode::Linear) {
+        if (m_mip_filter != MIPFilter::None)
+            return filter_footprint<UnpolarizedSpectrum>(
+                si, uv, active,
+                [&](const auto &texture, const Point2f &p, Mask a) {
+                    return lookup_spectral(texture, p, si.wavelengths, a);
+                });
+
+        if (m_atlas)
+            return lookup_spectral(m_atlas->texture, atlas_uv(uv, active),
+                                   si.wavelengths, active);
+
+        return dispatch_texture([&](const auto &texture) {
+            return lookup_spectral(texture, uv, si.wavelengths, active);
+        });
+    }
+
+    /**
+     * \brief Evaluates the texture at the given surface interaction
+     *
+     * Should only be used when the texture has exactly 1 channel.
+     */
+    MI_INLINE Float interpolate_1(const SurfaceInteraction3f &si,
+                                   Mask active) const {
+        if constexpr (!dr::is_array_v<Mask>)
+            active = true;
+
+        Point2f uv = m_transform.transform_affine(si.uv);
+
+        if (m_mip_filter != MIPFilter::None)
+            return filter_footprint<Float>(
+                si, uv, active,
+                [&](const auto &texture, const Point2f &p, Mask a) {
+                    return lookup_1(texture, p, a);
+                });
+
+        if (m_atlas)
+            return lookup_1(m_atlas->texture, atlas_uv(uv, active), active);
+
+        return dispatch_texture([&](const auto &texture) {
+            return lookup_1(texture, uv, active);
+        });
+    }
+
+    /**
+     * \brief Evaluates the texture at the given surface interaction
+     *
+     * Should only be used when the texture has exactly 3 channels.
+     */
+    MI_INLINE Color3f interpolate_3(const SurfaceInteraction3f &si,
+                                     Mask active) const {
+        if constexpr (!dr::is_array_v<Mask>)
+            active = true;
+
+        Point2f uv = m_transform.transform_affine(si.uv);
+
+        if (m_mip_filter != MIPFilter::None)
+            return filter_footprint<Color3f>(
+                si, uv, active,
+                [&](const auto &texture, const Point2f &p, Mask a) {
+                    return lookup_3(texture, p, a);
+                });
+
+        if (m_atlas)
+            return lookup_3(m_atlas->texture, atlas_uv(uv, active), active);
+
+        return dispatch_texture([&](const auto &texture) {
+            return lookup_3(texture, uv, active);
+        });
+    }
+
+    /// Spectrally upsampled lookup into one level of the texture
+    template <typename Tex>
+    MI_INLINE UnpolarizedSpectrum lookup_spectral(const Tex &texture,
+                                                  Point2f uv,
+                                                  const Wavelength &wavelengths,
+                                                  Mask active) const {
+        if (texture.filter_mode() == dr::FilterMode::Linear) {
             Color3f v00, v10, v01, v11;
             dr::Array<Float *, 4> fetch_values;
             fetch_values[0] = v00.data();
@@ -634,19 +1077,15 @@ protected:
             fetch_values[2] = v01.data();
             fetch_values[3] = v11.data();
 
-            if (m_accel)
-                m_texture.eval_fetch(uv, fetch_values, active);
-            else
-                m_texture.eval_fetch_nonaccel(uv, fetch_values, active);
+            fetch_texture(texture, uv, fetch_values, active);
 
             UnpolarizedSpectrum c00, c10, c01, c11, c0, c1;
-            c00 = srgb_model_eval<UnpolarizedSpectrum>(v00, si.wavelengths);
-            c10 = srgb_model_eval<UnpolarizedSpectrum>(v10, si.wavelengths);
-            c01 = srgb_model_eval<UnpolarizedSpectrum>(v01, si.wavelengths);
-            c11 = srgb_model_eval<UnpolarizedSpectrum>(v11, si.wavelengths);
+            c00 = srgb_model_eval<UnpolarizedSpectrum>(v00, wavelengths);
+            c10 = srgb_model_eval<UnpolarizedSpectrum>(v10, wavelengths);
+            c01 = srgb_model_eval<UnpolarizedSpectrum>(v01, wavelengths);
+            c11 = srgb_model_eval<UnpolarizedSpectrum>(v11, wavelengths);
 
-            ScalarVector2i res = resolution();
-            uv = dr::fmadd(uv, res, -.5f);
+            uv = dr::fmadd(uv, texel_resolution(texture, active), -.5f);
             Vector2i uv_i = dr::floor2int<Vector2i>(uv);
 
             // Interpolation weights
@@ -658,55 +1097,627 @@ protected:
             return dr::fmadd(w0.y(), c0, w1.y() * c1);
         } else {
             Color3f out;
-            if (m_accel)
-                m_texture.eval(uv, out.data(), active);
+            eval_texture(texture, uv, out.data(), active);
+            return srgb_model_eval<UnpolarizedSpectrum>(out, wavelengths);
+        }
+    }
+
+    /// Resolution of the given texture or level of the MIP pyramid
+    template <typename Tex>
+    MI_INLINE Vector2f texel_resolution(const Tex &texture,
+                                        const Mask &active) const {
+        if constexpr (std::is_same_v<Tex, MIPLevel>) {
+            return Vector2f(texture.chain.resolution(texture.level, active));
+        } else {
+            DRJIT_MARK_USED(active);
+            const size_t *shape = texture.shape();
+            return Vector2f((ScalarFloat) shape[1], (ScalarFloat) shape[0]);
+        }
+    }
+
+    /// Single-channel lookup into one level of the texture
+    template <typename Tex>
+    MI_INLINE Float lookup_1(const Tex &texture, const Point2f &uv,
+                             Mask active) const {
+        Float out;
+        eval_texture(texture, uv, &out, active);
+        return out;
+    }
+
+    /// RGB lookup into one level of the texture
+    template <typename Tex>
+    MI_INLINE Color3f lookup_3(const Tex &texture, const Point2f &uv,
+                               Mask active) const {
+        Color3f out;
+        eval_texture(texture, uv, out.data(), active);
+        return out;
+    }
+
+    /// Interpolated lookup into a texture, optionally using hardware acceleration
+    template <typename Tex>
+    MI_INLINE void eval_texture(const Tex &texture, const Point2f &uv,
+                                Float *out, Mask active) const {
+        if (m_accel)
+            texture.eval(uv, out, active);
+        else
+            texture.eval_nonaccel(uv, out, active);
+    }
+
+    /// Fetch the texels surrounding a position, optionally using hardware acceleration
+    template <typename Tex>
+    MI_INLINE void fetch_texture(const Tex &texture, const Point2f &uv,
+                                 dr::Array<Float *, 4> &out, Mask active) const {
+        if (m_accel)
+            texture.eval_fetch(uv, out, active);
+        else
+            texture.eval_fetch_nonaccel(uv, out, active);
+    }
+
+    /**
+     * \brief Invoke \c func with the full resolution image
+     *
+     * The function receives either a \c Texture2f or a \ref PackedTexture
+     * depending on the storage format.
+     */
+    template <typename Func>
+    MI_INLINE decltype(auto) dispatch_texture(const Func &func) const {
+        if (m_format == StorageFormat::Float32)
+            return func(m_storage->texture);
+        else
+            return func(m_storage->packed);
+    }
+
+    /// Return the number of levels of the MIP pyramid
+    MI_INLINE size_t mip_level_count() const {
+        return 1 + m_storage->mip_chain.level_count();
+    }
+
+    MI_INLINE size_t channel_count() const {
+        return dispatch_texture([](const auto &texture) {
+            return texture.shape()[2];
+        });
+    }
+
+    MI_INLINE dr::FilterMode filter_mode() const {
+        return dispatch_texture([](const auto &texture) {
+            return texture.filter_mode();
+        });
+    }
+
+    MI_INLINE dr::WrapMode wrap_mode() const {
+        return dispatch_texture([](const auto &texture) {
+            return texture.wrap_mode();
+        });
+    }
+
+    template <typename T> MI_INLINE Vector2i wrap(const T &pos) const {
+        return dispatch_texture([&](const auto &texture) {
+            return Vector2i(texture.wrap(dr::Array<Int32, 2>(pos)));
+        });
+    }
+
+    /**
+     * \brief Filter the texture over the footprint of the pixel that
+     * produced \c si using the MIP pyramid
+     *
+     * The footprint is given by the UV partials of the interaction. When they
+     * are unavailable (i.e. zero), this reduces to a bilinear lookup into the
+     * full resolution image.
+     */
+    template <typename Value, typename Lookup>
+    Value filter_footprint(const SurfaceInteraction3f &si, const Point2f &uv,
+                           Mask active, const Lookup &lookup) const {
+        ScalarVector2f res = ScalarVector2f(resolution());
+
+        // Footprint axes in units of texels of the full resolution image
+        Vector2f dx = m_transform.transform_affine(si.duv_dx) * res,
+                 dy = m_transform.transform_affine(si.duv_dy) * res;
+        Float len_x = dr::norm(dx),
+              len_y = dr::norm(dy);
+
+        if (m_mip_filter == MIPFilter::Trilinear)
+            return trilinear<Value>(uv, dr::maximum(len_x, len_y), active, lookup);
+
+        Vector2f major = dr::select(len_x > len_y, dx, dy);
+        Float len_major = dr::maximum(len_x, len_y),
+              len_minor = dr::minimum(len_x, len_y);
+
+        /* Clamp the eccentricity of the ellipse, which bounds the number of
+           taps at the cost of additional blur along the minor axis */
+        len_minor = dr::maximum(len_minor, len_major / m_max_anisotropy);
+
+        uint32_t max_taps = (uint32_t) dr::ceil(m_max_anisotropy);
+        UInt32 tap_count = dr::clamp(
+            dr::ceil2int<UInt32>(len_major / dr::maximum(len_minor, 1e-8f)),
+            1u, max_taps);
+        Float inv_tap_count = dr::rcp(Float(tap_count));
+        Vector2f major_uv = major / res;
+
+        Value result = dr::zeros<Value>();
+        Float weight_sum = 0.f;
+        for (uint32_t i = 0; i < max_taps; ++i) {
+            Mask active_i = active && (tap_count > i);
+            if (dr::none_or<false>(active_i))
+                break;
+
+            // Position of the tap along the major axis in [-1, 1]
+            Float t = dr::fmadd(Float(2 * i + 1), inv_tap_count, -1.f);
+
+            // Gaussian weight as used by the EWA filter (alpha = 2)
+            Float weight = dr::select(active_i, dr::exp(-2.f * dr::sqr(t)), 0.f);
+
+            result += weight * trilinear<Value>(dr::fmadd(major_uv, t, uv),
+                                                len_minor, active_i, lookup);
+            weight_sum += weight;
+        }
+
+        return result * dr::select(weight_sum > 0.f, dr::rcp(weight_sum), 0.f);
+    }
+
+    /**
+     * \brief Interpolate between the two pyramid levels that best match a
+     * footprint of the given width (in texels of the full resolution image)
+     */
+    template <typename Value, typename Lookup>
+    Value trilinear(const Point2f &uv, const Float &width, Mask active,
+                    const Lookup &lookup) const {
+        uint32_t level_count = (uint32_t) mip_level_count();
+
+        Float level = dr::clamp(dr::log2(dr::maximum(width, 1e-8f)), 0.f,
+                                (ScalarFloat) (level_count - 1)),
+              level_floor = dr::floor(level),
+              t = level - level_floor;
+        UInt32 level_0 = UInt32(level_floor);
+
+        /* The full resolution image is stored separately from the coarse
+           levels, hence the finer of the two levels is fetched from either
+           one of them. Every lane only gathers from its two levels. */
+        Mask fine_full = active && dr::eq(level_0, 0u),
+             fine_chain = active && !fine_full;
+
+        Value fine = dr::zeros<Value>();
+        if (dr::any_or<true>(fine_full))
+            fine = dispatch_texture([&](const auto &texture) {
+                return lookup(texture, uv, fine_full);
+            });
+
+        if (level_count == 1)
+            return fine;
+
+        const MIPChain &chain = m_storage->mip_chain;
+        if (dr::any_or<true>(fine_chain))
+            fine = dr::select(
+                fine_chain,
+                lookup(MIPLevel{ chain, dr::select(fine_full, UInt32(0), level_0 - 1u) },
+                       uv, fine_chain),
+                fine);
+
+        // Level 'level_0 + 1' has index 'level_0' in the chain
+        Mask coarse_active = active && t > 0.f;
+        Value coarse = dr::zeros<Value>();
+        if (dr::any_or<true>(coarse_active))
+            coarse = lookup(MIPLevel{ chain, dr::minimum(level_0, level_count - 2) },
+                            uv, coarse_active);
+
+        return fine * (1.f - t) + coarse * t;
+    }
+
+    /**
+     * \brief Initialize \ref m_storage from the given bitmap, converting
+     * it into the representation used by the current variant
+     *
+     * When \c bitmap is \c nullptr, the image is loaded from \c file_path
+     * unless its spectral coefficients are found in the on-disk cache.
+     */
+    void init_storage(ref<Bitmap> bitmap, const fs::path &file_path,
+                      dr::FilterMode filter_mode, dr::WrapMode wrap_mode,
+                      bool auto_format) {
+        std::vector<ref<Bitmap>> levels;
+        Struct::Type source_format = Struct::Type::Float32;
+        double mean = 0.0;
+        bool exceed_unit_range = false;
+
+        fs::path cache_path;
+        if (is_spectral_v<Spectrum> && m_spectral_cache && !m_raw &&
+            !file_path.empty()) {
+            cache_path = spectral_cache_path(file_path, wrap_mode);
+            read_spectral_cache(cache_path, file_path, levels, source_format, mean);
+        }
+
+        if (levels.empty()) {
+            if (!bitmap) {
+                Log(Debug, "Loading bitmap texture from \"%s\" ..", m_name);
+                bitmap = Bitmap::load_prefetched(file_path);
+            }
+            source_format = bitmap->component_format();
+
+            /* Convert to linear RGB float bitmap, will be converted
+               into spectral profile coefficients below (in place) */
+            Bitmap::PixelFormat pixel_format = bitmap->pixel_format();
+            switch (pixel_format) {
+                case Bitmap::PixelFormat::Y:
+                case Bitmap::PixelFormat::YA:
+                    pixel_format = Bitmap::PixelFormat::Y;
+                    break;
+
+                case Bitmap::PixelFormat::RGB:
+                case Bitmap::PixelFormat::RGBA:
+                case Bitmap::PixelFormat::XYZ:
+                case Bitmap::PixelFormat::XYZA:
+                    pixel_format = Bitmap::PixelFormat::RGB;
+                    break;
+
+                default:
+                    Throw("The texture needs to have a known pixel "
+                          "format (Y[A], RGB[A], XYZ[A] are supported).");
+            }
+
+            if (m_raw) {
+                /* Don't undo gamma correction in the conversion below.
+                   This is needed, e.g., for normal maps. */
+                bitmap->set_srgb_gamma(false);
+            }
+
+            // Convert the image into the working floating point representation
+            bitmap =
+                bitmap->convert(pixel_format, struct_type_v<ScalarFloat>, false);
+
+            if (dr::any(bitmap->size() < 2)) {
+                Log(Warn,
+                    "Image must be at least 2x2 pixels in size, up-sampling..");
+                using ReconstructionFilter = Bitmap::ReconstructionFilter;
+                ref<ReconstructionFilter> rfilter =
+                    PluginManager::instance()->create_object<ReconstructionFilter>(
+                        Properties("tent"));
+                bitmap =
+                    bitmap->resample(dr::maximum(bitmap->size(), 2), rfilter);
+            }
+
+            size_t channels = bitmap->channel_count();
+            if (channels != 1 && channels != 3)
+                Throw("Unsupported channel count: %d (expected 1 or 3)", channels);
+            bool upsample = is_spectral_v<Spectrum> && !m_raw && channels == 3;
+
+            /* Build the MIP pyramid from linear values, i.e. before the
+               conversion to spectral coefficients below */
+            levels.push_back(bitmap);
+            if (m_mip_filter != MIPFilter::None) {
+                std::vector<ref<Bitmap>> mip_levels =
+                    mip_pyramid(bitmap.get(), wrap_mode, upsample);
+                levels.insert(levels.end(), mip_levels.begin(), mip_levels.end());
+            }
+
+            ScalarFloat *ptr = (ScalarFloat *) bitmap->data();
+            if (upsample)
+                mean = srgb_model_fetch(ptr, ptr, bitmap->pixel_count(),
+                                        &exceed_unit_range);
             else
-                m_texture.eval_nonaccel(uv, out.data(), active);
+                mean = pixel_sum(ptr, bitmap->pixel_count(), channels,
+                                 exceed_unit_range);
+
+            if (upsample && !cache_path.empty())
+                write_spectral_cache(cache_path, file_path, levels,
+                                     source_format, mean);
+        }
+
+        bitmap = levels[0];
+
+        if (auto_format) {
+            switch (source_format) {
+                case Struct::Type::UInt8:   m_format = StorageFormat::UInt8;   break;
+                case Struct::Type::Float16: m_format = StorageFormat::Float16; break;
+                default: break;
+            }
+        }
+
+        // Spectral coefficients can't be stored as 8-bit values
+        if (m_format == StorageFormat::UInt8 && is_spectral_v<Spectrum> &&
+            !m_raw && bitmap->channel_count() == 3) {
+            Log(Debug, "Storing the spectral coefficients of bitmap "
+                       "texture \"%s\" in float16 format.", m_name);
+            m_format = StorageFormat::Float16;
+        }
+
+        if (exceed_unit_range && !m_raw)
+            Log(Warn,
+                "BitmapTexture: texture named \"%s\" contains pixels that "
+                "exceed the [0, 1] range!",
+                m_name);
+        else if (exceed_unit_range && m_format == StorageFormat::UInt8)
+            Log(Warn,
+                "BitmapTexture: texture named \"%s\" contains pixels that "
+                "exceed the [0, 1] range, which will be clamped by the "
+                "\"uint8\" format!",
+                m_name);
+
+        m_mean = Float(mean / bitmap->pixel_count());
+        m_storage->mean = m_mean;
+        m_storage->format = m_format;
 
-            return srgb_model_eval<UnpolarizedSpectrum>(out, si.wavelengths);
+        if (m_format == StorageFormat::Float32) {
+            size_t channels = bitmap->channel_count();
+            ScalarVector2i res = ScalarVector2i(bitmap->size());
+            size_t shape[3] = { (size_t) res.y(), (size_t) res.x(), channels };
+            m_storage->texture = Texture2f(TensorXf(bitmap->data(), 3, shape),
+                                           m_accel, m_accel, filter_mode,
+                                           wrap_mode);
+        } else {
+            m_storage->packed = PackedTexture(bitmap.get(), m_format, !m_raw,
+                                              filter_mode, wrap_mode);
+            Log(Debug, "Storing bitmap texture \"%s\" in %s format (%s).",
+                m_name, m_format == StorageFormat::UInt8 ? "uint8" : "float16",
+                util::mem_string(m_storage->packed.bytes()));
         }
+
+        if (m_mip_filter != MIPFilter::None)
+            set_mip_levels(std::vector<ref<Bitmap>>(levels.begin() + 1, levels.end()),
+                           wrap_mode, bitmap->buffer_size());
     }
 
     /**
-     * \brief Evaluates the texture at the given surface interaction
+     * \brief Compute the sum of the luminance (3 channels) or values
+     * (1 channel) of \c count pixels in parallel, and check whether all
+     * values lie in the [0, 1] range
+     */
+    static double pixel_sum(const ScalarFloat *ptr, size_t count,
+                            size_t channels, bool &exceed_unit_range) {
+        using FloatP = dr::Packet<ScalarFloat>;
+        using UInt32P = dr::uint32_array_t<FloatP>;
+        using MaskP = dr::mask_t<FloatP>;
+        using Color3fP = Color<FloatP, 3>;
+
+        const size_t packet_count = (count + FloatP::Size - 1) / FloatP::Size;
+        std::atomic<bool> exceed(false);
+        std::mutex mutex;
+        double total = 0.0;
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, packet_count, 1024),
+            [&](const dr::blocked_range<size_t> &range) {
+                double partial = 0.0;
+                bool partial_exceed = false;
+
+                for (size_t p = range.begin(); p != range.end(); ++p) {
+                    UInt32P index =
+                        dr::arange<UInt32P>() + uint32_t(p * FloatP::Size);
+                    MaskP active = index < (uint32_t) count;
+
+                    FloatP value;
+                    MaskP in_range;
+                    if (channels == 3) {
+                        Color3fP color;
+                        for (uint32_t c = 0; c < 3; ++c)
+                            color[c] = dr::gather<FloatP>(ptr, index * 3u + c, active);
+                        in_range = dr::all(color >= 0.f && color <= 1.f);
+                        value = luminance(color);
+                    } else {
+                        value = dr::gather<FloatP>(ptr, index, active);
+                        in_range = value >= 0.f && value <= 1.f;
+                    }
+
+                    partial_exceed |= dr::any(active && !in_range);
+                    partial += (double) dr::sum(dr::select(active, value, 0.f));
+                }
+
+                if (partial_exceed)
+                    exceed = true;
+                std::lock_guard<std::mutex> guard(mutex);
+                total += partial;
+            }
+        );
+
+        exceed_unit_range = exceed;
+        return total;
+    }
+
+    /// Return the filename of the on-disk cache of spectral coefficients
+    fs::path spectral_cache_path(const fs::path &file_path,
+                                 dr::WrapMode wrap_mode) const {
+        // The MIP pyramid depends on the wrap mode
+        size_t key = hash_combine(hash_combine(hash(wrap_mode),
+                                               hash(m_mip_filter != MIPFilter::None)),
+                                  sizeof(ScalarFloat));
+        return fs::path(tfm::format("%s.%08x.spec", file_path.string(),
+                                    (uint32_t) key));
+    }
+
+    /**
+     * \brief Read the spectral coefficients of the levels of the texture from
+     * the on-disk cache
      *
-     * Should only be used when the texture has exactly 1 channel.
+     * Returns without modifying \c levels if the cache doesn't exist, is
+     * invalid, or is older than the image.
      */
-    MI_INLINE Float interpolate_1(const SurfaceInteraction3f &si,
-                                   Mask active) const {
-        if constexpr (!dr::is_array_v<Mask>)
-            active = true;
+    void read_spectral_cache(const fs::path &cache_path, const fs::path &file_path,
+                             std::vector<ref<Bitmap>> &levels,
+                             Struct::Type &source_format, double &mean) const {
+        if (!fs::exists(cache_path))
+            return;
+
+        try {
+            ref<FileStream> stream = new FileStream(cache_path);
+            char magic[4];
+            stream->read(magic, 4);
+            uint32_t version, float_size, level_count, format;
+            uint64_t source_size;
+            int64_t source_time;
+            stream->read(version);
+            stream->read(float_size);
+            stream->read(source_size);
+            stream->read(source_time);
+            if (memcmp(magic, SpectralCacheMagic, 4) != 0 ||
+                version != SpectralCacheVersion ||
+                float_size != sizeof(ScalarFloat) ||
+                source_size != fs::file_size(file_path) ||
+                source_time != fs::last_write_time(file_path)) {
+                Log(Debug, "Ignoring outdated spectral coefficient cache \"%s\".",
+                    cache_path);
+                return;
+            }
+            stream->read(format);
+            stream->read(mean);
+            stream->read(level_count);
+
+            std::vector<ref<Bitmap>> result;
+            for (uint32_t i = 0; i < level_count; ++i) {
+                ScalarVector2u size;
+                stream->read(size.x());
+                stream->read(size.y());
+                ref<Bitmap> level = new Bitmap(Bitmap::PixelFormat::RGB,
+                                               struct_type_v<ScalarFloat>, size);
+                stream->read(level->data(), level->buffer_size());
+                result.push_back(level);
+            }
 
-        Point2f uv = m_transform.transform_affine(si.uv);
+            levels = std::move(result);
+            source_format = (Struct::Type) format;
+            Log(Debug, "Loaded spectral coefficients of bitmap texture \"%s\" "
+                "from \"%s\".", m_name, cache_path);
+        } catch (const std::exception &e) {
+            Log(Warn, "Could not read spectral coefficient cache \"%s\": %s",
+                cache_path, e.what());
+        }
+    }
 
-        Float out;
-        if (m_accel)
-            m_texture.eval(uv, &out, active);
-        else
-            m_texture.eval_nonaccel(uv, &out, active);
+    /// Write the spectral coefficients of the levels of the texture to disk
+    void write_spectral_cache(const fs::path &cache_path, const fs::path &file_path,
+                              const std::vector<ref<Bitmap>> &levels,
+                              Struct::Type source_format, double mean) const {
+        /* Write to a temporary file first, other processes may read the
+           cache. Its name is unique to the writing process and thread, since
+           several of them may write the same cache concurrently. */
+#if defined(_WIN32)
+        int pid = _getpid();
+#else
+        int pid = (int) getpid();
+#endif
+        fs::path temp_path = fs::path(tfm::format(
+            "%s.%i.%zu.tmp", cache_path.string(), pid,
+            std::hash<std::thread::id>()(std::this_thread::get_id())));
+        try {
+            ref<FileStream> stream =
+                new FileStream(temp_path, FileStream::ETruncReadWrite);
+            stream->write(SpectralCacheMagic, 4);
+            stream->write(SpectralCacheVersion);
+            stream->write((uint32_t) sizeof(ScalarFloat));
+            stream->write((uint64_t) fs::file_size(file_path));
+            stream->write(fs::last_write_time(file_path));
+            stream->write((uint32_t) source_format);
+            stream->write(mean);
+            stream->write((uint32_t) levels.size());
+            for (const ref<Bitmap> &level : levels) {
+                stream->write(level->width());
+                stream->write(level->height());
+                stream->write(level->data(), level->buffer_size());
+            }
+            stream->close();
+
+            if (!fs::rename(temp_path, cache_path))
+                Throw("renaming \"%s\" failed", temp_path);
+            Log(Debug, "Wrote spectral coefficients of bitmap texture \"%s\" "
+                "to \"%s\".", m_name, cache_path);
+        } catch (const std::exception &e) {
+            fs::remove(temp_path);
+            Log(Warn, "Could not write spectral coefficient cache \"%s\": %s",
+                cache_path, e.what());
+        }
+    }
 
-        return out;
+    /// Replace shared texture data by a private copy
+    void detach_storage() {
+        if (!m_shared)
+            return;
+
+        std::shared_ptr<Storage> storage = std::make_shared<Storage>();
+        storage->format = m_storage->format;
+        storage->texture = Texture2f(TensorXf(m_storage->texture.tensor()),
+                                     m_accel, m_accel, filter_mode(), wrap_mode());
+        storage->packed = m_storage->packed;
+        storage->mip_chain = m_storage->mip_chain;
+        storage->mean = m_storage->mean;
+
+        m_storage = storage;
+        m_shared = false;
+    }
+
+    /// Copy the data of the full resolution image into a bitmap
+    ref<Bitmap> base_bitmap() const {
+        auto &&data = dr::migrate(m_storage->texture.value(), AllocType::Host);
+
+        if constexpr (dr::is_jit_v<Float>)
+            dr::sync_thread();
+
+        const size_t *shape = m_storage->texture.shape();
+        ref<Bitmap> bitmap = new Bitmap(
+            shape[2] == 1 ? Bitmap::PixelFormat::Y : Bitmap::PixelFormat::RGB,
+            struct_type_v<ScalarFloat>, ScalarVector2u(shape[1], shape[0]));
+        std::memcpy(bitmap->data(), data.data(), bitmap->buffer_size());
+        return bitmap;
     }
 
     /**
-     * \brief Evaluates the texture at the given surface interaction
+     * \brief Compute the levels of the MIP pyramid below the full resolution
+     * image given by \c bitmap
      *
-     * Should only be used when the texture has exactly 3 channels.
+     * Each level halves the resolution of the previous one, until the next
+     * level would have fewer than two pixels along one of its axes.
+     *
+     * \param upsample
+     *     Should the levels be converted into spectral coefficients?
      */
-    MI_INLINE Color3f interpolate_3(const SurfaceInteraction3f &si,
-                                     Mask active) const {
-        if constexpr (!dr::is_array_v<Mask>)
-            active = true;
+    std::vector<ref<Bitmap>> mip_pyramid(const Bitmap *bitmap,
+                                         dr::WrapMode wrap_mode,
+                                         bool upsample) const {
+        FilterBoundaryCondition bc;
+        switch (wrap_mode) {
+            case dr::WrapMode::Repeat: bc = FilterBoundaryCondition::Repeat; break;
+            case dr::WrapMode::Mirror: bc = FilterBoundaryCondition::Mirror; break;
+            default: bc = FilterBoundaryCondition::Clamp; break;
+        }
 
-        Point2f uv = m_transform.transform_affine(si.uv);
+        // Avoid negative values due to the negative lobes of the filter
+        std::pair<ScalarFloat, ScalarFloat> bound = {
+            m_raw ? -dr::Infinity<ScalarFloat> : 0.f, dr::Infinity<ScalarFloat>
+        };
+
+        std::vector<ref<Bitmap>> levels;
+        ScalarVector2u size = bitmap->size();
+        ref<Bitmap> level;
+        while (dr::all(size >= 4u)) {
+            size /= 2u;
+            level = (level ? level.get() : bitmap)
+                        ->resample(size, nullptr, { bc, bc }, bound);
+
+            ref<Bitmap> stored = level;
+            if (upsample) {
+                // Keep 'level' in RGB as the source of the next level
+                stored = new Bitmap(*level);
+                ScalarFloat *ptr = (ScalarFloat *) stored->data();
+                srgb_model_fetch(ptr, ptr, stored->pixel_count());
+            }
+            levels.push_back(stored);
+        }
 
-        Color3f out;
-        if (m_accel)
-            m_texture.eval(uv, out.data(), active);
-        else
-            m_texture.eval_nonaccel(uv, out.data(), active);
+        return levels;
+    }
 
-        return out;
+    /// Store the given levels of the MIP pyramid (see \ref mip_pyramid())
+    void set_mip_levels(const std::vector<ref<Bitmap>> &levels,
+                        dr::WrapMode wrap_mode, size_t base_bytes) {
+        m_storage->mip_chain = MIPChain(levels, m_format, !m_raw, wrap_mode);
+        size_t mip_bytes = m_storage->mip_chain.bytes();
+
+        Log(Debug, "Built MIP pyramid of bitmap texture \"%s\": %u levels, "
+            "%s (+%.1f%% over the full resolution image)", m_name,
+            mip_level_count(), util::mem_string(mip_bytes),
+            100.0 * mip_bytes / base_bytes);
+    }
+
+    /// Build and store the MIP pyramid of the given full resolution image
+    void build_mipmap(const Bitmap *bitmap, dr::WrapMode wrap_mode,
+                      bool upsample) {
+        set_mip_levels(mip_pyramid(bitmap, wrap_mode, upsample), wrap_mode,
+                       bitmap->buffer_size());
     }
 
     /**
@@ -714,7 +1725,7 @@ protected:
      * following an update
      */
     void rebuild_internals(bool init_mean, bool init_distr) {
-        auto&& data = dr::migrate(m_texture.value(), AllocType::Host);
+        auto&& data = dr::migrate(m_storage->texture.value(), AllocType::Host);
 
         if constexpr (dr::is_jit_v<Float>)
             dr::sync_thread();
@@ -724,11 +1735,17 @@ protected:
 
         const ScalarFloat *ptr = data.data();
 
+        std::unique_ptr<ScalarFloat[]> decoded;
+        if (m_format != StorageFormat::Float32) {
+            decoded = m_storage->packed.decode();
+            ptr = decoded.get();
+        }
+
         double mean = 0.0;
         size_t pixel_count = (size_t) dr::prod(resolution());
         bool exceed_unit_range = false;
 
-        const size_t channels = m_texture.shape()[2];
+        const size_t channels = channel_count();
         if (channels == 3) {
             std::unique_ptr<ScalarFloat[]> importance_map(
                 init_distr ? new ScalarFloat[pixel_count] : nullptr);
@@ -785,12 +1802,446 @@ protected:
     }
 
 protected:
-    Texture2f m_texture;
+    /// Precision of the texture data kept in memory
+    enum class StorageFormat { Float32, Float16, UInt8 };
+
+    /**
+     * \brief Texture data stored in reduced precision
+     *
+     * Implements the subset of the <tt>dr::Texture</tt> interface used by
+     * this plugin (without hardware acceleration). Texels are decoded into
+     * floating point values during lookups. RGB texels are padded to 32 bits
+     * (\c uint8) or 64 bits (\c float16), so that every texel is fetched
+     * using one or two gathers. 8-bit values are decoded using a lookup
+     * table, which also undoes the sRGB gamma curve where needed.
+     */
+    class PackedTexture {
+    public:
+        PackedTexture() = default;
+
+        PackedTexture(const Bitmap *bitmap, StorageFormat format, bool srgb,
+                      dr::FilterMode filter_mode, dr::WrapMode wrap_mode)
+            : m_format(format), m_srgb(srgb), m_filter_mode(filter_mode),
+              m_wrap_mode(wrap_mode) {
+            size_t channels = bitmap->channel_count(),
+                   texels   = bitmap->pixel_count();
+            m_shape[0] = bitmap->height();
+            m_shape[1] = bitmap->width();
+            m_shape[2] = channels;
+
+            std::vector<uint32_t> words;
+            if (format == StorageFormat::UInt8) {
+                ref<Bitmap> bytes = bitmap->convert(
+                    bitmap->pixel_format(), Struct::Type::UInt8, srgb);
+                const uint8_t *ptr = (const uint8_t *) bytes->data();
+
+                if (channels == 1) {
+                    words.resize((texels + 3) / 4, 0);
+                    for (size_t i = 0; i < texels; ++i)
+                        words[i / 4] |= (uint32_t) ptr[i] << (8 * (i % 4));
+                } else {
+                    words.resize(texels);
+                    for (size_t i = 0; i < texels; ++i, ptr += 3)
+                        words[i] = (uint32_t) ptr[0] | ((uint32_t) ptr[1] << 8) |
+                                   ((uint32_t) ptr[2] << 16);
+                }
+
+                ScalarFloat lut[256];
+                for (uint32_t i = 0; i < 256; ++i)
+                    lut[i] = decode_byte(i);
+                m_lut = dr::load<FloatStorage>(lut, 256);
+            } else {
+                const ScalarFloat *ptr = (const ScalarFloat *) bitmap->data();
+                auto half = [&](size_t i) -> uint32_t {
+                    return dr::half::float32_to_float16(ptr[i]);
+                };
+
+                if (channels == 1) {
+                    words.resize((texels + 1) / 2, 0);
+                    for (size_t i = 0; i < texels; ++i)
+                        words[i / 2] |= half(i) << (16 * (i % 2));
+                } else {
+                    words.resize(2 * texels);
+                    for (size_t i = 0; i < texels; ++i) {
+                        words[2 * i]     = half(3 * i) | (half(3 * i + 1) << 16);
+                        words[2 * i + 1] = half(3 * i + 2);
+                    }
+                }
+            }
+
+            m_data = dr::load<DynamicBuffer<UInt32>>(words.data(), words.size());
+        }
+
+        const size_t *shape() const { return m_shape; }
+        dr::FilterMode filter_mode() const { return m_filter_mode; }
+        dr::WrapMode wrap_mode() const { return m_wrap_mode; }
+
+        /// Return the size of the texture data in bytes
+        size_t bytes() const {
+            return (dr::width(m_data) + dr::width(m_lut)) * sizeof(uint32_t);
+        }
+
+        /// Apply the wrap mode to integer texel coordinates
+        dr::Array<Int32, 2> wrap(const dr::Array<Int32, 2> &pos) const {
+            dr::Array<Int32, 2> res((int32_t) m_shape[1], (int32_t) m_shape[0]);
+            if (m_wrap_mode == dr::WrapMode::Clamp)
+                return dr::clamp(pos, 0, res - 1);
+
+            // Floor division and positive remainder
+            dr::Array<Int32, 2> div = dr::select(pos < 0, pos + 1, pos) / res;
+            div = dr::select(pos < 0, div - 1, div);
+            dr::Array<Int32, 2> mod = pos - div * res;
+
+            if (m_wrap_mode == dr::WrapMode::Mirror)
+                mod = dr::select(dr::eq(div & 1, 0), mod, res - 1 - mod);
+
+            return mod;
+        }
+
+        /// Fetch the channels of the texels with the given linear indices
+        void read(const UInt32 &index, Float *out, const Mask &active) const {
+            if (m_format == StorageFormat::UInt8) {
+                if (m_shape[2] == 1) {
+                    UInt32 word = dr::gather<UInt32>(m_data, index >> 2, active);
+                    out[0] = dr::gather<Float>(
+                        m_lut, (word >> ((index & 3u) << 3)) & 0xFFu, active);
+                } else {
+                    UInt32 word = dr::gather<UInt32>(m_data, index, active);
+                    for (uint32_t i = 0; i < 3; ++i)
+                        out[i] = dr::gather<Float>(
+                            m_lut, (word >> (8 * i)) & 0xFFu, active);
+                }
+            } else {
+                if (m_shape[2] == 1) {
+                    UInt32 word = dr::gather<UInt32>(m_data, index >> 1, active);
+                    out[0] = half_to_float(word >> ((index & 1u) << 4));
+                } else {
+                    UInt32 w0 = dr::gather<UInt32>(m_data, index * 2u, active),
+                           w1 = dr::gather<UInt32>(m_data, index * 2u + 1u, active);
+                    out[0] = half_to_float(w0);
+                    out[1] = half_to_float(w0 >> 16);
+                    out[2] = half_to_float(w1);
+                }
+            }
+        }
+
+        void eval_fetch(const Point2f &uv, dr::Array<Float *, 4> &out,
+                        Mask active) const {
+            ScalarVector2f res((ScalarFloat) m_shape[1], (ScalarFloat) m_shape[0]);
+            Vector2i pos = dr::floor2int<Vector2i>(dr::fmadd(uv, res, -.5f));
+            const ScalarVector2i offset[4] = { { 0, 0 }, { 1, 0 },
+                                               { 0, 1 }, { 1, 1 } };
+            for (size_t i = 0; i < 4; ++i)
+                read(index(pos + offset[i]), out[i], active);
+        }
+
+        void eval(const Point2f &uv, Float *out, Mask active) const {
+            ScalarVector2f res((ScalarFloat) m_shape[1], (ScalarFloat) m_shape[0]);
+            size_t channels = m_shape[2];
+
+            if (m_filter_mode == dr::FilterMode::Nearest) {
+                read(index(dr::floor2int<Vector2i>(uv * res)), out, active);
+                return;
+            }
+
+            Float values[4][3];
+            dr::Array<Float *, 4> fetch_values;
+            for (size_t i = 0; i < 4; ++i)
+                fetch_values[i] = values[i];
+            eval_fetch(uv, fetch_values, active);
+
+            Point2f p = dr::fmadd(uv, res, -.5f);
+            Point2f w1 = p - dr::floor(p), w0 = 1.f - w1;
+            for (size_t i = 0; i < channels; ++i) {
+                Float v0 = dr::fmadd(w0.x(), values[0][i], w1.x() * values[1][i]),
+                      v1 = dr::fmadd(w0.x(), values[2][i], w1.x() * values[3][i]);
+                out[i] = dr::fmadd(w0.y(), v0, w1.y() * v1);
+            }
+        }
+
+        void eval_nonaccel(const Point2f &uv, Float *out, Mask active) const {
+            eval(uv, out, active);
+        }
+
+        void eval_fetch_nonaccel(const Point2f &uv, dr::Array<Float *, 4> &out,
+                                 Mask active) const {
+            eval_fetch(uv, out, active);
+        }
+
+        /// Decode the complete texture into host memory
+        std::unique_ptr<ScalarFloat[]> decode() const {
+            auto &&data = dr::migrate(m_data, AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+
+            const uint32_t *words = data.data();
+            size_t channels = m_shape[2],
+                   count = m_shape[0] * m_shape[1] * channels;
+            std::unique_ptr<ScalarFloat[]> result(new ScalarFloat[count]);
+
+            for (size_t i = 0; i < count; ++i) {
+                if (m_format == StorageFormat::UInt8) {
+                    uint32_t byte = channels == 1
+                        ? words[i / 4] >> (8 * (i % 4))
+                        : words[i / 3] >> (8 * (i % 3));
+                    result[i] = decode_byte(byte & 0xFFu);
+                } else {
+                    uint32_t word = channels == 1
+                        ? words[i / 2] >> (16 * (i % 2))
+                        : (i % 3 == 2 ? words[2 * (i / 3) + 1]
+                                      : words[2 * (i / 3)] >> (16 * (i % 3)));
+                    result[i] = dr::half::float16_to_float32((uint16_t) word);
+                }
+            }
+
+            return result;
+        }
+
+    protected:
+        MI_INLINE UInt32 index(const Vector2i &pos) const {
+            Vector2i p = wrap(pos);
+            return UInt32(p.y() * (int32_t) m_shape[1] + p.x());
+        }
+
+        ScalarFloat decode_byte(uint32_t value) const {
+            ScalarFloat result = value / 255.f;
+            return m_srgb ? dr::srgb_to_linear(result) : result;
+        }
+
+        /// Convert the lower 16 bits of \c value from half to single precision
+        static MI_INLINE Float half_to_float(const UInt32 &value) {
+            // Shift exponent and mantissa into place and adjust the bias
+            Float result = dr::reinterpret_array<Float>((value & 0x7FFFu) << 13) *
+                           dr::reinterpret_array<ScalarFloat>(0x77800000u);
+            return dr::reinterpret_array<Float>(
+                dr::reinterpret_array<UInt32>(result) | ((value & 0x8000u) << 16));
+        }
+
+    protected:
+        DynamicBuffer<UInt32> m_data;
+        FloatStorage m_lut;
+        size_t m_shape[3] = { 0, 0, 0 };
+        StorageFormat m_format = StorageFormat::Float32;
+        bool m_srgb = false;
+        dr::FilterMode m_filter_mode = dr::FilterMode::Linear;
+        dr::WrapMode m_wrap_mode = dr::WrapMode::Repeat;
+    };
+
+    /**
+     * \brief Coarse levels of a MIP pyramid stored one after the other in a
+     * single buffer
+     *
+     * Lookups take the level as a per-lane index, which lets \ref
+     * trilinear() gather from the two selected levels of every lane instead
+     * of visiting the complete pyramid. Texels use the same representation
+     * as the full resolution image, i.e. single precision values or a \ref
+     * PackedTexture encoding.
+     */
+    class MIPChain {
+    public:
+        MIPChain() = default;
+
+        MIPChain(const std::vector<ref<Bitmap>> &levels, StorageFormat format,
+                 bool srgb, dr::WrapMode wrap_mode)
+            : m_format(format), m_wrap_mode(wrap_mode) {
+            if (levels.empty())
+                return;
+
+            std::vector<uint32_t> offset, width, height;
+            size_t texels = 0;
+            for (const ref<Bitmap> &level : levels) {
+                offset.push_back((uint32_t) texels);
+                width.push_back(level->width());
+                height.push_back(level->height());
+                texels += level->pixel_count();
+            }
+
+            m_channels = levels[0]->channel_count();
+            m_level_count = levels.size();
+            m_offset = dr::load<DynamicBuffer<UInt32>>(offset.data(), offset.size());
+            m_width  = dr::load<DynamicBuffer<UInt32>>(width.data(), width.size());
+            m_height = dr::load<DynamicBuffer<UInt32>>(height.data(), height.size());
+
+            // Concatenate the texels of all levels
+            ref<Bitmap> chain =
+                new Bitmap(levels[0]->pixel_format(), struct_type_v<ScalarFloat>,
+                           ScalarVector2u((uint32_t) texels, 1u));
+            uint8_t *ptr = (uint8_t *) chain->data();
+            for (const ref<Bitmap> &level : levels) {
+                std::memcpy(ptr, level->data(), level->buffer_size());
+                ptr += level->buffer_size();
+            }
+
+            if (format == StorageFormat::Float32)
+                m_values = dr::load<FloatStorage>(chain->data(),
+                                                  texels * m_channels);
+            else
+                m_packed = PackedTexture(chain.get(), format, srgb,
+                                         dr::FilterMode::Linear, wrap_mode);
+        }
+
+        size_t level_count() const { return m_level_count; }
+
+        /// Return the size of the texture data in bytes
+        size_t bytes() const {
+            size_t result = 3 * m_level_count * sizeof(uint32_t);
+            if (m_format == StorageFormat::Float32)
+                result += dr::width(m_values) * sizeof(ScalarFloat);
+            else
+                result += m_packed.bytes();
+            return result;
+        }
+
+        /// Return the resolution of the given level
+        Vector2u resolution(const UInt32 &level, const Mask &active) const {
+            return Vector2u(dr::gather<UInt32>(m_width, level, active),
+                            dr::gather<UInt32>(m_height, level, active));
+        }
+
+        /// Fetch the four texels surrounding \c uv on the given level
+        void eval_fetch(const UInt32 &level, const Point2f &uv,
+                        dr::Array<Float *, 4> &out, Mask active) const {
+            Vector2i res = Vector2i(resolution(level, active));
+            UInt32 offset = dr::gather<UInt32>(m_offset, level, active);
+            Vector2i pos = dr::floor2int<Vector2i>(dr::fmadd(uv, Vector2f(res), -.5f));
+
+            const ScalarVector2i delta[4] = { { 0, 0 }, { 1, 0 },
+                                              { 0, 1 }, { 1, 1 } };
+            for (size_t i = 0; i < 4; ++i) {
+                Vector2i p = wrap(pos + delta[i], res);
+                UInt32 index = offset + UInt32(p.y() * res.x() + p.x());
+                if (m_format == StorageFormat::Float32) {
+                    for (size_t j = 0; j < m_channels; ++j)
+                        out[i][j] = dr::gather<Float>(
+                            m_values, index * (uint32_t) m_channels + (uint32_t) j,
+                            active);
+                } else {
+                    m_packed.read(index, out[i], active);
+                }
+            }
+        }
+
+        /// Bilinearly interpolate the given level at \c uv
+        void eval(const UInt32 &level, const Point2f &uv, Float *out,
+                  Mask active) const {
+            Float values[4][3];
+            dr::Array<Float *, 4> fetch_values;
+            for (size_t i = 0; i < 4; ++i)
+                fetch_values[i] = values[i];
+            eval_fetch(level, uv, fetch_values, active);
+
+            Point2f p = dr::fmadd(uv, Vector2f(resolution(level, active)), -.5f);
+            Point2f w1 = p - dr::floor(p), w0 = 1.f - w1;
+            for (size_t i = 0; i < m_channels; ++i) {
+                Float v0 = dr::fmadd(w0.x(), values[0][i], w1.x() * values[1][i]),
+                      v1 = dr::fmadd(w0.x(), values[2][i], w1.x() * values[3][i]);
+                out[i] = dr::fmadd(w0.y(), v0, w1.y() * v1);
+            }
+        }
+
+    protected:
+        /// Apply the wrap mode to integer texel coordinates of a level
+        Vector2i wrap(const Vector2i &pos, const Vector2i &res) const {
+            if (m_wrap_mode == dr::WrapMode::Clamp)
+                return dr::clamp(pos, 0, res - 1);
+
+            // Floor division and positive remainder
+            Vector2i div = dr::select(pos < 0, pos + 1, pos) / res;
+            div = dr::select(pos < 0, div - 1, div);
+            Vector2i mod = pos - div * res;
+
+            if (m_wrap_mode == dr::WrapMode::Mirror)
+                mod = dr::select(dr::eq(div & 1, 0), mod, res - 1 - mod);
+
+            return mod;
+        }
+
+    protected:
+        FloatStorage m_values;
+        PackedTexture m_packed;
+        DynamicBuffer<UInt32> m_offset, m_width, m_height;
+        size_t m_level_count = 0;
+        size_t m_channels = 0;
+        StorageFormat m_format = StorageFormat::Float32;
+        dr::WrapMode m_wrap_mode = dr::WrapMode::Repeat;
+    };
+
+    /// Lookup interface for one level of a \ref MIPChain chosen per lane
+    struct MIPLevel {
+        const MIPChain &chain;
+        UInt32 level;
+
+        dr::FilterMode filter_mode() const { return dr::FilterMode::Linear; }
+
+        void eval(const Point2f &uv, Float *out, Mask active) const {
+            chain.eval(level, uv, out, active);
+        }
+
+        void eval_fetch(const Point2f &uv, dr::Array<Float *, 4> &out,
+                        Mask active) const {
+            chain.eval_fetch(level, uv, out, active);
+        }
+
+        void eval_nonaccel(const Point2f &uv, Float *out, Mask active) const {
+            eval(uv, out, active);
+        }
+
+        void eval_fetch_nonaccel(const Point2f &uv, dr::Array<Float *, 4> &out,
+                                 Mask active) const {
+            eval_fetch(uv, out, active);
+        }
+    };
+
+    /**
+     * \brief Texel data of the texture
+     *
+     * Textures loaded from the same file with identical parameters share a
+     * single instance via \ref SharedCache. It is treated as immutable while
+     * shared and copied before its contents are exposed for modification.
+     */
+    struct Storage {
+        StorageFormat format = StorageFormat::Float32;
+        Texture2f texture;
+        // Optional: reduced precision storage (replaces 'texture')
+        PackedTexture packed;
+        // Optional: coarse levels of the MIP pyramid for filtering pixel footprints
+        MIPChain mip_chain;
+        Float mean;
+        // Atlases only: scale and offset of each packed image (4 values each)
+        FloatStorage atlas_rects;
+
+        /// Return the memory usage in bytes
+        size_t bytes() const {
+            size_t result = mip_chain.bytes();
+            if (format == StorageFormat::Float32)
+                result += dr::width(texture.value()) * sizeof(ScalarFloat);
+            else
+                result += packed.bytes();
+            return result;
+        }
+    };
+
+protected:
+    std::shared_ptr<Storage> m_storage;
+    /// Is \ref m_storage shared with other instances?
+    bool m_shared = false;
     ScalarTransform3f m_transform;
     bool m_accel;
     bool m_raw;
+    bool m_spectral_cache;
     Float m_mean;
     std::string m_name;
+    StorageFormat m_format;
+
+    // Optional: shared atlas storing the data of several textures
+    std::shared_ptr<Storage> m_atlas;
+    UInt32 m_atlas_index;
+    dr::WrapMode m_atlas_wrap;
+
+    // Optional: MIP pyramid for filtering pixel footprints
+    enum class MIPFilter { None, Trilinear, EWA };
+    MIPFilter m_mip_filter;
+    ScalarFloat m_max_anisotropy;
 
     // Optional: distribution for importance sampling
     mutable std::mutex m_mutex;
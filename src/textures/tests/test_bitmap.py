@@ -247,4 +247,364 @@ def test06_tensor_load(variants_all_rgb):
         'raw' : True
     })
 
-    assert dr.allclose(bitmap.mean(), 3.0);
\ No newline at end of file
+    assert dr.allclose(bitmap.mean(), 3.0);
+
+def make_raw_bitmap(data, filter_type, **kwargs):
+    import numpy as np
+    return mi.load_dict({
+        'type' : 'bitmap',
+        'data' : mi.TensorXf(np.array(data, dtype=np.float32)[..., None]),
+        'raw' : True,
+        'filter_type' : filter_type,
+        **kwargs
+    })
+
+
+def test07_mipmap_trilinear(variant_scalar_rgb):
+    import numpy as np
+
+    # Checkerboard with 1-texel checks
+    checker = np.indices((64, 64)).sum(axis=0) % 2
+    bilinear = make_raw_bitmap(checker, 'bilinear')
+    trilinear = make_raw_bitmap(checker, 'trilinear')
+    assert trilinear.needs_differentials()
+    assert not bilinear.needs_differentials()
+    assert 'mip_levels = 6' in str(trilinear)
+
+    # The request is passed on by nested textures and BSDFs
+    nested = mi.load_dict({ 'type' : 'checkerboard', 'color0' : trilinear })
+    assert nested.needs_differentials()
+    bsdf = mi.load_dict({
+        'type' : 'twosided',
+        'nested' : { 'type' : 'diffuse', 'reflectance' : nested }
+    })
+    assert bsdf.needs_differentials()
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    for uv in [[0.3, 0.7], [0.51, 0.12], [0.9, 0.95]]:
+        si.uv = uv
+
+        # Without UV partials, the full resolution image is used
+        si.duv_dx = si.duv_dy = [0, 0]
+        assert dr.allclose(trilinear.eval_1(si), bilinear.eval_1(si))
+
+        # A footprint covering many checks averages them out
+        si.duv_dx = [16 / 64, 0]
+        si.duv_dy = [0, 16 / 64]
+        assert dr.allclose(trilinear.eval_1(si), 0.5, atol=0.05)
+
+
+def test08_mipmap_ewa(variant_scalar_rgb):
+    import numpy as np
+
+    # Horizontal stripes, 4 rows each
+    stripes = np.repeat((np.arange(64) // 4) % 2, 64).reshape(64, 64)
+    trilinear = make_raw_bitmap(stripes, 'trilinear')
+    ewa = make_raw_bitmap(stripes, 'ewa', max_anisotropy=32)
+
+    # Footprint that is elongated along the stripes (center of a bright stripe)
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.uv = [0.5, 6 / 64]
+    si.duv_dx = [16 / 64, 0]
+    si.duv_dy = [0, 0.5 / 64]
+
+    # Isotropic filtering blurs the stripes, anisotropic filtering keeps them
+    assert dr.allclose(trilinear.eval_1(si), 0.5, atol=0.1)
+    assert dr.allclose(ewa.eval_1(si), 1.0, atol=0.05)
+
+
+def test09_mipmap_level_blend(variants_all_rgb, np_rng):
+    import numpy as np
+
+    # All coarser levels of a checkerboard with 1-texel checks are uniformly gray
+    checker = np.indices((64, 64)).sum(axis=0) % 2
+    bilinear = make_raw_bitmap(checker, 'bilinear')
+    trilinear = make_raw_bitmap(checker, 'trilinear')
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    for uv in np_rng.random((4, 2)):
+        si.uv = uv
+        si.duv_dx = si.duv_dy = [0, 0]
+        full = bilinear.eval_1(si)
+
+        for width in [1.5, 2, 3, 8, 64]:
+            si.duv_dx = [width / 64, 0]
+            si.duv_dy = [0, width / 64]
+
+            # Footprints between one and two texels blend the first two levels
+            t = min(np.log2(width), 1)
+            assert dr.allclose(trilinear.eval_1(si), (1 - t) * full + t * 0.5,
+                               atol=1e-3)
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'bilinear'])
+@pytest.mark.parametrize('wrap_mode', ['repeat', 'clamp', 'mirror'])
+@pytest.mark.parametrize('format', ['float16', 'uint8'])
+@pytest.mark.parametrize('channels', [1, 3])
+def test10_reduced_precision(variants_all_rgb, np_rng, filter_type, wrap_mode,
+                             format, channels):
+    import numpy as np
+    data = np_rng.random((13, 17, channels)).astype(np.float32)
+    bitmap = mi.Bitmap(data, mi.Bitmap.PixelFormat.Y if channels == 1
+                       else mi.Bitmap.PixelFormat.RGB)
+
+    def make(format):
+        return mi.load_dict({
+            'type' : 'bitmap',
+            'bitmap' : bitmap,
+            'filter_type' : filter_type,
+            'wrap_mode' : wrap_mode,
+            'format' : format
+        })
+
+    reference, packed = make('float32'), make(format)
+    assert f'format = {format}' in str(packed)
+    assert 'data' not in mi.traverse(packed)
+    assert dr.all(packed.resolution() == reference.resolution())
+    assert dr.allclose(packed.mean(), reference.mean(), atol=1e-2)
+
+    # Quantization error of the stored values (relative for half precision)
+    atol = 1e-2 if format == 'uint8' else 1e-3
+
+    si = dr.zeros(mi.SurfaceInteraction3f, 50)
+    si.uv = mi.Point2f(np_rng.random((2, 50)) * 3 - 1)
+    assert dr.allclose(packed.eval(si), reference.eval(si), atol=atol)
+    assert dr.allclose(packed.eval_1(si), reference.eval_1(si), atol=atol)
+
+
+def test11_reduced_precision_auto(variant_scalar_rgb):
+    import numpy as np
+    data = (np.arange(4 * 4 * 3) % 256).astype(np.uint8).reshape(4, 4, 3)
+    bitmap = mi.Bitmap(data)
+
+    texture = mi.load_dict({ 'type' : 'bitmap', 'bitmap' : bitmap, 'format' : 'auto' })
+    assert 'format = uint8' in str(texture)
+
+    bitmap = mi.Bitmap(np.zeros((4, 4, 3), dtype=np.float16))
+    texture = mi.load_dict({ 'type' : 'bitmap', 'bitmap' : bitmap, 'format' : 'auto' })
+    assert 'format = float16' in str(texture)
+
+    bitmap = mi.Bitmap(np.zeros((4, 4, 3), dtype=np.float32))
+    texture = mi.load_dict({ 'type' : 'bitmap', 'bitmap' : bitmap, 'format' : 'auto' })
+    assert 'format' not in str(texture)
+
+    with pytest.raises(RuntimeError, match='Invalid format'):
+        mi.load_dict({ 'type' : 'bitmap', 'bitmap' : bitmap, 'format' : 'float64' })
+
+
+def test12_reduced_precision_spectral(variant_scalar_spectral, np_rng):
+    import numpy as np
+    data = np_rng.random((8, 8, 3)).astype(np.float32)
+    bitmap = mi.Bitmap(data)
+
+    reference = mi.load_dict({ 'type' : 'bitmap', 'bitmap' : bitmap })
+    packed = mi.load_dict({ 'type' : 'bitmap', 'bitmap' : bitmap, 'format' : 'uint8' })
+
+    # Spectral coefficients fall back to half precision
+    assert 'format = float16' in str(packed)
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.wavelengths = [400, 500, 600, 700]
+    for uv in np_rng.random((20, 2)):
+        si.uv = uv
+        assert dr.allclose(packed.eval(si), reference.eval(si), atol=1e-2)
+
+
+def test13_reduced_precision_trilinear(variant_scalar_rgb):
+    import numpy as np
+    checker = (np.indices((64, 64)).sum(axis=0) % 2).astype(np.float32)
+    bitmap = mi.Bitmap(checker[..., None], mi.Bitmap.PixelFormat.Y)
+    texture = mi.load_dict({
+        'type' : 'bitmap',
+        'bitmap' : bitmap,
+        'raw' : True,
+        'filter_type' : 'trilinear',
+        'format' : 'uint8'
+    })
+    assert 'mip_levels = 6' in str(texture)
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.uv = [0.3, 0.7]
+    si.duv_dx = [16 / 64, 0]
+    si.duv_dy = [0, 16 / 64]
+    assert dr.allclose(texture.eval_1(si), 0.5, atol=0.05)
+
+
+def test14_shared_data(variants_all_rgb, tmp_path):
+    import numpy as np
+    filename = str(tmp_path / 'texture.exr')
+    mi.Bitmap(np.full((8, 8, 3), 0.25, dtype=np.float32)).write(filename)
+
+    def make(**kwargs):
+        return mi.load_dict({ 'type' : 'bitmap', 'filename' : filename, **kwargs })
+
+    mi.SharedCache.reset_stats()
+    textures = [make() for i in range(4)]
+    nearest = make(filter_type='nearest')
+
+    stats = mi.SharedCache.stats()
+    assert stats.requests == 5
+    assert stats.hits == 3
+    assert stats.bytes_saved == 3 * 8 * 8 * 3 * 4
+
+    # Modifying the data of one texture doesn't affect the others
+    params = mi.traverse(textures[0])
+    params['data'] = dr.full(mi.TensorXf, 0.75, (8, 8, 3))
+    params.update()
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.uv = [0.5, 0.5]
+    assert dr.allclose(textures[0].eval(si), 0.75)
+    assert dr.allclose(textures[1].eval(si), 0.25)
+    assert dr.allclose(nearest.eval(si), 0.25)
+
+    # New instances still share the original data
+    assert dr.allclose(make().eval(si), 0.25)
+    assert mi.SharedCache.stats().hits == 4
+
+    # Overwriting the file invalidates the cached data, even if the size of
+    # the file didn't change
+    import os
+    mtime = os.stat(filename).st_mtime
+    mi.Bitmap(np.full((8, 8, 3), 0.5, dtype=np.float32)).write(filename)
+    os.utime(filename, (mtime + 10, mtime + 10))
+    assert dr.allclose(make().eval(si), 0.5)
+    assert mi.SharedCache.stats().hits == 4
+
+
+def test15_spectral_cache(variant_scalar_spectral, tmp_path, np_rng):
+    import numpy as np, glob, os
+    filename = str(tmp_path / 'texture.exr')
+    mi.Bitmap(np_rng.random((16, 16, 3)).astype(np.float32)).write(filename)
+
+    def make():
+        return mi.load_dict({
+            'type' : 'bitmap',
+            'filename' : filename,
+            'filter_type' : 'trilinear',
+            'spectral_cache' : True
+        })
+
+    si = dr.zeros(mi.SurfaceInteraction3f)
+    si.wavelengths = [400, 500, 600, 700]
+    si.duv_dx = [0.1, 0]
+    si.duv_dy = [0, 0.1]
+    uvs = np_rng.random((20, 2))
+
+    def evaluate(texture):
+        result = []
+        for uv in uvs:
+            si.uv = uv
+            result.append(texture.eval(si))
+        return result, texture.mean()
+
+    reference = evaluate(make())
+    cache_files = glob.glob(filename + '.*.spec')
+    assert len(cache_files) == 1
+
+    # The second load reads the coefficients from the cache
+    mtime = os.path.getmtime(cache_files[0])
+    cached = evaluate(make())
+    assert os.path.getmtime(cache_files[0]) == mtime
+    for a, b in zip(reference[0], cached[0]):
+        assert dr.allclose(a, b)
+    assert dr.allclose(reference[1], cached[1])
+
+    # Corrupt cache files are ignored
+    with open(cache_files[0], 'wb') as f:
+        f.write(b'garbage')
+    corrupt = evaluate(make())
+    assert dr.allclose(reference[1], corrupt[1])
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'bilinear'])
+@pytest.mark.parametrize('wrap_mode', ['repeat', 'mirror', 'clamp'])
+def test16_eval_1_batch(variant_scalar_rgb, np_rng, filter_type, wrap_mode):
+    import numpy as np
+
+    def make(channels, res=(17, 13), **kwargs):
+        data = np_rng.random((res[1], res[0], channels)).astype(np.float32)
+        # Tensor data is always stored in single precision
+        if kwargs.get('format', 'float32') == 'float32':
+            source = { 'data': mi.TensorXf(data) }
+        else:
+            source = { 'bitmap': mi.Bitmap(data) }
+        return mi.load_dict({
+            'type': 'bitmap',
+            **source,
+            'raw': True,
+            'filter_type': filter_type,
+            'wrap_mode': wrap_mode,
+            **kwargs
+        })
+
+    textures = [
+        make(1),
+        make(3),
+        None,
+        make(1, res=(8, 8)),        # Different resolution
+        make(1, format='float16'),  # Reduced precision storage
+        mi.load_dict({ 'type': 'checkerboard' }),
+        make(1)
+    ]
+
+    si = mi.SurfaceInteraction3f()
+    for uv in np_rng.random((20, 2)) * 3 - 1:
+        si.uv = uv
+        values = mi.Texture.eval_1_batch(textures, si)
+        assert len(values) == len(textures)
+        for texture, value in zip(textures, values):
+            if texture is None:
+                assert value == 0
+            else:
+                assert dr.allclose(value, texture.eval_1(si), atol=1e-5)
+
+
+def test17_texture_atlas(variants_vec_rgb, np_rng):
+    import numpy as np
+
+    def make_scene(texture_atlas):
+        rng = np.random.default_rng(seed=0)
+        scene = {
+            'type': 'scene',
+            'texture_atlas': texture_atlas,
+            'integrator': { 'type': 'direct' },
+            'emitter': { 'type': 'constant' },
+            'sensor': {
+                'type': 'perspective',
+                'to_world': mi.ScalarTransform4f.look_at(
+                    origin=[0, 0, 8], target=[0, 0, 0], up=[0, 1, 0]),
+                'film': { 'type': 'hdrfilm', 'width': 48, 'height': 48 }
+            }
+        }
+
+        wrap_modes = ['repeat', 'clamp', 'mirror']
+        for i in range(9):
+            res = rng.integers(2, 12, size=2)
+            data = rng.random((res[1], res[0], 3)).astype(np.float32)
+            scene[f'rect_{i}'] = {
+                'type': 'rectangle',
+                'to_world': mi.ScalarTransform4f.translate(
+                    [(i % 3) * 2 - 2, (i // 3) * 2 - 2, 0]).scale(0.9),
+                'bsdf': {
+                    'type': 'diffuse',
+                    'reflectance': {
+                        'type': 'bitmap',
+                        'data': mi.TensorXf(data),
+                        'raw': True,
+                        'accel': False,
+                        'wrap_mode': wrap_modes[i % 3],
+                        'to_uv': mi.ScalarTransform4f.scale([3, 2, 1]),
+                        'filter_type': 'nearest' if i == 8 else 'bilinear'
+                    }
+                }
+            }
+        return mi.load_dict(scene)
+
+    # The texture with nearest filtering doesn't have a compatible partner
+    scene = make_scene(True)
+    assert sum('atlas' in str(s.bsdf()) for s in scene.shapes()) == 8
+
+    image = mi.render(scene, spp=4, seed=0)
+    ref = mi.render(make_scene(False), spp=4, seed=0)
+    assert dr.allclose(image, ref, atol=1e-4)
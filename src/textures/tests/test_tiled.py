@@ -0,0 +1,168 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+
+
+def make_tiled(tmp_path, res=(100, 70), channels=3, tile_size=16, seed=0):
+    import numpy as np
+    rng = np.random.default_rng(seed)
+    data = rng.random((res[1], res[0], channels)).astype(np.float32)
+    exr_path = str(tmp_path / 'texture.exr')
+    tiled_path = str(tmp_path / 'texture.mitiled')
+    mi.Bitmap(data).write(exr_path)
+    mi.TiledImage.convert(exr_path, tiled_path, tile_size=tile_size, raw=True)
+    return exr_path, tiled_path
+
+
+def test01_tiled_image(variant_scalar_rgb, tmp_path):
+    exr_path, tiled_path = make_tiled(tmp_path)
+    image = mi.TiledImage(tiled_path)
+    bitmap = mi.Bitmap(exr_path)
+
+    assert image.channel_count() == 3
+    assert image.tile_size() == 16
+    assert dr.all(image.size() == [100, 70])
+    assert dr.all(image.size(1) == [50, 35])
+    assert image.level_count() == 6
+
+    import numpy as np
+    ref = np.array(bitmap)
+    for x, y in [(0, 0), (99, 69), (17, 33), (64, 15), (15, 16)]:
+        assert dr.allclose(image.read(0, [x, y]), ref[y, x])
+
+    with pytest.raises(IndexError):
+        image.read(0, [100, 0])
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'bilinear'])
+@pytest.mark.parametrize('wrap_mode', ['repeat', 'clamp', 'mirror'])
+def test02_eval(variant_scalar_rgb, tmp_path, np_rng, filter_type, wrap_mode):
+    exr_path, tiled_path = make_tiled(tmp_path)
+
+    params = { 'filter_type': filter_type, 'wrap_mode': wrap_mode, 'raw': True }
+    bitmap = mi.load_dict({ 'type': 'bitmap', 'filename': exr_path, **params })
+    tiled = mi.load_dict({ 'type': 'tiled', 'filename': tiled_path, **params })
+
+    assert dr.all(tiled.resolution() == bitmap.resolution())
+
+    si = mi.SurfaceInteraction3f()
+    for uv in np_rng.random((50, 2)) * 3 - 1:
+        si.uv = uv
+        assert dr.allclose(tiled.eval_3(si), bitmap.eval_3(si), atol=1e-5)
+        assert dr.allclose(tiled.eval_1(si), bitmap.eval_1(si), atol=1e-5)
+
+
+def test03_trilinear(variant_scalar_rgb, tmp_path):
+    _, tiled_path = make_tiled(tmp_path, res=(64, 64), channels=1)
+    tiled = mi.load_dict({
+        'type': 'tiled',
+        'filename': tiled_path,
+        'filter_type': 'trilinear'
+    })
+    assert tiled.needs_differentials()
+
+    # A footprint covering the whole texture returns the average value
+    si = mi.SurfaceInteraction3f()
+    si.uv = [0.5, 0.5]
+    si.duv_dx = [1, 0]
+    si.duv_dy = [0, 1]
+    assert dr.allclose(tiled.eval_1(si), tiled.mean(), atol=1e-2)
+
+
+def test04_cache_stats(variant_scalar_rgb, tmp_path, np_rng):
+    _, tiled_path = make_tiled(tmp_path, res=(128, 128), tile_size=16)
+    tiled = mi.load_dict({ 'type': 'tiled', 'filename': tiled_path })
+
+    mi.TiledImage.clear_cache()
+    mi.TiledImage.reset_cache_stats()
+
+    si = mi.SurfaceInteraction3f()
+    for uv in np_rng.random((200, 2)):
+        si.uv = uv
+        tiled.eval(si)
+
+    stats = mi.TiledImage.cache_stats()
+    # At most all 64 tiles of the full resolution image were loaded
+    assert 0 < stats.misses <= 64
+    assert stats.bytes_read == stats.misses * 16 * 16 * 3 * 4
+    assert stats.resident_bytes == stats.bytes_read
+    assert stats.hits + stats.hint_hits + stats.misses == 200 * 4
+    assert 0 < stats.hit_rate() < 1
+
+
+def test05_eviction(variant_scalar_rgb, tmp_path):
+    _, tiled_path = make_tiled(tmp_path, res=(256, 256), tile_size=16)
+    image = mi.TiledImage(tiled_path)
+
+    budget = mi.TiledImage.cache_budget()
+    try:
+        mi.TiledImage.clear_cache()
+        mi.TiledImage.reset_cache_stats()
+        # Room for about 64 tiles, shared by the 16 partitions of the cache
+        mi.TiledImage.set_cache_budget(64 * 16 * 16 * 3 * 4)
+
+        values = []
+        for it in range(2):
+            for y in range(0, 256, 16):
+                for x in range(0, 256, 16):
+                    value = image.read(0, [x, y])
+                    if it == 0:
+                        values.append(value)
+                    else:
+                        assert value == values.pop(0)
+
+        stats = mi.TiledImage.cache_stats()
+        assert stats.evictions > 0
+        assert stats.misses > 256
+        assert stats.resident_bytes <= mi.TiledImage.cache_budget()
+    finally:
+        mi.TiledImage.set_cache_budget(budget)
+
+
+def test06_cache_budget_property(variant_scalar_rgb, tmp_path):
+    import gc
+    _, tiled_path = make_tiled(tmp_path)
+
+    def make(budget):
+        return mi.load_dict({ 'type': 'tiled', 'filename': tiled_path,
+                              'cache_budget': budget })
+
+    budget = mi.TiledImage.cache_budget()
+    try:
+        mi.TiledImage.set_cache_budget(1024 * 1024 * 1024)
+
+        # A budget larger than the default is applied
+        large = make(4096)
+        assert mi.TiledImage.cache_budget() == 4096 * 1024 * 1024
+
+        # The smallest budget among live textures is used
+        small = make(16)
+        assert mi.TiledImage.cache_budget() == 16 * 1024 * 1024
+        del small
+        gc.collect()
+        assert mi.TiledImage.cache_budget() == 4096 * 1024 * 1024
+
+        # The previous budget is restored once all textures are released
+        del large
+        gc.collect()
+        assert mi.TiledImage.cache_budget() == 1024 * 1024 * 1024
+    finally:
+        mi.TiledImage.set_cache_budget(budget)
+
+
+def test07_spectral(variant_scalar_spectral, tmp_path):
+    import numpy as np
+    data = np.full((32, 32, 3), [0.2, 0.5, 0.7], dtype=np.float32)
+    exr_path = str(tmp_path / 'constant.exr')
+    tiled_path = str(tmp_path / 'constant.mitiled')
+    mi.Bitmap(data).write(exr_path)
+    mi.TiledImage.convert(exr_path, tiled_path)
+
+    bitmap = mi.load_dict({ 'type': 'bitmap', 'filename': exr_path })
+    tiled = mi.load_dict({ 'type': 'tiled', 'filename': tiled_path })
+
+    si = mi.SurfaceInteraction3f()
+    si.uv = [0.3, 0.6]
+    si.wavelengths = [400, 500, 600, 700]
+    assert dr.allclose(tiled.eval(si), bitmap.eval(si), atol=1e-5)
+    assert dr.allclose(tiled.mean(), bitmap.mean(), atol=1e-5)
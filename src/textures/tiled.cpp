@@ -0,0 +1,433 @@
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/tiledimage.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/render/interaction.h>
+#include <mitsuba/render/srgb.h>
+#include <mitsuba/render/texture.h>
+#include <drjit/texture.h>
+#include <cstdint>
+#include <mutex>
+#include <set>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+
+.. _texture-tiled:
+
+Tiled texture (:monosp:`tiled`)
+-------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename of the tiled image to be loaded (see below)
+
+ * - filter_type
+   - |string|
+   - Specifies how pixel values are interpolated and filtered. The following
+     options are currently available:
+
+     - ``bilinear`` (default): perform bilinear interpolation, but no filtering.
+
+     - ``nearest``: perform nearest neighbor lookups.
+
+     - ``trilinear``: interpolate bilinearly between the two levels of the
+       MIP pyramid whose resolution best matches the footprint of the pixel
+       in texture space (see the :ref:`bitmap <texture-bitmap>` plugin).
+
+ * - wrap_mode
+   - |string|
+   - Controls the behavior of texture evaluations that fall outside of the
+     :math:`[0, 1]` range: ``repeat`` (default), ``mirror``, or ``clamp``.
+
+ * - raw
+   - |bool|
+   - Should spectral upsampling of the stored color data be disabled? By
+     default, this matches the :paramtype:`raw` setting used when the image
+     was converted.
+
+ * - cache_budget
+   - |float|
+   - Maximum amount of memory (in MiB) occupied by the tiles of all tiled
+     textures. The value may be larger or smaller than the global default of
+     1024 MiB. When several textures specify a budget, the smallest one among
+     the textures that are still alive is used, and the previous budget is
+     restored once all of them have been released. (Default: the global
+     budget, see :monosp:`TiledImage.set_cache_budget()`)
+
+ * - to_uv
+   - |transform|
+   - Specifies an optional 3x3 transformation matrix that will be applied to UV
+     values. A 4x4 matrix can also be provided, in which case the extra row and
+     column are ignored.
+   - |exposed|
+
+This plugin renders textures that do not fit into memory. Rather than loading
+the complete image, it accesses a pre-filtered image pyramid on disk that is
+split into square tiles. Tiles are loaded when they are first accessed and
+kept in a cache that is shared by all tiled textures. When its budget is
+exceeded, the least recently used tiles are evicted. The hit rate of the
+cache and the amount of data read from disk are reported in the log once
+the textures are released, and can be queried using
+``mi.TiledImage.cache_stats()``.
+
+Tiled images are created from any image supported by the
+:ref:`bitmap <texture-bitmap>` plugin (including OpenEXR files) as follows:
+
+.. code-block:: python
+
+    mi.TiledImage.convert('texture.exr', 'texture.mitiled', tile_size=64)
+
+Unless ``raw=True`` is specified, the conversion undoes the sRGB gamma curve
+of the input. The levels of the pyramid are computed assuming a repeating
+texture. In spectral modes, colors are upsampled when tiles are accessed.
+
+.. note:: This plugin is only supported in scalar variants.
+
+.. tabs::
+    .. code-tab:: xml
+        :name: tiled-texture
+
+        <texture type="tiled">
+            <string name="filename" value="texture.mitiled"/>
+            <string name="filter_type" value="trilinear"/>
+        </texture>
+
+    .. code-tab:: python
+
+        'type': 'tiled',
+        'filename': 'texture.mitiled',
+        'filter_type': 'trilinear'
+
+*/
+
+/* Cache budgets requested by live tiled textures via 'cache_budget'. The
+   shared tile cache uses the smallest one, and the budget that was active
+   before the first request is restored once the last texture is released. */
+static std::mutex budget_mutex;
+static std::multiset<size_t> budget_requests;
+static size_t budget_previous = 0;
+
+/// Apply the smallest requested budget (0, i.e. unlimited, sorts last)
+static void apply_budget_requests() {
+    size_t budget = budget_requests.empty() ? budget_previous
+                                            : *budget_requests.begin();
+    TiledImage::set_cache_budget(budget == SIZE_MAX ? 0 : budget);
+}
+
+template <typename Float, typename Spectrum>
+class TiledTexture final : public Texture<Float, Spectrum> {
+public:
+    MI_IMPORT_TYPES(Texture)
+
+    TiledTexture(const Properties &props) : Texture(props) {
+        if constexpr (dr::is_array_v<Float>)
+            Throw("The \"tiled\" texture plugin is only supported in scalar "
+                  "variants!");
+
+        m_transform = props.get<ScalarTransform3f>("to_uv", ScalarTransform3f());
+
+        FileResolver *fs = Thread::thread()->file_resolver();
+        fs::path file_path = fs->resolve(props.string("filename"));
+        m_name = file_path.filename().string();
+        Log(Debug, "Opening tiled texture \"%s\" ..", m_name);
+        m_image = new TiledImage(file_path);
+
+        std::string filter_mode_str = props.string("filter_type", "bilinear");
+        if (filter_mode_str == "nearest")
+            m_filter = Filter::Nearest;
+        else if (filter_mode_str == "bilinear")
+            m_filter = Filter::Bilinear;
+        else if (filter_mode_str == "trilinear")
+            m_filter = Filter::Trilinear;
+        else
+            Throw("Invalid filter type \"%s\", must be one of: \"nearest\", "
+                  "\"bilinear\", or \"trilinear\"!", filter_mode_str);
+
+        std::string wrap_mode_str = props.string("wrap_mode", "repeat");
+        if (wrap_mode_str == "repeat")
+            m_wrap_mode = dr::WrapMode::Repeat;
+        else if (wrap_mode_str == "mirror")
+            m_wrap_mode = dr::WrapMode::Mirror;
+        else if (wrap_mode_str == "clamp")
+            m_wrap_mode = dr::WrapMode::Clamp;
+        else
+            Throw("Invalid wrap mode \"%s\", must be one of: \"repeat\", "
+                  "\"mirror\", or \"clamp\"!", wrap_mode_str);
+
+        m_raw = props.get<bool>("raw", m_image->raw());
+
+        if constexpr (!dr::is_array_v<Float>)
+            m_mean = compute_mean();
+
+        if (props.has_property("cache_budget")) {
+            m_cache_budget = (size_t) (props.get<ScalarFloat>("cache_budget") *
+                                       1024.f * 1024.f);
+            if (m_cache_budget == 0)
+                m_cache_budget = SIZE_MAX;
+
+            std::lock_guard<std::mutex> guard(budget_mutex);
+            if (budget_requests.empty())
+                budget_previous = TiledImage::cache_budget();
+            budget_requests.insert(m_cache_budget);
+            apply_budget_requests();
+        }
+    }
+
+    ~TiledTexture() {
+        if (m_cache_budget == 0)
+            return;
+        std::lock_guard<std::mutex> guard(budget_mutex);
+        budget_requests.erase(budget_requests.find(m_cache_budget));
+        apply_budget_requests();
+    }
+
+    void traverse(TraversalCallback *callback) override {
+        callback->put_parameter("to_uv", m_transform, +ParamFlags::NonDifferentiable);
+    }
+
+    UnpolarizedSpectrum eval(const SurfaceInteraction3f &si,
+                             Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if constexpr (dr::is_array_v<Float>) {
+            DRJIT_MARK_USED(si);
+            return dr::zeros<UnpolarizedSpectrum>();
+        } else {
+            uint32_t channels = m_image->channel_count();
+            if (channels == 3 && is_spectral_v<Spectrum> && m_raw)
+                Throw("The tiled texture %s was queried for a spectrum, but "
+                      "texture conversion into spectra was explicitly "
+                      "disabled! (raw=true)", to_string());
+
+            if (!active)
+                return dr::zeros<UnpolarizedSpectrum>();
+
+            if (channels == 1)
+                return filter<Float>(si);
+
+            if constexpr (is_monochromatic_v<Spectrum>)
+                return luminance(filter<Color3f>(si));
+            else if constexpr (is_spectral_v<Spectrum>)
+                return filter<UnpolarizedSpectrum>(si);
+            else
+                return filter<Color3f>(si);
+        }
+    }
+
+    Float eval_1(const SurfaceInteraction3f &si,
+                 Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if constexpr (dr::is_array_v<Float>) {
+            DRJIT_MARK_USED(si);
+            return dr::zeros<Float>();
+        } else {
+            uint32_t channels = m_image->channel_count();
+            if (channels == 3 && is_spectral_v<Spectrum> && !m_raw)
+                Throw("eval_1(): The tiled texture %s was queried for a "
+                      "monochromatic value, but texture conversion to color "
+                      "spectra had previously been requested! (raw=false)",
+                      to_string());
+
+            if (!active)
+                return 0.f;
+
+            if (channels == 1)
+                return filter<Float>(si);
+            return luminance(filter<Color3f>(si));
+        }
+    }
+
+    Color3f eval_3(const SurfaceInteraction3f &si,
+                   Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if constexpr (dr::is_array_v<Float>) {
+            DRJIT_MARK_USED(si);
+            return dr::zeros<Color3f>();
+        } else {
+            if (m_image->channel_count() != 3)
+                Throw("eval_3(): The tiled texture %s was queried for a RGB "
+                      "value, but it is monochromatic!", to_string());
+            else if (is_spectral_v<Spectrum> && !m_raw)
+                Throw("eval_3(): The tiled texture %s was queried for a RGB "
+                      "value, but texture conversion to color spectra had "
+                      "previously been requested! (raw=false)", to_string());
+
+            if (!active)
+                return 0.f;
+
+            return filter<Color3f>(si);
+        }
+    }
+
+    ScalarVector2i resolution() const override {
+        return ScalarVector2i(m_image->size());
+    }
+
+    Float mean() const override { return m_mean; }
+
+    bool is_spatially_varying() const override { return true; }
+
+    bool needs_differentials() const override {
+        return m_filter == Filter::Trilinear;
+    }
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "TiledTexture[" << std::endl
+            << "  name = \"" << m_name << "\"," << std::endl
+            << "  resolution = \"" << resolution() << "\"," << std::endl
+            << "  levels = " << m_image->level_count() << "," << std::endl
+            << "  tile_size = " << m_image->tile_size() << "," << std::endl
+            << "  raw = " << (int) m_raw << "," << std::endl
+            << "  mean = " << m_mean << "," << std::endl
+            << "  transform = " << string::indent(m_transform) << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+protected:
+    /// Return the value of a texel of the given level
+    template <typename Value>
+    Value texel(uint32_t level, ScalarVector2i p,
+                const Wavelength &wavelengths) const {
+        ScalarVector2i size = ScalarVector2i(m_image->size(level));
+
+        switch (m_wrap_mode) {
+            case dr::WrapMode::Repeat:
+                p = p % size;
+                p = dr::select(p < 0, p + size, p);
+                break;
+
+            case dr::WrapMode::Mirror:
+                p = p % (2 * size);
+                p = dr::select(p < 0, p + 2 * size, p);
+                p = dr::select(p >= size, 2 * size - 1 - p, p);
+                break;
+
+            default:
+                break;
+        }
+        p = dr::clamp(p, 0, size - 1);
+
+        float value[3];
+        m_image->read(level, ScalarVector2u(p), value);
+
+        if constexpr (std::is_same_v<Value, Float>) {
+            DRJIT_MARK_USED(wavelengths);
+            return value[0];
+        } else {
+            ScalarColor3f rgb = m_image->channel_count() == 1
+                                    ? ScalarColor3f(value[0])
+                                    : ScalarColor3f(value[0], value[1], value[2]);
+            if constexpr (std::is_same_v<Value, Color3f>) {
+                DRJIT_MARK_USED(wavelengths);
+                return rgb;
+            } else {
+                return srgb_model_eval<UnpolarizedSpectrum>(
+                    srgb_model_fetch(rgb), wavelengths);
+            }
+        }
+    }
+
+    /// Interpolated lookup into a single level of the pyramid
+    template <typename Value>
+    Value lookup(uint32_t level, const Point2f &uv,
+                 const Wavelength &wavelengths) const {
+        ScalarVector2f size = ScalarVector2f(m_image->size(level));
+
+        if (m_filter == Filter::Nearest)
+            return texel<Value>(level, dr::floor2int<ScalarVector2i>(uv * size),
+                                wavelengths);
+
+        Point2f p = dr::fmadd(uv, size, -.5f);
+        ScalarVector2i pi = dr::floor2int<ScalarVector2i>(p);
+        Point2f w1 = p - Point2f(pi), w0 = 1.f - w1;
+
+        Value v00 = texel<Value>(level, pi, wavelengths),
+              v10 = texel<Value>(level, pi + ScalarVector2i(1, 0), wavelengths),
+              v01 = texel<Value>(level, pi + ScalarVector2i(0, 1), wavelengths),
+              v11 = texel<Value>(level, pi + ScalarVector2i(1, 1), wavelengths);
+
+        Value v0 = dr::fmadd(w0.x(), v00, w1.x() * v10),
+              v1 = dr::fmadd(w0.x(), v01, w1.x() * v11);
+
+        return dr::fmadd(w0.y(), v0, w1.y() * v1);
+    }
+
+    /// Evaluate the texture, filtering over the pixel footprint if requested
+    template <typename Value>
+    Value filter(const SurfaceInteraction3f &si) const {
+        Point2f uv = m_transform.transform_affine(si.uv);
+
+        if (m_filter != Filter::Trilinear)
+            return lookup<Value>(0, uv, si.wavelengths);
+
+        // Footprint width in units of texels of the full resolution image
+        ScalarVector2f res = ScalarVector2f(m_image->size());
+        Float width = dr::maximum(
+            dr::norm(m_transform.transform_affine(si.duv_dx) * res),
+            dr::norm(m_transform.transform_affine(si.duv_dy) * res));
+
+        uint32_t level_count = m_image->level_count();
+        Float level = dr::clamp(dr::log2(dr::maximum(width, 1e-8f)), 0.f,
+                                (ScalarFloat) (level_count - 1));
+        uint32_t level_i = (uint32_t) level;
+        Float t = level - (Float) level_i;
+
+        Value result = lookup<Value>(level_i, uv, si.wavelengths);
+        if (t > 0.f && level_i + 1 < level_count)
+            result = dr::fmadd(t, lookup<Value>(level_i + 1, uv, si.wavelengths),
+                               (1.f - t) * result);
+        return result;
+    }
+
+    /// Average the coarsest level of the pyramid
+    Float compute_mean() const {
+        uint32_t level = m_image->level_count() - 1;
+        ScalarVector2u size = ScalarVector2u(m_image->size(level));
+
+        double mean = 0.0;
+        float value[3];
+        for (uint32_t y = 0; y < size.y(); ++y) {
+            for (uint32_t x = 0; x < size.x(); ++x) {
+                m_image->read(level, ScalarVector2u(x, y), value);
+                if (m_image->channel_count() == 1)
+                    mean += (double) value[0];
+                else if (is_spectral_v<Spectrum> && !m_raw)
+                    mean += (double) srgb_model_mean(srgb_model_fetch(
+                        ScalarColor3f(value[0], value[1], value[2])));
+                else
+                    mean += (double) luminance(
+                        ScalarColor3f(value[0], value[1], value[2]));
+            }
+        }
+
+        return Float(mean / dr::prod(size));
+    }
+
+protected:
+    enum class Filter { Nearest, Bilinear, Trilinear };
+
+    ref<TiledImage> m_image;
+    ScalarTransform3f m_transform;
+    Filter m_filter;
+    dr::WrapMode m_wrap_mode;
+    bool m_raw;
+    Float m_mean;
+    std::string m_name;
+    /// Budget requested via 'cache_budget' (0: none, SIZE_MAX: unlimited)
+    size_t m_cache_budget = 0;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(TiledTexture, Texture)
+MI_EXPORT_PLUGIN(TiledTexture, "Tiled texture")
+
+NAMESPACE_END(mitsuba)
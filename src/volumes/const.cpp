@@ -83,6 +83,28 @@ public:
 
     ScalarFloat max() const override { return m_value->max(); }
 
+    TensorXf local_minorants(const ScalarVector3i &grid_resolution,
+                             ScalarFloat value_scale = 1.f) const override {
+        /* The value doesn't vary in space. In spectral modes, its minimum
+           over all wavelengths is only known when it is uniform. */
+        ScalarFloat minimum = 0.f;
+        if constexpr (!is_spectral_v<Spectrum>) {
+            UnpolarizedSpectrum value = eval(dr::zeros<Interaction3f>(), true);
+            minimum = dr::slice(dr::min(value), 0);
+        } else {
+            ScalarFloat mean = dr::slice(m_value->mean(), 0);
+            if (mean == m_value->max())
+                minimum = mean;
+        }
+
+        size_t shape[4] = { (size_t) grid_resolution.z(),
+                            (size_t) grid_resolution.y(),
+                            (size_t) grid_resolution.x(), 1 };
+        std::vector<ScalarFloat> values(shape[0] * shape[1] * shape[2],
+                                        dr::maximum(minimum, 0.f) * value_scale);
+        return TensorXf(values.data(), 4, shape);
+    }
+
     std::string to_string() const override {
         std::ostringstream oss;
         oss << "ConstVolume[" << std::endl
@@ -3,11 +3,14 @@
 #include <mitsuba/core/spectrum.h>
 #include <mitsuba/core/string.h>
 #include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
 #include <mitsuba/render/srgb.h>
 #include <mitsuba/render/volume.h>
 #include <mitsuba/render/volumegrid.h>
 #include <drjit/dynamic.h>
 #include <drjit/texture.h>
+#include <nanothread/nanothread.h>
+#include <mutex>
 
 NAMESPACE_BEGIN(mitsuba)
 
@@ -76,6 +79,42 @@ Grid-based volume data source (:monosp:`gridvolume`)
      cause small differences as hardware interpolation methods typically have a
      loss of precision (not exactly 32-bit arithmetic). (Default: true)
 
+ * - storage
+   - |string|
+   - Specifies the precision of the volume data kept in memory. The following
+     options are currently available:
+
+     - ``float32`` (default): single precision floating point values.
+
+     - ``float16``: half precision floating point values.
+
+     - ``unorm16``, ``unorm8``: 16-bit or 8-bit integers that are mapped
+       linearly onto the range of values of each channel (extended to
+       include zero, so that empty regions remain empty). In spectral modes,
+       the coefficients of upsampled spectra are stored using ``float16``
+       instead.
+
+     Reduced precision formats decrease the memory usage and bandwidth of
+     lookups, but they can't be modified or differentiated, and
+     :paramtype:`accel` has no effect. The maximum of the volume and the
+     majorants derived from it are computed from the decoded values, so
+     that they remain exact.
+
+ * - mip_levels
+   - |int|
+   - Number of levels of detail. Each level halves the resolution of the
+     previous one by averaging blocks of 2x2x2 voxels, and is stored in
+     single precision. Media look up the level whose voxels match the
+     footprint of a path (see the ``lod_spread`` parameter of :ref:`volpath
+     <integrator-volpath>`). Only volumes with 1 channel, or 3 channels in
+     RGB and monochrome modes, support more than one level. (Default: 1)
+
+Lookups into two grids with the same resolution, transformation, filter and
+wrap mode can share the transformation and the trilinear interpolation weights
+(see :ref:`heterogeneous <medium-heterogeneous>`). This applies to grids with a
+single level and 1 channel (or 3 channels in RGB and monochrome modes), except
+with hardware-accelerated lookups in CUDA mode, which remain separate.
+
 This class implements access to volume data stored on a 3D grid using a
 simple binary exchange format (compatible with Mitsuba 0.6). When appropriate,
 spectral upsampling is applied at loading time to convert RGB values to
@@ -93,7 +132,7 @@ little endian encoding and is specified as follows:
    * - Bytes 1-3
      - ASCII Bytes ’V’, ’O’, and ’L’
    * - Byte 4
-     - File format version number (currently 3)
+     - File format version number (3 or 4)
    * - Bytes 5-8
      - Encoding identified (32-bit integer). Currently, only a value of 1 is
        supported (float32-based representation)
@@ -108,13 +147,25 @@ little endian encoding and is specified as follows:
    * - Bytes 25-48
      - Axis-aligned bounding box of the data stored in single precision (order:
        xmin, ymin, zmin, xmax, ymax, zmax)
-   * - Bytes 49-*
+   * - Bytes 49-52
+     - *Version 4 only*: maximum value over all channels (single precision)
+   * - Next :math:`4C` bytes
+     - *Version 4 only*: maximum value of each of the :math:`C` channels
+       (single precision), followed by zero bytes up to the next multiple
+       of 64 bytes
+   * - Remaining bytes
      - Binary data of the volume stored in the specified encoding. The data
        are ordered so that the following C-style indexing operation makes sense
        after the file has been loaded into memory:
        :code:`data[((zpos*yres + ypos)*xres + xpos)*channels + chan]`
        where (xpos, ypos, zpos, chan) denotes the lookup location.
 
+Version 4 files are memory-mapped while they are loaded rather than read,
+and their maximum does not need to be computed, which substantially reduces
+the loading time of large volumes. ``mi.VolumeGrid.write()`` creates version 4
+files by default. Its ``version`` parameter can be set to 3 to create files
+that can be read by older releases.
+
 .. tabs::
     .. code-tab:: xml
 
@@ -153,6 +204,8 @@ public:
     MI_IMPORT_BASE(Volume, update_bbox, m_to_local, m_bbox, m_channel_count)
     MI_IMPORT_TYPES(VolumeGrid)
 
+    using FloatStorage = DynamicBuffer<Float>;
+
     GridVolume(const Properties &props) : Base(props) {
         std::string filter_type_str = props.string("filter_type", "trilinear");
         dr::FilterMode filter_mode;
@@ -180,8 +233,21 @@ public:
         m_raw = props.get<bool>("raw", false);
         m_accel = props.get<bool>("accel", true);
 
+        std::string storage_str = props.string("storage", "float32");
+        if (storage_str == "float32")
+            m_format = StorageFormat::Float32;
+        else if (storage_str == "float16")
+            m_format = StorageFormat::Float16;
+        else if (storage_str == "unorm16")
+            m_format = StorageFormat::UNorm16;
+        else if (storage_str == "unorm8")
+            m_format = StorageFormat::UNorm8;
+        else
+            Throw("Invalid storage \"%s\", must be one of: \"float32\", "
+                  "\"float16\", \"unorm16\", or \"unorm8\"!", storage_str);
+
         // Load volume data
-        ref<VolumeGrid> volume_grid = nullptr;
+        ref<const VolumeGrid> volume_grid = nullptr;
         TensorXf* tensor = nullptr;
         {
             ScalarVector3u res;
@@ -228,7 +294,7 @@ public:
                     Throw("Spectral conversion of tensor input is not supported "
                           "and requires a volume grid");
 
-                ScalarFloat *ptr = volume_grid->data();
+                const ScalarFloat *ptr = volume_grid->data();
 
                 auto scaled_data =
                     std::unique_ptr<ScalarFloat[]>(new ScalarFloat[size * 4]);
@@ -250,14 +316,18 @@ public:
                 }
                 m_max = (float) max;
 
+                // The polynomial coefficients don't tolerate quantization
+                if (m_format == StorageFormat::UNorm16 ||
+                    m_format == StorageFormat::UNorm8)
+                    m_format = StorageFormat::Float16;
+
                 size_t shape[4] = {
                     (size_t) res.z(),
                     (size_t) res.y(),
                     (size_t) res.x(),
                     4
                 };
-                m_texture = Texture3f(TensorXf(scaled_data.get(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
+                init_texture(scaled_data.get(), shape, filter_mode, wrap_mode);
             } else if (volume_grid) {
                 size_t shape[4] = {
                     (size_t) res.z(),
@@ -265,12 +335,11 @@ public:
                     (size_t) res.x(),
                     channel_count
                 };
-                m_texture = Texture3f(TensorXf(volume_grid->data(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
                 m_max = volume_grid->max();
                 m_max_per_channel.resize(volume_grid->channel_count());
                 volume_grid->max_per_channel(m_max_per_channel.data());
                 m_channel_count = channel_count;
+                init_texture(volume_grid->data(), shape, filter_mode, wrap_mode);
             } else if (tensor) {
                 size_t shape[4] = {
                     (size_t) res.z(),
@@ -278,10 +347,17 @@ public:
                     (size_t) res.x(),
                     channel_count
                 };
-                m_texture = Texture3f(TensorXf(tensor->array(), 4, shape),
-                                      m_accel, m_accel, filter_mode, wrap_mode);
-                m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
                 m_channel_count = channel_count;
+                if (m_format == StorageFormat::Float32) {
+                    m_texture = Texture3f(TensorXf(tensor->array(), 4, shape),
+                                          m_accel, m_accel, filter_mode, wrap_mode);
+                    m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
+                } else {
+                    auto &&data = dr::migrate(tensor->array(), AllocType::Host);
+                    if constexpr (dr::is_jit_v<Float>)
+                        dr::sync_thread();
+                    init_texture(data.data(), shape, filter_mode, wrap_mode);
+                }
             }
         }
 
@@ -296,15 +372,30 @@ public:
             m_fixed_max = true;
             m_max = props.get<ScalarFloat>("max_value");
         }
+
+        int mip_levels = props.get<int>("mip_levels", 1);
+        if (mip_levels < 1)
+            Throw("The number of mip levels must be positive!");
+        m_mip_levels = (uint32_t) mip_levels;
+        if (m_mip_levels > 1) {
+            const size_t channels = shape()[3];
+            if (channels != 1 && (channels != 3 || is_spectral_v<Spectrum>))
+                Throw("Mip levels are only supported for volumes with 1 "
+                      "channel, or 3 channels in RGB and monochrome modes!");
+            update_mips();
+        }
     }
 
     void traverse(TraversalCallback *callback) override {
-        callback->put_parameter("data", m_texture.tensor(), +ParamFlags::Differentiable);
+        // Reduced precision storage can't be modified
+        if (m_format == StorageFormat::Float32)
+            callback->put_parameter("data", m_texture.tensor(), +ParamFlags::Differentiable);
         Base::traverse(callback);
     }
 
     void parameters_changed(const std::vector<std::string> &keys) override {
-        if (keys.empty() || string::contains(keys, "data")) {
+        if (m_format == StorageFormat::Float32 &&
+            (keys.empty() || string::contains(keys, "data"))) {
             const size_t channels = nchannels();
             if (channels != 1 && channels != 3 && channels != 6)
                 Throw("parameters_changed(): The volume data %s was changed "
@@ -315,6 +406,9 @@ public:
 
             if (!m_fixed_max)
                 m_max = (float) dr::max_nested(dr::detach(m_texture.value()));
+
+            if (m_mip_levels > 1)
+                update_mips();
         }
     }
 
@@ -377,6 +471,88 @@ public:
         }
     }
 
+    UnpolarizedSpectrum eval_lod(const Interaction3f &it, Float footprint,
+                                 Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_mip_count == 0)
+            return eval(it, active);
+
+        // Coarsest level whose voxels don't exceed the footprint
+        Float lod = dr::log2(dr::maximum(footprint * m_inv_voxel_size, 1.f));
+        UInt32 level = dr::minimum(dr::floor2int<UInt32>(lod), m_mip_count);
+
+        UnpolarizedSpectrum result = dr::zeros<UnpolarizedSpectrum>();
+        Mask active_fine = active && dr::eq(level, 0u),
+             active_mip  = active && !active_fine;
+        if (dr::any_or<true>(active_fine))
+            dr::masked(result, active_fine) = eval(it, active_fine);
+
+        // All coarser levels share a single lookup
+        if (dr::any_or<true>(active_mip))
+            dr::masked(result, active_mip) =
+                eval_mip(dr::select(active_fine, UInt32(0), level - 1u),
+                         m_to_local * it.p, active_mip);
+
+        return result;
+    }
+
+    std::pair<UnpolarizedSpectrum, UnpolarizedSpectrum>
+    eval_pair(const Volume *other, const Interaction3f &it, Float footprint,
+              Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (!is_colocated(other))
+            return Base::eval_pair(other, it, footprint, active);
+
+        if (dr::none_or<false>(active))
+            return { dr::zeros<UnpolarizedSpectrum>(),
+                     dr::zeros<UnpolarizedSpectrum>() };
+
+        const GridVolume *grid = static_cast<const GridVolume *>(other);
+        Point3f p = m_to_local * it.p;
+        Color3f v0 = dr::zeros<Color3f>(), v1 = dr::zeros<Color3f>();
+
+        if (filter_mode() == dr::FilterMode::Nearest) {
+            eval_texture(p, v0.data(), active);
+            grid->eval_texture(p, v1.data(), active);
+        } else {
+            Color3f d0[8], d1[8];
+            dr::Array<Float *, 8> fetch0, fetch1;
+            for (size_t i = 0; i < 8; ++i) {
+                d0[i] = d1[i] = dr::zeros<Color3f>();
+                fetch0[i] = d0[i].data();
+                fetch1[i] = d1[i].data();
+            }
+
+            fetch_texture(p, fetch0, active);
+            grid->fetch_texture(p, fetch1, active);
+
+            // Interpolation weights, shared by both volumes
+            p = dr::fmadd(p, resolution(), -.5f);
+            Point3f w1 = p - dr::floor(p),
+                    w0 = 1.f - w1;
+
+            v0 = interpolate_fetched(d0, w0, w1);
+            v1 = interpolate_fetched(d1, w0, w1);
+        }
+
+        return { to_spectrum(v0), grid->to_spectrum(v1) };
+    }
+
+    bool is_colocated(const Volume *other) const override {
+        const GridVolume *grid = dynamic_cast<const GridVolume *>(other);
+        if (!grid || !is_fusable() || !grid->is_fusable())
+            return false;
+
+        const size_t *shape = this->shape(), *other_shape = grid->shape();
+        return shape[0] == other_shape[0] && shape[1] == other_shape[1] &&
+               shape[2] == other_shape[2] &&
+               filter_mode() == grid->filter_mode() &&
+               wrap_mode() == grid->wrap_mode() &&
+               dr::all_nested(dr::eq(m_to_local.matrix, grid->m_to_local.matrix));
+    }
+
     void eval_n(const Interaction3f &it, Float *out, Mask active = true) const override {
         MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
 
@@ -426,8 +602,18 @@ public:
             out[i] = m_max_per_channel[i];
     }
 
+    TensorXf local_majorants(const ScalarVector3i &grid_resolution,
+                             ScalarFloat value_scale) const override {
+        return local_bounds(grid_resolution, value_scale, false);
+    }
+
+    TensorXf local_minorants(const ScalarVector3i &grid_resolution,
+                             ScalarFloat value_scale) const override {
+        return local_bounds(grid_resolution, value_scale, true);
+    }
+
     ScalarVector3i resolution() const override {
-        const size_t *shape = m_texture.shape();
+        const size_t *shape = this->shape();
         return { (int) shape[2], (int) shape[1], (int) shape[0] };
     };
 
@@ -437,8 +623,13 @@ public:
             << "  to_local = " << string::indent(m_to_local, 13) << "," << std::endl
             << "  bbox = " << string::indent(m_bbox) << "," << std::endl
             << "  dimensions = " << resolution() << "," << std::endl
-            << "  max = " << m_max << "," << std::endl
-            << "  channels = " << m_texture.shape()[3] << std::endl
+            << "  max = " << m_max << "," << std::endl;
+        if (m_format != StorageFormat::Float32)
+            oss << "  storage = " << format_name() << "," << std::endl
+                << "  memory = " << util::mem_string(m_packed.bytes()) << "," << std::endl;
+        if (m_mip_count > 0)
+            oss << "  mip_levels = " << m_mip_count + 1 << "," << std::endl;
+        oss << "  channels = " << shape()[3] << std::endl
             << "]";
         return oss.str();
     }
@@ -446,6 +637,669 @@ public:
     MI_DECLARE_CLASS()
 
 protected:
+    /// Precision of the volume data kept in memory
+    enum class StorageFormat { Float32, Float16, UNorm16, UNorm8 };
+
+    /**
+     * \brief Volume data stored in reduced precision
+     *
+     * Implements the subset of the <tt>dr::Texture</tt> interface used by
+     * this plugin (without hardware acceleration). Voxels are decoded into
+     * floating point values during lookups. Single-channel voxels are packed
+     * densely into 32-bit words, while the channels of other voxels are
+     * padded to whole words, so that every voxel is fetched using as few
+     * gathers as possible. Normalized integers are mapped linearly onto the
+     * range of values of each channel, which is extended to include zero.
+     */
+    class PackedGrid {
+    public:
+        /// Maximum number of channels per voxel (see \ref nchannels())
+        static constexpr size_t MaxChannels = 6;
+
+        PackedGrid() = default;
+
+        PackedGrid(const ScalarFloat *data, const size_t *shape,
+                   StorageFormat format, dr::FilterMode filter_mode,
+                   dr::WrapMode wrap_mode)
+            : m_format(format), m_filter_mode(filter_mode),
+              m_wrap_mode(wrap_mode) {
+            if (shape[3] > MaxChannels)
+                Throw("Reduced precision storage supports at most %zu "
+                      "channels per voxel!", MaxChannels);
+            for (size_t i = 0; i < 4; ++i)
+                m_shape[i] = shape[i];
+
+            const size_t channels = shape[3],
+                         voxels   = shape[0] * shape[1] * shape[2];
+            const uint32_t bits = this->bits(), per_word = 32 / bits;
+            m_words_per_voxel =
+                channels == 1 ? 0 : (uint32_t) ((channels + per_word - 1) / per_word);
+
+            m_offset.resize(channels, 0.f);
+            m_scale.resize(channels, 0.f);
+            const ScalarFloat max_int = (ScalarFloat) mask();
+            if (format != StorageFormat::Float16) {
+                std::vector<ScalarFloat> lo, hi;
+                reduce_channels(
+                    [&](size_t i, size_t c) { return data[i * channels + c]; },
+                    lo, hi);
+                for (size_t c = 0; c < channels; ++c) {
+                    m_offset[c] = dr::minimum(lo[c], (ScalarFloat) 0);
+                    m_scale[c] = (dr::maximum(hi[c], (ScalarFloat) 0) - m_offset[c]) / max_int;
+                }
+            }
+
+            auto encode = [&](size_t i, size_t c) -> uint32_t {
+                ScalarFloat value = data[i * channels + c];
+                if (format == StorageFormat::Float16)
+                    return dr::half::float32_to_float16((float) value);
+                if (m_scale[c] == 0.f)
+                    return 0u;
+                ScalarFloat q = dr::round((value - m_offset[c]) / m_scale[c]);
+                return (uint32_t) dr::clamp(q, (ScalarFloat) 0, max_int);
+            };
+
+            size_t count = channels == 1 ? (voxels + per_word - 1) / per_word
+                                         : voxels * m_words_per_voxel;
+            std::unique_ptr<uint32_t[]> words(new uint32_t[count]);
+
+            // Single-channel words hold several voxels, other words a single one
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, channels == 1 ? count : voxels, 1 << 14),
+                [&](const dr::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        if (channels == 1) {
+                            uint32_t word = 0;
+                            for (uint32_t k = 0; k < per_word && i * per_word + k < voxels; ++k)
+                                word |= encode(i * per_word + k, 0) << (bits * k);
+                            words[i] = word;
+                        } else {
+                            uint32_t *voxel = words.get() + i * m_words_per_voxel;
+                            for (uint32_t k = 0; k < m_words_per_voxel; ++k)
+                                voxel[k] = 0;
+                            for (size_t c = 0; c < channels; ++c)
+                                voxel[c / per_word] |= encode(i, c) << (bits * (c % per_word));
+                        }
+                    }
+                }
+            );
+
+            // The maxima refer to the decoded values, which may exceed the input
+            std::vector<ScalarFloat> lo;
+            reduce_channels(
+                [&](size_t i, size_t c) { return decode(words.get(), i, c); },
+                lo, m_max_per_channel);
+
+            m_data = dr::load<DynamicBuffer<UInt32>>(words.get(), count);
+        }
+
+        const size_t *shape() const { return m_shape; }
+        dr::FilterMode filter_mode() const { return m_filter_mode; }
+        dr::WrapMode wrap_mode() const { return m_wrap_mode; }
+        const DynamicBuffer<UInt32> &data() const { return m_data; }
+
+        /// Return the maximum of the decoded values of each channel
+        const std::vector<ScalarFloat> &max_per_channel() const {
+            return m_max_per_channel;
+        }
+
+        /// Return the size of the volume data in bytes
+        size_t bytes() const { return dr::width(m_data) * sizeof(uint32_t); }
+
+        /// Apply the wrap mode to integer voxel coordinates
+        Vector3i wrap(const Vector3i &pos) const {
+            Vector3i res((int32_t) m_shape[2], (int32_t) m_shape[1],
+                         (int32_t) m_shape[0]);
+            if (m_wrap_mode == dr::WrapMode::Clamp)
+                return dr::clamp(pos, 0, res - 1);
+
+            // Floor division and positive remainder
+            Vector3i div = dr::select(pos < 0, pos + 1, pos) / res;
+            div = dr::select(pos < 0, div - 1, div);
+            Vector3i mod = pos - div * res;
+
+            if (m_wrap_mode == dr::WrapMode::Mirror)
+                mod = dr::select(dr::eq(div & 1, 0), mod, res - 1 - mod);
+
+            return mod;
+        }
+
+        /// Fetch the channels of the voxel with the given linear index
+        void read(const UInt32 &voxel, Float *out, const Mask &active) const {
+            const uint32_t bits = this->bits(), per_word = 32 / bits;
+            if (m_shape[3] == 1) {
+                UInt32 word = dr::gather<UInt32>(
+                    m_data, voxel >> (bits == 8 ? 2u : 1u), active);
+                out[0] = decode(word >> ((voxel & (per_word - 1)) * bits), 0);
+                return;
+            }
+
+            UInt32 base = voxel * m_words_per_voxel, word;
+            for (size_t c = 0; c < m_shape[3]; ++c) {
+                if (c % per_word == 0)
+                    word = dr::gather<UInt32>(
+                        m_data, base + (uint32_t) (c / per_word), active);
+                out[c] = decode(word >> (uint32_t) (bits * (c % per_word)), c);
+            }
+        }
+
+        void eval_fetch(const Point3f &p, dr::Array<Float *, 8> &out,
+                        Mask active) const {
+            Vector3i pos = dr::floor2int<Vector3i>(dr::fmadd(p, res(), -.5f));
+            for (int32_t i = 0; i < 8; ++i)
+                read(index(pos + ScalarVector3i(i & 1, (i >> 1) & 1, i >> 2)),
+                     out[i], active);
+        }
+
+        void eval(const Point3f &p, Float *out, Mask active) const {
+            if (m_filter_mode == dr::FilterMode::Nearest) {
+                read(index(dr::floor2int<Vector3i>(p * res())), out, active);
+                return;
+            }
+
+            const size_t channels = m_shape[3];
+            Float values[8 * MaxChannels];
+            dr::Array<Float *, 8> fetch_values;
+            for (size_t i = 0; i < 8; ++i)
+                fetch_values[i] = values + i * channels;
+            eval_fetch(p, fetch_values, active);
+
+            Point3f q = dr::fmadd(p, res(), -.5f);
+            Point3f w1 = q - dr::floor(q), w0 = 1.f - w1;
+            for (size_t c = 0; c < channels; ++c) {
+                const Float *v = values + c;
+                Float v00 = dr::fmadd(w0.x(), v[0], w1.x() * v[channels]),
+                      v10 = dr::fmadd(w0.x(), v[2 * channels], w1.x() * v[3 * channels]),
+                      v01 = dr::fmadd(w0.x(), v[4 * channels], w1.x() * v[5 * channels]),
+                      v11 = dr::fmadd(w0.x(), v[6 * channels], w1.x() * v[7 * channels]);
+                Float v0 = dr::fmadd(w0.y(), v00, w1.y() * v10),
+                      v1 = dr::fmadd(w0.y(), v01, w1.y() * v11);
+                out[c] = dr::fmadd(w0.z(), v0, w1.z() * v1);
+            }
+        }
+
+        void eval_nonaccel(const Point3f &p, Float *out, Mask active) const {
+            eval(p, out, active);
+        }
+
+        void eval_fetch_nonaccel(const Point3f &p, dr::Array<Float *, 8> &out,
+                                 Mask active) const {
+            eval_fetch(p, out, active);
+        }
+
+        /// Decode a channel of a voxel, given a host copy of \ref data()
+        ScalarFloat decode(const uint32_t *words, size_t voxel,
+                           size_t channel) const {
+            const uint32_t bits = this->bits(), per_word = 32 / bits;
+            uint32_t value = m_shape[3] == 1
+                ? words[voxel / per_word] >> (bits * (voxel % per_word))
+                : words[voxel * m_words_per_voxel + channel / per_word] >>
+                      (bits * (channel % per_word));
+            if (m_format == StorageFormat::Float16)
+                return (ScalarFloat) dr::half::float16_to_float32((uint16_t) value);
+            return dr::fmadd((ScalarFloat) (value & mask()), m_scale[channel],
+                             m_offset[channel]);
+        }
+
+    protected:
+        uint32_t bits() const { return m_format == StorageFormat::UNorm8 ? 8 : 16; }
+        uint32_t mask() const { return (1u << bits()) - 1u; }
+
+        ScalarVector3f res() const {
+            return ScalarVector3f((ScalarFloat) m_shape[2], (ScalarFloat) m_shape[1],
+                                  (ScalarFloat) m_shape[0]);
+        }
+
+        MI_INLINE UInt32 index(const Vector3i &pos) const {
+            Vector3i p = wrap(pos);
+            return UInt32((p.z() * (int32_t) m_shape[1] + p.y()) *
+                              (int32_t) m_shape[2] + p.x());
+        }
+
+        /// Decode a channel from the lower bits of \c value
+        MI_INLINE Float decode(const UInt32 &value, size_t channel) const {
+            if (m_format == StorageFormat::Float16)
+                return half_to_float(value);
+            return dr::fmadd(Float(value & mask()), m_scale[channel],
+                             m_offset[channel]);
+        }
+
+        /// Convert the lower 16 bits of \c value from half to single precision
+        static MI_INLINE Float half_to_float(const UInt32 &value) {
+            using Float32 = dr::float32_array_t<Float>;
+            // Shift exponent and mantissa into place and adjust the bias
+            Float32 result = dr::reinterpret_array<Float32>((value & 0x7FFFu) << 13) *
+                             dr::reinterpret_array<float>(0x77800000u);
+            return Float(dr::reinterpret_array<Float32>(
+                dr::reinterpret_array<UInt32>(result) | ((value & 0x8000u) << 16)));
+        }
+
+        /// Compute the minimum and maximum of each channel in parallel
+        template <typename Func>
+        void reduce_channels(Func value, std::vector<ScalarFloat> &lo,
+                             std::vector<ScalarFloat> &hi) const {
+            const size_t channels = m_shape[3],
+                         voxels   = m_shape[0] * m_shape[1] * m_shape[2];
+            lo.assign(channels, dr::Infinity<ScalarFloat>);
+            hi.assign(channels, -dr::Infinity<ScalarFloat>);
+
+            std::mutex mutex;
+            dr::parallel_for(
+                dr::blocked_range<size_t>(0, voxels, 1 << 16),
+                [&](const dr::blocked_range<size_t> &range) {
+                    std::vector<ScalarFloat> lo_local(channels, dr::Infinity<ScalarFloat>),
+                                             hi_local(channels, -dr::Infinity<ScalarFloat>);
+                    for (size_t i = range.begin(); i != range.end(); ++i) {
+                        for (size_t c = 0; c < channels; ++c) {
+                            ScalarFloat v = value(i, c);
+                            lo_local[c] = dr::minimum(lo_local[c], v);
+                            hi_local[c] = dr::maximum(hi_local[c], v);
+                        }
+                    }
+
+                    std::lock_guard<std::mutex> guard(mutex);
+                    for (size_t c = 0; c < channels; ++c) {
+                        lo[c] = dr::minimum(lo[c], lo_local[c]);
+                        hi[c] = dr::maximum(hi[c], hi_local[c]);
+                    }
+                }
+            );
+        }
+
+    protected:
+        DynamicBuffer<UInt32> m_data;
+        std::vector<ScalarFloat> m_offset;
+        std::vector<ScalarFloat> m_scale;
+        std::vector<ScalarFloat> m_max_per_channel;
+        size_t m_shape[4] = { 0, 0, 0, 0 };
+        uint32_t m_words_per_voxel = 0;
+        StorageFormat m_format = StorageFormat::Float16;
+        dr::FilterMode m_filter_mode = dr::FilterMode::Linear;
+        dr::WrapMode m_wrap_mode = dr::WrapMode::Clamp;
+    };
+
+    /**
+     * \brief Initialize the volume data from values in host memory
+     *
+     * In reduced precision formats, the maxima are recomputed from the
+     * decoded values.
+     */
+    void init_texture(const ScalarFloat *data, const size_t *shape,
+                      dr::FilterMode filter_mode, dr::WrapMode wrap_mode) {
+        if (m_format == StorageFormat::Float32) {
+            m_texture = Texture3f(TensorXf(data, 4, shape), m_accel, m_accel,
+                                  filter_mode, wrap_mode);
+            return;
+        }
+
+        m_packed = PackedGrid(data, shape, m_format, filter_mode, wrap_mode);
+        const std::vector<ScalarFloat> &max = m_packed.max_per_channel();
+        if (nchannels() != shape[3]) {
+            // Spectrally upsampled data is bounded by its scale factor
+            m_max = max[3];
+        } else {
+            m_max = *std::max_element(max.begin(), max.end());
+            m_max_per_channel = max;
+        }
+
+        Log(Debug, "Storing grid volume in %s format (%s).", format_name(),
+            util::mem_string(m_packed.bytes()));
+    }
+
+    const char *format_name() const {
+        switch (m_format) {
+            case StorageFormat::Float16: return "float16";
+            case StorageFormat::UNorm16: return "unorm16";
+            case StorageFormat::UNorm8:  return "unorm8";
+            default:                     return "float32";
+        }
+    }
+
+    /// Return the shape of the volume data (z, y, x, channels)
+    MI_INLINE const size_t *shape() const {
+        return m_format == StorageFormat::Float32 ? m_texture.shape()
+                                                  : m_packed.shape();
+    }
+
+    MI_INLINE dr::FilterMode filter_mode() const {
+        return m_format == StorageFormat::Float32 ? m_texture.filter_mode()
+                                                  : m_packed.filter_mode();
+    }
+
+    MI_INLINE dr::WrapMode wrap_mode() const {
+        return m_format == StorageFormat::Float32 ? m_texture.wrap_mode()
+                                                  : m_packed.wrap_mode();
+    }
+
+    /// Interpolated lookup, honoring the storage format and \ref m_accel
+    MI_INLINE void eval_texture(const Point3f &p, Float *out,
+                                const Mask &active) const {
+        if (m_format != StorageFormat::Float32)
+            m_packed.eval(p, out, active);
+        else if (m_accel)
+            m_texture.eval(p, out, active);
+        else
+            m_texture.eval_nonaccel(p, out, active);
+    }
+
+    /// Fetch the 8 voxels used by a trilinear lookup
+    MI_INLINE void fetch_texture(const Point3f &p, dr::Array<Float *, 8> &out,
+                                 const Mask &active) const {
+        if (m_format != StorageFormat::Float32)
+            m_packed.eval_fetch(p, out, active);
+        else if (m_accel)
+            m_texture.eval_fetch(p, out, active);
+        else
+            m_texture.eval_fetch_nonaccel(p, out, active);
+    }
+
+    /**
+     * \brief Can this volume share its interpolation weights in \ref
+     * eval_pair()?
+     *
+     * This requires lookups without levels of detail or spectral upsampling.
+     * Hardware-accelerated trilinear lookups are faster on their own.
+     */
+    bool is_fusable() const {
+        const size_t channels = shape()[3];
+        bool hardware = dr::is_cuda_v<Float> && m_accel &&
+                        m_format == StorageFormat::Float32;
+        return m_mip_count == 0 && !hardware &&
+               (channels == 1 || (channels == 3 && !is_spectral_v<Spectrum>));
+    }
+
+    /// Trilinear interpolation of the 8 voxels fetched by \ref fetch_texture()
+    MI_INLINE static Color3f interpolate_fetched(const Color3f *d,
+                                                 const Point3f &w0,
+                                                 const Point3f &w1) {
+        Color3f f00 = dr::fmadd(w0.x(), d[0], w1.x() * d[1]),
+                f10 = dr::fmadd(w0.x(), d[2], w1.x() * d[3]),
+                f01 = dr::fmadd(w0.x(), d[4], w1.x() * d[5]),
+                f11 = dr::fmadd(w0.x(), d[6], w1.x() * d[7]);
+        Color3f f0 = dr::fmadd(w0.y(), f00, w1.y() * f10),
+                f1 = dr::fmadd(w0.y(), f01, w1.y() * f11);
+        return dr::fmadd(w0.z(), f0, w1.z() * f1);
+    }
+
+    /// Convert the result of a 1- or 3-channel lookup into a spectrum
+    MI_INLINE UnpolarizedSpectrum to_spectrum(const Color3f &value) const {
+        if (shape()[3] == 1)
+            return value.x();
+
+        if constexpr (is_monochromatic_v<Spectrum>)
+            return luminance(value);
+        else if constexpr (is_rgb_v<Spectrum>)
+            return value;
+        else // Rejected by is_fusable()
+            return dr::zeros<UnpolarizedSpectrum>();
+    }
+
+    /// Compute the majorants (or minorants) of a coarse grid
+    TensorXf local_bounds(const ScalarVector3i &grid_resolution,
+                          ScalarFloat value_scale, bool minimum) const {
+        const size_t channels = shape()[3];
+
+        if (m_format == StorageFormat::Float32) {
+            auto &&data = dr::migrate(m_texture.value(), AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+            const ScalarFloat *values = data.data();
+            return local_bounds_impl(
+                grid_resolution, value_scale, minimum,
+                [values, channels](size_t voxel, size_t channel) {
+                    return values[voxel * channels + channel];
+                });
+        } else {
+            // Decode the voxels on the fly to keep the host copy compact
+            auto &&data = dr::migrate(m_packed.data(), AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+            const uint32_t *words = data.data();
+            return local_bounds_impl(
+                grid_resolution, value_scale, minimum,
+                [this, words](size_t voxel, size_t channel) {
+                    return m_packed.decode(words, voxel, channel);
+                });
+        }
+    }
+
+    /**
+     * \brief Compute the majorants (or minorants) of a coarse grid
+     *
+     * \c value returns the given channel of the voxel with the given linear
+     * index.
+     */
+    template <typename Func>
+    TensorXf local_bounds_impl(const ScalarVector3i &grid_resolution,
+                               ScalarFloat value_scale, bool minimum,
+                               Func value) const {
+        const ScalarVector3i res = resolution();
+        const size_t channels = shape()[3];
+
+        /* Spectrally upsampled data is bounded by its scale factor (last
+           channel), other volumes by the maximum over all channels */
+        const size_t channel_offset = channels == 4 && nchannels() == 3 ? 3 : 0;
+
+        /* The spectra of upsampled data may vanish at some wavelengths, so
+           that no useful lower bound is available */
+        if (minimum && channel_offset != 0)
+            return Base::local_minorants(grid_resolution, value_scale);
+
+        /* Trilinear lookups inside a cell may access one voxel on each side
+           of the voxels it overlaps. Out-of-range voxels are resolved
+           according to the wrap mode. Voxels of mip level k average blocks
+           of 2^k voxels, and their lookups reach up to 1.5 * 2^k voxels
+           (2^k - 1 without interpolation) further. */
+        const int levels = (int) m_mip_count;
+        const int margin = filter_mode() == dr::FilterMode::Linear
+                               ? (3 << levels) / 2
+                               : (1 << levels) - 1;
+        const dr::WrapMode wrap_mode = this->wrap_mode();
+        auto wrap = [wrap_mode](int i, int n) {
+            if (wrap_mode == dr::WrapMode::Repeat) {
+                i %= n;
+                return i < 0 ? i + n : i;
+            } else if (wrap_mode == dr::WrapMode::Mirror) {
+                i = i < 0 ? -i - 1 : i;
+                i %= 2 * n;
+                return i >= n ? 2 * n - 1 - i : i;
+            } else {
+                return dr::clamp(i, 0, n - 1);
+            }
+        };
+
+        size_t out_shape[4] = { (size_t) grid_resolution.z(),
+                                (size_t) grid_resolution.y(),
+                                (size_t) grid_resolution.x(), 1 };
+        std::unique_ptr<ScalarFloat[]> out(
+            new ScalarFloat[out_shape[0] * out_shape[1] * out_shape[2]]);
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, out_shape[0], 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                ScalarVector3i lo, hi;
+                for (size_t z = range.begin(); z != range.end(); ++z) {
+                    for (int y = 0; y < grid_resolution.y(); ++y) {
+                        for (int x = 0; x < grid_resolution.x(); ++x) {
+                            ScalarVector3i cell(x, y, (int) z);
+                            for (size_t k = 0; k < 3; ++k) {
+                                lo[k] = (int) ((int64_t) cell[k] * res[k] / grid_resolution[k]) - margin;
+                                hi[k] = (int) (((int64_t) cell[k] + 1) * res[k] +
+                                               grid_resolution[k] - 1) / grid_resolution[k] - 1 + margin;
+                            }
+
+                            ScalarFloat result = minimum ? dr::Infinity<ScalarFloat> : 0.f;
+                            for (int vz = lo.z(); vz <= hi.z(); ++vz) {
+                                size_t iz = (size_t) wrap(vz, res.z());
+                                for (int vy = lo.y(); vy <= hi.y(); ++vy) {
+                                    size_t iy = (size_t) wrap(vy, res.y());
+                                    for (int vx = lo.x(); vx <= hi.x(); ++vx) {
+                                        size_t ix = (size_t) wrap(vx, res.x());
+                                        size_t voxel = (iz * res.y() + iy) * res.x() + ix;
+                                        for (size_t c = channel_offset; c < channels; ++c)
+                                            result = minimum ? dr::minimum(result, value(voxel, c))
+                                                             : dr::maximum(result, value(voxel, c));
+                                    }
+                                }
+                            }
+
+                            out[(z * out_shape[1] + y) * out_shape[2] + x] = result * value_scale;
+                        }
+                    }
+                }
+            }
+        );
+
+        return TensorXf(out.get(), 4, out_shape);
+    }
+
+    /// (Re)build the coarser levels of detail from the volume data
+    void update_mips() {
+        m_mip_count = 0;
+
+        const size_t *shape = this->shape();
+        const size_t channels = shape[3];
+        ScalarVector3u res((uint32_t) shape[2], (uint32_t) shape[1],
+                           (uint32_t) shape[0]);
+
+        // World-space size of the voxels along their shortest side
+        ScalarTransform4f to_world = m_to_local.inverse();
+        ScalarFloat voxel_size = dr::Infinity<ScalarFloat>;
+        for (size_t k = 0; k < 3; ++k) {
+            ScalarVector3f axis(0.f);
+            axis[k] = 1.f;
+            voxel_size = dr::minimum(voxel_size,
+                                     dr::norm(to_world * axis) / res[k]);
+        }
+        m_inv_voxel_size = dr::rcp(voxel_size);
+
+        // Decode the finest level on the host
+        std::vector<ScalarFloat> level(dr::prod(res) * channels);
+        if (m_format == StorageFormat::Float32) {
+            auto &&data = dr::migrate(m_texture.value(), AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+            std::copy(data.data(), data.data() + level.size(), level.begin());
+        } else {
+            auto &&data = dr::migrate(m_packed.data(), AllocType::Host);
+            if constexpr (dr::is_jit_v<Float>)
+                dr::sync_thread();
+            for (size_t i = 0; i < level.size(); ++i)
+                level[i] = m_packed.decode(data.data(), i / channels, i % channels);
+        }
+
+        // Offset (in voxels) and resolution of each level
+        std::vector<uint32_t> info;
+        std::vector<ScalarFloat> mip_data;
+
+        while (m_mip_count + 1 < m_mip_levels && dr::any(res > 1u)) {
+            ScalarVector3u res_out = (res + 1u) / 2u;
+            std::vector<ScalarFloat> out(dr::prod(res_out) * channels);
+
+            // Average blocks of 2x2x2 voxels, which are clipped at the border
+            dr::parallel_for(
+                dr::blocked_range<uint32_t>(0, res_out.z(), 1),
+                [&](const dr::blocked_range<uint32_t> &range) {
+                    for (uint32_t z = range.begin(); z != range.end(); ++z) {
+                        for (uint32_t y = 0; y < res_out.y(); ++y) {
+                            for (uint32_t x = 0; x < res_out.x(); ++x) {
+                                ScalarFloat *dst =
+                                    out.data() + ((z * res_out.y() + y) * res_out.x() + x) * channels;
+                                uint32_t count = 0;
+                                for (uint32_t vz = 2 * z; vz < dr::minimum(2 * z + 2, res.z()); ++vz)
+                                    for (uint32_t vy = 2 * y; vy < dr::minimum(2 * y + 2, res.y()); ++vy)
+                                        for (uint32_t vx = 2 * x; vx < dr::minimum(2 * x + 2, res.x()); ++vx) {
+                                            const ScalarFloat *src =
+                                                level.data() + ((vz * res.y() + vy) * res.x() + vx) * channels;
+                                            for (size_t c = 0; c < channels; ++c)
+                                                dst[c] += src[c];
+                                            count++;
+                                        }
+                                for (size_t c = 0; c < channels; ++c)
+                                    dst[c] /= (ScalarFloat) count;
+                            }
+                        }
+                    }
+                }
+            );
+
+            info.insert(info.end(), { (uint32_t) (mip_data.size() / channels),
+                                      res_out.x(), res_out.y(), res_out.z() });
+            mip_data.insert(mip_data.end(), out.begin(), out.end());
+            m_mip_count++;
+            level = std::move(out);
+            res = res_out;
+        }
+
+        m_mip_info = dr::load<DynamicBuffer<UInt32>>(info.data(), info.size());
+        m_mip_data = dr::load<FloatStorage>(mip_data.data(), mip_data.size());
+    }
+
+    /**
+     * \brief Interpolated lookup into the coarser levels of detail, where
+     * \c level (starting at zero for level of detail 1) may vary per lane
+     */
+    MI_INLINE UnpolarizedSpectrum eval_mip(const UInt32 &level,
+                                           const Point3f &p,
+                                           const Mask &active) const {
+        const uint32_t channels = (uint32_t) shape()[3];
+        UInt32 offset = dr::gather<UInt32>(m_mip_info, level * 4u, active);
+        Vector3i res = Vector3i(Vector3u(
+            dr::gather<UInt32>(m_mip_info, level * 4u + 1u, active),
+            dr::gather<UInt32>(m_mip_info, level * 4u + 2u, active),
+            dr::gather<UInt32>(m_mip_info, level * 4u + 3u, active)));
+
+        // Accumulate the channels of a voxel with the given weight
+        Color3f value = dr::zeros<Color3f>();
+        auto read = [&](const Vector3i &pos, const Float &weight) {
+            Vector3i q = wrap(pos, res);
+            UInt32 voxel = offset + UInt32((q.z() * res.y() + q.y()) * res.x() + q.x());
+            for (uint32_t c = 0; c < channels; ++c)
+                value[c] = dr::fmadd(
+                    weight, dr::gather<Float>(m_mip_data, voxel * channels + c, active),
+                    value[c]);
+        };
+
+        if (filter_mode() == dr::FilterMode::Nearest) {
+            read(dr::floor2int<Vector3i>(p * Vector3f(res)), 1.f);
+        } else {
+            Point3f q = dr::fmadd(p, Vector3f(res), -.5f);
+            Vector3i pos = dr::floor2int<Vector3i>(q);
+            Point3f w1 = q - Point3f(pos), w0 = 1.f - w1;
+            for (int32_t i = 0; i < 8; ++i)
+                read(pos + ScalarVector3i(i & 1, (i >> 1) & 1, i >> 2),
+                     ((i & 1) ? w1.x() : w0.x()) *
+                     ((i & 2) ? w1.y() : w0.y()) *
+                     ((i & 4) ? w1.z() : w0.z()));
+        }
+
+        if (channels == 1)
+            return value.x();
+        if constexpr (is_monochromatic_v<Spectrum>)
+            return luminance(value);
+        else if constexpr (is_rgb_v<Spectrum>)
+            return value;
+        else // Rejected by the constructor
+            return dr::zeros<UnpolarizedSpectrum>();
+    }
+
+    /// Apply the wrap mode to integer voxel coordinates of a level of detail
+    Vector3i wrap(const Vector3i &pos, const Vector3i &res) const {
+        const dr::WrapMode wrap_mode = this->wrap_mode();
+        if (wrap_mode == dr::WrapMode::Clamp)
+            return dr::clamp(pos, 0, res - 1);
+
+        // Floor division and positive remainder
+        Vector3i div = dr::select(pos < 0, pos + 1, pos) / res;
+        div = dr::select(pos < 0, div - 1, div);
+        Vector3i mod = pos - div * res;
+
+        if (wrap_mode == dr::WrapMode::Mirror)
+            mod = dr::select(dr::eq(div & 1, 0), mod, res - 1 - mod);
+
+        return mod;
+    }
+
     /**
      * \brief Returns the number of channels in the grid
      *
@@ -453,7 +1307,7 @@ protected:
      * holds all scaling coefficients is omitted.
      */
     MI_INLINE size_t nchannels() const {
-        const size_t channels = m_texture.shape()[3];
+        const size_t channels = shape()[3];
         // When spectral upsampling is requested, a fourth channel is added to
         // the internal texture data to handle scaling coefficients.
         if (is_spectral_v<Spectrum> && channels == 4 && !m_raw)
@@ -472,7 +1326,7 @@ protected:
 
         Point3f p = m_to_local * it.p;
 
-        if (m_texture.filter_mode() == dr::FilterMode::Linear) {
+        if (filter_mode() == dr::FilterMode::Linear) {
             dr::Array<Float, 4> d000, d100, d010, d110, d001, d101, d011, d111;
             dr::Array<Float *, 8> fetch_values;
             fetch_values[0] = d000.data();
@@ -484,10 +1338,7 @@ protected:
             fetch_values[6] = d011.data();
             fetch_values[7] = d111.data();
 
-            if (m_accel)
-                m_texture.eval_fetch(p, fetch_values, active);
-            else
-                m_texture.eval_fetch_nonaccel(p, fetch_values, active);
+            fetch_texture(p, fetch_values, active);
 
             UnpolarizedSpectrum v000, v001, v010, v011, v100, v101, v110, v111;
             v000 = srgb_model_eval<UnpolarizedSpectrum>(dr::head<3>(d000), it.wavelengths);
@@ -528,10 +1379,7 @@ protected:
             return result;
         } else {
             dr::Array<Float, 4> v;
-            if (m_accel)
-                m_texture.eval(p, v.data(), active);
-            else
-                m_texture.eval_nonaccel(p, v.data(), active);
+            eval_texture(p, v.data(), active);
 
             return v.w() * srgb_model_eval<UnpolarizedSpectrum>(dr::head<3>(v), it.wavelengths);
         }
@@ -547,10 +1395,7 @@ protected:
 
         Point3f p = m_to_local * it.p;
         Float result;
-        if (m_accel)
-            m_texture.eval(p, &result, active);
-        else
-            m_texture.eval_nonaccel(p, &result, active);
+        eval_texture(p, &result, active);
 
         return result;
     }
@@ -566,10 +1411,7 @@ protected:
 
         Point3f p = m_to_local * it.p;
         Color3f result;
-        if (m_accel)
-            m_texture.eval(p, result.data(), active);
-        else
-            m_texture.eval_nonaccel(p, result.data(), active);
+        eval_texture(p, result.data(), active);
 
         return result;
     }
@@ -585,10 +1427,7 @@ protected:
 
         Point3f p = m_to_local * it.p;
         dr::Array<Float, 6> result;
-        if (m_accel)
-            m_texture.eval(p, result.data(), active);
-        else
-            m_texture.eval_nonaccel(p, result.data(), active);
+        eval_texture(p, result.data(), active);
 
         return result;
     }
@@ -604,19 +1443,27 @@ protected:
         MI_MASK_ARGUMENT(active);
 
         Point3f p = m_to_local * it.p;
-        if (m_accel)
-            m_texture.eval(p, out, active);
-        else
-            m_texture.eval_nonaccel(p, out, active);
+        eval_texture(p, out, active);
     }
 
 protected:
     Texture3f m_texture;
+    PackedGrid m_packed;
+    StorageFormat m_format = StorageFormat::Float32;
     bool m_accel;
     bool m_raw;
     bool m_fixed_max = false;
     ScalarFloat m_max;
     std::vector<ScalarFloat> m_max_per_channel;
+
+    /// Levels of detail 1, 2, ... stored one after the other (the finest level is \ref m_texture)
+    FloatStorage m_mip_data;
+    /// Offset (in voxels) and resolution of each level of detail in \ref m_mip_data
+    DynamicBuffer<UInt32> m_mip_info;
+    uint32_t m_mip_count = 0;
+    uint32_t m_mip_levels = 1;
+    /// Reciprocal of the world-space size of the voxels of the finest level
+    ScalarFloat m_inv_voxel_size = 0.f;
 };
 
 MI_IMPLEMENT_CLASS_VARIANT(GridVolume, Volume)
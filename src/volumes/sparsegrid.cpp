@@ -0,0 +1,665 @@
+#include <mitsuba/core/fresolver.h>
+#include <mitsuba/core/properties.h>
+#include <mitsuba/core/spectrum.h>
+#include <mitsuba/core/string.h>
+#include <mitsuba/core/transform.h>
+#include <mitsuba/core/util.h>
+#include <mitsuba/render/sparsevolumegrid.h>
+#include <mitsuba/render/srgb.h>
+#include <mitsuba/render/volume.h>
+#include <mitsuba/render/volumegrid.h>
+#include <drjit/dynamic.h>
+#include <drjit/texture.h>
+#include <nanothread/nanothread.h>
+#include <algorithm>
+
+NAMESPACE_BEGIN(mitsuba)
+
+/**!
+.. _volume-sparsegridvolume:
+
+Sparse grid-based volume data source (:monosp:`sparsegridvolume`)
+-----------------------------------------------------------------
+
+.. pluginparameters::
+
+ * - filename
+   - |string|
+   - Filename of the volume to be loaded. Both sparse volume files (``.svol``)
+     and dense volume files in the format of the :ref:`gridvolume
+     <volume-gridvolume>` plugin (``.vol``) are supported. The latter are
+     converted while they are loaded.
+
+ * - grid
+   - :monosp:`SparseVolumeGrid` or :monosp:`VolumeGrid object`
+   - When creating a sparse grid volume at runtime, e.g. from Python or C++,
+     an existing ``SparseVolumeGrid`` or ``VolumeGrid`` instance can be passed
+     directly rather than loading it from the filesystem with
+     :paramtype:`filename`.
+
+ * - tolerance
+   - |float|
+   - Tiles of dense volumes whose values vary by at most this amount (per
+     channel) are replaced by a constant tile. (Default: 0, i.e. only exactly
+     constant tiles are shared)
+
+ * - filter_type
+   - |string|
+   - Specifies how voxel values are interpolated. The following options are
+     currently available:
+
+     - ``trilinear`` (default): perform trilinear interpolation.
+
+     - ``nearest``: disable interpolation. In this mode, the plugin
+       performs nearest neighbor lookups of volume values.
+
+ * - wrap_mode
+   - |string|
+   - Controls the behavior of volume evaluations that fall outside of the
+     :math:`[0, 1]` range. The following options are currently available:
+
+     - ``clamp`` (default): clamp coordinates to the edge of the volume.
+
+     - ``repeat``: tile the volume infinitely.
+
+     - ``mirror``: mirror the volume along its boundaries.
+
+ * - raw
+   - |bool|
+   - Should the transformation to the stored color data (e.g. sRGB to linear,
+     spectral upsampling) be disabled? You will want to enable this when working
+     with non-color, 3-channel volume data. (Default: false)
+
+ * - use_grid_bbox
+   - |bool|
+   - Should the bounding box stored in the volume file be used to position
+     the volume? (Default: false)
+
+ * - to_world
+   - |transform|
+   - Specifies an optional 4x4 transformation matrix that will be applied to volume coordinates.
+
+This plugin provides the same lookups as the :ref:`gridvolume
+<volume-gridvolume>` plugin, but stores the voxels in a sparse data structure
+inspired by OpenVDB: the volume is subdivided into tiles of 8x8x8 voxels, and a
+top-level index grid references the brick of voxel values of each tile. All
+tiles that have the same constant value (for instance, empty space around a
+cloud or an explosion) share a single brick. The memory footprint is therefore
+roughly proportional to the number of non-constant tiles, which is often a
+small fraction of the dense grid. Lookups perform one additional memory access
+per voxel compared to the dense representation.
+
+The per-brick maxima are used to compute local majorants (see the
+``majorant_resolution_factor`` parameter of the :ref:`heterogeneous
+<medium-heterogeneous>` medium), so that empty regions of the volume are
+skipped efficiently during free-flight sampling.
+
+Sparse volume files use a little endian encoding and are specified as follows
+(:math:`T` denotes the number of tiles, i.e. the product of the resolution
+divided by 8 and rounded up along each axis, and :math:`B` the number of
+bricks):
+
+.. list-table:: Sparse volume file format
+   :widths: 8 30
+   :header-rows: 1
+
+   * - Position
+     - Content
+   * - Bytes 1-3
+     - ASCII Bytes ’S’, ’V’, and ’L’
+   * - Byte 4
+     - File format version number (currently 1)
+   * - Bytes 5-16
+     - Number of cells along the X, Y, and Z axes (32 bit integers)
+   * - Bytes 17-20
+     - Number of channels (32 bit integer)
+   * - Bytes 21-44
+     - Axis-aligned bounding box of the data stored in single precision (order:
+       xmin, ymin, zmin, xmax, ymax, zmax)
+   * - Bytes 45-48
+     - Number of bricks :math:`B` (32 bit unsigned integer)
+   * - Next :math:`4T` bytes
+     - Brick referenced by each tile (32 bit unsigned integers), ordered
+       so that the tile :math:`(x, y, z)` is found at index
+       :code:`(z*ytiles + y)*xtiles + x`
+   * - Remaining bytes
+     - Voxel values of the bricks (single precision), ordered so that the
+       channel :code:`chan` of voxel :code:`(x, y, z)` of brick :code:`b`
+       is found at index :code:`(((b*8 + z)*8 + y)*8 + x)*channels + chan`
+
+Sparse volume files can be created from dense ones in Python:
+
+.. code-block:: python
+
+    grid = mi.SparseVolumeGrid('my_volume.vol', tolerance=1e-4)
+    grid.write('my_volume.svol')
+
+.. tabs::
+    .. code-tab:: xml
+
+        <medium type="heterogeneous">
+            <volume type="sparsegridvolume" name="sigma_t">
+                <string name="filename" value="my_volume.svol"/>
+            </volume>
+        </medium>
+
+    .. code-tab:: python
+
+        'type': 'heterogeneous',
+        'sigma_t': {
+            'type': 'sparsegridvolume',
+            'filename': 'my_volume.svol'
+        }
+
+*/
+
+template <typename Float, typename Spectrum>
+class SparseGridVolume final : public Volume<Float, Spectrum> {
+public:
+    MI_IMPORT_BASE(Volume, update_bbox, m_to_local, m_bbox, m_channel_count)
+    MI_IMPORT_TYPES(SparseVolumeGrid, VolumeGrid)
+
+    static constexpr uint32_t BrickSize = SparseVolumeGrid::BrickSize;
+    static constexpr uint32_t BrickVoxels = SparseVolumeGrid::BrickVoxels;
+
+    SparseGridVolume(const Properties &props) : Base(props) {
+        std::string filter_type_str = props.string("filter_type", "trilinear");
+        if (filter_type_str == "nearest")
+            m_filter_mode = dr::FilterMode::Nearest;
+        else if (filter_type_str == "trilinear")
+            m_filter_mode = dr::FilterMode::Linear;
+        else
+            Throw("Invalid filter type \"%s\", must be one of: \"nearest\" or "
+                  "\"trilinear\"!", filter_type_str);
+
+        std::string wrap_mode_st = props.string("wrap_mode", "clamp");
+        if (wrap_mode_st == "repeat")
+            m_wrap_mode = dr::WrapMode::Repeat;
+        else if (wrap_mode_st == "mirror")
+            m_wrap_mode = dr::WrapMode::Mirror;
+        else if (wrap_mode_st == "clamp")
+            m_wrap_mode = dr::WrapMode::Clamp;
+        else
+            Throw("Invalid wrap mode \"%s\", must be one of: \"repeat\", "
+                  "\"mirror\", or \"clamp\"!",
+                  wrap_mode_st);
+
+        m_raw = props.get<bool>("raw", false);
+        ScalarFloat tolerance = props.get<ScalarFloat>("tolerance", 0.f);
+        if (tolerance < 0.f)
+            Throw("The \"tolerance\" parameter must be non-negative!");
+
+        // Load volume data
+        ref<SparseVolumeGrid> grid;
+        if (props.has_property("grid")) {
+            if (props.has_property("filename"))
+                Throw("Cannot specify both \"grid\" and \"filename\".");
+            Log(Debug, "Loading sparse volume grid from memory...");
+            ref<Object> other = props.object("grid");
+            grid = dynamic_cast<SparseVolumeGrid *>(other.get());
+            if (!grid) {
+                const VolumeGrid *dense = dynamic_cast<VolumeGrid *>(other.get());
+                if (!dense)
+                    Throw("Property \"grid\" must be a SparseVolumeGrid or a "
+                          "VolumeGrid instance.");
+                grid = new SparseVolumeGrid(dense, tolerance);
+            }
+        } else {
+            FileResolver *fs = Thread::thread()->file_resolver();
+            fs::path file_path = fs->resolve(props.string("filename"));
+            if (!fs::exists(file_path))
+                Log(Error, "\"%s\": file does not exist!", file_path);
+            grid = new SparseVolumeGrid(file_path, tolerance);
+        }
+
+        m_size = grid->size();
+        m_resolution = ScalarVector3f(m_size);
+        m_tile_count = grid->tile_count();
+        m_index = std::vector<uint32_t>(
+            grid->index(), grid->index() + dr::prod(m_tile_count));
+        m_index_device = dr::load<UInt32Storage>(m_index.data(), m_index.size());
+        m_brick_max.resize(grid->brick_count());
+        for (size_t i = 0; i < m_brick_max.size(); ++i)
+            m_brick_max[i] = grid->brick_max(i);
+
+        const size_t channel_count = grid->channel_count(),
+                     brick_values = grid->brick_count() * BrickVoxels;
+
+        // Apply spectral conversion if necessary
+        m_upsampled = is_spectral_v<Spectrum> && channel_count == 3 && !m_raw;
+        if (m_upsampled) {
+            std::unique_ptr<ScalarFloat[]> scaled_data(new ScalarFloat[brick_values * 4]);
+            const ScalarFloat *ptr = grid->data();
+            ScalarFloat *scaled_data_ptr = scaled_data.get();
+            for (size_t i = 0; i < brick_values; ++i) {
+                ScalarColor3f rgb = dr::load<ScalarColor3f>(ptr);
+                ScalarFloat scale = dr::max(rgb) * 2.f;
+                ScalarColor3f rgb_norm =
+                    rgb / dr::maximum((ScalarFloat) 1e-8, scale);
+                ScalarVector3f coeff = srgb_model_fetch(rgb_norm);
+                dr::store(scaled_data_ptr,
+                          dr::concat(coeff, dr::Array<ScalarFloat, 1>(scale)));
+                ptr += 3;
+                scaled_data_ptr += 4;
+            }
+
+            // The volume is bounded by the scale factor of the voxels
+            for (ScalarFloat &value : m_brick_max)
+                value *= 2.f;
+            m_max = grid->max() * 2.f;
+            m_channels = 4;
+            set_data(scaled_data.get());
+        } else {
+            m_max = grid->max();
+            m_max_per_channel.resize(channel_count);
+            grid->max_per_channel(m_max_per_channel.data());
+            m_channels = (uint32_t) channel_count;
+            m_channel_count = (uint32_t) channel_count;
+            set_data(grid->data());
+        }
+
+        if (props.get<bool>("use_grid_bbox", false)) {
+            m_to_local = grid->bbox_transform() * m_to_local;
+            update_bbox();
+        }
+        m_to_world = m_to_local.inverse();
+    }
+
+    UnpolarizedSpectrum eval(const Interaction3f &it,
+                             Mask active) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        const size_t channels = nchannels();
+        if (channels == 3 && is_spectral_v<Spectrum> && m_raw)
+            Throw("The SparseGridVolume texture %s was queried for a spectrum, "
+                  "but texture conversion into spectra was explicitly disabled! "
+                  "(raw=true)",
+                  to_string());
+        else if (channels != 3 && channels != 1)
+            Throw("The SparseGridVolume texture %s was queried for a spectrum, "
+                  "but has a number of channels which is not 1 or 3",
+                  to_string());
+
+        if (dr::none_or<false>(active))
+            return dr::zeros<UnpolarizedSpectrum>();
+
+        Footprint fp = footprint(it, active);
+        if (channels == 1)
+            return interpolate<1>(fp, active).x();
+
+        if constexpr (is_monochromatic_v<Spectrum>)
+            return luminance(Color3f(interpolate<3>(fp, active)));
+        else if constexpr (is_spectral_v<Spectrum>)
+            return interpolate_spectral(fp, it.wavelengths, active);
+        else
+            return Color3f(interpolate<3>(fp, active));
+    }
+
+    Float eval_1(const Interaction3f &it, Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        const size_t channels = nchannels();
+        if (m_upsampled)
+            Throw("eval_1(): The SparseGridVolume texture %s was queried for a "
+                  "scalar value, but texture conversion into spectra was "
+                  "requested! (raw=false)",
+                  to_string());
+        else if (channels != 1 && channels != 3 && channels != 6)
+            Throw("eval_1(): The SparseGridVolume texture %s was queried for a "
+                  "scalar value, but has a number of channels which is not 1, "
+                  "3 or 6", to_string());
+
+        if (dr::none_or<false>(active))
+            return dr::zeros<Float>();
+
+        Footprint fp = footprint(it, active);
+        if (channels == 1)
+            return interpolate<1>(fp, active).x();
+        else if (channels == 3)
+            return luminance(Color3f(interpolate<3>(fp, active)));
+        else // 6 channels
+            return dr::mean(interpolate<6>(fp, active));
+    }
+
+    Vector3f eval_3(const Interaction3f &it,
+                    Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        const size_t channels = nchannels();
+        if (channels != 3)
+            Throw("eval_3(): The SparseGridVolume texture %s was queried for a "
+                  "3D vector, but it has %s channel(s)", to_string(), channels);
+        else if (m_upsampled)
+            Throw("eval_3(): The SparseGridVolume texture %s was queried for a "
+                  "3D vector, but texture conversion into spectra was "
+                  "requested! (raw=false)", to_string());
+
+        if (dr::none_or<false>(active))
+            return dr::zeros<Vector3f>();
+
+        return Vector3f(interpolate<3>(footprint(it, active), active));
+    }
+
+    dr::Array<Float, 6> eval_6(const Interaction3f &it,
+                               Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        const size_t channels = nchannels();
+        if (channels != 6)
+            Throw("eval_6(): The SparseGridVolume texture %s was queried for a "
+                  "6D vector, but it has %s channel(s)", to_string(), channels);
+
+        if (dr::none_or<false>(active))
+            return dr::zeros<dr::Array<Float, 6>>();
+
+        return interpolate<6>(footprint(it, active), active);
+    }
+
+    void eval_n(const Interaction3f &it, Float *out,
+                Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        Footprint fp = footprint(it, active);
+        for (uint32_t c = 0; c < m_channels; ++c) {
+            Float result = 0.f;
+            for (size_t i = 0; i < fp.size; ++i)
+                result = dr::fmadd(
+                    fp.weight[i],
+                    dr::gather<Float>(m_data, fp.offset[i] + c, active), result);
+            out[c] = result;
+        }
+    }
+
+    std::pair<UnpolarizedSpectrum, Vector3f>
+    eval_gradient(const Interaction3f &it, Mask active = true) const override {
+        MI_MASKED_FUNCTION(ProfilerPhase::TextureEvaluate, active);
+
+        if (m_channels != 1)
+            Throw("eval_gradient(): The SparseGridVolume texture %s was "
+                  "queried for a gradient, but it has %s channel(s)",
+                  to_string(), nchannels());
+
+        if (dr::none_or<false>(active))
+            return { dr::zeros<UnpolarizedSpectrum>(), dr::zeros<Vector3f>() };
+
+        // Nearest neighbor lookups are piecewise constant
+        if (m_filter_mode == dr::FilterMode::Nearest)
+            return { interpolate<1>(footprint(it, active), active).x(),
+                     dr::zeros<Vector3f>() };
+
+        Point3f p = dr::fmadd(m_to_local * it.p, m_resolution, -.5f);
+        Vector3i p_i = dr::floor2int<Vector3i>(p);
+        Vector3f w1 = p - Point3f(p_i),
+                 w0 = 1.f - w1;
+
+        Float value = 0.f;
+        Vector3f grad = 0.f;
+        for (uint32_t i = 0; i < 8; ++i) {
+            ScalarVector3i d(i & 1, (i >> 1) & 1, i >> 2);
+            Float f = dr::gather<Float>(m_data, voxel_offset(p_i + d, active), active);
+
+            Float wx = d.x() ? w1.x() : w0.x(),
+                  wy = d.y() ? w1.y() : w0.y(),
+                  wz = d.z() ? w1.z() : w0.z();
+
+            // Derivatives of the interpolation weight along each axis
+            Vector3f dw(d.x() ? wy * wz : -wy * wz,
+                        d.y() ? wx * wz : -wx * wz,
+                        d.z() ? wx * wy : -wx * wy);
+
+            value = dr::fmadd(wx * wy, wz * f, value);
+            grad  = dr::fmadd(dw, f, grad);
+        }
+
+        // Gradients transform like normals from local to world space
+        grad = Vector3f(m_to_world * Normal3f(grad * m_resolution));
+
+        return { value, grad };
+    }
+
+    ScalarFloat max() const override { return m_max; }
+
+    void max_per_channel(ScalarFloat *out) const override {
+        for (size_t i = 0; i < m_max_per_channel.size(); ++i)
+            out[i] = m_max_per_channel[i];
+    }
+
+    TensorXf local_majorants(const ScalarVector3i &grid_resolution,
+                             ScalarFloat value_scale) const override {
+        const ScalarVector3i res = resolution();
+
+        /* Trilinear lookups inside a cell may access one voxel on each side
+           of the voxels it overlaps. The maximum over a cell is bounded by
+           the maxima of the bricks of all tiles touched by these voxels. */
+        const int margin = m_filter_mode == dr::FilterMode::Linear ? 1 : 0;
+
+        size_t out_shape[4] = { (size_t) grid_resolution.z(),
+                                (size_t) grid_resolution.y(),
+                                (size_t) grid_resolution.x(), 1 };
+        std::unique_ptr<ScalarFloat[]> out(
+            new ScalarFloat[out_shape[0] * out_shape[1] * out_shape[2]]);
+
+        dr::parallel_for(
+            dr::blocked_range<size_t>(0, out_shape[0], 1),
+            [&](const dr::blocked_range<size_t> &range) {
+                std::vector<uint32_t> tiles[3];
+                for (size_t z = range.begin(); z != range.end(); ++z) {
+                    for (int y = 0; y < grid_resolution.y(); ++y) {
+                        for (int x = 0; x < grid_resolution.x(); ++x) {
+                            ScalarVector3i cell(x, y, (int) z);
+                            for (size_t k = 0; k < 3; ++k) {
+                                int lo = (int) ((int64_t) cell[k] * res[k] / grid_resolution[k]) - margin,
+                                    hi = (int) (((int64_t) cell[k] + 1) * res[k] +
+                                                grid_resolution[k] - 1) / grid_resolution[k] - 1 + margin;
+
+                                // Tiles covering the (wrapped) voxel range along this axis
+                                tiles[k].clear();
+                                for (int v = lo; v <= hi; ++v) {
+                                    uint32_t tile = (uint32_t) wrap(v, res[k]) / BrickSize;
+                                    if (std::find(tiles[k].begin(), tiles[k].end(), tile) == tiles[k].end())
+                                        tiles[k].push_back(tile);
+                                }
+                            }
+
+                            ScalarFloat value = 0.f;
+                            for (uint32_t tz : tiles[2])
+                                for (uint32_t ty : tiles[1])
+                                    for (uint32_t tx : tiles[0])
+                                        value = dr::maximum(value, m_brick_max[m_index[
+                                            (tz * m_tile_count.y() + ty) * m_tile_count.x() + tx]]);
+
+                            out[(z * out_shape[1] + y) * out_shape[2] + x] = value * value_scale;
+                        }
+                    }
+                }
+            }
+        );
+
+        return TensorXf(out.get(), 4, out_shape);
+    }
+
+    ScalarVector3i resolution() const override { return ScalarVector3i(m_size); };
+
+    std::string to_string() const override {
+        std::ostringstream oss;
+        oss << "SparseGridVolume[" << std::endl
+            << "  to_local = " << string::indent(m_to_local, 13) << "," << std::endl
+            << "  bbox = " << string::indent(m_bbox) << "," << std::endl
+            << "  dimensions = " << resolution() << "," << std::endl
+            << "  bricks = " << m_brick_max.size() << "," << std::endl
+            << "  max = " << m_max << "," << std::endl
+            << "  channels = " << m_channels << "," << std::endl
+            << "  data = [ " << util::mem_string(dr::width(m_data) * sizeof(ScalarFloat))
+            << " of volume data ]" << std::endl
+            << "]";
+        return oss.str();
+    }
+
+    MI_DECLARE_CLASS()
+
+protected:
+    /// Offsets of the voxels that contribute to a lookup and their weights
+    struct Footprint {
+        UInt32 offset[8];
+        Float weight[8];
+        size_t size;
+    };
+
+    /**
+     * \brief Returns the number of channels in the grid
+     *
+     * For object instances that perform spectral upsampling, the channel that
+     * holds all scaling coefficients is omitted.
+     */
+    MI_INLINE size_t nchannels() const { return m_upsampled ? 3 : m_channels; }
+
+    /// Upload the brick data to the device
+    void set_data(const ScalarFloat *data) {
+        size_t size = m_brick_max.size() * BrickVoxels * m_channels;
+        if (size > (size_t) std::numeric_limits<uint32_t>::max())
+            Throw("The sparse volume grid is too large (%s of volume data), "
+                  "brick addresses must fit into 32 bit!",
+                  util::mem_string(size * sizeof(ScalarFloat)));
+        m_data = dr::load<FloatStorage>(data, size);
+    }
+
+    /// Map a voxel coordinate along an axis into the range [0, n)
+    MI_INLINE int wrap(int i, int n) const {
+        if (m_wrap_mode == dr::WrapMode::Repeat) {
+            i %= n;
+            return i < 0 ? i + n : i;
+        } else if (m_wrap_mode == dr::WrapMode::Mirror) {
+            i = i < 0 ? -i - 1 : i;
+            i %= 2 * n;
+            return i >= n ? 2 * n - 1 - i : i;
+        } else {
+            return dr::clamp(i, 0, n - 1);
+        }
+    }
+
+    /// Vectorized version of \ref wrap()
+    MI_INLINE Vector3i wrap(Vector3i v) const {
+        const ScalarVector3i res(m_size);
+        if (m_wrap_mode == dr::WrapMode::Repeat) {
+            v = v % res;
+            return dr::select(v < 0, v + res, v);
+        } else if (m_wrap_mode == dr::WrapMode::Mirror) {
+            v = dr::select(v < 0, -v - 1, v);
+            v = v % (2 * res);
+            return dr::select(v >= res, 2 * res - 1 - v, v);
+        } else {
+            return dr::clamp(v, 0, res - 1);
+        }
+    }
+
+    /// Return the offset of the first channel of a voxel in the brick data
+    MI_INLINE UInt32 voxel_offset(const Vector3i &v, Mask active) const {
+        Vector3u p = Vector3u(wrap(v)),
+                 tile = dr::sr<3>(p),
+                 local = p & (BrickSize - 1);
+
+        UInt32 brick = dr::gather<UInt32>(
+            m_index_device,
+            (tile.z() * m_tile_count.y() + tile.y()) * m_tile_count.x() + tile.x(),
+            active);
+
+        return (brick * BrickVoxels +
+                (local.z() * BrickSize + local.y()) * BrickSize + local.x()) *
+               m_channels;
+    }
+
+    /// Compute the voxels involved in a lookup and their interpolation weights
+    MI_INLINE Footprint footprint(const Interaction3f &it, Mask active) const {
+        Point3f p = m_to_local * it.p;
+        Footprint fp;
+
+        if (m_filter_mode == dr::FilterMode::Nearest) {
+            fp.size = 1;
+            fp.offset[0] = voxel_offset(dr::floor2int<Vector3i>(p * m_resolution), active);
+            fp.weight[0] = 1.f;
+        } else {
+            p = dr::fmadd(p, m_resolution, -.5f);
+            Vector3i p_i = dr::floor2int<Vector3i>(p);
+            Vector3f w1 = p - Point3f(p_i),
+                     w0 = 1.f - w1;
+
+            fp.size = 8;
+            for (uint32_t i = 0; i < 8; ++i) {
+                ScalarVector3i d(i & 1, (i >> 1) & 1, i >> 2);
+                fp.offset[i] = voxel_offset(p_i + d, active);
+                fp.weight[i] = (d.x() ? w1.x() : w0.x()) *
+                               (d.y() ? w1.y() : w0.y()) *
+                               (d.z() ? w1.z() : w0.z());
+            }
+        }
+
+        return fp;
+    }
+
+    /// Interpolate the first \c Channels channels of the volume
+    template <size_t Channels>
+    MI_INLINE dr::Array<Float, Channels> interpolate(const Footprint &fp,
+                                                     Mask active) const {
+        dr::Array<Float, Channels> result = 0.f;
+        for (size_t i = 0; i < fp.size; ++i)
+            for (size_t c = 0; c < Channels; ++c)
+                result[c] = dr::fmadd(
+                    fp.weight[i],
+                    dr::gather<Float>(m_data, fp.offset[i] + (uint32_t) c, active),
+                    result[c]);
+        return result;
+    }
+
+    /**
+     * \brief Evaluates the volume using spectral upsampling
+     *
+     * Like the \c gridvolume plugin, the spectra of the voxels and their
+     * scale factors are interpolated separately.
+     */
+    MI_INLINE UnpolarizedSpectrum interpolate_spectral(const Footprint &fp,
+                                                        const Wavelength &wavelengths,
+                                                        Mask active) const {
+        UnpolarizedSpectrum result = 0.f;
+        Float scale = 0.f;
+        for (size_t i = 0; i < fp.size; ++i) {
+            Vector3f coeff;
+            for (uint32_t c = 0; c < 3; ++c)
+                coeff[c] = dr::gather<Float>(m_data, fp.offset[i] + c, active);
+            Float s = dr::gather<Float>(m_data, fp.offset[i] + 3u, active);
+
+            result = dr::fmadd(
+                fp.weight[i],
+                srgb_model_eval<UnpolarizedSpectrum>(coeff, wavelengths), result);
+            scale = dr::fmadd(fp.weight[i], s, scale);
+        }
+        return result * scale;
+    }
+
+protected:
+    using FloatStorage = DynamicBuffer<Float>;
+    using UInt32Storage = DynamicBuffer<UInt32>;
+
+    FloatStorage m_data;
+    UInt32Storage m_index_device;
+
+    /// Host copies of the index and of the per-brick maxima (for majorants)
+    std::vector<uint32_t> m_index;
+    std::vector<ScalarFloat> m_brick_max;
+
+    ScalarVector3u m_size;
+    ScalarVector3f m_resolution;
+    ScalarVector3u m_tile_count;
+    ScalarTransform4f m_to_world;
+    uint32_t m_channels;
+    dr::FilterMode m_filter_mode;
+    dr::WrapMode m_wrap_mode;
+    bool m_raw;
+    bool m_upsampled;
+    ScalarFloat m_max;
+    std::vector<ScalarFloat> m_max_per_channel;
+};
+
+MI_IMPLEMENT_CLASS_VARIANT(SparseGridVolume, Volume)
+MI_EXPORT_PLUGIN(SparseGridVolume, "SparseGridVolume texture")
+
+NAMESPACE_END(mitsuba)
@@ -114,3 +114,229 @@ def test06_eval_per_channel(variants_all_rgb, tmpdir):
     it.p = mi.Point3f(1.0)
     print(vol.eval_n(it))
     assert dr.allclose(vol.eval_n(it), [1.0, 2.0, 3.0, 4.0, 5.0, 6.0])
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+def test07_local_majorants(variants_all_rgb, filter_type):
+    import numpy as np
+    data = np.full((4, 4, 4, 1), 0.5, dtype=np.float32)
+    data[0, 1, 3] = 4.0
+    data[3, 3, 0] = 0.1
+    vol = mi.load_dict({
+        'type' : 'gridvolume',
+        'data' : mi.TensorXf(data),
+        'raw' : True,
+        'filter_type' : filter_type
+    })
+
+    majorants = np.array(vol.local_majorants([2, 2, 2], 2.0))
+    assert majorants.shape == (2, 2, 2, 1)
+
+    expected = np.full((2, 2, 2, 1), 1.0)
+    if filter_type == 'nearest':
+        expected[0, 0, 1] = 8.0
+    else:
+        # Trilinear lookups in the neighboring cell along Y reach the voxel
+        expected[0, :, 1] = 8.0
+    assert np.allclose(majorants, expected)
+
+    # The minimum is only reachable from a single cell with both filters
+    minorants = np.array(vol.local_minorants([2, 2, 2], 2.0))
+    expected = np.full((2, 2, 2, 1), 1.0)
+    expected[1, 1, 0] = 0.2
+    assert np.allclose(minorants, expected)
+
+
+def test08_file_versions(variants_all_rgb, tmpdir):
+    import numpy as np
+    data = np.random.default_rng(seed=0).uniform(size=(5, 6, 7, 3)).astype(np.float32)
+    data[..., 1] *= 4.0
+    grid = mi.VolumeGrid(data)
+
+    for version in [3, 4]:
+        tmp_file = os.path.join(str(tmpdir), f"out_v{version}.vol")
+        grid.write(tmp_file, version=version)
+
+        loaded = mi.VolumeGrid(tmp_file)
+        # Version 4 files are mapped into memory rather than read
+        assert loaded.is_memory_mapped() == (version == 4 and
+                                             'double' not in mi.variant())
+        assert np.all(loaded.size() == [7, 6, 5])
+        assert dr.allclose(loaded.max(), data.max())
+        assert dr.allclose(loaded.max_per_channel(), data.max(axis=(0, 1, 2)))
+        assert np.allclose(np.array(loaded), data)
+
+        vol = mi.load_dict({
+            'type' : 'gridvolume',
+            'filename' : tmp_file,
+            'raw' : True
+        })
+        it = dr.zeros(mi.Interaction3f, 1)
+        it.p = mi.Point3f(0.1, 0.5, 0.9)
+        assert dr.allclose(vol.eval_3(it),
+                           mi.load_dict({ 'type' : 'gridvolume', 'grid' : grid,
+                                          'raw' : True }).eval_3(it))
+
+    # Version 3 remains the default
+    tmp_file = os.path.join(str(tmpdir), "out_default.vol")
+    grid.write(tmp_file)
+    assert not mi.VolumeGrid(tmp_file).is_memory_mapped()
+
+    # The maximum stored in version 4 files is computed while writing
+    tmp_file = os.path.join(str(tmpdir), "out_no_max.vol")
+    mi.VolumeGrid(data, compute_max=False).write(tmp_file, version=4)
+    loaded = mi.VolumeGrid(tmp_file)
+    assert dr.allclose(loaded.max(), data.max())
+    assert dr.allclose(loaded.max_per_channel(), data.max(axis=(0, 1, 2)))
+
+
+@pytest.mark.parametrize('storage', ['float16', 'unorm16', 'unorm8'])
+@pytest.mark.parametrize('channels', [1, 3])
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+def test09_reduced_precision(variants_all_rgb, storage, channels, filter_type):
+    import numpy as np
+    rng = np.random.default_rng(seed=0)
+    data = rng.uniform(0.0, 3.0, size=(6, 7, 8, channels)).astype(np.float32)
+    data[:2] = 0.0
+    props = {
+        'type' : 'gridvolume',
+        'grid' : mi.VolumeGrid(data),
+        'raw' : True,
+        'filter_type' : filter_type,
+        'wrap_mode' : 'mirror'
+    }
+    reference = mi.load_dict(props)
+    vol = mi.load_dict({ **props, 'storage' : storage })
+    assert storage in str(vol)
+    # Reduced precision data can't be modified
+    assert 'data' not in mi.traverse(vol)
+
+    rng = mi.PCG32(size=1000)
+    it = dr.zeros(mi.Interaction3f, 1000)
+    it.p = mi.Point3f(rng.next_float32(), rng.next_float32(), rng.next_float32()) * 1.2 - 0.1
+
+    # Quantization error of a value in [0, 3]
+    atol = { 'float16' : 3e-3, 'unorm16' : 1e-4, 'unorm8' : 1e-2 }[storage]
+    if channels == 1:
+        value = vol.eval_1(it)
+        assert dr.allclose(value, reference.eval_1(it), atol=atol)
+    else:
+        value = vol.eval_3(it)
+        assert dr.allclose(value, reference.eval_3(it), atol=atol)
+
+    # The maxima refer to the decoded values and bound all lookups
+    assert dr.allclose(vol.max(), data.max(), atol=atol)
+    assert np.max(np.array(value)) <= vol.max()
+    assert dr.allclose(vol.max_per_channel(), data.max(axis=(0, 1, 2)), atol=atol)
+
+    majorants = np.array(vol.local_majorants([1, 1, 1], 1.0))
+    assert majorants[0, 0, 0, 0] == vol.max()
+
+    # Empty regions remain exactly empty
+    it.p = mi.Point3f(0.5, 0.5, 0.05)
+    value = vol.eval_1(it) if channels == 1 else vol.eval_3(it)
+    assert np.all(np.array(value) == 0.0)
+
+
+def test10_reduced_precision_spectral(variants_all_spectral):
+    import numpy as np
+    data = np.random.default_rng(seed=0).uniform(size=(4, 5, 6, 3)).astype(np.float32)
+    props = { 'type' : 'gridvolume', 'grid' : mi.VolumeGrid(data) }
+    reference = mi.load_dict(props)
+    vol = mi.load_dict({ **props, 'storage' : 'unorm8' })
+    # Upsampled spectra are stored using half precision instead
+    assert 'float16' in str(vol)
+
+    it = dr.zeros(mi.Interaction3f, 100)
+    it.p = mi.Point3f(0.3, 0.6, 0.2)
+    it.wavelengths = mi.Spectrum(500.0)
+    assert dr.allclose(vol.eval(it), reference.eval(it), rtol=1e-2, atol=1e-3)
+    assert dr.allclose(vol.max(), reference.max(), rtol=1e-3)
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+def test11_mip_levels(variants_all_rgb, filter_type):
+    import numpy as np
+    # Checkerboard, whose coarser levels are constant
+    data = (np.indices((8, 8, 8)).sum(axis=0) % 2).astype(np.float32) * 2.0
+    vol = mi.load_dict({
+        'type' : 'gridvolume',
+        'data' : mi.TensorXf(data[..., None]),
+        'raw' : True,
+        'filter_type' : filter_type,
+        'mip_levels' : 3,
+        'to_world' : mi.ScalarTransform4f.scale(2.0)
+    })
+
+    rng = mi.PCG32(size=1000)
+    it = dr.zeros(mi.Interaction3f, 1000)
+    it.p = mi.Point3f(rng.next_float32(), rng.next_float32(), rng.next_float32()) * 2.0
+
+    # Footprints smaller than a voxel (of size 0.25) use the full resolution
+    assert dr.allclose(vol.eval_lod(it, 0.0), vol.eval(it))
+    assert dr.allclose(vol.eval_lod(it, 0.2), vol.eval(it))
+
+    # Coarser levels average the checkerboard
+    assert dr.allclose(vol.eval_lod(it, 0.5)[0], 1.0)
+    assert dr.allclose(vol.eval_lod(it, 100.0)[0], 1.0)
+
+    # The majorants also bound the lookups at the coarser levels
+    assert np.all(np.array(vol.local_majorants([2, 2, 2])) == 2.0)
+
+    if filter_type == 'trilinear':
+        # A linear ramp along x is reproduced by all levels away from the border
+        ramp = np.broadcast_to(np.arange(8, dtype=np.float32), (8, 8, 8))
+        vol = mi.load_dict({
+            'type' : 'gridvolume',
+            'data' : mi.TensorXf(np.ascontiguousarray(ramp)[..., None]),
+            'raw' : True,
+            'mip_levels' : 3,
+            'to_world' : mi.ScalarTransform4f.scale(2.0)
+        })
+        x = 0.6 + rng.next_float32() * 0.8
+        it.p = mi.Point3f(x, it.p.y, it.p.z)
+
+        # Lanes that select different levels are evaluated together
+        footprint = dr.select(rng.next_float32() < 0.5, 0.0, 1.0)
+        footprint = dr.select(rng.next_float32() < 0.5, footprint, 0.5)
+        assert dr.allclose(vol.eval_lod(it, footprint)[0], 4.0 * x - 0.5,
+                           atol=1e-4)
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+@pytest.mark.parametrize('wrap_mode', ['clamp', 'repeat'])
+def test12_eval_pair(variants_all_rgb, filter_type, wrap_mode):
+    import numpy as np
+    rng = np.random.default_rng(seed=0)
+    props = {
+        'type' : 'gridvolume',
+        'raw' : True,
+        # Hardware-accelerated lookups aren't fused
+        'accel' : False,
+        'filter_type' : filter_type,
+        'wrap_mode' : wrap_mode,
+        'to_world' : mi.ScalarTransform4f.translate([1, 0, 0]).scale([2, 1, 3])
+    }
+    density = mi.load_dict({ **props, 'data' : mi.TensorXf(
+        rng.uniform(0, 5, (6, 5, 4, 1)).astype(np.float32)) })
+    albedo = mi.load_dict({ **props, 'data' : mi.TensorXf(
+        rng.uniform(0, 1, (6, 5, 4, 3)).astype(np.float32)) })
+    other = mi.load_dict({ **props, 'data' : mi.TensorXf(
+        rng.uniform(0, 1, (6, 5, 3, 1)).astype(np.float32)) })
+
+    assert density.is_colocated(albedo)
+    assert not density.is_colocated(other)
+    assert not density.is_colocated(mi.load_dict({ 'type' : 'constvolume' }))
+
+    n = 1000
+    sampler = mi.PCG32(size=n)
+    it = dr.zeros(mi.Interaction3f, n)
+    p = mi.Point3f(sampler.next_float32(), sampler.next_float32(),
+                   sampler.next_float32()) * 1.2 - 0.1
+    it.p = p * mi.Vector3f(2, 1, 3) + mi.Vector3f(1, 0, 0)
+
+    # Fused and separate lookups agree
+    for volume in [albedo, other]:
+        value_0, value_1 = density.eval_pair(volume, it, 0.0)
+        assert dr.allclose(value_0, density.eval(it), atol=1e-5)
+        assert dr.allclose(value_1, volume.eval(it), atol=1e-5)
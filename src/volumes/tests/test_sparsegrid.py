@@ -0,0 +1,127 @@
+import pytest
+import drjit as dr
+import mitsuba as mi
+import os
+
+
+def make_cloud(shape, channels=1):
+    import numpy as np
+    rng = np.random.default_rng(seed=0)
+    data = np.zeros(shape + (channels,), dtype=np.float32)
+    # A dense blob that spans several tiles, surrounded by empty space
+    data[2:11, 5:14, 9:17] = rng.uniform(0.5, 2.0, (9, 9, 8, channels))
+    # A constant region, whose tiles share a single brick as well
+    data[:, 16:, :] = 0.75
+    return data
+
+
+def test01_sparse_grid_construct(variant_scalar_rgb, tmpdir):
+    import numpy as np
+    data = make_cloud((20, 19, 25))
+    grid = mi.SparseVolumeGrid(mi.VolumeGrid(data))
+
+    assert np.all(grid.size() == [25, 19, 20])
+    assert np.all(grid.tile_count() == [4, 3, 3])
+    assert grid.channel_count() == 1
+    # The blob touches 2x2x2 tiles, the other tiles are empty or constant
+    assert grid.brick_count() == 2 * 2 * 2 + 2
+    assert dr.allclose(grid.max(), data.max())
+    assert grid.buffer_size() < data.nbytes
+
+    # Round trip through sparse and dense volume files
+    sparse_file = os.path.join(str(tmpdir), "out.svol")
+    dense_file = os.path.join(str(tmpdir), "out.vol")
+    grid.write(sparse_file)
+    mi.VolumeGrid(data).write(dense_file)
+
+    for filename in [sparse_file, dense_file]:
+        other = mi.SparseVolumeGrid(filename)
+        assert np.all(other.size() == grid.size())
+        assert other.brick_count() == grid.brick_count()
+        assert dr.allclose(other.max(), grid.max())
+
+
+def test02_tolerance(variant_scalar_rgb):
+    import numpy as np
+    data = np.full((16, 16, 16, 1), 0.25, dtype=np.float32)
+    data[:8, :8, :8] += np.linspace(0, 1e-3, 8 * 8 * 8).reshape(8, 8, 8, 1)
+
+    assert mi.SparseVolumeGrid(mi.VolumeGrid(data)).brick_count() == 2
+    assert mi.SparseVolumeGrid(mi.VolumeGrid(data), 1e-2).brick_count() == 1
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+@pytest.mark.parametrize('wrap_mode', ['clamp', 'repeat', 'mirror'])
+@pytest.mark.parametrize('channels', [1, 3])
+def test03_compare_dense(variants_all_rgb, filter_type, wrap_mode, channels):
+    data = make_cloud((20, 19, 25), channels)
+    props = {
+        'filter_type' : filter_type,
+        'wrap_mode' : wrap_mode,
+        'to_world' : mi.ScalarTransform4f.translate([1, 2, 3]).scale([2, 1, 3])
+    }
+    dense = mi.load_dict({ 'type' : 'gridvolume', 'grid' : mi.VolumeGrid(data),
+                           'accel' : False, **props })
+    sparse = mi.load_dict({ 'type' : 'sparsegridvolume',
+                            'grid' : mi.SparseVolumeGrid(mi.VolumeGrid(data)),
+                            **props })
+
+    rng = mi.PCG32(size=10000)
+    it = dr.zeros(mi.Interaction3f, 10000)
+    # Lookups outside of the unit cube exercise the wrap modes
+    p = mi.Point3f(rng.next_float32(), rng.next_float32(), rng.next_float32()) * 1.5 - 0.25
+    it.p = p * mi.Vector3f(2, 1, 3) + mi.Vector3f(1, 2, 3)
+
+    assert dr.allclose(sparse.eval(it), dense.eval(it), atol=1e-5)
+    if channels == 1:
+        assert dr.allclose(sparse.eval_1(it), dense.eval_1(it), atol=1e-5)
+    else:
+        assert dr.allclose(sparse.eval_3(it), dense.eval_3(it), atol=1e-5)
+
+    assert dr.allclose(sparse.max(), dense.max())
+
+
+def test04_eval_gradient(variants_all_rgb):
+    data = make_cloud((20, 19, 25))
+    vol = mi.load_dict({
+        'type' : 'sparsegridvolume',
+        'grid' : mi.SparseVolumeGrid(mi.VolumeGrid(data)),
+        'to_world' : mi.ScalarTransform4f.scale([2, 1, 3])
+    })
+
+    rng = mi.PCG32(size=1000)
+    it = dr.zeros(mi.Interaction3f, 1000)
+    it.p = mi.Point3f(rng.next_float32() * 2, rng.next_float32(),
+                      rng.next_float32() * 3)
+
+    value, grad = vol.eval_gradient(it)
+    assert dr.allclose(value, vol.eval(it))
+
+    eps = 1e-3
+    for k in range(3):
+        offset = mi.Vector3f(0)
+        offset[k] = eps
+        it_fw, it_bw = dr.zeros(mi.Interaction3f, 1000), dr.zeros(mi.Interaction3f, 1000)
+        it_fw.p, it_bw.p = it.p + offset, it.p - offset
+        fd = (vol.eval_1(it_fw) - vol.eval_1(it_bw)) / (2 * eps)
+        # Exclude lookups close to voxel boundaries, where the gradient jumps
+        assert dr.count(dr.abs(grad[k] - fd) < 1e-2 * (1 + dr.abs(grad[k]))) > 980
+
+
+@pytest.mark.parametrize('filter_type', ['nearest', 'trilinear'])
+def test05_local_majorants(variants_all_rgb, filter_type):
+    import numpy as np
+    data = make_cloud((20, 19, 25))
+    grid = mi.VolumeGrid(data)
+    props = { 'filter_type' : filter_type }
+    dense = mi.load_dict({ 'type' : 'gridvolume', 'grid' : grid, **props })
+    sparse = mi.load_dict({ 'type' : 'sparsegridvolume',
+                            'grid' : mi.SparseVolumeGrid(grid), **props })
+
+    res = [5, 4, 3]
+    majorants = np.array(sparse.local_majorants(res, 2.0))
+    assert majorants.shape == (3, 4, 5, 1)
+
+    # Per-brick maxima are conservative, and empty regions remain empty
+    assert np.all(majorants >= np.array(dense.local_majorants(res, 2.0)))
+    assert np.any(majorants == 0.0)